@@ -390,6 +390,15 @@ typedef struct SNonSortExecInfo {
   int32_t blkNums;
 } SNonSortExecInfo;
 
+typedef struct SHashJoinExecInfo {
+  int32_t spillPartitions;  // partitions joined from the spill buffer, 0 if the join is done in memory
+  int32_t spillLevels;      // max times a partition is partitioned
+  int64_t spillBuildRows;
+  int64_t spillProbeRows;
+  int64_t writeBytes;  // write io bytes
+  int64_t readBytes;   // read io bytes
+} SHashJoinExecInfo;
+
 typedef struct STUidTagInfo {
   char*    name;
   uint64_t uid;
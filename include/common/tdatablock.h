@@ -214,6 +214,7 @@ size_t blockDataGetNumOfRows(const SSDataBlock* pBlock);
 
 int32_t blockDataMerge(SSDataBlock* pDest, const SSDataBlock* pSrc);
 int32_t blockDataMergeNRows(SSDataBlock* pDest, const SSDataBlock* pSrc, int32_t srcIdx, int32_t numOfRows);
+int32_t blockDataGatherRows(SSDataBlock* pDest, const SSDataBlock* pSrc, const int32_t* index, int32_t numOfRows);
 void blockDataShrinkNRows(SSDataBlock* pBlock, int32_t numOfRows);
 int32_t blockDataSplitRows(SSDataBlock* pBlock, bool hasVarCol, int32_t startIndex, int32_t* stopIndex,
                            int32_t pageSize);
@@ -229,11 +230,45 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+/**
+ * @brief sort the block by splitting the rows into key ranges that are sorted by up to numOfThreads threads
+ */
+int32_t blockDataSortParallel(SSDataBlock* pDataBlock, SArray* pOrderInfo, int32_t numOfThreads);
+/**
+ * @brief stop the threads of the parallel sorts, after all the threads that may sort are stopped
+ */
+void blockDataSortCleanup();
 /**
  * @brief find how many rows already in order start from first row
  */
 int32_t blockDataGetSortedRows(SSDataBlock* pDataBlock, SArray* pOrderInfo);
 
+/**
+ * @brief normalized prefix of the sort key of one row. The order columns are encoded with null ordering and ASC/DESC
+ * applied, so that comparing two prefixes as unsigned integers gives the order of the rows, unless they are equal.
+ */
+typedef struct SSortKeyPrefix {
+  uint64_t w[2];
+} SSortKeyPrefix;
+
+static FORCE_INLINE int32_t sortKeyPrefixCompare(const SSortKeyPrefix* pLeft, const SSortKeyPrefix* pRight) {
+  if (pLeft->w[0] != pRight->w[0]) {
+    return pLeft->w[0] < pRight->w[0] ? -1 : 1;
+  }
+  if (pLeft->w[1] != pRight->w[1]) {
+    return pLeft->w[1] < pRight->w[1] ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief check if the sort key prefix helps to sort the block. pComplete is set if equal prefixes mean equal keys, so
+ * no further comparison is needed.
+ */
+bool blockDataSortKeyApplicable(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, bool* pComplete);
+void blockDataBuildSortKeys(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, int32_t start, int32_t end,
+                            SSortKeyPrefix* pKeys);
+
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows, bool clearPayload);
 int32_t blockDataEnsureCapacity(SSDataBlock* pDataBlock, uint32_t numOfRows);
 
@@ -268,6 +303,13 @@ int32_t blockGetEncodeSize(const SSDataBlock* pBlock);
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+/**
+ * Compress the data produced by blockEncode with the codec, return the compressed length, or -1 if it does not fit
+ * into the output buffer.
+ */
+int32_t blockCompress(int8_t codec, const char* pData, int32_t dataLen, char* pOut, int32_t outLen);
+int32_t blockDecompress(int8_t codec, const char* pInput, int32_t compLen, char* pOut, int32_t rawLen);
+
 // for debug
 char* dumpBlockData(SSDataBlock* pDataBlock, const char* flag, char** dumpBuf, const char* taskIdStr);
 
@@ -62,6 +62,9 @@ extern char     tsEncryptKey[];
 extern int32_t tsMaxShellConns;
 extern int32_t tsShellActivityTimer;
 extern int32_t tsCompressMsgSize;
+extern int32_t tsCompressMsgAlgo;
+extern int32_t tsCompressMsgLevel;
+extern char    tsCompressMsgDict[];
 extern int64_t tsTickPerMin[3];
 extern int64_t tsTickPerHour[3];
 extern int32_t tsCountAlwaysReturnValue;
@@ -86,6 +89,7 @@ extern int32_t tsNumOfQnodeQueryThreads;
 extern int32_t tsNumOfQnodeFetchThreads;
 extern int32_t tsNumOfSnodeStreamThreads;
 extern int32_t tsNumOfSnodeWriteThreads;
+extern int32_t tsNumOfSortThreads;
 extern int64_t tsRpcQueueMemoryAllowed;
 extern int32_t tsRetentionSpeedLimitMB;
 
@@ -231,6 +235,8 @@ extern int64_t tsmaDataDeleteMark;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern bool    tsWalGroupCommit;
+extern int32_t tsWalGroupCommitThreads;
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -255,6 +261,12 @@ extern int     tsStreamAggCnt;
 extern bool    tsFilterScalarMode;
 extern int32_t tsMaxStreamBackendCache;
 extern int32_t tsPQSortMemThreshold;
+extern int32_t tsTsdbColCacheSize;
+extern int32_t tsTsdbPrefetchBlocks;
+extern int32_t tsTsdbPrefetchSize;
+extern bool    tsTsdbBloomFilter;
+extern int32_t tsHashJoinMemThreshold;
+extern int32_t tsQueryOperatorBufSize;
 extern int32_t tsResolveFQDNRetryTime;
 
 extern bool tsExperimental;
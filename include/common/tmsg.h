@@ -628,6 +628,7 @@ void tFreeSSubmitRsp(SSubmitRsp* pRsp);
 #define COL_SMA_ON     ((int8_t)0x1)
 #define COL_IDX_ON     ((int8_t)0x2)
 #define COL_IS_KEY     ((int8_t)0x4)
+#define COL_BLOOM_ON   ((int8_t)0x8)
 #define COL_SET_NULL   ((int8_t)0x10)
 #define COL_SET_VAL    ((int8_t)0x20)
 #define COL_IS_SYSINFO ((int8_t)0x40)
@@ -1660,6 +1661,12 @@ typedef struct {
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
   int64_t errors;
+  int64_t walFsyncReqs;  // wal group commit, fsync requests of writers
+  int64_t walFsyncs;     // wal group commit, fsyncs done for them
+  int64_t walFsyncUs;
+  int64_t walFsyncWaitUs;
+  int64_t colCacheHits;  // tsdb decompressed column cache of all vnodes, since they are opened
+  int64_t colCacheMisses;
 } SVnodesStat;
 
 typedef struct {
@@ -1683,6 +1690,8 @@ typedef struct {
   int64_t numOfBatchInsertSuccessReqs;
   int32_t numOfCachedTables;
   int32_t learnerProgress;  // use one reservered
+  int64_t colCacheHits;     // tsdb decompressed column cache, not sent in the status
+  int64_t colCacheMisses;
 } SVnodeLoad;
 
 typedef struct {
@@ -2154,6 +2163,11 @@ typedef struct SSysTableSchema {
 int32_t tSerializeSRetrieveTableReq(void* buf, int32_t bufLen, SRetrieveTableReq* pReq);
 int32_t tDeserializeSRetrieveTableReq(void* buf, int32_t bufLen, SRetrieveTableReq* pReq);
 
+// codecs of the encoded blocks carried by the compressed field of the fetch and dispatch messages, see blockCompress
+#define BLOCK_COMPRESS_NONE     0
+#define BLOCK_COMPRESS_LZ4      1  // the whole encoded block is compressed by lz4
+#define BLOCK_COMPRESS_COLUMNAR 2  // each column is compressed by the codec of its type
+
 typedef struct {
   int64_t useconds;
   int8_t  completed;  // all results are returned to client
@@ -2612,6 +2626,7 @@ typedef struct {
   uint64_t        taskId;
   int32_t         execId;
   SOperatorParam* pOpParam;
+  int8_t          compress;  // BLOCK_COMPRESS_* the fetcher decodes, lz4 from older versions
 } SResFetchReq;
 
 int32_t tSerializeSResFetchReq(void* buf, int32_t bufLen, SResFetchReq* pReq);
@@ -169,6 +169,23 @@ typedef union {
 
 typedef void (*TsdReaderNotifyCbFn)(ETsdReaderNotifyType type, STsdReaderNotifyInfo* info, void* param);
 
+// evaluate the filter pushed down to the reader on a block with only the filter columns loaded, *keep is set to false
+// if none of the rows qualify
+typedef int32_t (*TsdReaderFilterFn)(SSDataBlock* pBlock, bool* keep, void* param);
+
+// evaluate the filter on the min/max and null count of the columns of a file block, *keep is set to false if none of
+// the rows can qualify
+typedef int32_t (*TsdReaderSmaFilterFn)(SColumnDataAgg* pAggs, int32_t numOfAggs, int32_t numOfRows, bool* keep,
+                                        void* param);
+
+// the values a column is compared with by "=" or "in" in a conjunct of the filter, the values are of the column type.
+// A file block whose bloom filter of the column holds none of the values can't have rows qualifying the filter.
+typedef struct STsdReaderEqualCond {
+  int16_t colId;
+  int8_t  type;
+  SArray* pValues;  // SArray<SValue>
+} STsdReaderEqualCond;
+
 typedef struct TsdReader {
   int32_t      (*tsdReaderOpen)(void* pVnode, SQueryTableDataCond* pCond, void* pTableList, int32_t numOfTables,
                            SSDataBlock* pResBlock, void** ppReader, const char* idstr, SHashObj** pIgnoreTables);
@@ -189,6 +206,10 @@ typedef struct TsdReader {
 
   void         (*tsdSetFilesetDelimited)(void* pReader);
   void         (*tsdSetSetNotifyCb)(void* pReader, TsdReaderNotifyCbFn notifyFn, void* param);
+  void         (*tsdSetFilter)(void* pReader, const int16_t* colIds, int32_t numOfCols, TsdReaderFilterFn filterFn,
+                          void* param);
+  void         (*tsdSetSmaFilter)(void* pReader, TsdReaderSmaFilterFn filterFn, void* param);
+  void         (*tsdSetEqualConds)(void* pReader, SArray* pConds);
 } TsdReader;
 
 typedef struct SStoreCacheReader {
@@ -83,6 +83,14 @@ typedef struct {
   int8_t       has_snode;
   SMonDiskDesc logdir;
   SMonDiskDesc tempdir;
+  int64_t      rpc_comp_msgs;  // rpc compression of the process, since it is started
+  int64_t      rpc_comp_raw_bytes;
+  int64_t      rpc_comp_bytes;
+  int64_t      rpc_comp_us;
+  int64_t      rpc_decomp_msgs;
+  int64_t      rpc_decomp_raw_bytes;
+  int64_t      rpc_decomp_bytes;
+  int64_t      rpc_decomp_us;
 } SMonDnodeInfo;
 
 typedef struct {
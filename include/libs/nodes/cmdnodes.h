@@ -190,6 +190,7 @@ typedef struct SColumnDefNode {
   SDataType dataType;
   SNode*    pOptions;
   bool      sma;
+  bool      bloomFilter;  // listed in the sma option of the table explicitly
 } SColumnDefNode;
 
 typedef struct SCreateTableStmt {
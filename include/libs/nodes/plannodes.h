@@ -174,6 +174,7 @@ typedef struct SAggLogicNode {
   bool       isGroupTb;
   bool       isPartTb;  // true if partition keys has tbname
   bool       hasGroup;
+  bool       isPartial;  // partial aggregation of a super table split, merged again by the parent agg
   SNodeList *pTsmaSubplans;
 } SAggLogicNode;
 
@@ -588,6 +589,7 @@ typedef struct SAggPhysiNode {
   bool       mergeDataBlock;
   bool       groupKeyOptimized;
   bool       hasCountLikeFunc;
+  bool       isPartial;
 } SAggPhysiNode;
 
 typedef struct SDownstreamSourceNode {
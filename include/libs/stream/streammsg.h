@@ -96,6 +96,7 @@ typedef struct {
   int32_t childId;
   int64_t oldStage;
   int8_t  status;
+  int8_t  compress;  // BLOCK_COMPRESS_* the downstream task decodes, lz4 from older versions
 } SStreamTaskCheckRsp;
 
 int32_t tEncodeStreamTaskCheckRsp(SEncoder* pEncoder, const SStreamTaskCheckRsp* pRsp);
@@ -391,6 +391,7 @@ typedef struct STaskOutputInfo {
     STaskSinkFetch fetchSink;
   };
   int8_t        type;
+  int8_t        compress;  // BLOCK_COMPRESS_* decoded by all the downstream tasks, agreed on by the check rsps
   STokenBucket* pTokenBucket;
   SArray*       pNodeEpsetUpdateList;
 } STaskOutputInfo;
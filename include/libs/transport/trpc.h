@@ -65,12 +65,22 @@ typedef struct SRpcHandleInfo {
   int8_t       compressed;
 } SRpcHandleInfo;
 
+typedef struct SRpcMsgSeg {
+  void   *pData;  // allocated by taosMemoryMalloc, freed by rpc
+  int32_t len;
+} SRpcMsgSeg;
+
 typedef struct SRpcMsg {
   tmsg_t         msgType;
   void          *pCont;
   int32_t        contLen;
   int32_t        code;
   SRpcHandleInfo info;
+
+  // body segments following pCont, requests and responses write them to socket without copying unless the msg is
+  // compressed, the total body length is contLen + length of all segments
+  SRpcMsgSeg *pSegs;
+  int32_t     numOfSegs;
 } SRpcMsg;
 
 typedef void (*RpcCfp)(void *parent, SRpcMsg *, SEpSet *epset);
@@ -79,6 +89,26 @@ typedef bool (*RpcTfp)(int32_t code, tmsg_t msgType);
 typedef bool (*RpcFFfp)(tmsg_t msgType);
 typedef bool (*RpcNoDelayfp)(tmsg_t msgType);
 typedef void (*RpcDfp)(void *ahandle);
+typedef int8_t (*RpcCompFp)(tmsg_t msgType);
+typedef bool (*RpcMuxFp)(tmsg_t msgType);
+
+// compression algorithm of msg body
+#define RPC_COMP_NONE      0
+#define RPC_COMP_LZ4       1
+#define RPC_COMP_ZSTD      2
+#define RPC_COMP_ZSTD_DICT 3  // zstd with the dictionary of SRpcInit.compressDict, both ends must load the same one
+
+// compression counters, of a conn or of all the rpc instances of the process
+typedef struct {
+  int64_t numOfComp;
+  int64_t compRawBytes;
+  int64_t compBytes;
+  int64_t compUs;
+  int64_t numOfDecomp;
+  int64_t decompRawBytes;
+  int64_t decompBytes;
+  int64_t decompUs;
+} SRpcCompStat;
 
 typedef struct SRpcInit {
   char     localFqdn[TSDB_FQDN_LEN];
@@ -98,8 +128,11 @@ typedef struct SRpcInit {
   int32_t failFastThreshold;
   int32_t failFastInterval;
 
-  int32_t compressSize;  // -1: no compress, 0 : all data compressed, size: compress data if larger than size
-  int8_t  encryption;    // encrypt or not
+  int32_t compressSize;   // -1: no compress, 0 : all data compressed, size: compress data if larger than size
+  int8_t  compressAlgo;   // RPC_COMP_*, default lz4
+  int8_t  compressLevel;  // level of zstd
+  char   *compressDict;   // path of zstd dictionary, it is loaded once and shared by all rpc instances
+  int8_t  encryption;     // encrypt or not
 
   // the following is for client app ecurity only
   char *user;  // user name
@@ -120,6 +153,13 @@ typedef struct SRpcInit {
 
   RpcNoDelayfp noDelayFp;
 
+  // select compression algorithm for particular msg, compressAlgo is used if not set
+  RpcCompFp compFp;
+
+  // multiplex particular msg over shared conns, identified by seq
+  RpcMuxFp muxFp;
+  int32_t  muxLimit;  // max in-flight msgs on one multiplexed conn
+
   int32_t connLimitNum;
   int32_t connLimitLock;
   int32_t timeToGetConn;
@@ -177,6 +217,8 @@ int32_t rpcUtilSIpRangeToStr(SIpV4Range *pRange, char *buf);
 int32_t rpcUtilSWhiteListToStr(SIpWhiteList *pWhiteList, char **ppBuf);
 int32_t rpcCvtErrCode(int32_t code);
 
+void rpcGetCompStat(SRpcCompStat *pStat);
+
 #ifdef __cplusplus
 }
 #endif
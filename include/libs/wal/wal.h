@@ -73,6 +73,14 @@ typedef struct {
   int64_t logRetention;
 } SWalVer;
 
+typedef struct {
+  int64_t numOfFsyncs;    // files synced by the service
+  int64_t numOfRequests;  // fsync requests of writers
+  int64_t fsyncUs;        // total time spent on fsync
+  int64_t waitUs;         // total time writers wait until their logs are durable
+  int64_t maxWaitUs;
+} SWalGroupCommitStat;
+
 #pragma pack(push, 1)
 // used by sync module
 typedef struct {
@@ -124,6 +132,11 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // group commit, protected by the mutex of the service
+  int64_t syncReqVer;  // the largest version writers wait to be durable
+  int64_t syncedVer;   // all the logs up to this version are durable
+  int32_t syncEpoch;   // changed under both mutexes when logs are rolled back, so older fsyncs do not count
+  int8_t  syncState;   // 0: idle, 1: pending, 2: syncing
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -183,6 +196,7 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
 
 void walFsync(SWal *, bool force);
+void walGetGroupCommitStat(SWalGroupCommitStat *pStat);
 
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
@@ -48,6 +48,10 @@ extern "C" {
 #define ZIGZAG_ENCODE(T, v) (((u##T)((v) >> (sizeof(T) * 8 - 1))) ^ (((u##T)(v)) << 1))  // zigzag encode
 #define ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))                                 // zigzag decode
 
+// the largest zigzag value simple8b is able to encode, and the overflow check of delta encoding
+#define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
+#define safeInt64Add(a, b) (((a >= 0) && (b <= INT64_MAX - a)) || ((a < 0) && (b >= INT64_MIN - a)))
+
 // Compression algorithm
 #define NO_COMPRESSION 0
 #define ONE_STAGE_COMP 1
@@ -152,13 +156,34 @@ int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int
 // for internal usage
 int32_t getWordLength(char type);
 
+// lossless float and double codecs, regardless of the lossy columns
+int32_t tsCompressFloatImp(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressDoubleImp(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output);
+
 int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsDecompressTimestampImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressFloatImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBigintImplAvx512(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBigintImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
                                     bool bigEndian);
 int32_t tsDecompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output, bool bigEndian);
 
+int32_t tsCompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsCompressTimestampImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressIntZigzagAvx512(const char *const input, const int32_t start, const int32_t end, const char type,
+                                  uint64_t *const zigzag);
+int32_t tsCompressIntZigzagAvx2(const char *const input, const int32_t start, const int32_t end, const char type,
+                                uint64_t *const zigzag);
+int32_t tsCompressTimestampZigzagAvx512(const char *const input, const int32_t start, const int32_t end,
+                                        uint64_t *const zigzag);
+int32_t tsCompressTimestampZigzagAvx2(const char *const input, const int32_t start, const int32_t end,
+                                      uint64_t *const zigzag);
+
 /*************************************************************************
  *                  REGULAR COMPRESSION 2
  *************************************************************************/
@@ -202,12 +227,27 @@ int32_t tsDecompressBigint2(void *pIn, int32_t nIn, int32_t nEle, void *pOut, in
 int32_t getWordLength(char type);
 
 int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsDecompressTimestampImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressFloatImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBigintImplAvx512(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBigintImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
                                     bool bigEndian);
 int32_t tsDecompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output, bool bigEndian);
 
+int32_t tsCompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsCompressTimestampImpl_Hw(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressIntZigzagAvx512(const char *const input, const int32_t start, const int32_t end, const char type,
+                                  uint64_t *const zigzag);
+int32_t tsCompressIntZigzagAvx2(const char *const input, const int32_t start, const int32_t end, const char type,
+                                uint64_t *const zigzag);
+int32_t tsCompressTimestampZigzagAvx512(const char *const input, const int32_t start, const int32_t end,
+                                        uint64_t *const zigzag);
+int32_t tsCompressTimestampZigzagAvx2(const char *const input, const int32_t start, const int32_t end,
+                                      uint64_t *const zigzag);
+
 /*************************************************************************
  *                  STREAM COMPRESSION
  *************************************************************************/
@@ -33,14 +33,27 @@ typedef struct SFilePage {
 } SFilePage;
 
 typedef struct SDiskbasedBufStatis {
-  int64_t flushBytes;
+  int64_t flushBytes;     // bytes written to disk, after compression
+  int64_t flushRawBytes;  // bytes of the flushed pages before compression
   int64_t loadBytes;
   int32_t loadPages;
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int32_t compPages;  // number of flushed pages that are stored compressed
 } SDiskbasedBufStatis;
 
+/**
+ * Page codec used when spilling buffer pages to disk. Both functions return the number of bytes produced in dst, or a
+ * value <= 0 if the data can not be (de)compressed into the given capacity.
+ */
+typedef struct SBufPageCodec {
+  const char* name;
+  int32_t (*bound)(int32_t srcSize);
+  int32_t (*compress)(const char* src, int32_t srcSize, char* dst, int32_t dstCap);
+  int32_t (*decompress)(const char* src, int32_t srcSize, char* dst, int32_t dstCap);
+} SBufPageCodec;
+
 /**
  * create disk-based result buffer
  * @param pBuf
@@ -151,6 +164,14 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Replace the codec used to compress pages on disk, LZ4 is used by default. It must be set before any page is flushed.
+ * @param pBuf
+ * @param pCodec  NULL to restore the default LZ4 codec
+ * @return
+ */
+int32_t dBufSetPageCodec(SDiskbasedBuf* pBuf, const SBufPageCodec* pCodec);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
@@ -287,6 +287,20 @@ static bool clientRpcTfp(int32_t code, tmsg_t msgType) {
   return false;
 }
 
+// heartbeat and submit msgs are small and repetitive, they are compressed by the dictionary if it is configured
+static int8_t clientRpcCompFp(tmsg_t msgType) {
+  if (tsCompressMsgDict[0] != 0 && (msgType == TDMT_MND_HEARTBEAT || msgType == TDMT_VND_SUBMIT)) {
+    return RPC_COMP_ZSTD_DICT;
+  }
+  return tsCompressMsgAlgo;
+}
+
+// query and fetch msgs without persisted handle are multiplexed over the conns to the same node
+static bool clientRpcMuxFp(tmsg_t msgType) {
+  return msgType == TDMT_SCH_QUERY || msgType == TDMT_SCH_MERGE_QUERY || msgType == TDMT_SCH_FETCH ||
+         msgType == TDMT_SCH_MERGE_FETCH;
+}
+
 // TODO refactor
 void *openTransporter(const char *user, const char *auth, int32_t numOfThread) {
   SRpcInit rpcInit;
@@ -301,6 +315,11 @@ void *openTransporter(const char *user, const char *auth, int32_t numOfThread) {
   rpcInit.user = (char *)user;
   rpcInit.idleTime = tsShellActivityTimer * 1000;
   rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.compressAlgo = tsCompressMsgAlgo;
+  rpcInit.compressLevel = tsCompressMsgLevel;
+  rpcInit.compressDict = tsCompressMsgDict;
+  rpcInit.compFp = clientRpcCompFp;
+  rpcInit.muxFp = clientRpcMuxFp;
   rpcInit.dfp = destroyAhandle;
 
   rpcInit.retryMinInterval = tsRedirectPeriod;
@@ -2237,7 +2237,7 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
     char* pStart = (char*)pRsp->data + sizeof(int32_t) * 2;
 
     if (pRsp->compressed && compLen < rawLen) {
-      int32_t len = tsDecompressString(pStart, compLen, 1, pResultInfo->decompBuf, rawLen, ONE_STAGE_COMP, NULL, 0);
+      int32_t len = blockDecompress(pRsp->compressed, pStart, compLen, pResultInfo->decompBuf, rawLen);
       ASSERT(len == rawLen);
 
       pResultInfo->pData = pResultInfo->decompBuf;
@@ -16,11 +16,18 @@
 #define _DEFAULT_SOURCE
 #include "tdatablock.h"
 #include "tcompare.h"
+#include "tcompression.h"
+#include "tglobal.h"
 #include "tlog.h"
 #include "tname.h"
+#include "tworker.h"
 
 #define MALLOC_ALIGN_BYTES 32
 
+#define BLOCK_SORT_MAX_THREADS          64
+#define BLOCK_SORT_MIN_ROWS_PER_THREAD  8192
+#define BLOCK_SORT_SAMPLES_PER_THREAD   64
+
 
 
 int32_t colDataGetLength(const SColumnInfoData* pColumnInfoData, int32_t numOfRows) {
@@ -709,6 +716,83 @@ int32_t blockDataMergeNRows(SSDataBlock* pDest, const SSDataBlock* pSrc, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t colDataGatherRows(SColumnInfoData* pDst, const SColumnInfoData* pSrc, const int32_t* index,
+                                 int32_t numOfRows) {
+  if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
+    // the payload is shared by all rows, only the offsets are rearranged
+    int32_t len = pSrc->varmeta.length;
+    if (pDst->varmeta.allocLen < len) {
+      char* tmp = taosMemoryRealloc(pDst->pData, len);
+      if (tmp == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      pDst->pData = tmp;
+      pDst->varmeta.allocLen = len;
+    }
+    if (len > 0) {
+      memcpy(pDst->pData, pSrc->pData, len);
+    }
+    pDst->varmeta.length = len;
+
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      pDst->varmeta.offset[j] = pSrc->varmeta.offset[index[j]];
+    }
+  } else {
+    int32_t bytes = pSrc->info.bytes;
+    memset(pDst->nullbitmap, 0, BitmapLen(numOfRows));
+    if (pSrc->hasNull) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        if (colDataIsNull_f(pSrc->nullbitmap, index[j])) {
+          colDataSetNull_f(pDst->nullbitmap, j);
+        }
+      }
+    }
+
+    if (pSrc->pData != NULL) {
+      switch (bytes) {
+        case sizeof(int64_t):
+          for (int32_t j = 0; j < numOfRows; ++j) ((int64_t*)pDst->pData)[j] = ((int64_t*)pSrc->pData)[index[j]];
+          break;
+        case sizeof(int32_t):
+          for (int32_t j = 0; j < numOfRows; ++j) ((int32_t*)pDst->pData)[j] = ((int32_t*)pSrc->pData)[index[j]];
+          break;
+        default:
+          for (int32_t j = 0; j < numOfRows; ++j) {
+            memcpy(pDst->pData + (int64_t)bytes * j, pSrc->pData + (int64_t)bytes * index[j], bytes);
+          }
+          break;
+      }
+    }
+  }
+
+  pDst->hasNull = pSrc->hasNull;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t blockDataGatherRows(SSDataBlock* pDest, const SSDataBlock* pSrc, const int32_t* index, int32_t numOfRows) {
+  int32_t code = blockDataEnsureCapacity(pDest, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  size_t numOfCols = taosArrayGetSize(pDest->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pDest->pDataBlock, i);
+    SColumnInfoData* pCol = taosArrayGet(pSrc->pDataBlock, i);
+
+    code = colDataGatherRows(pDst, pCol, index, numOfRows);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  pDest->info.rows = numOfRows;
+  pDest->info.id = pSrc->info.id;
+  pDest->info.scanFlag = pSrc->info.scanFlag;
+  pDest->info.dataLoad = pSrc->info.dataLoad;
+  return TSDB_CODE_SUCCESS;
+}
+
 void blockDataShrinkNRows(SSDataBlock* pBlock, int32_t numOfRows) {
   if (numOfRows >= pBlock->info.rows) {
     blockDataCleanup(pBlock);
@@ -1102,8 +1186,10 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock) {
 }
 
 typedef struct SSDataBlockSortHelper {
-  SArray*      orderInfo;  // SArray<SBlockOrderInfo>
-  SSDataBlock* pDataBlock;
+  SArray*         orderInfo;  // SArray<SBlockOrderInfo>
+  SSDataBlock*    pDataBlock;
+  SSortKeyPrefix* pKeys;        // sort key prefix of each row, NULL if not used
+  bool            keyComplete;  // equal prefixes mean equal sort keys
 } SSDataBlockSortHelper;
 
 int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
@@ -1163,31 +1249,215 @@ int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
   return 0;
 }
 
-static int32_t blockDataAssign(SColumnInfoData* pCols, const SSDataBlock* pDataBlock, const int32_t* index) {
-  size_t numOfCols = taosArrayGetSize(pDataBlock->pDataBlock);
-  for (int32_t i = 0; i < numOfCols; ++i) {
-    SColumnInfoData* pDst = &pCols[i];
-    SColumnInfoData* pSrc = taosArrayGet(pDataBlock->pDataBlock, i);
+#define SORT_KEY_PREFIX_BYTES ((int32_t)sizeof(SSortKeyPrefix))
+
+static int32_t sortKeyFixedBytes(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      return 4;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return 8;
+    default:  // float and double are compared with tolerance, json has its own rules, neither can be encoded
+      return 0;
+  }
+}
 
-    if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
-      if (pSrc->varmeta.length != 0) {
-        memcpy(pDst->pData, pSrc->pData, pSrc->varmeta.length);
-      }
-      pDst->varmeta.length = pSrc->varmeta.length;
+static bool sortKeyIsVarType(int8_t type) {
+  return type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_GEOMETRY || type == TSDB_DATA_TYPE_VARBINARY ||
+         type == TSDB_DATA_TYPE_NCHAR;
+}
+
+bool blockDataSortKeyApplicable(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, bool* pComplete) {
+  int32_t len = 0;
+  *pComplete = false;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+
+    int32_t bytes = sortKeyFixedBytes(pCol->info.type);
+    if (bytes == 0) {
+      return i > 0 || sortKeyIsVarType(pCol->info.type);
+    }
+
+    len += 1 + bytes;  // null flag + value
+    if (len > SORT_KEY_PREFIX_BYTES) {
+      return true;
+    }
+  }
+
+  *pComplete = true;
+  return true;
+}
+
+static FORCE_INLINE void sortKeyPutByte(SSortKeyPrefix* pKey, int32_t pos, uint8_t b) {
+  pKey->w[pos >> 3] |= ((uint64_t)b) << (56 - ((pos & 7) << 3));
+}
+
+// Encode the string until the first character that stops the comparison of its comparator, and pad the rest with 0.
+static int32_t sortKeyPutVar(SSortKeyPrefix* pKey, int32_t pos, int8_t type, const char* pData, bool desc) {
+  uint8_t  mask = desc ? 0xFF : 0;
+  int32_t  len = varDataLen(pData);
+  uint8_t* p = (uint8_t*)varDataVal(pData);
 
-      for (int32_t j = 0; j < pDataBlock->info.rows; ++j) {
-        pDst->varmeta.offset[j] = pSrc->varmeta.offset[index[j]];
+  if (type == TSDB_DATA_TYPE_NCHAR) {  // compared as int32 code points, stop at 0
+    for (int32_t i = 0; i + (int32_t)sizeof(TdUcs4) <= len && pos < SORT_KEY_PREFIX_BYTES; i += sizeof(TdUcs4)) {
+      int32_t c = *(int32_t*)(p + i);
+      if (c <= 0) {
+        break;
       }
-    } else {
-      for (int32_t j = 0; j < pDataBlock->info.rows; ++j) {
-        if (colDataIsNull_f(pSrc->nullbitmap, index[j])) {
-          colDataSetNull_f_s(pDst, j);
-          continue;
+      for (int32_t k = 3; k >= 0 && pos < SORT_KEY_PREFIX_BYTES; --k) {
+        sortKeyPutByte(pKey, pos++, ((uint8_t)(c >> (k << 3))) ^ mask);
+      }
+    }
+  } else {  // varbinary is compared by memcmp, others by strncmp which stops at 0
+    bool stopAtZero = (type != TSDB_DATA_TYPE_VARBINARY);
+    for (int32_t i = 0; i < len && pos < SORT_KEY_PREFIX_BYTES; ++i) {
+      if (stopAtZero && p[i] == 0) {
+        break;
+      }
+      sortKeyPutByte(pKey, pos++, p[i] ^ mask);
+    }
+  }
+
+  while (mask != 0 && pos < SORT_KEY_PREFIX_BYTES) {
+    sortKeyPutByte(pKey, pos++, mask);
+  }
+  return pos;
+}
+
+static FORCE_INLINE uint64_t sortKeyGetFixed(const SColumnInfoData* pCol, int32_t row) {
+  const char* p = pCol->pData + (int64_t)row * pCol->info.bytes;
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return (uint8_t)(*(int8_t*)p) ^ 0x80u;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return *(uint8_t*)p;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (uint16_t)(*(int16_t*)p) ^ 0x8000u;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return *(uint16_t*)p;
+    case TSDB_DATA_TYPE_INT:
+      return (uint32_t)(*(int32_t*)p) ^ 0x80000000u;
+    case TSDB_DATA_TYPE_UINT:
+      return *(uint32_t*)p;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return (uint64_t)(*(int64_t*)p) ^ 0x8000000000000000ull;
+    default:
+      return *(uint64_t*)p;
+  }
+}
+
+void blockDataBuildSortKeys(const SSDataBlock* pDataBlock, const SArray* pOrderInfo, int32_t start, int32_t end,
+                            SSortKeyPrefix* pKeys) {
+  int32_t numOfOrders = taosArrayGetSize(pOrderInfo);
+
+  for (int32_t row = start; row < end; ++row) {
+    SSortKeyPrefix* pKey = &pKeys[row];
+    int32_t         pos = 0;
+    pKey->w[0] = 0;
+    pKey->w[1] = 0;
+
+    for (int32_t i = 0; i < numOfOrders && pos < SORT_KEY_PREFIX_BYTES; ++i) {
+      SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+      SColumnInfoData* pCol = taosArrayGet(pDataBlock->pDataBlock, pOrder->slotId);
+
+      int8_t  type = pCol->info.type;
+      int32_t bytes = sortKeyFixedBytes(type);
+      bool    isVar = sortKeyIsVarType(type);
+      if (bytes == 0 && !isVar) {
+        break;
+      }
+
+      // null first or last does not depend on the order
+      bool isNull = colDataIsNull_s(pCol, row);
+      sortKeyPutByte(pKey, pos++, (isNull == pOrder->nullFirst) ? 0 : 1);
+
+      bool desc = (pOrder->order == TSDB_ORDER_DESC);
+      if (isVar) {  // the length of the encoded string is not fixed, so it must be the last one in the prefix
+        if (!isNull) {
+          pos = sortKeyPutVar(pKey, pos, type, colDataGetVarData(pCol, row), desc);
         }
-        memcpy(pDst->pData + j * pDst->info.bytes, pSrc->pData + index[j] * pDst->info.bytes, pDst->info.bytes);
+        break;
+      }
+
+      uint64_t v = isNull ? 0 : sortKeyGetFixed(pCol, row);
+      if (desc && !isNull) {
+        v = ~v;
+      }
+
+      for (int32_t k = bytes - 1; k >= 0 && pos < SORT_KEY_PREFIX_BYTES; --k) {
+        sortKeyPutByte(pKey, pos++, (uint8_t)(v >> (k << 3)));
+      }
+    }
+  }
+}
+
+static int32_t dataBlockComparByKey(const void* p1, const void* p2, const void* param) {
+  const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
+
+  int32_t ret = sortKeyPrefixCompare(&pHelper->pKeys[*(int32_t*)p1], &pHelper->pKeys[*(int32_t*)p2]);
+  if (ret != 0 || pHelper->keyComplete) {
+    return ret;
+  }
+
+  return dataBlockCompar(p1, p2, param);
+}
+
+// Build the sort key prefix of all rows if it helps, and return the comparator to sort the rows.
+static __ext_compar_fn_t prepareSortKeys(SSDataBlockSortHelper* pHelper) {
+  if (!blockDataSortKeyApplicable(pHelper->pDataBlock, pHelper->orderInfo, &pHelper->keyComplete)) {
+    return dataBlockCompar;
+  }
+
+  pHelper->pKeys = taosMemoryMalloc(pHelper->pDataBlock->info.rows * sizeof(SSortKeyPrefix));
+  if (pHelper->pKeys == NULL) {  // sort without the prefix
+    return dataBlockCompar;
+  }
+
+  return dataBlockComparByKey;
+}
+
+static void colDataAssignByIndex(SColumnInfoData* pDst, const SColumnInfoData* pSrc, int32_t rows, const int32_t* index) {
+  if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
+    if (pSrc->varmeta.length != 0) {
+      memcpy(pDst->pData, pSrc->pData, pSrc->varmeta.length);
+    }
+    pDst->varmeta.length = pSrc->varmeta.length;
+
+    for (int32_t j = 0; j < rows; ++j) {
+      pDst->varmeta.offset[j] = pSrc->varmeta.offset[index[j]];
+    }
+  } else {
+    for (int32_t j = 0; j < rows; ++j) {
+      if (colDataIsNull_f(pSrc->nullbitmap, index[j])) {
+        colDataSetNull_f_s(pDst, j);
+        continue;
       }
+      memcpy(pDst->pData + j * pDst->info.bytes, pSrc->pData + index[j] * pDst->info.bytes, pDst->info.bytes);
     }
   }
+}
+
+static int32_t blockDataAssign(SColumnInfoData* pCols, const SSDataBlock* pDataBlock, const int32_t* index) {
+  size_t numOfCols = taosArrayGetSize(pDataBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDst = &pCols[i];
+    SColumnInfoData* pSrc = taosArrayGet(pDataBlock->pDataBlock, i);
+    colDataAssignByIndex(pDst, pSrc, pDataBlock->info.rows, index);
+  }
 
   return TSDB_CODE_SUCCESS;
 }
@@ -1319,9 +1589,18 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     pInfo->compFn = getKeyComparFunc(pInfo->pColData->info.type, pInfo->order);
   }
 
+  __ext_compar_fn_t fn = prepareSortKeys(&helper);
+  if (helper.pKeys != NULL) {
+    blockDataBuildSortKeys(pDataBlock, pOrderInfo, 0, rows, helper.pKeys);
+  }
+
   terrno = 0;
-  taosqsort_r(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
-  if (terrno) return terrno;
+  taosqsort_r(index, rows, sizeof(int32_t), &helper, fn);
+  taosMemoryFreeClear(helper.pKeys);
+  if (terrno) {
+    destroyTupleIndex(index);
+    return terrno;
+  }
 
   int64_t p1 = taosGetTimestampUs();
 
@@ -1349,6 +1628,390 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+typedef struct SBlockSortParallelSup {
+  SSDataBlockSortHelper helper;
+  int32_t               numOfThreads;
+  int32_t               rows;
+  int32_t*              pSplitters;  // row index of the numOfThreads - 1 splitters, in ascending order
+  uint8_t*              pBucket;     // the key range that each row belongs to
+  int32_t*              pCount;      // number of rows of each key range found by each worker
+  int32_t*              pBucketStart;
+  int32_t*              index;
+  SColumnInfoData*      pCols;
+  __ext_compar_fn_t     comparFn;
+} SBlockSortParallelSup;
+
+typedef struct SBlockSortWorker {
+  SBlockSortParallelSup* pSup;
+  int32_t                idx;
+  int32_t                code;
+} SBlockSortWorker;
+
+// the workers of a phase run by the pool, the caller waits until all of them are done. It is referenced by the caller
+// and the tasks in the pool, and freed by the last one of them, since a pool thread still holds the mutex for a while
+// after the caller is woken up.
+typedef struct SBlockSortRun {
+  TdThreadMutex mutex;
+  TdThreadCond  cond;
+  int32_t       numOfPending;
+  int32_t       numOfRef;
+} SBlockSortRun;
+
+typedef struct SBlockSortTask {
+  SBlockSortWorker* pWorker;
+  void* (*fp)(void*);
+  SBlockSortRun* pRun;
+} SBlockSortTask;
+
+// Find the key range of each row in the slice of current worker.
+static void* blockSortClassifyRows(void* param) {
+  SBlockSortWorker*      pWorker = param;
+  SBlockSortParallelSup* pSup = pWorker->pSup;
+
+  int32_t  numOfSplitters = pSup->numOfThreads - 1;
+  int32_t* pCount = pSup->pCount + pWorker->idx * pSup->numOfThreads;
+  int32_t  start = (int64_t)pSup->rows * pWorker->idx / pSup->numOfThreads;
+  int32_t  end = (int64_t)pSup->rows * (pWorker->idx + 1) / pSup->numOfThreads;
+
+  terrno = 0;
+  for (int32_t i = start; i < end; ++i) {
+    int32_t lo = 0, hi = numOfSplitters;
+    while (lo < hi) {
+      int32_t mid = (lo + hi) >> 1;
+      if (pSup->comparFn(&i, &pSup->pSplitters[mid], &pSup->helper) > 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+
+    pSup->pBucket[i] = (uint8_t)lo;
+    pCount[lo] += 1;
+  }
+
+  pWorker->code = terrno;
+  return NULL;
+}
+
+// Move the row index of current slice into the key ranges, the rows of one key range are stored continuously.
+static void* blockSortScatterRows(void* param) {
+  SBlockSortWorker*      pWorker = param;
+  SBlockSortParallelSup* pSup = pWorker->pSup;
+
+  int32_t* pPos = pSup->pCount + pWorker->idx * pSup->numOfThreads;
+  int32_t  start = (int64_t)pSup->rows * pWorker->idx / pSup->numOfThreads;
+  int32_t  end = (int64_t)pSup->rows * (pWorker->idx + 1) / pSup->numOfThreads;
+
+  for (int32_t i = start; i < end; ++i) {
+    pSup->index[pPos[pSup->pBucket[i]]++] = i;
+  }
+
+  return NULL;
+}
+
+static void* blockSortSortBucket(void* param) {
+  SBlockSortWorker*      pWorker = param;
+  SBlockSortParallelSup* pSup = pWorker->pSup;
+
+  int32_t start = pSup->pBucketStart[pWorker->idx];
+  int32_t num = pSup->pBucketStart[pWorker->idx + 1] - start;
+
+  terrno = 0;
+  taosqsort_r(pSup->index + start, num, sizeof(int32_t), &pSup->helper, pSup->comparFn);
+  pWorker->code = terrno;
+  return NULL;
+}
+
+static void* blockSortBuildKeys(void* param) {
+  SBlockSortWorker*      pWorker = param;
+  SBlockSortParallelSup* pSup = pWorker->pSup;
+
+  int32_t start = (int64_t)pSup->rows * pWorker->idx / pSup->numOfThreads;
+  int32_t end = (int64_t)pSup->rows * (pWorker->idx + 1) / pSup->numOfThreads;
+  blockDataBuildSortKeys(pSup->helper.pDataBlock, pSup->helper.orderInfo, start, end, pSup->helper.pKeys);
+  return NULL;
+}
+
+static void* blockSortAssignCols(void* param) {
+  SBlockSortWorker*      pWorker = param;
+  SBlockSortParallelSup* pSup = pWorker->pSup;
+  SSDataBlock*           pDataBlock = pSup->helper.pDataBlock;
+
+  size_t numOfCols = taosArrayGetSize(pDataBlock->pDataBlock);
+  for (int32_t i = pWorker->idx; i < numOfCols; i += pSup->numOfThreads) {
+    SColumnInfoData* pSrc = taosArrayGet(pDataBlock->pDataBlock, i);
+    colDataAssignByIndex(&pSup->pCols[i], pSrc, pSup->rows, pSup->index);
+  }
+
+  return NULL;
+}
+
+static SBlockSortRun* blockSortCreateRun() {
+  SBlockSortRun* pRun = taosMemoryCalloc(1, sizeof(SBlockSortRun));
+  if (pRun == NULL) {
+    return NULL;
+  }
+
+  (void)taosThreadMutexInit(&pRun->mutex, NULL);
+  (void)taosThreadCondInit(&pRun->cond, NULL);
+  pRun->numOfRef = 1;
+  return pRun;
+}
+
+static void blockSortReleaseRun(SBlockSortRun* pRun) {
+  if (atomic_sub_fetch_32(&pRun->numOfRef, 1) == 0) {
+    (void)taosThreadCondDestroy(&pRun->cond);
+    (void)taosThreadMutexDestroy(&pRun->mutex);
+    taosMemoryFree(pRun);
+  }
+}
+
+// The threads of all the parallel sorts are taken from a pool shared by the process, of numOfSortThreads - 1 threads.
+// The pool is created by the first parallel sort, so numOfSortThreads is not dynamic. A task is put into the pool only
+// if an idle thread is reserved for it, so it never waits in the queue behind the tasks of other sorts.
+static SSingleWorker blockSortPool = {0};
+static TdThreadOnce  blockSortPoolOnce = PTHREAD_ONCE_INIT;
+static int32_t       blockSortPoolIdle = 0;
+static int8_t        blockSortPoolStopped = 0;
+
+static void blockSortProcessTask(SQueueInfo* pInfo, void* pItem) {
+  SBlockSortTask* pTask = pItem;
+  SBlockSortRun*  pRun = pTask->pRun;
+
+  (void)pTask->fp(pTask->pWorker);
+  taosFreeQitem(pTask);
+  (void)atomic_add_fetch_32(&blockSortPoolIdle, 1);
+
+  (void)taosThreadMutexLock(&pRun->mutex);
+  if (--pRun->numOfPending == 0) {
+    (void)taosThreadCondSignal(&pRun->cond);
+  }
+  (void)taosThreadMutexUnlock(&pRun->mutex);
+  blockSortReleaseRun(pRun);
+}
+
+static void blockSortInitPool() {
+  int32_t numOfThreads = TMIN(tsNumOfSortThreads, BLOCK_SORT_MAX_THREADS) - 1;
+  if (numOfThreads <= 0 || atomic_load_8(&blockSortPoolStopped)) {
+    return;
+  }
+
+  SSingleWorkerCfg cfg = {.name = "sort", .min = numOfThreads, .max = numOfThreads, .fp = blockSortProcessTask};
+  if (tSingleWorkerInit(&blockSortPool, &cfg) != 0) {
+    uError("failed to init sort worker pool since %s", terrstr());
+    return;
+  }
+
+  atomic_store_32(&blockSortPoolIdle, numOfThreads);
+}
+
+void blockDataSortCleanup() {
+  // no thread is reserved any more, even after the running tasks give their threads back
+  atomic_store_8(&blockSortPoolStopped, 1);
+  atomic_store_32(&blockSortPoolIdle, INT32_MIN / 2);
+  tSingleWorkerCleanup(&blockSortPool);
+}
+
+// returns false if no thread of the pool is idle, then the worker is to be run by the caller
+static bool blockSortPutTask(SBlockSortWorker* pWorker, void* (*fp)(void*), SBlockSortRun* pRun) {
+  while (1) {
+    int32_t idle = atomic_load_32(&blockSortPoolIdle);
+    if (idle <= 0) {
+      return false;
+    }
+    if (atomic_val_compare_exchange_32(&blockSortPoolIdle, idle, idle - 1) == idle) {
+      break;
+    }
+  }
+
+  SBlockSortTask* pTask = taosAllocateQitem(sizeof(SBlockSortTask), DEF_QITEM, 0);
+  if (pTask == NULL) {
+    (void)atomic_add_fetch_32(&blockSortPoolIdle, 1);
+    return false;
+  }
+
+  pTask->pWorker = pWorker;
+  pTask->fp = fp;
+  pTask->pRun = pRun;
+
+  (void)atomic_add_fetch_32(&pRun->numOfRef, 1);
+  (void)taosThreadMutexLock(&pRun->mutex);
+  pRun->numOfPending += 1;
+  (void)taosThreadMutexUnlock(&pRun->mutex);
+
+  if (taosWriteQitem(blockSortPool.queue, pTask) != 0) {
+    (void)taosThreadMutexLock(&pRun->mutex);
+    pRun->numOfPending -= 1;
+    (void)taosThreadMutexUnlock(&pRun->mutex);
+    blockSortReleaseRun(pRun);
+    taosFreeQitem(pTask);
+    (void)atomic_add_fetch_32(&blockSortPoolIdle, 1);
+    return false;
+  }
+
+  return true;
+}
+
+// Run the function by all workers, the first one is executed in the caller thread. The ones that find no idle thread
+// in the pool are executed in the caller thread as well, after the first one.
+static int32_t blockSortRunWorkers(SBlockSortWorker* pWorkers, int32_t numOfWorkers, void* (*fp)(void*)) {
+  bool           inPool[BLOCK_SORT_MAX_THREADS] = {0};
+  SBlockSortRun* pRun = NULL;
+
+  (void)taosThreadOnce(&blockSortPoolOnce, blockSortInitPool);
+  if (numOfWorkers > 1) {
+    pRun = blockSortCreateRun();
+  }
+
+  for (int32_t i = 1; i < numOfWorkers; ++i) {
+    pWorkers[i].code = 0;
+    inPool[i] = (pRun != NULL) && blockSortPutTask(&pWorkers[i], fp, pRun);
+  }
+
+  pWorkers[0].code = 0;
+  (void)fp(&pWorkers[0]);
+
+  for (int32_t i = 1; i < numOfWorkers; ++i) {
+    if (!inPool[i]) {
+      (void)fp(&pWorkers[i]);
+    }
+  }
+
+  if (pRun != NULL) {
+    (void)taosThreadMutexLock(&pRun->mutex);
+    while (pRun->numOfPending > 0) {
+      (void)taosThreadCondWait(&pRun->cond, &pRun->mutex);
+    }
+    (void)taosThreadMutexUnlock(&pRun->mutex);
+    blockSortReleaseRun(pRun);
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    if (pWorkers[i].code != TSDB_CODE_SUCCESS) {
+      code = pWorkers[i].code;
+    }
+  }
+
+  return code;
+}
+
+int32_t blockDataSortParallel(SSDataBlock* pDataBlock, SArray* pOrderInfo, int32_t numOfThreads) {
+  int32_t rows = pDataBlock->info.rows;
+
+  numOfThreads = TMIN(numOfThreads, BLOCK_SORT_MAX_THREADS);
+  numOfThreads = TMIN(numOfThreads, rows / BLOCK_SORT_MIN_ROWS_PER_THREAD);
+  if (numOfThreads <= 1) {
+    return blockDataSort(pDataBlock, pOrderInfo);
+  }
+
+  int64_t p0 = taosGetTimestampUs();
+
+  SBlockSortParallelSup sup = {.helper = {.pDataBlock = pDataBlock, .orderInfo = pOrderInfo},
+                               .numOfThreads = numOfThreads,
+                               .rows = rows};
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pInfo = taosArrayGet(pOrderInfo, i);
+    pInfo->pColData = taosArrayGet(pDataBlock->pDataBlock, pInfo->slotId);
+    pInfo->compFn = getKeyComparFunc(pInfo->pColData->info.type, pInfo->order);
+  }
+
+  int32_t           code = TSDB_CODE_SUCCESS;
+  int32_t           numOfSamples = numOfThreads * BLOCK_SORT_SAMPLES_PER_THREAD;
+  int32_t*          pSamples = taosMemoryMalloc(numOfSamples * sizeof(int32_t));
+  SBlockSortWorker* pWorkers = taosMemoryCalloc(numOfThreads, sizeof(SBlockSortWorker));
+  sup.pSplitters = taosMemoryMalloc(numOfThreads * sizeof(int32_t));
+  sup.pBucket = taosMemoryMalloc(rows);
+  sup.pCount = taosMemoryCalloc(numOfThreads * numOfThreads, sizeof(int32_t));
+  sup.pBucketStart = taosMemoryCalloc(numOfThreads + 1, sizeof(int32_t));
+  sup.index = taosMemoryMalloc(rows * sizeof(int32_t));
+  if (pSamples == NULL || pWorkers == NULL || sup.pSplitters == NULL || sup.pBucket == NULL || sup.pCount == NULL ||
+      sup.pBucketStart == NULL || sup.index == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    pWorkers[i].pSup = &sup;
+    pWorkers[i].idx = i;
+  }
+
+  sup.comparFn = prepareSortKeys(&sup.helper);
+  if (sup.helper.pKeys != NULL) {
+    (void)blockSortRunWorkers(pWorkers, numOfThreads, blockSortBuildKeys);
+  }
+
+  // 1. split the key space into numOfThreads ranges of similar size by the evenly distributed samples
+  for (int32_t i = 0; i < numOfSamples; ++i) {
+    pSamples[i] = (int64_t)rows * i / numOfSamples;
+  }
+
+  terrno = 0;
+  taosqsort_r(pSamples, numOfSamples, sizeof(int32_t), &sup.helper, sup.comparFn);
+  if (terrno != TSDB_CODE_SUCCESS) {
+    code = terrno;
+    goto _end;
+  }
+
+  for (int32_t i = 0; i < numOfThreads - 1; ++i) {
+    sup.pSplitters[i] = pSamples[(i + 1) * BLOCK_SORT_SAMPLES_PER_THREAD];
+  }
+
+  // 2. partition the rows by key range, so that every key range can be sorted independently
+  code = blockSortRunWorkers(pWorkers, numOfThreads, blockSortClassifyRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  int32_t offset = 0;
+  for (int32_t b = 0; b < numOfThreads; ++b) {
+    sup.pBucketStart[b] = offset;
+    for (int32_t w = 0; w < numOfThreads; ++w) {
+      int32_t num = sup.pCount[w * numOfThreads + b];
+      sup.pCount[w * numOfThreads + b] = offset;  // start position of the rows of worker w in key range b
+      offset += num;
+    }
+  }
+  sup.pBucketStart[numOfThreads] = offset;
+
+  (void)blockSortRunWorkers(pWorkers, numOfThreads, blockSortScatterRows);
+
+  // 3. sort each key range, the concatenation of them is the sorted result
+  code = blockSortRunWorkers(pWorkers, numOfThreads, blockSortSortBucket);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  int64_t p1 = taosGetTimestampUs();
+
+  sup.pCols = createHelpColInfoData(pDataBlock);
+  if (sup.pCols == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  (void)blockSortRunWorkers(pWorkers, numOfThreads, blockSortAssignCols);
+  copyBackToBlock(pDataBlock, sup.pCols);
+
+  int64_t p2 = taosGetTimestampUs();
+  uDebug("blockDataSortParallel sort:%" PRId64 ", assign:%" PRId64 ", rows:%d, threads:%d", p1 - p0, p2 - p1, rows,
+         numOfThreads);
+
+_end:
+  taosMemoryFree(pSamples);
+  taosMemoryFree(pWorkers);
+  taosMemoryFree(sup.pSplitters);
+  taosMemoryFree(sup.pBucket);
+  taosMemoryFree(sup.pCount);
+  taosMemoryFree(sup.pBucketStart);
+  taosMemoryFree(sup.helper.pKeys);
+  destroyTupleIndex(sup.index);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+  }
+  return code;
+}
+
 void blockDataCleanup(SSDataBlock* pDataBlock) {
   blockDataEmpty(pDataBlock);
   SDataBlockInfo* pInfo = &pDataBlock->info;
@@ -2691,6 +3354,234 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   return pStart;
 }
 
+// clang-format off
+// columnar compressed data format:
+// +------------------------------------------------+-----------------------------+-----------------------------+-----+-----------+
+// | header of blockEncode, from version to the     | col1 meta seg | col1 data seg | col2 meta seg | col2 data seg | ... | blankFill |
+// | column lengths, copied as it is                |               |               |               |               |     |           |
+// +------------------------------------------------+-----------------------------+-----------------------------+-----+-----------+
+// each segment is | method sizeof(int8_t) | length sizeof(int32_t) | bytes |, and the method tells whether the bytes are
+// compressed by the codec of the column type or copied as they are
+// clang-format on
+#define BLOCK_SEG_RAW      0
+#define BLOCK_SEG_CODEC    1
+#define BLOCK_SEG_HEAD_LEN (sizeof(int8_t) + sizeof(int32_t))
+
+static int32_t blockColumnCompress(int8_t type, const char* pIn, int32_t len, int32_t nEle, char* pOut, int32_t outLen) {
+  switch (type) {
+    case TSDB_DATA_TYPE_FLOAT:
+      return tsCompressFloatImp(pIn, nEle, pOut);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return tsCompressDoubleImp(pIn, nEle, pOut);
+    case TSDB_DATA_TYPE_BOOL:
+      // the values under null are not restricted to true or false
+      type = TSDB_DATA_TYPE_TINYINT;
+      break;
+    default:
+      break;
+  }
+
+  if (tDataTypes[type].compFunc == NULL) {
+    return -1;
+  }
+  return tDataTypes[type].compFunc((void*)pIn, len, nEle, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+}
+
+static int32_t blockColumnDecompress(int8_t type, const char* pIn, int32_t compLen, int32_t nEle, char* pOut,
+                                     int32_t len) {
+  switch (type) {
+    case TSDB_DATA_TYPE_FLOAT:
+      return tsDecompressFloatImp(pIn, nEle, pOut);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return tsDecompressDoubleImp(pIn, nEle, pOut);
+    case TSDB_DATA_TYPE_BOOL:
+      type = TSDB_DATA_TYPE_TINYINT;
+      break;
+    default:
+      break;
+  }
+
+  if (tDataTypes[type].decompFunc == NULL) {
+    return -1;
+  }
+  return tDataTypes[type].decompFunc((void*)pIn, compLen, nEle, pOut, len, ONE_STAGE_COMP, NULL, 0);
+}
+
+// compress one segment of len bytes, the type is the one of the segment values, or -1 to copy them as they are
+static char* blockCompressSegment(int8_t type, const char* pIn, int32_t len, int32_t nEle, char* pOut,
+                                  const char* pEnd) {
+  // the codecs may take one more byte than the input in the worst case
+  if (pOut + BLOCK_SEG_HEAD_LEN + len + COMP_OVERFLOW_BYTES > pEnd) {
+    return NULL;
+  }
+
+  int8_t* method = (int8_t*)pOut;
+  int32_t* segLen = (int32_t*)(pOut + sizeof(int8_t));
+  char*    pData = pOut + BLOCK_SEG_HEAD_LEN;
+
+  int32_t compLen = -1;
+  if (type >= 0 && len > 0) {
+    compLen = blockColumnCompress(type, pIn, len, nEle, pData, len + COMP_OVERFLOW_BYTES);
+  }
+
+  if (compLen > 0 && compLen < len) {
+    *method = BLOCK_SEG_CODEC;
+    *segLen = compLen;
+  } else {
+    *method = BLOCK_SEG_RAW;
+    *segLen = len;
+    memcpy(pData, pIn, len);
+  }
+
+  return pData + *segLen;
+}
+
+static const char* blockDecompressSegment(int8_t type, const char* pIn, const char* pEnd, int32_t len, int32_t nEle,
+                                          char* pOut) {
+  if (pIn + BLOCK_SEG_HEAD_LEN > pEnd) {
+    return NULL;
+  }
+
+  int8_t      method = *(int8_t*)pIn;
+  int32_t     segLen = *(int32_t*)(pIn + sizeof(int8_t));
+  const char* pData = pIn + BLOCK_SEG_HEAD_LEN;
+  if (segLen < 0 || pData + segLen > pEnd) {
+    return NULL;
+  }
+
+  if (method == BLOCK_SEG_RAW) {
+    if (segLen != len) {
+      return NULL;
+    }
+    memcpy(pOut, pData, len);
+  } else if (blockColumnDecompress(type, pData, segLen, nEle, pOut, len) != len) {
+    return NULL;
+  }
+
+  return pData + segLen;
+}
+
+static int32_t blockCompressColumnar(const char* pData, int32_t dataLen, char* pOut, int32_t outLen) {
+  int32_t numOfRows = ((const int32_t*)pData)[2];
+  int32_t numOfCols = ((const int32_t*)pData)[3];
+  int32_t headLen = blockDataGetSerialMetaSize(numOfCols) - sizeof(bool);
+  if (headLen + BLOCK_SEG_HEAD_LEN > outLen) {
+    return -1;
+  }
+
+  const char*    pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* colSizes = (const int32_t*)(pSchema + numOfCols * (sizeof(int8_t) + sizeof(int32_t)));
+  const char*    pStart = pData + headLen;
+  const char*    pEnd = pOut + outLen;
+
+  memcpy(pOut, pData, headLen);
+  char* p = pOut + headLen;
+
+  for (int32_t i = 0; i < numOfCols && p != NULL; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colLen = ntohl(colSizes[i]);
+
+    if (IS_VAR_DATA_TYPE(type)) {
+      // the offsets are mostly ascending, and compressed by delta as integers
+      int32_t metaLen = numOfRows * sizeof(int32_t);
+      p = blockCompressSegment(TSDB_DATA_TYPE_INT, pStart, metaLen, numOfRows, p, pEnd);
+      pStart += metaLen;
+      if (p != NULL) {
+        p = blockCompressSegment(type, pStart, colLen, 1, p, pEnd);
+      }
+    } else {
+      int32_t metaLen = BitmapLen(numOfRows);
+      p = blockCompressSegment(-1, pStart, metaLen, 0, p, pEnd);
+      pStart += metaLen;
+      if (p != NULL) {
+        bool fixed = (tDataTypes[type].bytes > 0 && colLen == numOfRows * tDataTypes[type].bytes);
+        p = blockCompressSegment(fixed ? type : -1, pStart, colLen, numOfRows, p, pEnd);
+      }
+    }
+    pStart += colLen;
+  }
+
+  if (p == NULL || p + sizeof(bool) > pEnd) {
+    return -1;
+  }
+
+  *(bool*)p = *(bool*)pStart;
+  p += sizeof(bool);
+  return p - pOut;
+}
+
+static int32_t blockDecompressColumnar(const char* pInput, int32_t compLen, char* pOut, int32_t rawLen) {
+  if (compLen < blockDataGetSerialMetaSize(0)) {
+    return -1;
+  }
+
+  int32_t numOfRows = ((const int32_t*)pInput)[2];
+  int32_t numOfCols = ((const int32_t*)pInput)[3];
+  int32_t headLen = blockDataGetSerialMetaSize(numOfCols) - sizeof(bool);
+  if (numOfRows < 0 || numOfCols < 0 || headLen > compLen || headLen > rawLen) {
+    return -1;
+  }
+
+  const char*    pSchema = pInput + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* colSizes = (const int32_t*)(pSchema + numOfCols * (sizeof(int8_t) + sizeof(int32_t)));
+  const char*    pEnd = pInput + compLen;
+  char*          pOutEnd = pOut + rawLen;
+
+  memcpy(pOut, pInput, headLen);
+  const char* p = pInput + headLen;
+  char*       pStart = pOut + headLen;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colLen = ntohl(colSizes[i]);
+    bool    isVar = IS_VAR_DATA_TYPE(type);
+    int32_t metaLen = isVar ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+    if (colLen < 0 || pStart + metaLen + colLen > pOutEnd) {
+      return -1;
+    }
+
+    p = blockDecompressSegment(isVar ? TSDB_DATA_TYPE_INT : -1, p, pEnd, metaLen, numOfRows, pStart);
+    if (p == NULL) {
+      return -1;
+    }
+    pStart += metaLen;
+
+    p = blockDecompressSegment(type, p, pEnd, colLen, isVar ? 1 : numOfRows, pStart);
+    if (p == NULL) {
+      return -1;
+    }
+    pStart += colLen;
+  }
+
+  if (p + sizeof(bool) > pEnd || pStart + sizeof(bool) > pOutEnd) {
+    return -1;
+  }
+
+  *(bool*)pStart = *(bool*)p;
+  pStart += sizeof(bool);
+  return pStart - pOut;
+}
+
+int32_t blockCompress(int8_t codec, const char* pData, int32_t dataLen, char* pOut, int32_t outLen) {
+  if (codec == BLOCK_COMPRESS_COLUMNAR) {
+    return blockCompressColumnar(pData, dataLen, pOut, outLen);
+  }
+
+  // the lz4 codec copies the input after a flag byte if it is not reduced
+  if (dataLen + 1 > outLen) {
+    return -1;
+  }
+  return tsCompressString((void*)pData, dataLen, 1, pOut, outLen, ONE_STAGE_COMP, NULL, 0);
+}
+
+int32_t blockDecompress(int8_t codec, const char* pInput, int32_t compLen, char* pOut, int32_t rawLen) {
+  if (codec == BLOCK_COMPRESS_COLUMNAR) {
+    return blockDecompressColumnar(pInput, compLen, pOut, rawLen);
+  }
+
+  return tsDecompressString((void*)pInput, compLen, 1, pOut, rawLen, ONE_STAGE_COMP, NULL, 0);
+}
+
 void trimDataBlock(SSDataBlock* pBlock, int32_t totalRows, const bool* pBoolList) {
   //  int32_t totalRows = pBlock->info.rows;
   int32_t bmLen = BitmapLen(totalRows);
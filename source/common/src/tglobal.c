@@ -72,9 +72,16 @@ int32_t tsNumOfQnodeQueryThreads = 16;
 int32_t tsNumOfQnodeFetchThreads = 1;
 int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
+int32_t tsNumOfSortThreads = 1;         // 1 means the sorts are single threaded, read once by the first parallel sort
 int32_t tsMaxStreamBackendCache = 128;  // M
 int32_t tsPQSortMemThreshold = 16;      // M
-int32_t tsRetentionSpeedLimitMB = 0;    // unlimited
+int32_t tsTsdbColCacheSize = 0;          // M, per vnode, 0 means the decompressed column cache is disabled
+int32_t tsTsdbPrefetchBlocks = 0;        // data blocks read ahead by a tsdb reader, 0 means no prefetch
+int32_t tsTsdbPrefetchSize = 16;         // M, upper limit of the data read ahead by a tsdb reader
+bool    tsTsdbBloomFilter = false;       // build bloom filters on the columns listed in the sma option of the tables
+int32_t tsHashJoinMemThreshold = 1024;   // M, build table size to spill a hash join to disk, 0 means never spill
+int32_t tsQueryOperatorBufSize = 10240;  // K, in-memory pages of the result buffer of an operator
+int32_t tsRetentionSpeedLimitMB = 0;     // unlimited
 
 // sync raft
 int32_t tsElectInterval = 25 * 1000;
@@ -197,6 +204,14 @@ bool    tsMultiResultFunctionStarReturnTags = false;
  */
 int32_t tsCompressMsgSize = -1;
 
+/*
+ * algorithm to compress the message, 1: lz4, 2: zstd. With a zstd dictionary trained from the samples of heartbeat and
+ * submit messages, these small and repetitive messages are compressed by the dictionary regardless of the size.
+ */
+int32_t tsCompressMsgAlgo = 1;
+int32_t tsCompressMsgLevel = 3;
+char    tsCompressMsgDict[PATH_MAX] = {0};
+
 // count/hyperloglog function always return values in case of all NULL data or Empty data set.
 int32_t tsCountAlwaysReturnValue = 1;
 
@@ -263,6 +278,8 @@ bool    tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+bool    tsWalGroupCommit = false;  // if true, the fsync of all vnodes is done by a few service threads in batches
+int32_t tsWalGroupCommitThreads = 4;
 
 // ttl
 bool    tsTtlChangeOnWrite = false;  // if true, ttl delete time changes on last write
@@ -510,6 +527,9 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
     return -1;
   if (cfgAddInt32(pCfg, "compressMsgSize", tsCompressMsgSize, -1, 100000000, CFG_SCOPE_BOTH, CFG_DYN_CLIENT) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "compressMsgAlgo", tsCompressMsgAlgo, 1, 2, CFG_SCOPE_BOTH, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compressMsgLevel", tsCompressMsgLevel, 1, 19, CFG_SCOPE_BOTH, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddString(pCfg, "compressMsgDict", tsCompressMsgDict, CFG_SCOPE_BOTH, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryPolicy", tsQueryPolicy, 1, 4, CFG_SCOPE_CLIENT, CFG_DYN_ENT_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "enableQueryHb", tsEnableQueryHb, CFG_SCOPE_CLIENT, CFG_DYN_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "enableScience", tsEnableScience, CFG_SCOPE_CLIENT, CFG_DYN_NONE) != 0) return -1;
@@ -674,6 +694,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt32(pCfg, "numOfVnodeRsmaThreads", tsNumOfVnodeRsmaThreads, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "numOfQnodeQueryThreads", tsNumOfQnodeQueryThreads, 4, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfSortThreads", tsNumOfSortThreads, 1, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   //  tsNumOfQnodeFetchThreads = tsNumOfCores / 2;
   //  tsNumOfQnodeFetchThreads = TMAX(tsNumOfQnodeFetchThreads, 4);
@@ -747,6 +768,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "timeseriesThreshold", tsTimeSeriesThreshold, 0, 2000, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddBool(pCfg, "walGroupCommit", tsWalGroupCommit, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitThreads", tsWalGroupCommitThreads, 1, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -772,6 +795,12 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "filterScalarMode", tsFilterScalarMode, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxStreamBackendCache", tsMaxStreamBackendCache, 16, 1024, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "pqSortMemThreshold", tsPQSortMemThreshold, 1, 10240, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbColCacheSize", tsTsdbColCacheSize, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbPrefetchBlocks", tsTsdbPrefetchBlocks, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbPrefetchSize", tsTsdbPrefetchSize, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddBool(pCfg, "tsdbBloomFilter", tsTsdbBloomFilter, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
+  if (cfgAddInt32(pCfg, "hashJoinMemThreshold", tsHashJoinMemThreshold, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryOperatorBufSize", tsQueryOperatorBufSize, 16, 4194304, CFG_SCOPE_SERVER, CFG_DYN_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "resolveFQDNRetryTime", tsResolveFQDNRetryTime, 1, 10240, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
 
   if (cfgAddString(pCfg, "s3Accesskey", tsS3AccessKey, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -1059,6 +1088,9 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
+  tsCompressMsgAlgo = cfgGetItem(pCfg, "compressMsgAlgo")->i32;
+  tsCompressMsgLevel = cfgGetItem(pCfg, "compressMsgLevel")->i32;
+  tstrncpy(tsCompressMsgDict, cfgGetItem(pCfg, "compressMsgDict")->str, PATH_MAX);
   tsNumOfTaskQueueThreads = cfgGetItem(pCfg, "numOfTaskQueueThreads")->i32;
   tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
   tsEnableQueryHb = cfgGetItem(pCfg, "enableQueryHb")->bval;
@@ -1137,6 +1169,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
   tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
+  tsNumOfSortThreads = cfgGetItem(pCfg, "numOfSortThreads")->i32;
   //  tsNumOfQnodeFetchThreads = cfgGetItem(pCfg, "numOfQnodeFetchTereads")->i32;
   tsNumOfSnodeStreamThreads = cfgGetItem(pCfg, "numOfSnodeSharedThreads")->i32;
   tsNumOfSnodeWriteThreads = cfgGetItem(pCfg, "numOfSnodeUniqueThreads")->i32;
@@ -1196,6 +1229,8 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTimeSeriesThreshold = cfgGetItem(pCfg, "timeseriesThreshold")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommit = cfgGetItem(pCfg, "walGroupCommit")->bval;
+  tsWalGroupCommitThreads = cfgGetItem(pCfg, "walGroupCommitThreads")->i32;
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
@@ -1237,6 +1272,12 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsFilterScalarMode = cfgGetItem(pCfg, "filterScalarMode")->bval;
   tsMaxStreamBackendCache = cfgGetItem(pCfg, "maxStreamBackendCache")->i32;
   tsPQSortMemThreshold = cfgGetItem(pCfg, "pqSortMemThreshold")->i32;
+  tsTsdbColCacheSize = cfgGetItem(pCfg, "tsdbColCacheSize")->i32;
+  tsTsdbPrefetchBlocks = cfgGetItem(pCfg, "tsdbPrefetchBlocks")->i32;
+  tsTsdbPrefetchSize = cfgGetItem(pCfg, "tsdbPrefetchSize")->i32;
+  tsTsdbBloomFilter = cfgGetItem(pCfg, "tsdbBloomFilter")->bval;
+  tsHashJoinMemThreshold = cfgGetItem(pCfg, "hashJoinMemThreshold")->i32;
+  tsQueryOperatorBufSize = cfgGetItem(pCfg, "queryOperatorBufSize")->i32;
   tsResolveFQDNRetryTime = cfgGetItem(pCfg, "resolveFQDNRetryTime")->i32;
   tsMinDiskFreeSize = cfgGetItem(pCfg, "minDiskFreeSize")->i64;
 
@@ -1560,6 +1601,8 @@ static int32_t taosCfgDynamicOptionsForServer(SConfig *pCfg, const char *name) {
                                          {"minDiskFreeSize", &tsMinDiskFreeSize},
 
                                          {"cacheLazyLoadThreshold", &tsCacheLazyLoadThreshold},
+                                         {"hashJoinMemThreshold", &tsHashJoinMemThreshold},
+                                         {"queryOperatorBufSize", &tsQueryOperatorBufSize},
                                          {"checkpointInterval", &tsStreamCheckpointInterval},
                                          {"keepAliveIdle", &tsKeepAliveIdle},
                                          {"logKeepDays", &tsLogKeepDays},
@@ -7315,6 +7315,7 @@ int32_t tSerializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq) {
   } else {
     if (tEncodeI32(&encoder, 0) < 0) return -1;
   }
+  if (tEncodeI8(&encoder, pReq->compress) < 0) return -1;
 
   tEndEncode(&encoder);
 
@@ -7354,6 +7355,11 @@ int32_t tDeserializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq)
     if (NULL == pReq->pOpParam) return -1;
     if (tDeserializeSOperatorParam(&decoder, pReq->pOpParam) < 0) return -1;
   }
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pReq->compress) < 0) return -1;
+  } else {
+    pReq->compress = BLOCK_COMPRESS_LZ4;
+  }
 
   tEndDecode(&decoder);
 
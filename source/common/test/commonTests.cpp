@@ -10,6 +10,7 @@
 
 #include "taos.h"
 #include "tcommon.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
 #include "tmisce.h"
@@ -408,6 +409,171 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, dataBlock_sort_key_test) {
+  int32_t numOfRows = 10000;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[20] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+
+    int32_t v = (i % 7) - 3;
+    colDataSetVal(p0, i, (const char*)&v, (i % 11) == 0);
+
+    int32_t len = snprintf(varDataVal(buf), sizeof(buf) - VARSTR_HEADER_SIZE, "s%d", (i * 7919) % 1000);
+    varDataSetLen(buf, len);
+    colDataSetVal(p1, i, buf, false);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order = {.nullFirst = false, .order = TSDB_ORDER_DESC, .slotId = 0};
+  taosArrayPush(pOrderInfo, &order);
+  order = {.nullFirst = false, .order = TSDB_ORDER_ASC, .slotId = 1};
+  taosArrayPush(pOrderInfo, &order);
+
+  bool complete = true;
+  ASSERT_TRUE(blockDataSortKeyApplicable(b, pOrderInfo, &complete));
+  ASSERT_FALSE(complete);
+
+  SSortKeyPrefix* pKeys = (SSortKeyPrefix*)taosMemoryCalloc(numOfRows, sizeof(SSortKeyPrefix));
+  blockDataBuildSortKeys(b, pOrderInfo, 0, numOfRows, pKeys);
+
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+
+  // the prefix of sorted rows never decreases, and the rows with the same prefix are ordered by the column values
+  blockDataBuildSortKeys(b, pOrderInfo, 0, numOfRows, pKeys);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 1; i < numOfRows; ++i) {
+    ASSERT_LE(sortKeyPrefixCompare(&pKeys[i - 1], &pKeys[i]), 0);
+
+    bool prevNull = colDataIsNull_s(p0, i - 1);
+    bool curNull = colDataIsNull_s(p0, i);
+    ASSERT_TRUE(!prevNull || curNull);
+    if (prevNull || curNull) {
+      continue;
+    }
+
+    int32_t prev = *(int32_t*)colDataGetData(p0, i - 1);
+    int32_t cur = *(int32_t*)colDataGetData(p0, i);
+    ASSERT_GE(prev, cur);
+    if (prev == cur) {
+      ASSERT_LE(compareLenPrefixedStr(colDataGetData(p1, i - 1), colDataGetData(p1, i)), 0);
+    }
+  }
+
+  taosMemoryFree(pKeys);
+  taosArrayDestroy(pOrderInfo);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, dataBlock_columnar_compress_test) {
+  int32_t numOfRows = 4096;
+
+  SSDataBlock* b = createDataBlock();
+
+  int8_t types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT,    TSDB_DATA_TYPE_DOUBLE,
+                    TSDB_DATA_TYPE_BOOL,      TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_UBIGINT};
+  int32_t numOfCols = sizeof(types) / sizeof(types[0]);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int32_t         bytes = (types[i] == TSDB_DATA_TYPE_BINARY) ? 20 : tDataTypes[types[i]].bytes;
+    SColumnInfoData infoData = createColumnInfoData(types[i], bytes, i + 1);
+    blockDataAppendColInfo(b, &infoData);
+  }
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[20] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t  ts = 1700000000000 + i * 1000;
+    int32_t  v = i / 3;
+    double   d = 20.5 + (i % 10) * 0.1;
+    bool     f = i & 1;
+    uint64_t u = (uint64_t)i * 7919;
+
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&ts, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&v, (i % 5) == 0);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, (const char*)&f, (i % 3) == 0);
+
+    int32_t len = snprintf(varDataVal(buf), sizeof(buf) - VARSTR_HEADER_SIZE, "device-%d", i % 10);
+    varDataSetLen(buf, len);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 4), i, buf, (i % 4) == 0);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 5), i, (const char*)&u, false);
+    b->info.rows++;
+  }
+
+  int32_t size = blockGetEncodeSize(b);
+  char*   pRaw = (char*)taosMemoryCalloc(1, size);
+  char*   pComp = (char*)taosMemoryCalloc(1, size);
+  char*   pBack = (char*)taosMemoryCalloc(1, size);
+
+  int32_t rawLen = blockEncode(b, pRaw, numOfCols);
+  int32_t compLen = blockCompress(BLOCK_COMPRESS_COLUMNAR, pRaw, rawLen, pComp, rawLen);
+  ASSERT_GT(compLen, 0);
+  ASSERT_LT(compLen, rawLen / 2);
+
+  ASSERT_EQ(blockDecompress(BLOCK_COMPRESS_COLUMNAR, pComp, compLen, pBack, rawLen), rawLen);
+  ASSERT_EQ(memcmp(pRaw, pBack, rawLen), 0);
+
+  // a truncated block is rejected instead of being decoded out of bounds
+  ASSERT_EQ(blockDecompress(BLOCK_COMPRESS_COLUMNAR, pComp, compLen / 2, pBack, rawLen), -1);
+
+  taosMemoryFree(pRaw);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pBack);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, fetchReq_compress_test) {
+  SResFetchReq req = {0};
+  req.queryId = 1;
+  req.taskId = 2;
+  req.execId = 3;
+  req.compress = BLOCK_COMPRESS_COLUMNAR;
+
+  int32_t len = tSerializeSResFetchReq(NULL, 0, &req);
+  char*   buf = (char*)taosMemoryCalloc(1, len);
+  ASSERT_EQ(tSerializeSResFetchReq(buf, len, &req), len);
+
+  SResFetchReq out = {0};
+  ASSERT_EQ(tDeserializeSResFetchReq(buf, len, &out), 0);
+  EXPECT_EQ(out.taskId, 2);
+  EXPECT_EQ(out.execId, 3);
+  EXPECT_EQ(out.compress, BLOCK_COMPRESS_COLUMNAR);
+
+  // the fetchers of older versions send no codec, they decode lz4 only
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, (uint8_t*)buf + sizeof(SMsgHead), len - sizeof(SMsgHead));
+  tStartEncode(&encoder);
+  tEncodeU64(&encoder, req.sId);
+  tEncodeU64(&encoder, req.queryId);
+  tEncodeU64(&encoder, req.taskId);
+  tEncodeI32(&encoder, req.execId);
+  tEncodeI32(&encoder, 0);
+  tEndEncode(&encoder);
+  int32_t oldLen = encoder.pos + sizeof(SMsgHead);
+  tEncoderClear(&encoder);
+
+  out = (SResFetchReq){0};
+  ASSERT_EQ(tDeserializeSResFetchReq(buf, oldLen, &out), 0);
+  EXPECT_EQ(out.taskId, 2);
+  EXPECT_EQ(out.compress, BLOCK_COMPRESS_LZ4);
+  taosMemoryFree(buf);
+}
+
 void check_tm(const STm* tm, int32_t y, int32_t mon, int32_t d, int32_t h, int32_t m, int32_t s, int64_t fsec) {
   ASSERT_EQ(tm->tm.tm_year, y);
   ASSERT_EQ(tm->tm.tm_mon, mon);
@@ -184,6 +184,7 @@ void dmCleanup() {
   SDnode *pDnode = dmInstance();
   if (dmCheckRepeatCleanup(pDnode) != 0) return;
   dmCleanupDnode(pDnode);
+  blockDataSortCleanup();
   monCleanup();
   auditCleanup();
   syncCleanUp();
@@ -42,6 +42,17 @@ static void dmGetMonitorDnodeInfo(SDnode *pDnode, SMonDnodeInfo *pInfo) {
   pInfo->logdir.size = tsLogSpace.size;
   tstrncpy(pInfo->tempdir.name, tsTempDir, sizeof(pInfo->tempdir.name));
   pInfo->tempdir.size = tsTempSpace.size;
+
+  SRpcCompStat compStat = {0};
+  rpcGetCompStat(&compStat);
+  pInfo->rpc_comp_msgs = compStat.numOfComp;
+  pInfo->rpc_comp_raw_bytes = compStat.compRawBytes;
+  pInfo->rpc_comp_bytes = compStat.compBytes;
+  pInfo->rpc_comp_us = compStat.compUs;
+  pInfo->rpc_decomp_msgs = compStat.numOfDecomp;
+  pInfo->rpc_decomp_raw_bytes = compStat.decompRawBytes;
+  pInfo->rpc_decomp_bytes = compStat.decompBytes;
+  pInfo->rpc_decomp_us = compStat.decompUs;
 }
 
 static void dmGetDmMonitorInfo(SDnode *pDnode) {
@@ -340,6 +340,20 @@ static bool rpcNoDelayMsg(tmsg_t msgType) {
   }
   return false;
 }
+// heartbeat and submit msgs are small and repetitive, they are compressed by the dictionary if it is configured
+static int8_t rpcCompAlgo(tmsg_t msgType) {
+  if (tsCompressMsgDict[0] != 0 &&
+      (msgType == TDMT_MND_STATUS || msgType == TDMT_MND_HEARTBEAT || msgType == TDMT_SYNC_HEARTBEAT ||
+       msgType == TDMT_SYNC_HEARTBEAT_REPLY || msgType == TDMT_VND_SUBMIT)) {
+    return RPC_COMP_ZSTD_DICT;
+  }
+  return tsCompressMsgAlgo;
+}
+// fetch msgs of exchange fan out to many vnodes, they are multiplexed over the conns to the same dnode
+static bool rpcMuxMsg(tmsg_t msgType) {
+  return msgType == TDMT_SCH_QUERY || msgType == TDMT_SCH_MERGE_QUERY || msgType == TDMT_SCH_FETCH ||
+         msgType == TDMT_SCH_MERGE_FETCH;
+}
 int32_t dmInitClient(SDnode *pDnode) {
   SDnodeTrans *pTrans = &pDnode->trans;
 
@@ -354,6 +368,10 @@ int32_t dmInitClient(SDnode *pDnode) {
   rpcInit.parent = pDnode;
   rpcInit.rfp = rpcRfp;
   rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.compressAlgo = tsCompressMsgAlgo;
+  rpcInit.compressLevel = tsCompressMsgLevel;
+  rpcInit.compressDict = tsCompressMsgDict;
+  rpcInit.compFp = rpcCompAlgo;
   rpcInit.dfp = destroyAhandle;
 
   rpcInit.retryMinInterval = tsRedirectPeriod;
@@ -366,6 +384,7 @@ int32_t dmInitClient(SDnode *pDnode) {
   rpcInit.ffp = dmFailFastFp;
 
   rpcInit.noDelayFp = rpcNoDelayMsg;
+  rpcInit.muxFp = rpcMuxMsg;
 
   int32_t connLimitNum = tsNumOfRpcSessions / (tsNumOfRpcThreads * 3) / 2;
   connLimitNum = TMAX(connLimitNum, 10);
@@ -402,6 +421,10 @@ int32_t dmInitStatusClient(SDnode *pDnode) {
   rpcInit.parent = pDnode;
   rpcInit.rfp = rpcRfp;
   rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.compressAlgo = tsCompressMsgAlgo;
+  rpcInit.compressLevel = tsCompressMsgLevel;
+  rpcInit.compressDict = tsCompressMsgDict;
+  rpcInit.compFp = rpcCompAlgo;
 
   rpcInit.retryMinInterval = tsRedirectPeriod;
   rpcInit.retryStepFactor = tsRedirectFactor;
@@ -447,6 +470,10 @@ int32_t dmInitSyncClient(SDnode *pDnode) {
   rpcInit.parent = pDnode;
   rpcInit.rfp = rpcRfp;
   rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.compressAlgo = tsCompressMsgAlgo;
+  rpcInit.compressLevel = tsCompressMsgLevel;
+  rpcInit.compressDict = tsCompressMsgDict;
+  rpcInit.compFp = rpcCompAlgo;
 
   rpcInit.retryMinInterval = tsRedirectPeriod;
   rpcInit.retryStepFactor = tsRedirectFactor;
@@ -517,6 +544,10 @@ int32_t dmInitServer(SDnode *pDnode) {
   rpcInit.idleTime = tsShellActivityTimer * 1000;
   rpcInit.parent = pDnode;
   rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.compressAlgo = tsCompressMsgAlgo;
+  rpcInit.compressLevel = tsCompressMsgLevel;
+  rpcInit.compressDict = tsCompressMsgDict;
+  rpcInit.compFp = rpcCompAlgo;
   taosVersionStrToInt(version, &(rpcInit.compatibilityVer));
   pTrans->serverRpc = rpcOpen(&rpcInit);
   if (pTrans->serverRpc == NULL) {
@@ -178,6 +178,10 @@ void         tsdbReaderSetCloseFlag(STsdbReader *pReader);
 int64_t      tsdbGetLastTimestamp2(SVnode *pVnode, void *pTableList, int32_t numOfTables, const char *pIdStr);
 void         tsdbSetFilesetDelimited(STsdbReader *pReader);
 void         tsdbReaderSetNotifyCb(STsdbReader *pReader, TsdReaderNotifyCbFn notifyFn, void *param);
+void         tsdbReaderSetFilter(STsdbReader *pReader, const int16_t *colIds, int32_t numOfCols,
+                                 TsdReaderFilterFn filterFn, void *param);
+void         tsdbReaderSetSmaFilter(STsdbReader *pReader, TsdReaderSmaFilterFn filterFn, void *param);
+void         tsdbReaderSetEqualConds(STsdbReader *pReader, SArray *pConds);
 
 int32_t tsdbReuseCacherowsReader(void *pReader, void *pTableIdList, int32_t numOfTables);
 int32_t tsdbCacherowsReaderOpen(void *pVnode, int32_t type, void *pTableIdList, int32_t numOfTables, int32_t numOfCols,
@@ -191,6 +195,7 @@ void    tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t  tsdbCacheGetCapacity(SVnode *pVnode);
 size_t  tsdbCacheGetUsage(SVnode *pVnode);
 int32_t tsdbCacheGetElems(SVnode *pVnode);
+void    tsdbColCacheGetStat(SVnode *pVnode, int64_t *hit, int64_t *miss);
 
 //// tq
 typedef struct SIdInfo {
@@ -251,6 +251,7 @@ int32_t tsdbTbDataIterCreate(STbData *pTbData, STsdbRowKey *pFrom, int8_t backwa
 void *  tsdbTbDataIterDestroy(STbDataIter *pIter);
 void    tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter);
 bool    tsdbTbDataIterNext(STbDataIter *pIter);
+bool    tsdbTbDataIterPickChunk(STbDataIter *pIter);
 void    tsdbMemTableCountRows(SMemTable *pMemTable, SSHashObj *pTableMap, int64_t *rowsNum);
 
 // STbData
@@ -375,6 +376,9 @@ struct STsdb {
   TdThreadMutex        bMutex;
   SLRUCache *          pgCache;
   TdThreadMutex        pgMutex;
+  SLRUCache *          colCache;  // decompressed block columns, NULL if disabled
+  int64_t              colCacheHit;
+  int64_t              colCacheMiss;
   struct STFileSystem *pFS;  // new
   SRocksCache          rCache;
   SCompMonitor         *pCompMonitor;
@@ -390,6 +394,7 @@ struct TSDBKEY {
 };
 
 typedef struct SMemSkipListNode SMemSkipListNode;
+typedef struct SMemAppendChunk  SMemAppendChunk;
 typedef struct SMemSkipList {
   int64_t           size;
   uint32_t          seed;
@@ -408,7 +413,11 @@ struct STbData {
   SDelData *   pHead;
   SDelData *   pTail;
   SMemSkipList sl;
-  STbData *    next;
+  // rows with larger keys than all rows before are appended here, others are put into the skiplist
+  SMemAppendChunk *pChunkHead;
+  SMemAppendChunk *pChunkTail;
+  int64_t          nChunkRow;
+  STbData *        next;
   SRBTreeNode  rbtn[1];
 };
 
@@ -449,6 +458,14 @@ struct SMemSkipListNode {
   SMemSkipListNode *forwards[0];
 };
 
+struct SMemAppendChunk {
+  SMemAppendChunk *pPrev;
+  SMemAppendChunk *pNext;
+  int32_t          capacity;
+  int32_t          nRow;  // published rows, readers load it atomically
+  TSDBROW          aRow[];
+};
+
 struct STsdbRowKey {
   SRowKey key;
   int64_t version;
@@ -553,6 +570,9 @@ struct STbDataIter {
   SMemSkipListNode *pNode;
   TSDBROW *         pRow;
   TSDBROW           row;
+  SMemAppendChunk * pChunk;  // current chunk, NULL if all the appended rows are iterated
+  int32_t           iChunkRow;
+  int8_t            inChunk;  // the current row comes from pChunk
 };
 
 struct SDelData {
@@ -665,6 +685,11 @@ typedef struct {
   int32_t     fid;
   int64_t     cid;
   int64_t     blkno;
+  uint8_t    *pRun;      // consecutive pages written or read by one syscall
+  int64_t     runPgno;   // pgno of the first page in pRun
+  int64_t     runOffset; // file offset of the first page in pRun
+  int32_t     nRunPage;  // pages in pRun
+  int8_t      runDirty;  // pages in pRun are not written yet
 } STsdbFD;
 
 struct SDelFWriter {
@@ -951,6 +976,23 @@ int32_t tsdbCacheGetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, LRUHan
 int32_t tsdbCacheSetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_t *pPage);
 int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+typedef struct {
+  int32_t fid;
+  int32_t cid;       // column id, 0 for the key part of the block
+  int64_t commitId;  // commit id of the data file
+  int64_t offset;    // offset of the block in the data file
+} SColCacheKey;
+
+int32_t    tsdbOpenColCache(STsdb *pTsdb);
+void       tsdbCloseColCache(STsdb *pTsdb);
+int32_t    tsdbColCacheGetKeyPart(STsdb *pTsdb, const SColCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                                  bool *hit);
+int32_t    tsdbColCachePutKeyPart(STsdb *pTsdb, const SColCacheKey *pKey, const SDiskDataHdr *pHdr,
+                                  SBlockData *pBlockData);
+LRUHandle *tsdbColCacheLookup(STsdb *pTsdb, const SColCacheKey *pKey);
+int32_t    tsdbColCacheLoadColData(STsdb *pTsdb, LRUHandle *h, SBlockData *pBlockData);
+int32_t    tsdbColCachePutColData(STsdb *pTsdb, const SColCacheKey *pKey, SColData *pColData);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -985,18 +1027,24 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
     return pIter->pRow;
   }
 
+  bool hasNode;
   if (pIter->backward) {
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return NULL;
-    }
+    hasNode = (pIter->pNode != pIter->pTbData->sl.pHead);
   } else {
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
+    hasNode = (pIter->pNode != pIter->pTbData->sl.pTail);
+  }
+
+  if (pIter->pChunk == NULL) {
+    if (!hasNode) {
       return NULL;
     }
+    pIter->inChunk = 0;
+  } else {
+    pIter->inChunk = hasNode ? tsdbTbDataIterPickChunk(pIter) : 1;
   }
 
   pIter->pRow = &pIter->row;
-  pIter->row = pIter->pNode->row;
+  pIter->row = pIter->inChunk ? pIter->pChunk->aRow[pIter->iChunkRow] : pIter->pNode->row;
 
   return pIter->pRow;
 }
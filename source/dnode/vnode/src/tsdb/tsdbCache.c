@@ -126,6 +126,37 @@ static void tsdbClosePgCache(STsdb *pTsdb) {
   }
 }
 
+int32_t tsdbOpenColCache(STsdb *pTsdb) {
+  if (tsTsdbColCacheSize <= 0) {
+    pTsdb->colCache = NULL;
+    return 0;
+  }
+
+  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsTsdbColCacheSize * 1024 * 1024, 0, .5);
+  if (pCache == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+  pTsdb->colCache = pCache;
+  pTsdb->colCacheHit = 0;
+  pTsdb->colCacheMiss = 0;
+  return 0;
+}
+
+void tsdbCloseColCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->colCache;
+  if (pCache) {
+    tsdbInfo("vgId:%d, col cache elems:%d usage:%" PRId64 " hit:%" PRId64 " miss:%" PRId64, TD_VID(pTsdb->pVnode),
+             taosLRUCacheGetElems(pCache), (int64_t)taosLRUCacheGetUsage(pCache), pTsdb->colCacheHit,
+             pTsdb->colCacheMiss);
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+    pTsdb->colCache = NULL;
+  }
+}
+
 #define ROCKS_KEY_LEN (sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t))
 
 enum {
@@ -1780,6 +1811,12 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenColCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   code = tsdbOpenRocksCache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
     code = TSDB_CODE_OUT_OF_MEMORY;
@@ -1813,6 +1850,7 @@ void tsdbCloseCache(STsdb *pTsdb) {
 #endif
   tsdbCloseBCache(pTsdb);
   tsdbClosePgCache(pTsdb);
+  tsdbCloseColCache(pTsdb);
   tsdbCloseRocksCache(pTsdb);
 }
 
@@ -3587,6 +3625,15 @@ int32_t tsdbCacheGetElems(SVnode *pVnode) {
   return elems;
 }
 
+void tsdbColCacheGetStat(SVnode *pVnode, int64_t *hit, int64_t *miss) {
+  *hit = 0;
+  *miss = 0;
+  if (pVnode->pTsdb != NULL) {
+    *hit = atomic_load_64(&pVnode->pTsdb->colCacheHit);
+    *miss = atomic_load_64(&pVnode->pTsdb->colCacheMiss);
+  }
+}
+
 #if 0
 static void getBICacheKey(int32_t fid, int64_t commitID, char *key, int *len) {
   struct {
@@ -3804,3 +3851,180 @@ int32_t tsdbCacheSetPageS3(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_
 
   return code;
 }
+
+// decompressed block column cache ========================================================================
+typedef struct {
+  SDiskDataHdr hdr;
+  int64_t     *aVersion;
+  TSKEY       *aTSKEY;
+  int32_t      nColData;  // primary key columns
+  SColData     aColData[TD_MAX_PK_COLS];
+} SColCacheKeyPart;
+
+static int32_t tColCacheBitmapSize(const SColData *pColData) {
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return BIT1_SIZE(pColData->nVal);
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      return BIT2_SIZE(pColData->nVal);
+    default:
+      return 0;
+  }
+}
+
+// size of the buffers of a SColData when it is copied into a cache entry
+static int32_t tColCacheColDataSize(const SColData *pColData) {
+  int32_t size = ALIGN_NUM(tColCacheBitmapSize(pColData), 8);
+  if (IS_VAR_DATA_TYPE(pColData->type) && (pColData->flag & HAS_VALUE)) {
+    size += ALIGN_NUM(pColData->nVal << 2, 8);
+  }
+  return size + ALIGN_NUM(pColData->nData, 8);
+}
+
+// bump allocator over the payload of a cache entry
+static void *tColCacheEntryAlloc(void *arg, int32_t size) {
+  uint8_t **ppBuf = (uint8_t **)arg;
+  void     *p = *ppBuf;
+  *ppBuf += ALIGN_NUM(size, 8);
+  return p;
+}
+
+// allocator of the SColData buffers owned by a SBlockData
+static void *tColCacheBlockDataAlloc(void *arg, int32_t size) {
+  (void)arg;
+  uint8_t *p = NULL;
+  if (tRealloc(&p, size) != 0) {
+    return NULL;
+  }
+  return p;
+}
+
+static void deleteColCache(const void *key, size_t keyLen, void *value, void *ud) {
+  (void)ud;
+  taosMemoryFree(value);
+}
+
+static void tsdbColCacheInsert(STsdb *pTsdb, const SColCacheKey *pKey, void *pEntry, size_t charge) {
+  // the entry is owned by the cache from now on, ignore cache updating if not ok
+  (void)taosLRUCacheInsert(pTsdb->colCache, pKey, sizeof(*pKey), pEntry, charge, deleteColCache, NULL,
+                           TAOS_LRU_PRIORITY_LOW, NULL);
+}
+
+static int32_t tsdbColCacheCopyToBlockData(SColData *pColData, SBlockData *pBlockData) {
+  SColData *pTo = NULL;
+  int32_t   code = tBlockDataAddColData(pBlockData, pColData->cid, pColData->type, pColData->cflag, &pTo);
+  if (code) return code;
+
+  code = tColDataCopy(pColData, pTo, tColCacheBlockDataAlloc, NULL);
+  if (code) {
+    pBlockData->nColData--;
+    tColDataDestroy(pTo);
+  }
+  return code;
+}
+
+LRUHandle *tsdbColCacheLookup(STsdb *pTsdb, const SColCacheKey *pKey) {
+  LRUHandle *h = taosLRUCacheLookup(pTsdb->colCache, pKey, sizeof(*pKey));
+  if (h) {
+    atomic_add_fetch_64(&pTsdb->colCacheHit, 1);
+  } else {
+    atomic_add_fetch_64(&pTsdb->colCacheMiss, 1);
+  }
+  return h;
+}
+
+int32_t tsdbColCacheGetKeyPart(STsdb *pTsdb, const SColCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                               bool *hit) {
+  int32_t code = 0;
+
+  *hit = false;
+  LRUHandle *h = tsdbColCacheLookup(pTsdb, pKey);
+  if (h == NULL) {
+    return code;
+  }
+
+  SColCacheKeyPart *pKeyPart = taosLRUCacheValue(pTsdb->colCache, h);
+  int32_t           nRow = pKeyPart->hdr.nRow;
+
+  tBlockDataReset(pBlockData);
+  pBlockData->suid = pKeyPart->hdr.suid;
+  pBlockData->uid = pKeyPart->hdr.uid;
+  pBlockData->nRow = nRow;
+
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, sizeof(int64_t) * nRow);
+  if (code) goto _exit;
+  memcpy(pBlockData->aVersion, pKeyPart->aVersion, sizeof(int64_t) * nRow);
+
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, sizeof(TSKEY) * nRow);
+  if (code) goto _exit;
+  memcpy(pBlockData->aTSKEY, pKeyPart->aTSKEY, sizeof(TSKEY) * nRow);
+
+  for (int32_t i = 0; i < pKeyPart->nColData; ++i) {
+    code = tsdbColCacheCopyToBlockData(&pKeyPart->aColData[i], pBlockData);
+    if (code) goto _exit;
+  }
+
+  *pHdr = pKeyPart->hdr;
+  *hit = true;
+
+_exit:
+  tsdbCacheRelease(pTsdb->colCache, h);
+  return code;
+}
+
+int32_t tsdbColCachePutKeyPart(STsdb *pTsdb, const SColCacheKey *pKey, const SDiskDataHdr *pHdr,
+                               SBlockData *pBlockData) {
+  // uids only exist in the blocks of stt files
+  if (pHdr->szUid > 0 || pBlockData->nColData > TD_MAX_PK_COLS) {
+    return 0;
+  }
+
+  int32_t nRow = pBlockData->nRow;
+  size_t  charge = sizeof(SColCacheKeyPart) + (sizeof(int64_t) + sizeof(TSKEY)) * nRow;
+  for (int32_t i = 0; i < pBlockData->nColData; ++i) {
+    charge += tColCacheColDataSize(&pBlockData->aColData[i]);
+  }
+
+  SColCacheKeyPart *pKeyPart = taosMemoryMalloc(charge);
+  if (pKeyPart == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint8_t *pBuf = (uint8_t *)(pKeyPart + 1);
+  pKeyPart->hdr = *pHdr;
+  pKeyPart->aVersion = tColCacheEntryAlloc(&pBuf, sizeof(int64_t) * nRow);
+  memcpy(pKeyPart->aVersion, pBlockData->aVersion, sizeof(int64_t) * nRow);
+  pKeyPart->aTSKEY = tColCacheEntryAlloc(&pBuf, sizeof(TSKEY) * nRow);
+  memcpy(pKeyPart->aTSKEY, pBlockData->aTSKEY, sizeof(TSKEY) * nRow);
+  pKeyPart->nColData = pBlockData->nColData;
+  for (int32_t i = 0; i < pBlockData->nColData; ++i) {
+    (void)tColDataCopy(&pBlockData->aColData[i], &pKeyPart->aColData[i], tColCacheEntryAlloc, &pBuf);
+  }
+
+  tsdbColCacheInsert(pTsdb, pKey, pKeyPart, charge);
+  return 0;
+}
+
+int32_t tsdbColCacheLoadColData(STsdb *pTsdb, LRUHandle *h, SBlockData *pBlockData) {
+  SColData *pColData = taosLRUCacheValue(pTsdb->colCache, h);
+  int32_t   code = tsdbColCacheCopyToBlockData(pColData, pBlockData);
+
+  tsdbCacheRelease(pTsdb->colCache, h);
+  return code;
+}
+
+int32_t tsdbColCachePutColData(STsdb *pTsdb, const SColCacheKey *pKey, SColData *pColData) {
+  size_t    charge = sizeof(SColData) + tColCacheColDataSize(pColData);
+  SColData *pEntry = taosMemoryMalloc(charge);
+  if (pEntry == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint8_t *pBuf = (uint8_t *)(pEntry + 1);
+  (void)tColDataCopy(pColData, pEntry, tColCacheEntryAlloc, &pBuf);
+
+  tsdbColCacheInsert(pTsdb, pKey, pEntry, charge);
+  return 0;
+}
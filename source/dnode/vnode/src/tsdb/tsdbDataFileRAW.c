@@ -135,7 +135,8 @@ static int32_t tsdbDataFileRAWWriterCloseCommit(SDataFileRAWWriter *writer, TFil
   if (writer->fd) {
     code = tsdbFsyncFile(writer->fd, encryptAlgorithm, encryptKey);
     TSDB_CHECK_CODE(code, lino, _exit);
-    tsdbCloseFile(&writer->fd);
+    code = tsdbCloseFile(&writer->fd);
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
 _exit:
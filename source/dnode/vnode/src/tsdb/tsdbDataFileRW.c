@@ -15,6 +15,22 @@
 
 #include "tsdbDataFileRW.h"
 #include "meta.h"
+#include "tbloomfilter.h"
+
+// bloom filters of the columns listed in the SMA option of the table (COL_BLOOM_ON) are stored right after the SMA
+// records of a block, and located by an extra SMA record of this column id whose sum is the size of the filters. No
+// column has this id, so the record is ignored by the readers unaware of the filters.
+#define TSDB_BLOCK_BLOOM_CID 0
+#define TSDB_BLOCK_BLOOM_FPP 0.01
+#define TSDB_BLOCK_BLOOM_TYPE(type) \
+  (IS_INTEGER_TYPE(type) || (type) == TSDB_DATA_TYPE_TIMESTAMP || (type) == TSDB_DATA_TYPE_VARCHAR)
+
+// the default hash functions of the bloom filter mix short keys such as integers poorly
+static FORCE_INLINE void tsdbBlockBloomHash(const void *key, uint32_t len, uint64_t *h1, uint64_t *h2) {
+  uint64_t h = MurmurHash3_64(key, len);
+  *h1 = h & 0xFFFFFFFF;
+  *h2 = h >> 32;
+}
 
 // SDataFileReader =============================================
 struct SDataFileReader {
@@ -324,8 +340,10 @@ _exit:
   return code;
 }
 
-int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
-                                          STSchema *pTSchema, int16_t cids[], int32_t ncid) {
+// keyLoaded: bData already holds the key part and some columns of the record, only the missing columns are loaded
+static int32_t tsdbDataFileReadBlockDataByColumnImpl(SDataFileReader *reader, const SBrinRecord *record,
+                                                     SBlockData *bData, STSchema *pTSchema, int16_t cids[],
+                                                     int32_t ncid, bool keyLoaded) {
   int32_t code = 0;
   int32_t lino = 0;
 
@@ -333,31 +351,67 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
   SBuffer     *buffer0 = reader->buffers + 0;
   SBuffer     *buffer1 = reader->buffers + 1;
   SBuffer     *assist = reader->buffers + 2;
+  STsdb       *tsdb = reader->config->tsdb;
+  LRUHandle  **aHandle = NULL;
+
+  // decompressed columns of the block may be served by the column cache of the vnode, the blocks of a data file
+  // never change once written, so (fid, commit id, block offset, cid) identifies a column
+  bool         useCache = (tsdb->colCache != NULL && reader->config->files[TSDB_FTYPE_DATA].exist);
+  bool         keyHit = false;
+  SColCacheKey cacheKey = {0};
+  if (useCache) {
+    cacheKey.fid = reader->config->files[TSDB_FTYPE_DATA].file.fid;
+    cacheKey.commitId = reader->config->files[TSDB_FTYPE_DATA].file.cid;
+    cacheKey.offset = record->blockOffset;
+  }
+  if (useCache && !keyLoaded) {
+    code = tsdbColCacheGetKeyPart(tsdb, &cacheKey, &hdr, bData, &keyHit);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
   int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
   char* encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
-  // load key part
-  tBufferClear(buffer0);
-  code = tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockKeySize, buffer0, 0,
-                              encryptAlgorithm, encryptKey);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  SBufferReader br;
+  if (keyLoaded) {
+    // only the header of the key part is needed to locate the columns
+    tBufferClear(buffer0);
+    code = tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockKeySize, buffer0, 0,
+                                encryptAlgorithm, encryptKey);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
-  // SDiskDataHdr
-  SBufferReader br = BUFFER_READER_INITIALIZER(0, buffer0);
-  code = tGetDiskDataHdr(&br, &hdr);
-  TSDB_CHECK_CODE(code, lino, _exit);
+    br = BUFFER_READER_INITIALIZER(0, buffer0);
+    code = tGetDiskDataHdr(&br, &hdr);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    ASSERT(hdr.delimiter == TSDB_FILE_DLMT && hdr.uid == bData->uid && hdr.nRow == bData->nRow);
+  } else if (!keyHit) {
+    // load key part
+    tBufferClear(buffer0);
+    code = tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockKeySize, buffer0, 0,
+                                encryptAlgorithm, encryptKey);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
-  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
+    // SDiskDataHdr
+    br = BUFFER_READER_INITIALIZER(0, buffer0);
+    code = tGetDiskDataHdr(&br, &hdr);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
-  tBlockDataReset(bData);
-  bData->suid = hdr.suid;
-  bData->uid = hdr.uid;
-  bData->nRow = hdr.nRow;
+    ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
 
-  // Key part
-  code = tBlockDataDecompressKeyPart(&hdr, &br, bData, assist);
-  TSDB_CHECK_CODE(code, lino, _exit);
-  ASSERT(br.offset == buffer0->size);
+    tBlockDataReset(bData);
+    bData->suid = hdr.suid;
+    bData->uid = hdr.uid;
+    bData->nRow = hdr.nRow;
+
+    // Key part
+    code = tBlockDataDecompressKeyPart(&hdr, &br, bData, assist);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    ASSERT(br.offset == buffer0->size);
+
+    if (useCache) {
+      (void)tsdbColCachePutKeyPart(tsdb, &cacheKey, &hdr, bData);
+    }
+  }
 
   int extraColIdx = -1;
   for (int i = 0; i < ncid; i++) {
@@ -370,7 +424,36 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
   if (extraColIdx < 0) {
     goto _exit;
   }
-  
+
+  if (useCache) {
+    aHandle = taosMemoryCalloc(ncid, POINTER_BYTES);
+    if (aHandle == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    int32_t nMiss = 0;
+    for (int32_t i = extraColIdx; i < ncid; ++i) {
+      if (tBlockDataGetColData(bData, cids[i]) == NULL) {
+        cacheKey.cid = cids[i];
+        aHandle[i] = tsdbColCacheLookup(tsdb, &cacheKey);
+        if (aHandle[i] == NULL) ++nMiss;
+      }
+    }
+
+    // all the columns are cached, no need to touch the file
+    if (nMiss == 0) {
+      for (int32_t i = extraColIdx; i < ncid; ++i) {
+        if (aHandle[i]) {
+          code = tsdbColCacheLoadColData(tsdb, aHandle[i], bData);
+          aHandle[i] = NULL;
+          TSDB_CHECK_CODE(code, lino, _exit);
+        }
+      }
+      goto _exit;
+    }
+  }
+
   // load SBlockCol part
   tBufferClear(buffer0);
   code = tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset + record->blockKeySize, hdr.szBlkCol,
@@ -457,6 +540,13 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       continue;
     }
 
+    if (aHandle && aHandle[i]) {  // cached
+      code = tsdbColCacheLoadColData(tsdb, aHandle[i], bData);
+      aHandle[i] = NULL;
+      TSDB_CHECK_CODE(code, lino, _exit);
+      continue;
+    }
+
     while (cid > blockCol.cid) {
       if (br.offset >= buffer0->size) {
         blockCol.cid = INT16_MAX;
@@ -500,9 +590,48 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       SBufferReader br1 = BUFFER_READER_INITIALIZER(0, buffer1);
       code = tBlockDataDecompressColData(&hdr, &blockCol, &br1, bData, assist);
       TSDB_CHECK_CODE(code, lino, _exit);
+    } else {
+      continue;
+    }
+
+    if (useCache) {
+      cacheKey.cid = cid;
+      (void)tsdbColCachePutColData(tsdb, &cacheKey, tBlockDataGetColData(bData, cid));
     }
   }
 
+_exit:
+  if (aHandle) {
+    for (int32_t i = 0; i < ncid; ++i) {
+      if (aHandle[i]) tsdbCacheRelease(tsdb->colCache, aHandle[i]);
+    }
+    taosMemoryFree(aHandle);
+  }
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(reader->config->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
+                                          STSchema *pTSchema, int16_t cids[], int32_t ncid) {
+  return tsdbDataFileReadBlockDataByColumnImpl(reader, record, bData, pTSchema, cids, ncid, false);
+}
+
+int32_t tsdbDataFileReadBlockDataMoreColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
+                                            STSchema *pTSchema, int16_t cids[], int32_t ncid) {
+  return tsdbDataFileReadBlockDataByColumnImpl(reader, record, bData, pTSchema, cids, ncid, true);
+}
+
+int32_t tsdbDataFileReadAheadBlockData(SDataFileReader *reader, const SBrinRecord *record) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (reader->fd[TSDB_FTYPE_DATA] == NULL) return code;
+
+  code = tsdbReadAheadFile(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockSize);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
 _exit:
   if (code) {
     TSDB_ERROR_LOG(TD_VID(reader->config->tsdb->pVnode), lino, code);
@@ -511,12 +640,17 @@ _exit:
 }
 
 int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *record,
-                                 TColumnDataAggArray *columnDataAggArray) {
+                                 TColumnDataAggArray *columnDataAggArray, int64_t *bloomSize) {
   int32_t  code = 0;
   int32_t  lino = 0;
   SBuffer *buffer = reader->buffers + 0;
 
-  TARRAY2_CLEAR(columnDataAggArray, NULL);
+  if (columnDataAggArray) {
+    TARRAY2_CLEAR(columnDataAggArray, NULL);
+  }
+  if (bloomSize) {
+    *bloomSize = 0;
+  }
   if (record->smaSize > 0) {
     tBufferClear(buffer);
     int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
@@ -533,8 +667,17 @@ int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *rec
       code = tGetColumnDataAgg(&br, sma);
       TSDB_CHECK_CODE(code, lino, _exit);
 
-      code = TARRAY2_APPEND_PTR(columnDataAggArray, sma);
-      TSDB_CHECK_CODE(code, lino, _exit);
+      if (sma->colId == TSDB_BLOCK_BLOOM_CID) {
+        if (bloomSize) {
+          *bloomSize = sma->sum;
+        }
+        continue;
+      }
+
+      if (columnDataAggArray) {
+        code = TARRAY2_APPEND_PTR(columnDataAggArray, sma);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
     }
     ASSERT(br.offset == record->smaSize);
   }
@@ -546,6 +689,85 @@ _exit:
   return code;
 }
 
+int32_t tsdbDataFileReadBlockBloom(SDataFileReader *reader, const SBrinRecord *record, int64_t bloomSize,
+                                   SBuffer *buffer) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  tBufferClear(buffer);
+  if (bloomSize > 0) {
+    int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+    char   *encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+    code = tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_SMA], record->smaOffset + record->smaSize, bloomSize, buffer, 0,
+                                encryptAlgorithm, encryptKey);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(reader->config->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+int32_t tsdbBlockBloomMayContain(const SBuffer *bloom, int16_t cid, int8_t type, const SValue *aValue, int32_t nValue,
+                                 bool *mayContain) {
+  int32_t       code = 0;
+  SBufferReader br = BUFFER_READER_INITIALIZER(0, (SBuffer *)bloom);
+
+  *mayContain = true;
+  while (br.offset < bloom->size) {
+    int16_t  colId;
+    uint32_t hashFunctions;
+    uint64_t numUnits;
+
+    if ((code = tBufferGetI16v(&br, &colId))) return code;
+    if ((code = tBufferGetU32v(&br, &hashFunctions))) return code;
+    if ((code = tBufferGetU64v(&br, &numUnits))) return code;
+    if (numUnits == 0 || br.offset + numUnits * sizeof(uint64_t) > bloom->size) {
+      return TSDB_CODE_FILE_CORRUPTED;
+    }
+
+    if (colId != cid) {
+      br.offset += numUnits * sizeof(uint64_t);
+      continue;
+    }
+
+    // the same probing as tBloomFilterNoContain, the units are read in place
+    const uint8_t *units = (const uint8_t *)BR_PTR(&br);
+    uint64_t       numBits = numUnits * 64;
+    for (int32_t i = 0; i < nValue; ++i) {
+      const void *key = IS_VAR_DATA_TYPE(type) ? (const void *)aValue[i].pData : (const void *)&aValue[i].val;
+      uint32_t    len = IS_VAR_DATA_TYPE(type) ? aValue[i].nData : tDataTypes[type].bytes;
+      uint64_t    h1, h2;
+      bool        found = true;
+
+      tsdbBlockBloomHash(key, len, &h1, &h2);
+      uint64_t cbHash = h1;
+
+      for (uint32_t j = 0; j < hashFunctions; ++j) {
+        uint64_t bit = cbHash % numBits;
+        uint64_t unit;
+        memcpy(&unit, units + (bit >> 6) * sizeof(uint64_t), sizeof(unit));
+        if ((unit & (1ULL << (bit & 63))) == 0) {
+          found = false;
+          break;
+        }
+        cbHash += h2;
+      }
+
+      if (found) {
+        return code;
+      }
+    }
+
+    *mayContain = false;
+    return code;
+  }
+
+  return code;
+}
+
 int32_t tsdbDataFileReadTombBlk(SDataFileReader *reader, const TTombBlkArray **tombBlkArray) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -988,6 +1210,70 @@ _exit:
   return code;
 }
 
+// a bloom filter of the values of the column, as [cid, hash functions, units, bits of the units], sized by the number
+// of distinct values: a block of a few repeated values only takes a few bytes
+static int32_t tsdbDataFilePutBlockBloom(SDataFileWriter *writer, SColData *colData, SBuffer *buffer) {
+  int32_t       code = 0;
+  int32_t       lino = 0;
+  SBloomFilter *pBF = NULL;
+  int32_t       nHash = 0;
+  uint64_t     *aHash = taosMemoryMalloc(sizeof(uint64_t) * colData->nVal);
+  if (aHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t iVal = 0; iVal < colData->nVal; ++iVal) {
+    SColVal cv;
+    tColDataGetValue(colData, iVal, &cv);
+    if (!COL_VAL_IS_VALUE(&cv)) continue;
+
+    if (IS_VAR_DATA_TYPE(colData->type)) {
+      aHash[nHash++] = MurmurHash3_64((const char *)cv.value.pData, cv.value.nData);
+    } else {
+      aHash[nHash++] = MurmurHash3_64((const char *)&cv.value.val, tDataTypes[colData->type].bytes);
+    }
+  }
+
+  int32_t nDistinct = 0;
+  if (nHash > 0) {
+    taosSort(aHash, nHash, sizeof(uint64_t), compareUint64Val);
+    for (int32_t i = 0; i < nHash; ++i) {
+      if (i == 0 || aHash[i] != aHash[nDistinct - 1]) {
+        aHash[nDistinct++] = aHash[i];
+      }
+    }
+  }
+
+  pBF = tBloomFilterInit(TMAX(nDistinct, 1), TSDB_BLOCK_BLOOM_FPP);
+  if (pBF == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // split as tsdbBlockBloomHash does
+  for (int32_t i = 0; i < nDistinct; ++i) {
+    tBloomFilterPutHash(pBF, aHash[i] & 0xFFFFFFFF, aHash[i] >> 32);
+  }
+
+  code = tBufferPutI16v(buffer, colData->cid);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  code = tBufferPutU32v(buffer, pBF->hashFunctions);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  code = tBufferPutU64v(buffer, pBF->numUnits);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  code = tBufferPut(buffer, pBF->buffer, pBF->numUnits * sizeof(uint64_t));
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(writer->config->tsdb->pVnode), lino, code);
+  }
+  tBloomFilterDestroy(pBF);
+  taosMemoryFree(aHash);
+  return code;
+}
+
 static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData *bData) {
   if (bData->nRow == 0) return 0;
 
@@ -1061,6 +1347,25 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
     code = tPutColumnDataAgg(&buffers[0], sma);
     TSDB_CHECK_CODE(code, lino, _exit);
   }
+
+  tBufferClear(&buffers[1]);
+  if (tsTsdbBloomFilter && buffers[0].size > 0) {
+    for (int32_t i = 0; i < bData->nColData; ++i) {
+      SColData *colData = bData->aColData + i;
+      if ((colData->cflag & COL_BLOOM_ON) == 0 || ((colData->flag & HAS_VALUE) == 0)) continue;
+      if (!TSDB_BLOCK_BLOOM_TYPE(colData->type)) continue;
+
+      code = tsdbDataFilePutBlockBloom(writer, colData, &buffers[1]);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    if (buffers[1].size > 0) {
+      SColumnDataAgg sma[1] = {{.colId = TSDB_BLOCK_BLOOM_CID, .sum = buffers[1].size}};
+
+      code = tPutColumnDataAgg(&buffers[0], sma);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
   record->smaSize = buffers[0].size;
 
   if (record->smaSize > 0) {
@@ -1070,6 +1375,13 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
     writer->files[TSDB_FTYPE_SMA].size += record->smaSize;
   }
 
+  if (buffers[1].size > 0) {
+    code = tsdbWriteFile(writer->fd[TSDB_FTYPE_SMA], writer->files[TSDB_FTYPE_SMA].size, buffers[1].data,
+                         buffers[1].size, encryptAlgorithm, encryptKey);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    writer->files[TSDB_FTYPE_SMA].size += buffers[1].size;
+  }
+
   // append SBrinRecord
   code = tsdbDataFileWriteBrinRecord(writer, record);
   TSDB_CHECK_CODE(code, lino, _exit);
@@ -1767,7 +2079,8 @@ static int32_t tsdbDataFileWriterCloseCommit(SDataFileWriter *writer, TFileOpArr
     if (writer->fd[i]) {
       code = tsdbFsyncFile(writer->fd[i], encryptAlgorithm, encryptKey);
       TSDB_CHECK_CODE(code, lino, _exit);
-      tsdbCloseFile(&writer->fd[i]);
+      code = tsdbCloseFile(&writer->fd[i]);
+      TSDB_CHECK_CODE(code, lino, _exit);
     }
   }
 
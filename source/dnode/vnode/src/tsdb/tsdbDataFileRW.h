@@ -59,9 +59,20 @@ int32_t tsdbDataFileReadBrinBlock(SDataFileReader *reader, const SBrinBlk *brinB
 int32_t tsdbDataFileReadBlockData(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData);
 int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid);
-// .sma
+// load the columns of cids that are not in bData yet, bData must hold the key part loaded from the same record
+int32_t tsdbDataFileReadBlockDataMoreColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
+                                            STSchema *pTSchema, int16_t cids[], int32_t ncid);
+int32_t tsdbDataFileReadAheadBlockData(SDataFileReader *reader, const SBrinRecord *record);
+// .sma, the size of the bloom filters of the block is returned in bloomSize if not NULL
 int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *record,
-                                 TColumnDataAggArray *columnDataAggArray);
+                                 TColumnDataAggArray *columnDataAggArray, int64_t *bloomSize);
+// the bloom filters of the block of the size got with its SMA, buffer is left empty if the block has none
+int32_t tsdbDataFileReadBlockBloom(SDataFileReader *reader, const SBrinRecord *record, int64_t bloomSize,
+                                   SBuffer *buffer);
+// *mayContain is set to false if the bloom filter of column cid holds none of the values, a column without a bloom
+// filter may contain any value
+int32_t tsdbBlockBloomMayContain(const SBuffer *bloom, int16_t cid, int8_t type, const SValue *aValue, int32_t nValue,
+                                 bool *mayContain);
 // .tomb
 int32_t tsdbDataFileReadTombBlk(SDataFileReader *reader, const TTombBlkArray **tombBlkArray);
 int32_t tsdbDataFileReadTombBlock(SDataFileReader *reader, const STombBlk *tombBlk, STombBlock *tData);
@@ -32,7 +32,7 @@ typedef struct SFDataPtr {
 } SFDataPtr;
 
 extern int32_t tsdbOpenFile(const char *path, STsdb *pTsdb, int32_t flag, STsdbFD **ppFD, int32_t lcn);
-extern void    tsdbCloseFile(STsdbFD **ppFD);
+extern int32_t tsdbCloseFile(STsdbFD **ppFD);
 
 extern int32_t tsdbWriteFile(STsdbFD *pFD, int64_t offset, const uint8_t *pBuf, int64_t size, 
                             int32_t encryptAlgorithm, char* encryptKey);
@@ -40,6 +40,7 @@ extern int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t
                             int32_t encryptAlgorithm, char* encryptKey);
 extern int32_t tsdbReadFileToBuffer(STsdbFD *pFD, int64_t offset, int64_t size, SBuffer *buffer, int64_t szHint,
                                     int32_t encryptAlgorithm, char* encryptKey);
+extern int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size);
 extern int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char* encryptKey);
 
 typedef struct SColCompressInfo SColCompressInfo;
@@ -31,7 +31,11 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+#define MEM_CHUNK_MIN_ROWS 64
+#define MEM_CHUNK_MAX_ROWS 4096
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, STsdbRowKey *pKey, int32_t flags);
+static void    tbDataChunkSeek(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
@@ -241,6 +245,8 @@ void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, S
   pIter->pTbData = pTbData;
   pIter->backward = backward;
   pIter->pRow = NULL;
+  pIter->inChunk = 0;
+  tbDataChunkSeek(pTbData, pFrom, backward, pIter);
   if (pFrom == NULL) {
     // create from head or tail
     if (backward) {
@@ -260,38 +266,59 @@ void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, S
   }
 }
 
-bool tsdbTbDataIterNext(STbDataIter *pIter) {
-  pIter->pRow = NULL;
-  if (pIter->backward) {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pTail);
+// Choose the next row from the append chunks or the skiplist, both of them have rows.
+bool tsdbTbDataIterPickChunk(STbDataIter *pIter) {
+  STsdbRowKey chunkKey;
+  STsdbRowKey nodeKey;
 
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
-    }
+  tsdbRowGetKey(&pIter->pChunk->aRow[pIter->iChunkRow], &chunkKey);
+  tsdbRowGetKey(&pIter->pNode->row, &nodeKey);
 
-    pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
+  int32_t c = tsdbRowKeyCmpr(&chunkKey, &nodeKey);
+  return pIter->backward ? (c > 0) : (c < 0);
+}
+
+static void tbDataIterChunkNext(STbDataIter *pIter) {
+  SMemAppendChunk *pChunk = pIter->pChunk;
+
+  if (pIter->backward) {
+    if (--pIter->iChunkRow < 0) {
+      // the chunks before the tail are full and will not change
+      pIter->pChunk = pChunk->pPrev;
+      if (pIter->pChunk) {
+        pIter->iChunkRow = pIter->pChunk->nRow - 1;
+      }
     }
   } else {
-    ASSERT(pIter->pNode != pIter->pTbData->sl.pHead);
-
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
+    if (++pIter->iChunkRow >= atomic_load_32(&pChunk->nRow)) {
+      pIter->pChunk = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext);
+      pIter->iChunkRow = 0;
     }
+  }
+}
+
+bool tsdbTbDataIterNext(STbDataIter *pIter) {
+  if (tsdbTbDataIterGet(pIter) == NULL) {
+    return false;
+  }
 
+  pIter->pRow = NULL;
+  if (pIter->inChunk) {
+    tbDataIterChunkNext(pIter);
+  } else if (pIter->backward) {
+    ASSERT(pIter->pNode != pIter->pTbData->sl.pTail);
+    pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
+  } else {
+    ASSERT(pIter->pNode != pIter->pTbData->sl.pHead);
     pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
-    }
   }
 
-  return true;
+  return tsdbTbDataIterGet(pIter) != NULL;
 }
 
 int64_t tsdbCountTbDataRows(STbData *pTbData) {
   SMemSkipListNode *pNode = pTbData->sl.pHead;
-  int64_t           rowsNum = 0;
+  int64_t           rowsNum = atomic_load_64(&pTbData->nChunkRow);
 
   while (NULL != pNode) {
     pNode = SL_GET_NODE_FORWARD(pNode, 0);
@@ -378,6 +405,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->maxKey = TSKEY_MIN;
   pTbData->pHead = NULL;
   pTbData->pTail = NULL;
+  pTbData->pChunkHead = NULL;
+  pTbData->pChunkTail = NULL;
+  pTbData->nChunkRow = 0;
   pTbData->sl.seed = taosRand();
   pTbData->sl.size = 0;
   pTbData->sl.maxLevel = maxLevel;
@@ -574,6 +604,158 @@ _exit:
   return code;
 }
 
+// Position the iterator at the first appended row not less than pFrom (forward), or the last one not greater than
+// pFrom (backward).
+static void tbDataChunkSeek(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter) {
+  STsdbRowKey tKey;
+
+  pIter->pChunk = NULL;
+  pIter->iChunkRow = 0;
+
+  if (backward) {
+    for (SMemAppendChunk *pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->pChunkTail); pChunk;
+         pChunk = pChunk->pPrev) {
+      int32_t nRow = atomic_load_32(&pChunk->nRow);
+      int32_t iRow = nRow - 1;
+
+      if (pFrom) {
+        tsdbRowGetKey(&pChunk->aRow[0], &tKey);
+        if (tsdbRowKeyCmpr(&tKey, pFrom) > 0) continue;
+
+        // find the last row not greater than pFrom
+        int32_t lo = 0, hi = iRow;
+        while (lo < hi) {
+          int32_t mid = (lo + hi + 1) >> 1;
+          tsdbRowGetKey(&pChunk->aRow[mid], &tKey);
+          if (tsdbRowKeyCmpr(&tKey, pFrom) > 0) {
+            hi = mid - 1;
+          } else {
+            lo = mid;
+          }
+        }
+        iRow = lo;
+      }
+
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = iRow;
+      return;
+    }
+  } else {
+    for (SMemAppendChunk *pChunk = (SMemAppendChunk *)atomic_load_ptr(&pTbData->pChunkHead); pChunk;
+         pChunk = (SMemAppendChunk *)atomic_load_ptr(&pChunk->pNext)) {
+      int32_t nRow = atomic_load_32(&pChunk->nRow);
+      int32_t iRow = 0;
+
+      if (pFrom) {
+        tsdbRowGetKey(&pChunk->aRow[nRow - 1], &tKey);
+        if (tsdbRowKeyCmpr(&tKey, pFrom) < 0) continue;
+
+        // find the first row not less than pFrom
+        int32_t lo = 0, hi = nRow - 1;
+        while (lo < hi) {
+          int32_t mid = (lo + hi) >> 1;
+          tsdbRowGetKey(&pChunk->aRow[mid], &tKey);
+          if (tsdbRowKeyCmpr(&tKey, pFrom) < 0) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        iRow = lo;
+      }
+
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = iRow;
+      return;
+    }
+  }
+}
+
+// Get the largest key of the table from the last appended row and the last row of the skiplist, whichever is larger.
+static bool tbDataGetLastKey(STbData *pTbData, STsdbRowKey *pKey) {
+  STsdbRowKey       tKey;
+  bool              hasKey = false;
+  SMemAppendChunk  *pChunk = pTbData->pChunkTail;
+  SMemSkipListNode *pNode = SL_NODE_BACKWARD(pTbData->sl.pTail, 0);
+
+  if (pChunk) {
+    tsdbRowGetKey(&pChunk->aRow[pChunk->nRow - 1], pKey);
+    hasKey = true;
+  }
+
+  if (pNode != pTbData->sl.pHead) {
+    tsdbRowGetKey(&pNode->row, &tKey);
+    if (!hasKey || tsdbRowKeyCmpr(&tKey, pKey) > 0) {
+      *pKey = tKey;
+      hasKey = true;
+    }
+  }
+
+  return hasKey;
+}
+
+// Append a row larger than all the rows of the table. Only the writer thread changes the chunks, a row is visible to
+// the readers after the number of rows of the chunk or the link of the new chunk is stored.
+static int32_t tbDataAppendRow(SMemTable *pMemTable, STbData *pTbData, TSDBROW *pRow, int32_t nHint) {
+  SMemAppendChunk *pChunk = pTbData->pChunkTail;
+
+  if (pChunk == NULL || pChunk->nRow >= pChunk->capacity) {
+    SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
+    int32_t    capacity = pChunk ? pChunk->capacity << 1 : MEM_CHUNK_MIN_ROWS;
+
+    capacity = TMAX(capacity, nHint);
+    capacity = TMIN(capacity, MEM_CHUNK_MAX_ROWS);
+
+    SMemAppendChunk *pNew = vnodeBufPoolMallocAligned(pPool, sizeof(*pNew) + sizeof(TSDBROW) * capacity);
+    if (pNew == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pNew->pPrev = pChunk;
+    pNew->pNext = NULL;
+    pNew->capacity = capacity;
+    pNew->nRow = 1;
+    pNew->aRow[0] = *pRow;
+
+    if (pChunk) {
+      atomic_store_ptr(&pChunk->pNext, pNew);
+    } else {
+      atomic_store_ptr(&pTbData->pChunkHead, pNew);
+    }
+    atomic_store_ptr(&pTbData->pChunkTail, pNew);
+  } else {
+    pChunk->aRow[pChunk->nRow] = *pRow;
+    atomic_store_32(&pChunk->nRow, pChunk->nRow + 1);
+  }
+
+  atomic_add_fetch_64(&pTbData->nChunkRow, 1);
+  return TSDB_CODE_SUCCESS;
+}
+
+// Put the row into the skiplist, rows of a batch are put in order, so the position of the previous one is reused.
+static int32_t tbDataPutRow(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, bool *posValid,
+                            TSDBROW *pRow, STsdbRowKey *pKey) {
+  int32_t code = 0;
+
+  if (!*posValid) {
+    tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_BACKWARD);
+    code = tbDataDoPut(pMemTable, pTbData, pos, pRow, 0);
+    if (code) return code;
+
+    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+    }
+    *posValid = true;
+    return code;
+  }
+
+  if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
+    tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_FROM_POS);
+  }
+
+  return tbDataDoPut(pMemTable, pTbData, pos, pRow, 1);
+}
+
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -625,34 +807,27 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     if (code) goto _exit;
   }
 
-  // loop to add each row to the skiplist
+  // loop to add each row, rows after all existing ones are appended to the chunks, others to the skiplist
   SMemSkipListNode *pos[SL_MAX_LEVEL];
+  bool              posValid = false;
   TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
   STsdbRowKey       key;
+  STsdbRowKey       lastKey;
+  bool              hasLast = tbDataGetLastKey(pTbData, &lastKey);
 
-  // first row
-  tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
-  pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
+  for (; tRow.iRow < pBlockData->nRow; ++tRow.iRow) {
+    tsdbRowGetKey(&tRow, &key);
 
-  // remain row
-  ++tRow.iRow;
-  if (tRow.iRow < pBlockData->nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+    if (!hasLast || tsdbRowKeyCmpr(&key, &lastKey) > 0) {
+      if ((code = tbDataAppendRow(pMemTable, pTbData, &tRow, pBlockData->nRow - tRow.iRow))) goto _exit;
+      lastKey = key;
+      hasLast = true;
+    } else {
+      if ((code = tbDataPutRow(pMemTable, pTbData, pos, &posValid, &tRow, &key))) goto _exit;
     }
 
-    while (tRow.iRow < pBlockData->nRow) {
-      tsdbRowGetKey(&tRow, &key);
-
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
-      }
-
-      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
-
-      ++tRow.iRow;
+    if (tRow.iRow == 0) {
+      pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
     }
   }
 
@@ -682,37 +857,49 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   int32_t           nRow = TARRAY_SIZE(pSubmitTbData->aRowP);
   SRow            **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
   STsdbRowKey       key;
+  STsdbRowKey       lastKey;
+  bool              hasLast = tbDataGetLastKey(pTbData, &lastKey);
   SMemSkipListNode *pos[SL_MAX_LEVEL];
+  bool              posValid = false;
   TSDBROW           tRow = {.type = TSDBROW_ROW_FMT, .version = version};
-  int32_t           iRow = 0;
+  uint8_t          *pRowBuf = NULL;  // space for the appended rows of this batch, allocated once
 
-  // backward put first data
-  tRow.pTSRow = aRow[iRow++];
-  tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
-  if (code) goto _exit;
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    tRow.pTSRow = aRow[iRow];
+    tsdbRowGetKey(&tRow, &key);
 
-  pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
-
-  // forward put rest data
-  if (iRow < nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
-
-    while (iRow < nRow) {
-      tRow.pTSRow = aRow[iRow];
-      tsdbRowGetKey(&tRow, &key);
+    if (hasLast && tsdbRowKeyCmpr(&key, &lastKey) <= 0) {
+      code = tbDataPutRow(pMemTable, pTbData, pos, &posValid, &tRow, &key);
+      if (code) goto _exit;
+    } else {
+      if (pRowBuf == NULL) {
+        int64_t size = 0;
+        for (int32_t i = iRow; i < nRow; i++) {
+          size += ALIGN_NUM(aRow[i]->len, 8);
+        }
 
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+        pRowBuf = vnodeBufPoolMallocAligned(pMemTable->pTsdb->pVnode->inUse, size);
+        if (pRowBuf == NULL) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+          goto _exit;
+        }
       }
 
-      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
+      TSDBROW row = tRow;
+      row.pTSRow = (SRow *)pRowBuf;
+      memcpy(pRowBuf, tRow.pTSRow, tRow.pTSRow->len);
+      pRowBuf += ALIGN_NUM(tRow.pTSRow->len, 8);
+
+      code = tbDataAppendRow(pMemTable, pTbData, &row, nRow - iRow);
       if (code) goto _exit;
 
-      iRow++;
+      // the key of the copied row, whose primary key values refer to the buffer pool instead of the request
+      tsdbRowGetKey(&row, &lastKey);
+      hasLast = true;
+    }
+
+    if (iRow == 0) {
+      pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
     }
   }
 
@@ -734,7 +921,7 @@ _exit:
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size + atomic_load_64(&pTbData->nChunkRow); }
 
 int32_t tsdbRefMemTable(SMemTable *pMemTable, SQueryNode *pQNode) {
   int32_t code = 0;
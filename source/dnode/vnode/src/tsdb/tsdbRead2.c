@@ -370,6 +370,7 @@ bool shouldFreePkBuf(SBlockLoadSuppInfo* pSupp) { return (pSupp->numOfPks > 0) &
 void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order, bool needFree) {
   pIter->order = order;
   pIter->index = -1;
+  pIter->prefetchIndex = -1;
   pIter->numOfBlocks = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
@@ -1299,13 +1300,60 @@ static FORCE_INLINE STSchema* getTableSchemaImpl(STsdbReader* pReader, uint64_t
   return pReader->info.pSchema;
 }
 
-static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+// blocks are accessed in the order of their offsets in the data file, so the following blocks of the current one are
+// handed to the kernel to load in background, while the current block is decompressed and merged
+static void doReadAheadFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  if (tsTsdbPrefetchBlocks <= 0 || pReader->pFileReader == NULL) {
+    return;
+  }
+
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  int32_t             step = ASCENDING_TRAVERSE(pBlockIter->order) ? 1 : -1;
+  int64_t             budget = (int64_t)tsTsdbPrefetchSize * 1024 * 1024;
+  int64_t             size = 0;
+
+  for (int32_t i = 1; i <= tsTsdbPrefetchBlocks; ++i) {
+    int32_t index = pBlockIter->index + step * i;
+    if (index < 0 || index >= pBlockIter->numOfBlocks) {
+      break;
+    }
+
+    SFileDataBlockInfo* pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+
+    // bound the data read ahead of the current block
+    size += pBlockInfo->blockSize;
+    if (size > budget) {
+      break;
+    }
+
+    // already issued
+    if ((index - pBlockIter->prefetchIndex) * step <= 0) {
+      continue;
+    }
+
+    SBrinRecord record;
+    blockInfoToRecord(&record, pBlockInfo, pSup);
+    if (tsdbDataFileReadAheadBlockData(pReader->pFileReader, &record) != TSDB_CODE_SUCCESS) {
+      // the blocks are still read on demand
+      pBlockIter->prefetchIndex = pBlockIter->index + step * tsTsdbPrefetchBlocks;
+      break;
+    }
+
+    pBlockIter->prefetchIndex = index;
+    pReader->cost.prefetchBlocks += 1;
+  }
+}
+
+// moreCols: the key part and some columns of the block are loaded already, load the missing ones in cids
+static int32_t doLoadFileBlockColumns(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                      uint64_t uid, int16_t* cids, int32_t numOfCids, bool moreCols) {
   int32_t   code = 0;
   STSchema* pSchema = pReader->info.pSchema;
   int64_t   st = taosGetTimestampUs();
 
-  tBlockDataReset(pBlockData);
+  if (!moreCols) {
+    tBlockDataReset(pBlockData);
+  }
 
   if (pReader->info.pSchema == NULL) {
     pSchema = getTableSchemaImpl(pReader, uid);
@@ -1322,8 +1370,13 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SBrinRecord tmp;
   blockInfoToRecord(&tmp, pBlockInfo, pSup);
   SBrinRecord* pRecord = &tmp;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
+
+  if (moreCols) {
+    code = tsdbDataFileReadBlockDataMoreColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, cids, numOfCids);
+  } else {
+    doReadAheadFileBlocks(pReader, pBlockIter);
+    code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, cids, numOfCids);
+  }
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -1340,11 +1393,19 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
             pRecord->numRow, pRecord->minVer, pRecord->maxVer, elapsedTime, pReader->idStr);
 
   pReader->cost.blockLoadTime += elapsedTime;
-  pDumpInfo->allDumped = false;
+  if (!moreCols) {
+    pDumpInfo->allDumped = false;
+  }
 
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                   uint64_t uid) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  return doLoadFileBlockColumns(pReader, pBlockIter, pBlockData, uid, &pSup->colId[1], pSup->numOfCols - 1, false);
+}
+
 /**
  * This is an two rectangles overlap cases.
  */
@@ -1559,6 +1620,105 @@ static bool isCleanFileDataBlock(STsdbReader* pReader, SFileDataBlockInfo* pBloc
   return isCleanFileBlock;
 }
 
+// the SMA of the block is loaded in colAggArray
+static bool fileBlockPrunedBySma(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo) {
+  SReaderFilterInfo*  pFilter = &pReader->filterInfo;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  bool                keep = true;
+  int64_t             st = taosGetTimestampUs();
+
+  if (pSup->colAggArray.size == 0) {
+    return false;
+  }
+
+  pReader->cost.smaDataLoad += 1;
+  int32_t code =
+      pFilter->smaFn(pSup->colAggArray.data, pSup->colAggArray.size, pBlockInfo->numRow, &keep, pFilter->smaParam);
+  pReader->cost.smaLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  if (code != TSDB_CODE_SUCCESS || keep) {
+    return false;
+  }
+
+  pReader->cost.smaPrunedBlocks += 1;
+  tsdbDebug("%p uid:%" PRIu64 " file block pruned by SMA, global index:%d, brange:%" PRId64 "-%" PRId64 ", rows:%d, %s",
+            pReader, pBlockInfo->uid, pReader->status.blockIter.index, pBlockInfo->firstKey, pBlockInfo->lastKey,
+            pBlockInfo->numRow, pReader->idStr);
+  return true;
+}
+
+// each condition is a conjunct of the filter, so a block can't qualify if any of the conditions fails. bloomSize is
+// got along with the SMA of the block.
+static bool fileBlockPrunedByBloom(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo, SBrinRecord* pRecord,
+                                   int64_t bloomSize) {
+  SReaderFilterInfo* pFilter = &pReader->filterInfo;
+
+  if (bloomSize <= 0) {
+    return false;
+  }
+
+  int32_t code = tsdbDataFileReadBlockBloom(pReader->pFileReader, pRecord, bloomSize, &pFilter->bloom);
+  if (code != TSDB_CODE_SUCCESS || pFilter->bloom.size == 0) {
+    return false;
+  }
+
+  int32_t num = taosArrayGetSize(pFilter->pEqualConds);
+  for (int32_t i = 0; i < num; ++i) {
+    STsdReaderEqualCond* pCond = taosArrayGet(pFilter->pEqualConds, i);
+    bool                 mayContain = true;
+
+    code = tsdbBlockBloomMayContain(&pFilter->bloom, pCond->colId, pCond->type, TARRAY_DATA(pCond->pValues),
+                                    taosArrayGetSize(pCond->pValues), &mayContain);
+    if (code != TSDB_CODE_SUCCESS) {
+      return false;
+    }
+
+    if (!mayContain) {
+      pReader->cost.bloomPrunedBlocks += 1;
+      tsdbDebug("%p uid:%" PRIu64 " file block pruned by bloom filter of column:%d, global index:%d, brange:%" PRId64
+                "-%" PRId64 ", rows:%d, %s",
+                pReader, pBlockInfo->uid, pCond->colId, pReader->status.blockIter.index, pBlockInfo->firstKey,
+                pBlockInfo->lastKey, pBlockInfo->numRow, pReader->idStr);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// rows of a clean file block are not merged with any other rows, so the block can be skipped as a whole if the SMA or
+// the bloom filters of its columns prove that no rows qualify the filter
+static bool fileBlockPrunedByFilter(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo,
+                                    STableBlockScanInfo* pScanInfo, TSDBKEY keyInBuf) {
+  SReaderFilterInfo* pFilter = &pReader->filterInfo;
+
+  if ((pFilter->smaFn == NULL && pFilter->pEqualConds == NULL) || pBlockInfo->smaSize <= 0 ||
+      pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    return false;
+  }
+
+  if (!isCleanFileDataBlock(pReader, pBlockInfo, pScanInfo, keyInBuf)) {
+    return false;
+  }
+
+  SBrinRecord record;
+  int64_t     bloomSize = 0;
+  int64_t     st = taosGetTimestampUs();
+  blockInfoToRecord(&record, pBlockInfo, &pReader->suppInfo);
+
+  // the SMA records of the block are read once, they locate the bloom filters as well
+  int32_t code = tsdbDataFileReadBlockSma(pReader->pFileReader, &record, &pReader->suppInfo.colAggArray, &bloomSize);
+  pReader->cost.smaLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  if (code != TSDB_CODE_SUCCESS) {
+    return false;
+  }
+
+  if (pFilter->smaFn != NULL && fileBlockPrunedBySma(pReader, pBlockInfo)) {
+    return true;
+  }
+
+  return pFilter->pEqualConds != NULL && fileBlockPrunedByBloom(pReader, pBlockInfo, &record, bloomSize);
+}
+
 static int32_t buildDataBlockFromBuf(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo, int64_t endKey) {
   if (!(pBlockScanInfo->iiter.hasVal || pBlockScanInfo->iter.hasVal)) {
     return TSDB_CODE_SUCCESS;
@@ -3031,6 +3191,11 @@ static int32_t doBuildDataBlock(STsdbReader* pReader) {
   }
 
   TSDBKEY keyInBuf = getCurrentKeyInBuf(pScanInfo, pReader);
+  if (fileBlockPrunedByFilter(pReader, pBlockInfo, pScanInfo, keyInBuf)) {
+    setBlockAllDumped(&pStatus->fBlockDumpInfo, pBlockInfo->lastKey, pReader->info.order);
+    return code;
+  }
+
   if (fileBlockShouldLoad(pReader, pBlockInfo, pScanInfo, keyInBuf)) {
     code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid);
     if (code != TSDB_CODE_SUCCESS) {
@@ -4407,6 +4572,8 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   }
 
   taosMemoryFree(pSupInfo->colId);
+  taosMemoryFree(pReader->filterInfo.colId);
+  tBufferDestroy(&pReader->filterInfo.bloom);
   tBlockDataDestroy(&pReader->status.fileBlockData);
   cleanupDataBlockIterator(&pReader->status.blockIter, shouldFreePkBuf(&pReader->suppInfo));
 
@@ -4451,12 +4618,14 @@ void tsdbReaderClose2(STsdbReader* pReader) {
       "build in-memory-block-time:%.2f ms, sttBlocks:%" PRId64 ", sttBlocks-time:%.2f ms, sttStatisBlock:%" PRId64
       ", stt-statis-Block-time:%.2f ms, composed-blocks:%" PRId64
       ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,createSkylineIterTime:%.2f "
-      "ms, initSttBlockReader:%.2fms, %s",
+      "ms, initSttBlockReader:%.2fms, prefetchBlocks:%" PRId64 ", filterOutBlocks:%" PRId64
+      ", smaPrunedBlocks:%" PRId64 ", bloomPrunedBlocks:%" PRId64 ", %s",
       pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
       pCost->blockLoadTime, pCost->buildmemBlock, pCost->sttCost.loadBlocks, pCost->sttCost.blockElapsedTime,
       pCost->sttCost.loadStatisBlocks, pCost->sttCost.statisElapsedTime, pCost->composedBlocks,
       pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
-      pCost->createSkylineIterTime, pCost->initSttBlockReader, pReader->idStr);
+      pCost->createSkylineIterTime, pCost->initSttBlockReader, pCost->prefetchBlocks, pCost->filterOutBlocks,
+      pCost->smaPrunedBlocks, pCost->bloomPrunedBlocks, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
 
@@ -4926,7 +5095,7 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
 
   SBrinRecord pRecord;
   blockInfoToRecord(&pRecord, pBlockInfo, pSup);
-  code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pRecord, &pSup->colAggArray);
+  code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pRecord, &pSup->colAggArray, NULL);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbDebug("vgId:%d, failed to load block SMA for uid %" PRIu64 ", code:%s, %s", 0, pBlockInfo->uid, tstrerror(code),
               pReader->idStr);
@@ -4993,6 +5162,52 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
+// load the filter columns of the block and dump them to evaluate the filter, the other columns are loaded and dumped
+// only if any rows qualify, or the block is not dumped completely and is merged later with all the columns
+static int32_t doLoadFileBlockByFilter(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SReaderFilterInfo*  pFilter = &pReader->filterInfo;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  SFileBlockDumpInfo  dumpInfo = pStatus->fBlockDumpInfo;
+  bool                keep = true;
+
+  int32_t code = doLoadFileBlockColumns(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                        pFilter->colId, pFilter->numOfCols, false);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  dumpInfo.allDumped = pStatus->fBlockDumpInfo.allDumped;
+  code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
+  if (code != TSDB_CODE_SUCCESS || pStatus->fileBlockData.nRow == 0) {
+    return code;
+  }
+
+  if (pResBlock->info.rows > 0) {
+    code = pFilter->fn(pResBlock, &keep, pFilter->param);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  // the columns not loaded are filled with NULL, and the rows are all removed by the filter of the executor
+  if (!keep && pStatus->fBlockDumpInfo.allDumped) {
+    pReader->cost.filterOutBlocks += 1;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  code = doLoadFileBlockColumns(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                &pSup->colId[1], pSup->numOfCols - 1, true);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // dump the same rows again with all the columns
+  pStatus->fBlockDumpInfo = dumpInfo;
+  return copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
+}
+
 static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   SReaderStatus*      pStatus = &pReader->status;
   int32_t             code = TSDB_CODE_SUCCESS;
@@ -5007,6 +5222,17 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
+  if (pReader->filterInfo.fn != NULL) {
+    code = doLoadFileBlockByFilter(pReader, pBlockScanInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      tBlockDataReset(&pStatus->fileBlockData);
+      terrno = code;
+      return NULL;
+    }
+
+    return pReader->resBlockInfo.pResBlock;
+  }
+
   code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataReset(&pStatus->fileBlockData);
@@ -5476,3 +5702,62 @@ void tsdbReaderSetNotifyCb(STsdbReader* pReader, TsdReaderNotifyCbFn notifyFn, v
   pReader->notifyFn = notifyFn;
   pReader->notifyParam = param;
 }
+
+void tsdbReaderSetFilter(STsdbReader* pReader, const int16_t* colIds, int32_t numOfCols, TsdReaderFilterFn filterFn,
+                         void* param) {
+  SReaderFilterInfo*  pFilter = &pReader->filterInfo;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  int32_t             numOfFilterCols = 0;
+
+  taosMemoryFreeClear(pFilter->colId);
+  pFilter->fn = NULL;
+  pFilter->param = NULL;
+  pFilter->numOfCols = 0;
+
+  if (filterFn == NULL || numOfCols <= 0) {
+    return;
+  }
+
+  // the filter is not pushed down, the executor filters the whole blocks as before
+  pFilter->colId = taosMemoryMalloc(sizeof(int16_t) * pSup->numOfCols);
+  if (pFilter->colId == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (colIds[i] != PRIMARYKEY_TIMESTAMP_COL_ID) {
+      numOfFilterCols += 1;
+    }
+  }
+
+  // the primary timestamp is always loaded with the key part
+  for (int32_t i = 1; i < pSup->numOfCols; ++i) {
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      if (colIds[j] == pSup->colId[i]) {
+        pFilter->colId[pFilter->numOfCols++] = pSup->colId[i];
+        break;
+      }
+    }
+  }
+
+  // some filter columns are not loaded by the reader, or no other columns are left to skip
+  if (pFilter->numOfCols != numOfFilterCols || pFilter->numOfCols >= pSup->numOfCols - 1) {
+    taosMemoryFreeClear(pFilter->colId);
+    pFilter->numOfCols = 0;
+    return;
+  }
+
+  pFilter->fn = filterFn;
+  pFilter->param = param;
+  tsdbDebug("%p filter pushed down, filter columns:%d, total columns:%d, %s", pReader, pFilter->numOfCols,
+            pSup->numOfCols, pReader->idStr);
+}
+
+void tsdbReaderSetSmaFilter(STsdbReader* pReader, TsdReaderSmaFilterFn filterFn, void* param) {
+  pReader->filterInfo.smaFn = filterFn;
+  pReader->filterInfo.smaParam = param;
+}
+
+void tsdbReaderSetEqualConds(STsdbReader* pReader, SArray* pConds) {
+  pReader->filterInfo.pEqualConds = (taosArrayGetSize(pConds) > 0) ? pConds : NULL;
+}
@@ -151,6 +151,10 @@ typedef struct SReadCostSummary {
   double  createScanInfoList;
   double  createSkylineIterTime;
   double  initSttBlockReader;
+  int64_t prefetchBlocks;
+  int64_t filterOutBlocks;    // blocks of which only the filter columns are loaded
+  int64_t smaPrunedBlocks;    // blocks skipped since the min/max of the columns can't match the filter
+  int64_t bloomPrunedBlocks;  // blocks skipped since the bloom filters hold none of the values compared by the filter
 } SReadCostSummary;
 
 typedef struct STableUidList {
@@ -190,6 +194,20 @@ typedef struct SBlockLoadSuppInfo {
   bool                smaValid;  // the sma on all queried columns are activated
 } SBlockLoadSuppInfo;
 
+// the filter pushed down by the executor. A clean file block is skipped if its SMA or bloom filters prove no rows qualify,
+// otherwise the filter columns of the block are loaded and evaluated first, and the other columns are loaded only if any
+// rows qualify
+typedef struct SReaderFilterInfo {
+  TsdReaderFilterFn    fn;
+  void*                param;
+  int16_t*             colId;  // filter columns in ascending order, the primary timestamp is excluded
+  int32_t              numOfCols;
+  TsdReaderSmaFilterFn smaFn;  // evaluated on the SMA of the clean file blocks before they are loaded
+  void*                smaParam;
+  SArray*              pEqualConds;  // SArray<STsdReaderEqualCond>, owned by the executor
+  SBuffer              bloom;        // bloom filters of the current file block
+} SReaderFilterInfo;
+
 // each blocks in stt file not overlaps with in-memory/data-file/tomb-files, and not overlap with any other blocks in stt-file
 typedef struct SSttBlockReader {
   STimeWindow        window;
@@ -239,7 +257,8 @@ typedef struct SFileDataBlockInfo {
 typedef struct SDataBlockIter {
   int32_t    numOfBlocks;
   int32_t    index;
-  SArray*    blockList;  // SArray<SFileDataBlockInfo>
+  int32_t    prefetchIndex;  // the last block read ahead in the access order
+  SArray*    blockList;      // SArray<SFileDataBlockInfo>
   int32_t    order;
   SDataBlk   block;  // current SDataBlk data
 } SDataBlockIter;
@@ -302,6 +321,7 @@ struct STsdbReader {
   bool                 bFilesetDelimited;   // duration by duration output
   TsdReaderNotifyCbFn  notifyFn;
   void*                notifyParam;
+  SReaderFilterInfo    filterInfo;
 };
 
 typedef struct SBrinRecordIter {
@@ -18,6 +18,70 @@
 #include "tsdb.h"
 #include "vnd.h"
 
+// consecutive pages are written and read in runs of up to this size, so a block spanning many pages costs one syscall
+#define TSDB_FD_RUN_SIZE (64 * 1024)
+
+static int32_t tsdbRunCapacity(STsdbFD *pFD) { return TMAX(1, TSDB_FD_RUN_SIZE / pFD->szPage); }
+
+static int64_t tsdbPageFileOffset(STsdbFD *pFD, int64_t pgno) {
+  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
+  if (pFD->lcn > 1) {
+    SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
+    int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->s3ChunkSize;
+    int64_t    chunkoffset = chunksize * (pFD->lcn - 1);
+
+    offset -= chunkoffset;
+  }
+  ASSERT(offset >= 0);
+  return offset;
+}
+
+static void tsdbDecryptPage(uint8_t *pPage, int32_t szPage, char *encryptKey) {
+  unsigned char PacketData[128];
+  int           NewLen;
+
+  int32_t count = 0;
+  while (count < szPage) {
+    SCryptOpts opts = {0};
+    opts.len = 128;
+    opts.source = pPage + count;
+    opts.result = PacketData;
+    opts.unitLen = 128;
+    // strncpy(opts.key, tsEncryptKey, 16);
+    strncpy(opts.key, encryptKey, ENCRYPT_KEY_LEN);
+
+    NewLen = CBC_Decrypt(&opts);
+
+    memcpy(pPage + count, PacketData, NewLen);
+    count += NewLen;
+  }
+  // tsdbDebug("CBC_Decrypt count:%d %s", count, __FUNCTION__);
+}
+
+// write the pages kept in the run buffer to the file
+static int32_t tsdbFlushFileRun(STsdbFD *pFD) {
+  if (!pFD->runDirty) return 0;
+
+  int64_t offset = pFD->runOffset;
+  int64_t size = (int64_t)pFD->nRunPage * pFD->szPage;
+  int64_t n = 0;
+
+  pFD->runDirty = 0;
+  pFD->nRunPage = 0;
+
+  while (n < size) {
+    int64_t ret = taosPWriteFile(pFD->pFD, pFD->pRun + n, size - n, offset + n);
+    if (ret < 0) {
+      return TAOS_SYSTEM_ERROR(errno);
+    } else if (ret == 0) {
+      return TSDB_CODE_FILE_CORRUPTED;
+    }
+    n += ret;
+  }
+
+  return 0;
+}
+
 static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   int32_t     code = 0;
   const char *path = pFD->path;
@@ -158,9 +222,16 @@ _exit:
   return code;
 }
 
-void tsdbCloseFile(STsdbFD **ppFD) {
+// the pages left in the run buffer are written before the file is closed, and the file is closed even if they fail
+int32_t tsdbCloseFile(STsdbFD **ppFD) {
+  int32_t  code = 0;
   STsdbFD *pFD = *ppFD;
   if (pFD) {
+    code = tsdbFlushFileRun(pFD);
+    if (code) {
+      tsdbError("failed to flush file %s since %s", pFD->path, tstrerror(code));
+    }
+    taosMemoryFree(pFD->pRun);
     taosMemoryFree(pFD->pBuf);
     // if (!pFD->s3File) {
     taosCloseFile(&pFD->pFD);
@@ -168,6 +239,7 @@ void tsdbCloseFile(STsdbFD **ppFD) {
     taosMemoryFree(pFD);
     *ppFD = NULL;
   }
+  return code;
 }
 
 static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey) {
@@ -191,10 +263,22 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *e
     }
     ASSERT(offset >= 0);
 
-    int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
-    if (n < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _exit;
+    // the page goes to the run buffer, which is written once it is full or the next page is not adjacent
+    if (!pFD->runDirty || pFD->pgno != pFD->runPgno + pFD->nRunPage || pFD->nRunPage >= tsdbRunCapacity(pFD)) {
+      code = tsdbFlushFileRun(pFD);
+      if (code) goto _exit;
+
+      if (pFD->pRun == NULL) {
+        pFD->pRun = taosMemoryMalloc((int64_t)tsdbRunCapacity(pFD) * pFD->szPage);
+        if (pFD->pRun == NULL) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+          goto _exit;
+        }
+      }
+      pFD->runPgno = pFD->pgno;
+      pFD->runOffset = offset;
+      pFD->nRunPage = 0;
+      pFD->runDirty = 1;
     }
 
     taosCalcChecksumAppend(0, pFD->pBuf, pFD->szPage);
@@ -221,11 +305,8 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *e
       // tsdbDebug("CBC_Encrypt count:%d %s", count, __FUNCTION__);
     }
 
-    n = taosWriteFile(pFD->pFD, pFD->pBuf, pFD->szPage);
-    if (n < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _exit;
-    }
+    memcpy(pFD->pRun + (int64_t)pFD->nRunPage * pFD->szPage, pFD->pBuf, pFD->szPage);
+    pFD->nRunPage++;
 
     if (pFD->szFile < pFD->pgno) {
       pFD->szFile = pFD->pgno;
@@ -248,15 +329,11 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno, int32_t encryptAlgor
     }
   }
 
-  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
-  if (pFD->lcn > 1) {
-    SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
-    int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->s3ChunkSize;
-    int64_t    chunkoffset = chunksize * (pFD->lcn - 1);
+  // the page may still be in the run buffer
+  code = tsdbFlushFileRun(pFD);
+  if (code) goto _exit;
 
-    offset -= chunkoffset;
-  }
-  ASSERT(offset >= 0);
+  int64_t offset = tsdbPageFileOffset(pFD, pgno);
   /*
   if (pFD->s3File) {
     LRUHandle *handle = NULL;
@@ -279,15 +356,8 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno, int32_t encryptAlgor
     tsdbCacheRelease(pFD->pTsdb->bCache, handle);
   } else {
   */
-  // seek
-  int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _exit;
-  }
-
   // read
-  n = taosReadFile(pFD->pFD, pFD->pBuf, pFD->szPage);
+  int64_t n = taosPReadFile(pFD->pFD, pFD->pBuf, pFD->szPage, offset);
   if (n < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _exit;
@@ -299,34 +369,63 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno, int32_t encryptAlgor
 
   if (encryptAlgorithm == DND_CA_SM4) {
     // if(tsiEncryptAlgorithm == DND_CA_SM4 && (tsiEncryptScope & DND_CS_TSDB) == DND_CS_TSDB){
-    unsigned char PacketData[128];
-    int           NewLen;
+    tsdbDecryptPage(pFD->pBuf, pFD->szPage, encryptKey);
+  }
 
-    int32_t count = 0;
-    while (count < pFD->szPage) {
-      SCryptOpts opts = {0};
-      opts.len = 128;
-      opts.source = pFD->pBuf + count;
-      opts.result = PacketData;
-      opts.unitLen = 128;
-      // strncpy(opts.key, tsEncryptKey, 16);
-      strncpy(opts.key, encryptKey, ENCRYPT_KEY_LEN);
+  // check
+  if (pgno > 1 && !taosCheckChecksumWhole(pFD->pBuf, pFD->szPage)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
 
-      NewLen = CBC_Decrypt(&opts);
+  pFD->pgno = pgno;
 
-      memcpy(pFD->pBuf + count, PacketData, NewLen);
-      count += NewLen;
+_exit:
+  return code;
+}
+
+// read up to nPage pages from pgno into the run buffer by one syscall, the run keeps serving later reads of these
+// pages until the next page is written
+static int32_t tsdbReadFilePageRun(STsdbFD *pFD, int64_t pgno, int64_t nPage, int32_t encryptAlgorithm,
+                                   char *encryptKey) {
+  int32_t code = 0;
+
+  nPage = TMIN(nPage, tsdbRunCapacity(pFD));
+  if (pFD->pRun == NULL) {
+    pFD->pRun = taosMemoryMalloc((int64_t)tsdbRunCapacity(pFD) * pFD->szPage);
+    if (pFD->pRun == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
     }
-    // tsdbDebug("CBC_Decrypt count:%d %s", count, __FUNCTION__);
   }
+  pFD->nRunPage = 0;
 
-  // check
-  if (pgno > 1 && !taosCheckChecksumWhole(pFD->pBuf, pFD->szPage)) {
+  int64_t n = taosPReadFile(pFD->pFD, pFD->pRun, nPage * pFD->szPage, tsdbPageFileOffset(pFD, pgno));
+  if (n < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  } else if (n < pFD->szPage) {
     code = TSDB_CODE_FILE_CORRUPTED;
     goto _exit;
   }
 
-  pFD->pgno = pgno;
+  // the pages beyond the end of file are not part of the run, and fail on their own read
+  nPage = n / pFD->szPage;
+  for (int64_t i = 0; i < nPage; ++i) {
+    uint8_t *pPage = pFD->pRun + i * pFD->szPage;
+
+    if (encryptAlgorithm == DND_CA_SM4) {
+      tsdbDecryptPage(pPage, pFD->szPage, encryptKey);
+    }
+
+    if (pgno + i > 1 && !taosCheckChecksumWhole(pPage, pFD->szPage)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+  }
+
+  pFD->runPgno = pgno;
+  pFD->nRunPage = nPage;
 
 _exit:
   return code;
@@ -378,13 +477,24 @@ static int32_t tsdbReadFileImp(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int6
   ASSERT(bOffset < szPgCont);
 
   while (n < size) {
+    uint8_t *pPage = pFD->pBuf;
     if (pFD->pgno != pgno) {
-      code = tsdbReadFilePage(pFD, pgno, encryptAlgorithm, encryptKey);
-      if (code) goto _exit;
+      if (pgno >= pFD->runPgno && pgno < pFD->runPgno + pFD->nRunPage) {
+        pPage = pFD->pRun + (pgno - pFD->runPgno) * pFD->szPage;
+      } else if (bOffset + size - n > szPgCont) {
+        // the rest of the read spans more pages
+        code = tsdbReadFilePageRun(pFD, pgno, (bOffset + size - n + szPgCont - 1) / szPgCont, encryptAlgorithm,
+                                   encryptKey);
+        if (code) goto _exit;
+        pPage = pFD->pRun;
+      } else {
+        code = tsdbReadFilePage(pFD, pgno, encryptAlgorithm, encryptKey);
+        if (code) goto _exit;
+      }
     }
 
     int64_t nRead = TMIN(szPgCont - bOffset, size - n);
-    memcpy(pBuf + n, pFD->pBuf + bOffset, nRead);
+    memcpy(pBuf + n, pPage + bOffset, nRead);
 
     n += nRead;
     pgno++;
@@ -581,6 +691,11 @@ int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size,
     }
   }
 
+  code = tsdbFlushFileRun(pFD);
+  if (code) {
+    goto _exit;
+  }
+
   if (pFD->s3File && pFD->lcn > 1 /* && tsS3BlockSize < 0*/) {
     return tsdbReadFileS3(pFD, offset, pBuf, size, szHint);
   } else {
@@ -604,6 +719,31 @@ int32_t tsdbReadFileToBuffer(STsdbFD *pFD, int64_t offset, int64_t size, SBuffer
   return code;
 }
 
+// ask the kernel to load the pages of [offset, offset + size) in background, so that the read of the range later
+// finds them in the page cache
+int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size) {
+  int32_t code = 0;
+  if (size <= 0) return code;
+
+  if (!pFD->pFD) {
+    code = tsdbOpenFileImpl(pFD);
+    if (code) {
+      return code;
+    }
+  }
+
+  // chunks migrated to s3 are not in the local file
+  if (pFD->s3File) return code;
+
+  int64_t pgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset, pFD->szPage), pFD->szPage);
+  int64_t lpgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+
+  if (taosReadAheadFile(pFD->pFD, tsdbPageFileOffset(pFD, pgno), (lpgno - pgno + 1) * pFD->szPage) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+  return code;
+}
+
 int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey) {
   int32_t code = 0;
   /*
@@ -615,6 +755,9 @@ int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey)
   code = tsdbWriteFilePage(pFD, encryptAlgorithm, encryptKey);
   if (code) goto _exit;
 
+  code = tsdbFlushFileRun(pFD);
+  if (code) goto _exit;
+
   if (taosFsyncFile(pFD->pFD) < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _exit;
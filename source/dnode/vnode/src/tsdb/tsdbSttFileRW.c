@@ -872,7 +872,8 @@ static int32_t tsdbSttFWriterCloseCommit(SSttFileWriter *writer, TFileOpArray *o
   code = tsdbFsyncFile(writer->fd, encryptAlgorithm, encryptKey);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  tsdbCloseFile(&writer->fd);
+  code = tsdbCloseFile(&writer->fd);
+  TSDB_CHECK_CODE(code, lino, _exit);
 
   ASSERT(writer->file->size > 0);
   STFileOp op = (STFileOp){
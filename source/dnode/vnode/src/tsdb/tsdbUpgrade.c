@@ -164,7 +164,8 @@ static int32_t tsdbUpgradeHead(STsdb *tsdb, SDFileSet *pDFileSet, SDataFReader *
     code = tsdbFsyncFile(ctx->fd, ctx->encryptAlgorithm, ctx->encryptKey);
     TSDB_CHECK_CODE(code, lino, _exit);
 
-    tsdbCloseFile(&ctx->fd);
+    code = tsdbCloseFile(&ctx->fd);
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
 _exit:
@@ -299,7 +300,8 @@ static int32_t tsdbUpgradeSttFile(STsdb *tsdb, SDFileSet *pDFileSet, SDataFReade
     code = tsdbFsyncFile(ctx->fd, ctx->encryptAlgorithm, ctx->encryptKey);
     TSDB_CHECK_CODE(code, lino, _exit1);
 
-    tsdbCloseFile(&ctx->fd);
+    code = tsdbCloseFile(&ctx->fd);
+    TSDB_CHECK_CODE(code, lino, _exit1);
 
     code = TARRAY2_APPEND(lvl->fobjArr, fobj);
     TSDB_CHECK_CODE(code, lino, _exit1);
@@ -558,7 +560,8 @@ static int32_t tsdbDumpTombDataToFSet(STsdb *tsdb, SDelFReader *reader, SArray *
     code = tsdbFsyncFile(ctx->fd, ctx->encryptAlgorithm, ctx->encryptKey);
     TSDB_CHECK_CODE(code, lino, _exit);
 
-    tsdbCloseFile(&ctx->fd);
+    code = tsdbCloseFile(&ctx->fd);
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
 _exit:
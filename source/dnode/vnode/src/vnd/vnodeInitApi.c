@@ -63,6 +63,9 @@ void initTsdbReaderAPI(TsdReader* pReader) {
 
   pReader->tsdSetFilesetDelimited = (void (*)(void*))tsdbSetFilesetDelimited;
   pReader->tsdSetSetNotifyCb = (void (*)(void*, TsdReaderNotifyCbFn, void*))tsdbReaderSetNotifyCb;
+  pReader->tsdSetFilter = (void (*)(void*, const int16_t*, int32_t, TsdReaderFilterFn, void*))tsdbReaderSetFilter;
+  pReader->tsdSetSmaFilter = (void (*)(void*, TsdReaderSmaFilterFn, void*))tsdbReaderSetSmaFilter;
+  pReader->tsdSetEqualConds = (void (*)(void*, SArray*))tsdbReaderSetEqualConds;
 }
 
 void initMetadataAPI(SStoreMeta* pMeta) {
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "tglobal.h"
+#include "tsdb.h"
+
+// decompressed block columns cached by (fid, commit id, offset, cid), and the hit and miss counters of the vnode
+
+namespace {
+
+const int32_t  nRow = 1000;
+const tb_uid_t uid = 10001;
+const int64_t  commitId = 1;
+
+int64_t testVersion(int32_t fid, int32_t iRow) { return fid * 100000 + iRow; }
+TSKEY   testTs(int64_t offset, int32_t iRow) { return offset * 1000 + iRow; }
+int32_t testVal(int32_t fid, int64_t offset, int16_t cid, int32_t iRow) {
+  return (int32_t)(fid * 7 + offset * 13 + cid * 17 + iRow);
+}
+
+// a tsdb of a vnode with only the decompressed column cache opened
+class TsdbColCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int32_t oldSize = tsTsdbColCacheSize;
+
+    vnode.pTsdb = &tsdb;
+    tsdb.pVnode = &vnode;
+    tsTsdbColCacheSize = 16;
+    int32_t code = tsdbOpenColCache(&tsdb);
+    tsTsdbColCacheSize = oldSize;
+    ASSERT_EQ(code, 0);
+  }
+
+  void TearDown() override { tsdbCloseColCache(&tsdb); }
+
+  // the key part of a block missing from the cache is made up from (fid, offset) and put into it, a cached one is
+  // checked against that
+  void readKeyPart(const SColCacheKey *pKey) {
+    SDiskDataHdr hdr = {0};
+    SBlockData   bData;
+    bool         hit = false;
+
+    (void)tBlockDataCreate(&bData);
+    ASSERT_EQ(tsdbColCacheGetKeyPart(&tsdb, pKey, &hdr, &bData, &hit), 0);
+    if (hit) {
+      EXPECT_EQ(hdr.uid, uid);
+      EXPECT_EQ(hdr.nRow, nRow);
+      EXPECT_EQ(bData.nColData, 0);
+      EXPECT_EQ(bData.nRow, nRow);
+      for (int32_t i = 0; i < nRow && bData.nRow == nRow; ++i) {
+        ASSERT_EQ(bData.aVersion[i], testVersion(pKey->fid, i)) << "row " << i;
+        ASSERT_EQ(bData.aTSKEY[i], testTs(pKey->offset, i)) << "row " << i;
+      }
+    } else {
+      hdr.uid = uid;
+      hdr.nRow = nRow;
+      bData.uid = uid;
+      bData.nRow = nRow;
+      ASSERT_EQ(tRealloc((uint8_t **)&bData.aVersion, sizeof(int64_t) * nRow), 0);
+      ASSERT_EQ(tRealloc((uint8_t **)&bData.aTSKEY, sizeof(TSKEY) * nRow), 0);
+      for (int32_t i = 0; i < nRow; ++i) {
+        bData.aVersion[i] = testVersion(pKey->fid, i);
+        bData.aTSKEY[i] = testTs(pKey->offset, i);
+      }
+      EXPECT_EQ(tsdbColCachePutKeyPart(&tsdb, pKey, &hdr, &bData), 0);
+    }
+    tBlockDataDestroy(&bData);
+  }
+
+  // a column of int, made up from (fid, offset, cid) as well
+  void readColData(const SColCacheKey *pKey) {
+    SBlockData bData;
+    SColData   colData = {0};
+    LRUHandle *h = tsdbColCacheLookup(&tsdb, pKey);
+
+    (void)tBlockDataCreate(&bData);
+    tColDataInit(&colData, pKey->cid, TSDB_DATA_TYPE_INT, 0);
+    if (h) {
+      ASSERT_EQ(tsdbColCacheLoadColData(&tsdb, h, &bData), 0);
+
+      SColData *pColData = tBlockDataGetColData(&bData, pKey->cid);
+      ASSERT_NE(pColData, nullptr);
+      ASSERT_EQ(pColData->nVal, nRow);
+      for (int32_t i = 0; i < nRow; ++i) {
+        SColVal colVal;
+        tColDataGetValue(pColData, i, &colVal);
+        ASSERT_TRUE(COL_VAL_IS_VALUE(&colVal)) << "row " << i;
+        ASSERT_EQ(colVal.value.val, testVal(pKey->fid, pKey->offset, pKey->cid, i)) << "row " << i;
+      }
+    } else {
+      for (int32_t i = 0; i < nRow; ++i) {
+        SColVal colVal = {0};
+        colVal.cid = pKey->cid;
+        colVal.flag = CV_FLAG_VALUE;
+        colVal.value.type = TSDB_DATA_TYPE_INT;
+        colVal.value.val = testVal(pKey->fid, pKey->offset, pKey->cid, i);
+        ASSERT_EQ(tColDataAppendValue(&colData, &colVal), 0);
+      }
+      EXPECT_EQ(tsdbColCachePutColData(&tsdb, pKey, &colData), 0);
+    }
+    tColDataDestroy(&colData);
+    tBlockDataDestroy(&bData);
+  }
+
+  // read the key part and the columns of a block as a data file reader does, and return the hits and misses of them
+  void readBlock(int32_t fid, int64_t offset, const std::vector<int16_t> &aCid, int64_t *hit, int64_t *miss) {
+    SColCacheKey key = {0};
+    int64_t      hit0, miss0;
+    tsdbColCacheGetStat(&vnode, &hit0, &miss0);
+
+    key.fid = fid;
+    key.commitId = commitId;
+    key.offset = offset;
+    ASSERT_NO_FATAL_FAILURE(readKeyPart(&key));
+    for (int16_t cid : aCid) {
+      key.cid = cid;
+      ASSERT_NO_FATAL_FAILURE(readColData(&key));
+    }
+
+    tsdbColCacheGetStat(&vnode, hit, miss);
+    *hit -= hit0;
+    *miss -= miss0;
+  }
+
+  SVnode vnode = {};
+  STsdb  tsdb = {};
+};
+
+}  // namespace
+
+TEST_F(TsdbColCacheTest, sameBlockHits) {
+  int64_t hit, miss;
+
+  readBlock(1, 4096, {2, 3}, &hit, &miss);
+  EXPECT_EQ(hit, 0);
+  EXPECT_EQ(miss, 3);
+
+  // the content read the second time is checked against the first one
+  readBlock(1, 4096, {2, 3}, &hit, &miss);
+  EXPECT_EQ(hit, 3);
+  EXPECT_EQ(miss, 0);
+
+  readBlock(1, 4096, {3}, &hit, &miss);
+  EXPECT_EQ(hit, 2);
+  EXPECT_EQ(miss, 0);
+}
+
+TEST_F(TsdbColCacheTest, changedKeyMisses) {
+  int64_t hit, miss;
+
+  readBlock(1, 4096, {2}, &hit, &miss);
+  EXPECT_EQ(miss, 2);
+
+  // a block of another file, at another offset of the file, or another column of the block
+  readBlock(2, 4096, {2}, &hit, &miss);
+  EXPECT_EQ(hit, 0);
+  EXPECT_EQ(miss, 2);
+
+  readBlock(1, 8192, {2}, &hit, &miss);
+  EXPECT_EQ(hit, 0);
+  EXPECT_EQ(miss, 2);
+
+  readBlock(1, 4096, {4}, &hit, &miss);
+  EXPECT_EQ(hit, 1);
+  EXPECT_EQ(miss, 1);
+
+  // none of them replaces another
+  for (int32_t fid : {1, 2}) {
+    for (int64_t offset : {4096, 8192}) {
+      if (fid == 2 && offset == 8192) continue;
+      readBlock(fid, offset, {2}, &hit, &miss);
+      EXPECT_EQ(hit, 2) << "fid:" << fid << " offset:" << offset;
+      EXPECT_EQ(miss, 0) << "fid:" << fid << " offset:" << offset;
+    }
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "tsdb.h"
+#include "tsdbDef.h"
+
+// tsdb page-wise file io: consecutive pages are written and read in runs, the content round-trips through STsdbFD
+// whatever the sizes of the calls, and a run that fails to be written is reported by tsdbCloseFile
+
+namespace {
+
+const char   *path = "tsdb_file_io_test.data";
+const int32_t szPage = 4096;
+const int64_t szFile = 4 * 1024 * 1024 + 1234;
+
+uint8_t testByte(int64_t offset, int32_t round) { return (uint8_t)((offset * 7 + round * 31 + 3) & 0xff); }
+
+class TsdbFileIOTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    vnode.config.tsdbPageSize = szPage;
+    tsdb.pVnode = &vnode;
+    taosRemoveFile(path);
+  }
+
+  void TearDown() override { taosRemoveFile(path); }
+
+  void writeRange(STsdbFD *pFD, int64_t start, int64_t end, int32_t szWrite, int32_t round) {
+    std::vector<uint8_t> buf(szWrite);
+    for (int64_t offset = start; offset < end; offset += szWrite) {
+      int32_t n = (int32_t)TMIN(szWrite, end - offset);
+      for (int32_t i = 0; i < n; ++i) {
+        buf[i] = testByte(offset + i, round);
+      }
+      ASSERT_EQ(tsdbWriteFile(pFD, offset, buf.data(), n, 0, NULL), 0) << "offset:" << offset;
+    }
+  }
+
+  // the bytes of [start, end) are of the round, others of round 0
+  void checkRead(STsdbFD *pFD, int32_t szRead, bool random, int64_t start = 0, int64_t end = 0, int32_t round = 0) {
+    std::vector<uint8_t> buf(szRead);
+    uint64_t             seed = 0x9e3779b97f4a7c15ULL;
+    for (int64_t i = 0; i < szFile / szRead; ++i) {
+      int64_t offset = i * szRead;
+      if (random) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        offset = (int64_t)((seed >> 17) % (uint64_t)(szFile - szRead + 1));
+      }
+
+      ASSERT_EQ(tsdbReadFile(pFD, offset, buf.data(), szRead, 0, 0, NULL), 0) << "offset:" << offset;
+      for (int32_t j = 0; j < szRead; ++j) {
+        int64_t o = offset + j;
+        ASSERT_EQ(buf[j], testByte(o, (o >= start && o < end) ? round : 0)) << "offset:" << o << " size:" << szRead;
+      }
+    }
+  }
+
+  void writeFile(int32_t szWrite) {
+    STsdbFD *pFD = NULL;
+    ASSERT_EQ(tsdbOpenFile(path, &tsdb, TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE, &pFD, 0), 0);
+    writeRange(pFD, 0, szFile, szWrite, 0);
+    EXPECT_EQ(tsdbFsyncFile(pFD, 0, NULL), 0);
+    EXPECT_EQ(tsdbCloseFile(&pFD), 0);
+    EXPECT_EQ(pFD, nullptr);
+  }
+
+  SVnode vnode = {};
+  STsdb  tsdb = {};
+};
+
+}  // namespace
+
+TEST_F(TsdbFileIOTest, roundTrip) {
+  // writes of a part of a page, and of many pages, none of them aligned to the page content
+  for (int32_t szWrite : {1000, 100 * 1000}) {
+    ASSERT_NO_FATAL_FAILURE(writeFile(szWrite));
+
+    STsdbFD *pFD = NULL;
+    ASSERT_EQ(tsdbOpenFile(path, &tsdb, TD_FILE_READ, &pFD, 0), 0);
+    // sizes of small, common and large data blocks, read in order and at random
+    for (int32_t szRead : {3000, 48 * 1000, 500 * 1000}) {
+      ASSERT_NO_FATAL_FAILURE(checkRead(pFD, szRead, false));
+      ASSERT_NO_FATAL_FAILURE(checkRead(pFD, szRead, true));
+    }
+    EXPECT_EQ(tsdbCloseFile(&pFD), 0);
+  }
+}
+
+TEST_F(TsdbFileIOTest, readAfterWrite) {
+  ASSERT_NO_FATAL_FAILURE(writeFile(64 * 1000));
+
+  // pages rewritten in the middle of the file are read back before they are synced, from the run or the file
+  STsdbFD *pFD = NULL;
+  int64_t  start = 3 * szPage + 100, end = 40 * szPage + 7;
+  ASSERT_EQ(tsdbOpenFile(path, &tsdb, TD_FILE_READ | TD_FILE_WRITE, &pFD, 0), 0);
+  ASSERT_NO_FATAL_FAILURE(writeRange(pFD, start, end, 5000, 1));
+  ASSERT_NO_FATAL_FAILURE(checkRead(pFD, 48 * 1000, false, start, end, 1));
+  EXPECT_EQ(tsdbFsyncFile(pFD, 0, NULL), 0);
+  EXPECT_EQ(tsdbCloseFile(&pFD), 0);
+
+  ASSERT_EQ(tsdbOpenFile(path, &tsdb, TD_FILE_READ, &pFD, 0), 0);
+  ASSERT_NO_FATAL_FAILURE(checkRead(pFD, 3000, true, start, end, 1));
+  EXPECT_EQ(tsdbCloseFile(&pFD), 0);
+}
+
+TEST_F(TsdbFileIOTest, closeError) {
+  ASSERT_NO_FATAL_FAILURE(writeFile(64 * 1000));
+
+  // the file is opened for read only, so the pages kept in the run fail to be written when it is closed
+  STsdbFD *pFD = NULL;
+  ASSERT_EQ(tsdbOpenFile(path, &tsdb, TD_FILE_READ, &pFD, 0), 0);
+  ASSERT_NO_FATAL_FAILURE(writeRange(pFD, szFile, szFile + 3 * szPage, 1000, 1));
+  EXPECT_NE(tsdbCloseFile(&pFD), 0);
+  EXPECT_EQ(pFD, nullptr);
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "tsdb.h"
+#include "vnd.h"
+
+// rows of a table in memory: the ones after all existing rows are appended to chunks, others are put into the skiplist,
+// and the iterator merges both of them by key and version
+
+namespace {
+
+const tb_uid_t suid = 0;
+const tb_uid_t uid = 10001;
+
+struct SMemTableTestRow {
+  int64_t ts;
+  int64_t version;
+  int32_t val;
+};
+
+SColVal testColVal(int16_t cid, int8_t type, int64_t val) {
+  SColVal colVal = {0};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_VALUE;
+  colVal.value.type = type;
+  colVal.value.val = val;
+  return colVal;
+}
+
+// a memtable of a vnode with no meta and no last row cache, the rows are of a single table of (ts, int)
+class TsdbMemTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SSchema aSchema[2] = {0};
+    aSchema[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aSchema[0].colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aSchema[0].bytes = sizeof(TSKEY);
+    aSchema[1].type = TSDB_DATA_TYPE_INT;
+    aSchema[1].colId = PRIMARYKEY_TIMESTAMP_COL_ID + 1;
+    aSchema[1].bytes = sizeof(int32_t);
+
+    vnode.config.szBuf = 16 * 1024 * 1024;
+    vnode.config.tsdbCfg.slLevel = 5;
+    vnode.config.cacheLast = 0;
+    tsdb.pVnode = &vnode;
+
+    pTSchema = tBuildTSchema(aSchema, 2, 1);
+    ASSERT_NE(pTSchema, nullptr);
+    ASSERT_EQ(vnodeOpenBufPool(&vnode), 0);
+
+    // take a buffer pool as a vnode does when it begins
+    vnode.inUse = vnode.freeList;
+    vnode.inUse->nRef = 1;
+    vnode.freeList = vnode.inUse->freeNext;
+    vnode.inUse->freeNext = NULL;
+
+    ASSERT_EQ(tsdbMemTableCreate(&tsdb, &tsdb.mem), 0);
+  }
+
+  void TearDown() override {
+    if (tsdb.mem) tsdbMemTableDestroy(tsdb.mem, false);
+    vnode.inUse = NULL;
+    vnodeCloseBufPool(&vnode);
+    tDestroyTSchema(pTSchema);
+  }
+
+  void insertRows(int64_t version, const std::vector<int64_t> &aTs, const std::vector<int32_t> &aVal) {
+    SArray       *aRowP = taosArrayInit(aTs.size(), sizeof(SRow *));
+    SArray       *aColVal = taosArrayInit(2, sizeof(SColVal));
+    SSubmitTbData tbData = {0};
+    ASSERT_NE(aRowP, nullptr);
+    ASSERT_NE(aColVal, nullptr);
+
+    for (size_t i = 0; i < aTs.size(); ++i) {
+      SColVal aRowVal[] = {testColVal(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, aTs[i]),
+                           testColVal(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_INT, aVal[i])};
+      SRow   *pRow = NULL;
+
+      taosArrayClear(aColVal);
+      ASSERT_NE(taosArrayPush(aColVal, &aRowVal[0]), nullptr);
+      ASSERT_NE(taosArrayPush(aColVal, &aRowVal[1]), nullptr);
+      ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+      ASSERT_NE(taosArrayPush(aRowP, &pRow), nullptr);
+    }
+
+    tbData.suid = suid;
+    tbData.uid = uid;
+    tbData.sver = 1;
+    tbData.aRowP = aRowP;
+    EXPECT_EQ(tsdbInsertTableData(&tsdb, version, &tbData, NULL), 0);
+
+    for (int32_t i = 0; i < taosArrayGetSize(aRowP); ++i) {
+      tRowDestroy(*(SRow **)taosArrayGet(aRowP, i));
+    }
+    taosArrayDestroy(aRowP);
+    taosArrayDestroy(aColVal);
+  }
+
+  void insertCols(int64_t version, const std::vector<int64_t> &aTs, const std::vector<int32_t> &aVal) {
+    SArray       *aCol = taosArrayInit(2, sizeof(SColData));
+    SSubmitTbData tbData = {0};
+    ASSERT_NE(aCol, nullptr);
+    ASSERT_NE(taosArrayReserve(aCol, 2), nullptr);
+
+    SColData *pTsData = (SColData *)taosArrayGet(aCol, 0);
+    SColData *pValData = (SColData *)taosArrayGet(aCol, 1);
+    tColDataInit(pTsData, PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, 0);
+    tColDataInit(pValData, PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_INT, 0);
+
+    for (size_t i = 0; i < aTs.size(); ++i) {
+      SColVal tsVal = testColVal(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, aTs[i]);
+      SColVal val = testColVal(PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_INT, aVal[i]);
+      EXPECT_EQ(tColDataAppendValue(pTsData, &tsVal), 0);
+      EXPECT_EQ(tColDataAppendValue(pValData, &val), 0);
+    }
+
+    tbData.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT;
+    tbData.suid = suid;
+    tbData.uid = uid;
+    tbData.sver = 1;
+    tbData.aCol = aCol;
+    EXPECT_EQ(tsdbInsertTableData(&tsdb, version, &tbData, NULL), 0);
+
+    taosArrayDestroyEx(aCol, tColDataDestroy);
+  }
+
+  // the rows of a submit are sorted by key, as the vnode does before they are inserted, in row or column format
+  void insert(int64_t version, const std::vector<int64_t> &aTs, bool colFmt = false) {
+    std::vector<int32_t> aVal;
+    for (int64_t ts : aTs) {
+      aVal.push_back((int32_t)(ts * 10 + version));
+      expected.push_back({ts, version, aVal.back()});
+    }
+    if (colFmt) {
+      ASSERT_NO_FATAL_FAILURE(insertCols(version, aTs, aVal));
+    } else {
+      ASSERT_NO_FATAL_FAILURE(insertRows(version, aTs, aVal));
+    }
+  }
+
+  // iterate the table from the key, or from the first or last row if pFrom is NULL
+  std::vector<SMemTableTestRow> scan(const int64_t *pFrom, bool backward) {
+    std::vector<SMemTableTestRow> rows;
+    STbData                      *pTbData = tsdbGetTbDataFromMemTable(tsdb.mem, suid, uid);
+    STbDataIter                   iter = {0};
+    STsdbRowKey                   from = {0};
+    if (pTbData == NULL) return rows;
+
+    from.key.ts = pFrom ? *pFrom : 0;
+    from.version = backward ? INT64_MAX : 0;
+    tsdbTbDataIterOpen(pTbData, pFrom ? &from : NULL, backward, &iter);
+    for (TSDBROW *pRow = tsdbTbDataIterGet(&iter); pRow && rows.size() <= expected.size();
+         pRow = tsdbTbDataIterGet(&iter)) {
+      SColVal colVal;
+      tsdbRowGetColVal(pRow, pTSchema, 1, &colVal);
+      rows.push_back({TSDBROW_TS(pRow), TSDBROW_VERSION(pRow), (int32_t)colVal.value.val});
+      (void)tsdbTbDataIterNext(&iter);
+    }
+    return rows;
+  }
+
+  // rows of the same key are in the order of versions, ascending forward and descending backward
+  void checkScan(const int64_t *pFrom, bool backward) {
+    std::vector<SMemTableTestRow> rows = expected;
+    std::stable_sort(rows.begin(), rows.end(), [](const SMemTableTestRow &a, const SMemTableTestRow &b) {
+      return a.ts != b.ts ? a.ts < b.ts : a.version < b.version;
+    });
+    if (backward) std::reverse(rows.begin(), rows.end());
+    if (pFrom) {
+      rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                [&](const SMemTableTestRow &r) { return backward ? r.ts > *pFrom : r.ts < *pFrom; }),
+                 rows.end());
+    }
+
+    std::vector<SMemTableTestRow> got = scan(pFrom, backward);
+    ASSERT_EQ(got.size(), rows.size()) << "from:" << (pFrom ? *pFrom : -1) << " backward:" << backward;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      ASSERT_EQ(got[i].ts, rows[i].ts) << "row " << i << " backward:" << backward;
+      ASSERT_EQ(got[i].version, rows[i].version) << "row " << i << " ts:" << rows[i].ts << " backward:" << backward;
+      ASSERT_EQ(got[i].val, rows[i].val) << "row " << i;
+    }
+  }
+
+  void checkAllScans(const std::vector<int64_t> &aFrom) {
+    checkScan(NULL, false);
+    checkScan(NULL, true);
+    for (int64_t from : aFrom) {
+      checkScan(&from, false);
+      checkScan(&from, true);
+    }
+  }
+
+  // the rows appended to the chunks and the rows put into the skiplist
+  void count(int64_t *nChunkRow, int64_t *nSkipListRow) {
+    STbData *pTbData = tsdbGetTbDataFromMemTable(tsdb.mem, suid, uid);
+    *nChunkRow = pTbData ? pTbData->nChunkRow : 0;
+    *nSkipListRow = pTbData ? pTbData->sl.size : 0;
+  }
+
+  SVnode                        vnode = {};
+  STsdb                         tsdb = {};
+  STSchema                     *pTSchema = NULL;
+  std::vector<SMemTableTestRow> expected;
+};
+
+std::vector<int64_t> tsRange(int64_t start, int64_t end, int64_t step = 1) {
+  std::vector<int64_t> aTs;
+  for (int64_t ts = start; ts < end; ts += step) {
+    aTs.push_back(ts);
+  }
+  return aTs;
+}
+
+}  // namespace
+
+TEST_F(TsdbMemTableTest, inOrderRows) {
+  // batches of both formats, larger than the largest chunk
+  for (int64_t v = 1; v <= 6; ++v) {
+    insert(v, tsRange((v - 1) * 3000, v * 3000), v % 2 == 0);
+  }
+
+  int64_t nChunkRow, nSkipListRow;
+  count(&nChunkRow, &nSkipListRow);
+  EXPECT_EQ(nChunkRow, 18000);
+  EXPECT_EQ(nSkipListRow, 0);
+
+  checkAllScans({-1, 0, 63, 64, 4095, 4096, 9999, 17999, 18000});
+}
+
+TEST_F(TsdbMemTableTest, outOfOrderRows) {
+  insert(1, tsRange(0, 10000, 2));
+  insert(2, tsRange(1, 10000, 2));
+  insert(3, tsRange(10000, 10100), true);
+  insert(4, {-5, 3, 5001, 10099});
+
+  int64_t nChunkRow, nSkipListRow;
+  count(&nChunkRow, &nSkipListRow);
+  // a row of the last key is newer than the rows in memory, it is appended as well
+  EXPECT_EQ(nChunkRow, 5000 + 1 + 100 + 1);
+  EXPECT_EQ(nSkipListRow, 4999 + 3);
+
+  checkAllScans({-10, -5, 0, 1, 5000, 5001, 9999, 10000, 10099, 10100});
+}
+
+TEST_F(TsdbMemTableTest, duplicateKeys) {
+  insert(1, tsRange(0, 100));
+  // the rows of the keys before the last one go to the skiplist, the versions of the last key are appended
+  insert(2, tsRange(50, 150));
+  insert(3, {0, 99, 149});
+  insert(4, {149}, true);
+  insert(5, tsRange(149, 152), true);
+
+  int64_t nChunkRow, nSkipListRow;
+  count(&nChunkRow, &nSkipListRow);
+  EXPECT_EQ(nChunkRow, 100 + 51 + 1 + 1 + 3);
+  EXPECT_EQ(nSkipListRow, 49 + 2);
+
+  checkAllScans({0, 50, 99, 100, 149, 151});
+}
+
+TEST_F(TsdbMemTableTest, iterateOrder) {
+  // single row submits grow the chunks one row a time, with rows out of order among them
+  uint64_t seed = 0x9e3779b97f4a7c15ULL;
+  int64_t  last = 0;
+  for (int64_t v = 1; v <= 20000; ++v) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    if ((seed >> 60) < 3) {
+      insert(v, {(int64_t)((seed >> 20) % (uint64_t)(last + 1))}, v % 3 == 0);
+    } else {
+      last += (int64_t)((seed >> 40) % 3);
+      insert(v, {last}, v % 3 == 0);
+    }
+  }
+
+  int64_t nChunkRow, nSkipListRow;
+  count(&nChunkRow, &nSkipListRow);
+  EXPECT_EQ(nChunkRow + nSkipListRow, 20000);
+  EXPECT_GT(nChunkRow, 4096);
+  EXPECT_GT(nSkipListRow, 0);
+
+  checkAllScans({0, last / 3, last / 2, last});
+}
@@ -1697,6 +1697,21 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       EXPLAIN_ROW_END();
       QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
 
+      if (pResNode->pExecInfo) {
+        SExplainExecInfo  *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
+        SHashJoinExecInfo *pExecInfo = (SHashJoinExecInfo *)execInfo->verboseInfo;
+        if (pExecInfo && execInfo->verboseLen >= sizeof(SHashJoinExecInfo) && pExecInfo->spillPartitions > 0) {
+          EXPLAIN_ROW_NEW(level + 1, "Spill: ");
+          EXPLAIN_ROW_APPEND("partitions:%d levels:%d", pExecInfo->spillPartitions, pExecInfo->spillLevels + 1);
+          EXPLAIN_ROW_APPEND("  build rows:%" PRId64 " probe rows:%" PRId64, pExecInfo->spillBuildRows,
+                             pExecInfo->spillProbeRows);
+          EXPLAIN_ROW_APPEND("  write:%.2f Mb read:%.2f Mb", pExecInfo->writeBytes / (1024 * 1024.0),
+                             pExecInfo->readBytes / (1024 * 1024.0));
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+      }
+
       if (verbose) {
         EXPLAIN_ROW_NEW(level + 1, EXPLAIN_OUTPUT_FORMAT);
         EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT,
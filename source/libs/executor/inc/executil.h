@@ -220,4 +220,35 @@ SNodeList* makeColsNodeArrFromSortKeys(SNodeList* pSortKeys);
 
 int32_t extractKeysLen(const SArray* keys);
 
+/**
+ * Group keys of a whole data block. The keys of all rows are built column by column and hashed in one pass, then the
+ * rows are assigned to the groups of the block through an open addressing table. The key of a row has the same layout
+ * as the one built by buildKeys.
+ */
+typedef struct SGroupKeyBatch {
+  int32_t   capacity;     // number of rows the buffers can hold
+  int32_t   keyLen;       // max length of one key
+  char*     pKeys;        // key of each row, keyLen bytes apart
+  int32_t*  keyLens;      // length of the key of each row
+  uint32_t* hashes;       // hash value of the key of each row
+  int32_t*  rowGroups;    // group index of each row
+  int32_t*  slots;        // open addressing table of group index + 1, 0 means an empty slot
+  int32_t   slotMask;
+  int32_t   numOfGroups;  // number of distinct keys in the block
+  int32_t   numOfRuns;    // number of runs of identical keys in the block
+  int32_t*  groupRows;    // first row of each group
+  int32_t*  groupCounts;  // number of rows of each group
+  int32_t*  groupStarts;  // start position of each group in index
+  int32_t*  index;        // row indexes grouped by key, the selection vectors of all groups
+} SGroupKeyBatch;
+
+int32_t groupKeyBatchBuild(SGroupKeyBatch* pBatch, const SArray* pGroupCols, int32_t keyLen,
+                           const SSDataBlock* pBlock);
+void    groupKeyBatchPartition(SGroupKeyBatch* pBatch, int32_t numOfRows);
+void    groupKeyBatchCleanup(SGroupKeyBatch* pBatch);
+
+static FORCE_INLINE char* groupKeyBatchGetKey(const SGroupKeyBatch* pBatch, int32_t rowIndex) {
+  return pBatch->pKeys + (int64_t)rowIndex * pBatch->keyLen;
+}
+
 #endif  // TDENGINE_EXECUTIL_H
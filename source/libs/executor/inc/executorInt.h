@@ -35,6 +35,7 @@ extern "C" {
 #include "taosdef.h"
 #include "tarray.h"
 #include "tfill.h"
+#include "tbloomfilter.h"
 #include "thash.h"
 #include "tlockfree.h"
 #include "tmsg.h"
@@ -248,6 +249,27 @@ typedef struct STableMetaCacheInfo {
   uint64_t   cacheHit;
 } STableMetaCacheInfo;
 
+/*
+ * Join keys of the build side of a hash join, handed over to the table scan of the probe side once the hash table is
+ * built. The scan drops the blocks out of the key range by block SMA, and the rows missed by the bloom filter, since
+ * they can never be matched by an inner join.
+ */
+typedef struct SJoinRtFilter {
+  int32_t       slotId;  // slot of the join key in the result block of the scan
+  int8_t        type;
+  int32_t       bytes;
+  bool          hasRange;  // min and max are valid, for integer keys only
+  int64_t       min;
+  int64_t       max;
+  SBloomFilter* pBloom;
+  bool          rowFilter;  // turned off when the bloom filter drops too few rows
+  bool*         pKeep;
+  int32_t       keepCap;
+  int64_t       checkRows;
+  int64_t       filterRows;
+  int64_t       filterBlocks;
+} SJoinRtFilter;
+
 typedef struct STableScanBase {
   STsdbReader*           dataReader;
   SFileBlockLoadRecorder readRecorder;
@@ -263,6 +285,9 @@ typedef struct STableScanBase {
   // there are more than one table list exists in one task, if only one vnode exists.
   STableListInfo* pTableListInfo;
   TsdReader       readerAPI;
+  SJoinRtFilter*  pJoinFilter;
+  SArray*         pFilterColIds;  // SArray<int16_t>, columns of the filter evaluated in the reader, NULL if not pushed down
+  SArray*         pEqualConds;    // SArray<STsdReaderEqualCond>, checked by the reader against the block bloom filters
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -856,6 +881,8 @@ extern void doDestroyExchangeOperatorInfo(void* param);
 
 int32_t doFilterImpl(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo, SColumnInfoData** pResCol);
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+int32_t setTableScanJoinFilter(struct SOperatorInfo* pOperator, SJoinRtFilter* pFilter);
+void    destroyJoinRtFilter(SJoinRtFilter* pFilter);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, SExecTaskInfo* pTask, STableMetaCacheInfo* pCache);
 
@@ -25,6 +25,15 @@ extern "C" {
 #define HJOIN_ROW_BITMAP_SIZE (2 * 1048576)
 #define HJOIN_BLK_THRESHOLD_RATIO 0.9
 
+#define HJOIN_SPILL_PART_BITS 4
+#define HJOIN_SPILL_PART_NUM (1 << HJOIN_SPILL_PART_BITS)
+#define HJOIN_SPILL_MAX_LEVEL 4
+#define HJOIN_SPILL_PAGE_SIZE (256 * 1024)
+#define HJOIN_SPILL_BUF_SIZE (16 * 1048576)
+
+#define HJOIN_RT_FILTER_MAX_KEYS (4 * 1048576)
+#define HJOIN_RT_FILTER_ERROR_RATE 0.01
+
 typedef int32_t (*hJoinImplFp)(SOperatorInfo*);
 
 
@@ -61,6 +70,7 @@ typedef struct SHJoinColInfo {
   int32_t          dstSlot;
   bool             keyCol;
   bool             vardata;
+  int8_t           type;
   int32_t*         offset;
   int32_t          bytes;
   char*            data;
@@ -128,6 +138,42 @@ typedef struct SHJoinExecInfo {
   int64_t expectRows;
 } SHJoinExecInfo;
 
+/*
+ * A partition of both tables once the build table exceeds hashJoinMemThreshold. The build rows are kept as records
+ * of [keyLen][valLen][key][val], the val part in the same format as in the row buffers, and the probe rows as
+ * serialized blocks, both in pages of the spill buffers.
+ */
+typedef struct SHJoinPartition {
+  int32_t      level;        // times the rows are partitioned, the bits of key hash to choose a partition
+  bool         noMatch;      // probe rows out of the table time range, they never match any build row
+  int64_t      buildRows;
+  int64_t      buildSize;
+  int64_t      probeRows;
+  SArray*      pBuildPages;  // SArray<int32_t>
+  SArray*      pProbePages;  // SArray<int32_t>
+  char*        pRecBuf;      // build records not written to a page yet, the first 4 bytes are the length
+  SSDataBlock* pProbeBlk;    // probe rows not written to a page yet
+} SHJoinPartition;
+
+typedef struct SHJoinSpillCtx {
+  bool              spilled;
+  int64_t           memLimit;
+  int64_t           memSize;  // estimated memory of the key hash and the row buffers
+  SDiskbasedBuf*    pBuildBuf;
+  SDiskbasedBuf*    pProbeBuf;
+  int32_t           buildPageSize;
+  int32_t           probePageSize;
+  int32_t           probeBlkRows;  // max rows of a probe block to fit in one page
+  SHJoinPartition*  parts[HJOIN_SPILL_PART_NUM];
+  SHJoinPartition*  pNoMatch;
+  bool              probeSpilled;
+  SArray*           pPending;  // SArray<SHJoinPartition*>, partitions waiting to be joined
+  SHJoinPartition*  pCur;
+  int32_t           probePageIdx;
+  SSDataBlock*      pProbeBlk;  // probe block read back from the spill buffer
+  SHashJoinExecInfo stat;
+} SHJoinSpillCtx;
+
 
 typedef struct SHJoinOperatorInfo {
   EJoinType        joinType;
@@ -149,6 +195,7 @@ typedef struct SHJoinOperatorInfo {
   SHJoinExecInfo   execInfo;
   int32_t          blkThreshold;
   hJoinImplFp      joinFp;  
+  SHJoinSpillCtx   spill;
 } SHJoinOperatorInfo;
 
 
@@ -22,6 +22,7 @@ extern "C" {
 
 #include "os.h"
 #include "tcommon.h"
+#include "tdatablock.h"
 
 enum {
   SORT_MULTISOURCE_MERGE = 0x1,
@@ -47,6 +48,10 @@ typedef struct SSortSource {
   };
   int64_t fetchUs;
   int64_t fetchNum;
+  // sort key prefix of each row in src.pBlock, valid only if keyValid is true
+  SSortKeyPrefix* pKeys;
+  int32_t         keyCapacity;
+  bool            keyValid;
 } SSortSource;
 
 typedef struct SMsortComparParam {
@@ -61,6 +66,10 @@ typedef struct SMsortComparParam {
   int32_t tsOrder;
   __compar_fn_t cmpTsFn;
   void* pPkOrder; // SBlockOrderInfo*
+
+  // compare the sort key prefix of rows before the columns, when sortType != SORT_BLOCK_TS_MERGE
+  bool useSortKey;
+  bool sortKeyComplete;
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -17,7 +17,6 @@
 #include "dataSinkMgt.h"
 #include "executorInt.h"
 #include "planner.h"
-#include "tcompression.h"
 #include "tdatablock.h"
 #include "tglobal.h"
 #include "tqueue.h"
@@ -103,10 +102,13 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
         }
       }
 
+      // the codec is chosen by the scheduler of the query, which is able to decode it
+      int8_t  codec = pHandle->pManager->cfg.compress;
       int32_t dataLen = blockEncode(pInput->pData, pHandle->pCompressBuf, numOfCols);
-      int32_t len = tsCompressString(pHandle->pCompressBuf, dataLen, 1, pEntry->data, pBuf->allocSize, ONE_STAGE_COMP, NULL, 0);
-      if (len < dataLen) {
-        pEntry->compressed = 1;
+      int32_t len = blockCompress(codec, pHandle->pCompressBuf, dataLen, pEntry->data,
+                                  pBuf->allocSize - sizeof(SDataCacheEntry));
+      if (len > 0 && len < dataLen) {
+        pEntry->compressed = codec;
         pEntry->dataLen = len;
         pEntry->rawLen = dataLen;
       } else {  // no need to compress data
@@ -137,7 +139,8 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
     }
   */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  // one more byte for the flag of the lz4 codec, which copies the block after it if the block is not reduced
+  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData) + 1;
 
   pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
   if (pBuf->pData == NULL) {
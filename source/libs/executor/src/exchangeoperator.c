@@ -504,6 +504,7 @@ int32_t doSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTas
     req.taskId = pSource->taskId;
     req.queryId = pTaskInfo->id.queryId;
     req.execId = pSource->execId;
+    req.compress = BLOCK_COMPRESS_COLUMNAR;
     if (pDataInfo->pSrcUidList) {
       int32_t code =
           buildTableScanOperatorParam(&req.pOpParam, pDataInfo->pSrcUidList, pDataInfo->srcOpType, pDataInfo->tableSeq);
@@ -721,7 +722,7 @@ int32_t doExtractResultBlocks(SExchangeInfo* pExchangeInfo, SSourceDataInfo* pDa
 
     pNextStart = pStart + compLen;
     if (pRetrieveRsp->compressed && (compLen < rawLen)) {
-      int32_t t = tsDecompressString(pStart, compLen, 1, pDataInfo->decompBuf, rawLen, ONE_STAGE_COMP, NULL, 0);
+      int32_t t = blockDecompress(pRetrieveRsp->compressed, pStart, compLen, pDataInfo->decompBuf, rawLen);
       ASSERT(t == rawLen);
       pStart = pDataInfo->decompBuf;
     }
@@ -2475,3 +2475,171 @@ int32_t extractKeysLen(const SArray* keys) {
   len += sizeof(int8_t) * keyNum;  // null flag
   return len;
 }
+
+static int32_t groupKeyBatchEnsureCapacity(SGroupKeyBatch* pBatch, int32_t numOfRows, int32_t keyLen) {
+  if (pBatch->capacity >= numOfRows && pBatch->keyLen == keyLen) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  groupKeyBatchCleanup(pBatch);
+
+  int32_t numOfSlots = 2;
+  while (numOfSlots < numOfRows * 2) numOfSlots <<= 1;
+
+  pBatch->pKeys = taosMemoryMalloc((int64_t)numOfRows * keyLen);
+  pBatch->keyLens = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  pBatch->hashes = taosMemoryMalloc(sizeof(uint32_t) * numOfRows);
+  pBatch->rowGroups = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  pBatch->slots = taosMemoryCalloc(numOfSlots, sizeof(int32_t));
+  pBatch->groupRows = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  pBatch->groupCounts = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  pBatch->groupStarts = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  pBatch->index = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  if (pBatch->pKeys == NULL || pBatch->keyLens == NULL || pBatch->hashes == NULL || pBatch->rowGroups == NULL ||
+      pBatch->slots == NULL || pBatch->groupRows == NULL || pBatch->groupCounts == NULL ||
+      pBatch->groupStarts == NULL || pBatch->index == NULL) {
+    groupKeyBatchCleanup(pBatch);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pBatch->capacity = numOfRows;
+  pBatch->keyLen = keyLen;
+  pBatch->slotMask = numOfSlots - 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t groupKeyBatchBuild(SGroupKeyBatch* pBatch, const SArray* pGroupCols, int32_t keyLen,
+                           const SSDataBlock* pBlock) {
+  int32_t numOfRows = pBlock->info.rows;
+  int32_t numOfCols = taosArrayGetSize(pGroupCols);
+
+  int32_t code = groupKeyBatchEnsureCapacity(pBatch, numOfRows, keyLen);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // build the keys column by column, the null flags are at the head of each key
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    pBatch->keyLens[j] = sizeof(int8_t) * numOfCols;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    const SColumn*         pCol = TARRAY_GET_ELEM(pGroupCols, i);
+    const SColumnInfoData* pColInfoData = TARRAY_GET_ELEM(pBlock->pDataBlock, pCol->slotId);
+    char*                  pKey = pBatch->pKeys;
+
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      for (int32_t j = 0; j < numOfRows; ++j, pKey += keyLen) {
+        if (colDataIsNull_var(pColInfoData, j)) {
+          pKey[i] = 1;
+          continue;
+        }
+
+        const char* val = pColInfoData->pData + pColInfoData->varmeta.offset[j];
+        pKey[i] = 0;
+        memcpy(pKey + pBatch->keyLens[j], val, varDataTLen(val));
+        pBatch->keyLens[j] += varDataTLen(val);
+      }
+    } else {
+      int32_t bytes = pCol->bytes;
+      for (int32_t j = 0; j < numOfRows; ++j, pKey += keyLen) {
+        if (pColInfoData->hasNull && colDataIsNull_f(pColInfoData->nullbitmap, j)) {
+          pKey[i] = 1;
+          continue;
+        }
+
+        pKey[i] = 0;
+        memcpy(pKey + pBatch->keyLens[j], pColInfoData->pData + (int64_t)bytes * j, bytes);
+        pBatch->keyLens[j] += bytes;
+      }
+    }
+  }
+
+  // hash all keys in one pass
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    pBatch->hashes[j] = MurmurHash3_32(groupKeyBatchGetKey(pBatch, j), pBatch->keyLens[j]);
+  }
+
+  // assign the rows to the groups, a row identical to the previous one skips the probe
+  memset(pBatch->slots, 0, sizeof(int32_t) * (pBatch->slotMask + 1));
+  pBatch->numOfGroups = 0;
+  pBatch->numOfRuns = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    uint32_t    hash = pBatch->hashes[j];
+    int32_t     len = pBatch->keyLens[j];
+    const char* pKey = groupKeyBatchGetKey(pBatch, j);
+
+    if (j > 0 && hash == pBatch->hashes[j - 1] && len == pBatch->keyLens[j - 1] &&
+        memcmp(pKey, groupKeyBatchGetKey(pBatch, j - 1), len) == 0) {
+      int32_t g = pBatch->rowGroups[j - 1];
+      pBatch->rowGroups[j] = g;
+      pBatch->groupCounts[g] += 1;
+      continue;
+    }
+
+    pBatch->numOfRuns += 1;
+
+    int32_t pos = hash & pBatch->slotMask;
+    while (1) {
+      int32_t g = pBatch->slots[pos] - 1;
+      if (g < 0) {
+        g = pBatch->numOfGroups++;
+        pBatch->slots[pos] = g + 1;
+        pBatch->groupRows[g] = j;
+        pBatch->groupCounts[g] = 1;
+        pBatch->rowGroups[j] = g;
+        break;
+      }
+
+      int32_t r = pBatch->groupRows[g];
+      if (pBatch->hashes[r] == hash && pBatch->keyLens[r] == len &&
+          memcmp(groupKeyBatchGetKey(pBatch, r), pKey, len) == 0) {
+        pBatch->groupCounts[g] += 1;
+        pBatch->rowGroups[j] = g;
+        break;
+      }
+
+      pos = (pos + 1) & pBatch->slotMask;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Stable counting sort of the rows by group, the rows of a group keep their order in the block.
+void groupKeyBatchPartition(SGroupKeyBatch* pBatch, int32_t numOfRows) {
+  int32_t start = 0;
+  for (int32_t g = 0; g < pBatch->numOfGroups; ++g) {
+    pBatch->groupStarts[g] = start;
+    start += pBatch->groupCounts[g];
+  }
+
+  // groupRows is reused as the write cursor of each group
+  for (int32_t g = 0; g < pBatch->numOfGroups; ++g) {
+    pBatch->groupRows[g] = pBatch->groupStarts[g];
+  }
+
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    pBatch->index[pBatch->groupRows[pBatch->rowGroups[j]]++] = j;
+  }
+
+  // restore the first row of each group
+  for (int32_t g = 0; g < pBatch->numOfGroups; ++g) {
+    pBatch->groupRows[g] = pBatch->index[pBatch->groupStarts[g]];
+  }
+}
+
+void groupKeyBatchCleanup(SGroupKeyBatch* pBatch) {
+  taosMemoryFreeClear(pBatch->pKeys);
+  taosMemoryFreeClear(pBatch->keyLens);
+  taosMemoryFreeClear(pBatch->hashes);
+  taosMemoryFreeClear(pBatch->rowGroups);
+  taosMemoryFreeClear(pBatch->slots);
+  taosMemoryFreeClear(pBatch->groupRows);
+  taosMemoryFreeClear(pBatch->groupCounts);
+  taosMemoryFreeClear(pBatch->groupStarts);
+  taosMemoryFreeClear(pBatch->index);
+  pBatch->capacity = 0;
+  pBatch->numOfGroups = 0;
+  pBatch->numOfRuns = 0;
+}
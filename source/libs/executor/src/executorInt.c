@@ -880,8 +880,7 @@ int32_t getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, uint32_t* defaul
 
   // The default buffer for each operator in query is 10MB.
   // at least four pages need to be in buffer
-  // TODO: make this variable to be configurable.
-  *defaultBufsz = 4096 * 2560;
+  *defaultBufsz = tsQueryOperatorBufSize * 1024u;
   if ((*defaultBufsz) <= (*defaultPgsz)) {
     (*defaultBufsz) = (*defaultPgsz) * 4;
     if (*defaultBufsz < ((int64_t)(*defaultPgsz)) * 4) {
@@ -38,6 +38,15 @@ typedef struct SGroupbyOperatorInfo {
   int32_t        groupKeyLen;    // total group by column width
   SGroupResInfo  groupResInfo;
   SExprSupp      scalarSup;
+  bool           batchEnabled;   // group keys of a block are hashed and grouped in batch
+  int32_t        rowModeBlocks;  // number of blocks to be processed row by row before trying the batch again
+  SGroupKeyBatch keyBatch;
+  SSDataBlock*   pGroupedBlock;  // rows of the input block rearranged by group
+  bool           partialAgg;     // partial results may be returned before the input is exhausted
+  bool           passThrough;    // groups are hardly reduced, the results are returned after each input block
+  bool           flushing;       // the results being returned cover only a part of the input
+  int64_t        inputRows;      // rows aggregated since the last flush
+  int32_t        numOfFlushes;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -87,6 +96,8 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  groupKeyBatchCleanup(&pInfo->keyBatch);
+  blockDataDestroy(pInfo->pGroupedBlock);
   taosMemoryFreeClear(param);
 }
 
@@ -272,10 +283,111 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
+#define GROUPBY_BATCH_MIN_ROWS   64
+#define GROUPBY_BATCH_RUN_FACTOR 32  // rows per run of identical keys above which the batch does not pay off
+#define GROUPBY_ROW_MODE_BLOCKS  16
+
+// partial group by whose input rows are less than this times the groups gains little by aggregating
+#define GROUPBY_PARTIAL_MIN_REDUCTION 2
+
+static void doGroupbyAggRange(SOperatorInfo* pOperator, SSDataBlock* pBlock, char* pKey, int32_t keyLen,
+                              int32_t rowIndex, int32_t num) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+
+  int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pKey, keyLen,
+                                        pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+  if (ret != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, ret);
+  }
+
+  applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
+                                  pOperator->exprSupp.numOfExprs);
+  doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+}
+
+static bool groupbyBatchApplicable(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  if (!pInfo->batchEnabled || pBlock->pBlockAgg != NULL || pBlock->info.rows < GROUPBY_BATCH_MIN_ROWS) {
+    return false;
+  }
+
+  if (pInfo->rowModeBlocks > 0) {
+    pInfo->rowModeBlocks -= 1;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * The keys of the whole block are built and hashed in one pass, and each row is assigned to a group of the block.
+ * If the rows of the same group are scattered over the block, the block is rearranged by group, so that the aggregate
+ * functions run once for each group of the block instead of once for each run of identical keys.
+ */
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupKeyBatch*       pBatch = &pInfo->keyBatch;
+  int32_t               rows = pBlock->info.rows;
+
+  int32_t code = groupKeyBatchBuild(pBatch, pInfo->pGroupCols, pInfo->groupKeyLen, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  // long runs of identical keys, e.g. group by tags, are cheaper to be handled row by row
+  if (pBatch->numOfRuns * GROUPBY_BATCH_RUN_FACTOR < rows) {
+    pInfo->rowModeBlocks = GROUPBY_ROW_MODE_BLOCKS;
+  }
+
+  if (pBatch->numOfRuns <= pBatch->numOfGroups * 2) {
+    // the rows of a group are mostly adjacent, apply the functions on each run in place
+    int32_t start = 0;
+    for (int32_t j = 1; j <= rows; ++j) {
+      if (j < rows && pBatch->rowGroups[j] == pBatch->rowGroups[start]) {
+        continue;
+      }
+
+      doGroupbyAggRange(pOperator, pBlock, groupKeyBatchGetKey(pBatch, start), pBatch->keyLens[start], start,
+                        j - start);
+      start = j;
+    }
+    return;
+  }
+
+  groupKeyBatchPartition(pBatch, rows);
+
+  if (pInfo->pGroupedBlock == NULL) {
+    pInfo->pGroupedBlock = createOneDataBlock(pBlock, false);
+    if (pInfo->pGroupedBlock == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+  }
+
+  SSDataBlock* pGrouped = pInfo->pGroupedBlock;
+  code = blockDataGatherRows(pGrouped, pBlock, pBatch->index, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  setInputDataBlock(&pOperator->exprSupp, pGrouped, pInfo->binfo.inputTsOrder, pBlock->info.scanFlag, true);
+  for (int32_t g = 0; g < pBatch->numOfGroups; ++g) {
+    int32_t row = pBatch->groupRows[g];
+    doGroupbyAggRange(pOperator, pGrouped, groupKeyBatchGetKey(pBatch, row), pBatch->keyLens[row],
+                      pBatch->groupStarts[g], pBatch->groupCounts[g]);
+  }
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
+  if (groupbyBatchApplicable(pInfo, pBlock)) {
+    doHashGroupbyAggBatch(pOperator, pBlock);
+    return;
+  }
+
   SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
   int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
   //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
@@ -410,6 +522,48 @@ void doBuildResultDatablockByHash(SOperatorInfo* pOperator, SOptrBasicInfo* pbIn
   }
 }
 
+/*
+ * The partial group by of a super table query is merged again by the upper aggregation, so its results may be sent
+ * before the whole input is aggregated. Once the in-memory pages of the result buffer are used up, the groups are
+ * returned and the buffer is reused instead of being paged to disk. If the input is hardly reduced by the groups, the
+ * results of each input block are returned at once.
+ */
+static bool groupbyPartialShouldFlush(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SDiskbasedBuf*        pBuf = pInfo->aggSup.pResultBuf;
+
+  if (pInfo->passThrough) {
+    return tSimpleHashGetSize(pInfo->aggSup.pResultRowHashTable) > 0;
+  }
+
+  if (getTotalBufSize(pBuf) < (size_t)getNumOfInMemBufPages(pBuf) * getBufPageSize(pBuf)) {
+    return false;
+  }
+
+  int32_t numOfGroups = tSimpleHashGetSize(pInfo->aggSup.pResultRowHashTable);
+  if (pInfo->inputRows < (int64_t)numOfGroups * GROUPBY_PARTIAL_MIN_REDUCTION) {
+    pInfo->passThrough = true;
+    qDebug("%s partial group by turns to pass through, rows:%" PRId64 " groups:%d", GET_TASKID(pOperator->pTaskInfo),
+           pInfo->inputRows, numOfGroups);
+  }
+
+  return true;
+}
+
+static void resetGroupbyPartialResult(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+
+  tSimpleHashClear(pInfo->aggSup.pResultRowHashTable);
+  clearDiskbasedBuf(pInfo->aggSup.pResultBuf);
+  initResultRowInfo(&pInfo->binfo.resultRowInfo);
+  pInfo->aggSup.currentPageId = -1;
+
+  pInfo->inputRows = 0;
+  pInfo->flushing = false;
+  pInfo->numOfFlushes += 1;
+  pOperator->status = OP_OPENED;
+}
+
 static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
   SSDataBlock* pRes = pInfo->binfo.pRes;
@@ -420,6 +574,16 @@ static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
 
     doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
     if (!hasRemainResultByHash(pOperator)) {
+      if (pInfo->flushing) {
+        // go on with the rest of the input
+        resetGroupbyPartialResult(pOperator);
+        break;
+      }
+
+      if (pInfo->numOfFlushes > 0) {
+        qDebug("%s partial group by flushed %d times, pass through:%d", GET_TASKID(pOperator->pTaskInfo),
+               pInfo->numOfFlushes, pInfo->passThrough);
+      }
       setOperatorCompleted(pOperator);
       // clean hash after completed
       tSimpleHashCleanup(pInfo->aggSup.pResultRowHashTable);
@@ -444,10 +608,13 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
 
   SGroupbyOperatorInfo* pInfo = pOperator->info;
   if (pOperator->status == OP_RES_TO_RETURN) {
-    return buildGroupResultDataBlockByHash(pOperator);
+    SSDataBlock* pRes = buildGroupResultDataBlockByHash(pOperator);
+    if (pRes != NULL || pOperator->status == OP_EXEC_DONE) {
+      return pRes;
+    }
   }
   SGroupResInfo* pGroupResInfo = &pInfo->groupResInfo;
-  
+
   int32_t order = pInfo->binfo.inputTsOrder;
   int64_t        st = taosGetTimestampUs();
   SOperatorInfo* downstream = pOperator->pDownstream[0];
@@ -473,6 +640,14 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
     }
 
     doHashGroupbyAgg(pOperator, pBlock);
+
+    if (pInfo->partialAgg) {
+      pInfo->inputRows += pBlock->info.rows;
+      if (groupbyPartialShouldFlush(pOperator)) {
+        pInfo->flushing = true;
+        break;
+      }
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -480,6 +655,7 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
   // initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
   if (pGroupResInfo->pRows != NULL) {
     taosArrayDestroy(pGroupResInfo->pRows);
+    pGroupResInfo->pRows = NULL;
   }
   if (pGroupResInfo->pBuf) {
     taosMemoryFree(pGroupResInfo->pBuf);
@@ -489,8 +665,14 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
   pGroupResInfo->iter = 0;
   pGroupResInfo->dataPos = NULL;
 
-  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
-  return buildGroupResultDataBlockByHash(pOperator);
+  pOperator->cost.openCost += (taosGetTimestampUs() - st) / 1000.0;
+
+  SSDataBlock* pRes = buildGroupResultDataBlockByHash(pOperator);
+  if (pRes == NULL && pOperator->status != OP_EXEC_DONE) {
+    // nothing is left by a partial flush, go on with the rest of the input
+    return hashGroupbyAggregate(pOperator);
+  }
+  return pRes;
 }
 
 SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode* pAggNode, SExecTaskInfo* pTaskInfo) {
@@ -527,6 +709,15 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
     goto _error;
   }
 
+  // json keys are validated row by row
+  pInfo->batchEnabled = true;
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pGroupCols); ++i) {
+    SColumn* pCol = taosArrayGet(pInfo->pGroupCols, i);
+    if (pCol->type == TSDB_DATA_TYPE_JSON) {
+      pInfo->batchEnabled = false;
+    }
+  }
+
   int32_t    num = 0;
   SExprInfo* pExprInfo = createExprInfo(pAggNode->pAggFuncs, pAggNode->pGroupKeys, &num);
   code = initAggSup(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, num, pInfo->groupKeyLen, pTaskInfo->id.str,
@@ -546,6 +737,8 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
   pInfo->binfo.mergeResultBlock = pAggNode->mergeDataBlock;
   pInfo->binfo.inputTsOrder = pAggNode->node.inputTsOrder;
   pInfo->binfo.outputTsOrder = pAggNode->node.outputTsOrder;
+  pInfo->partialAgg = pAggNode->isPartial && pAggNode->node.pConditions == NULL && pAggNode->node.pLimit == NULL &&
+                      pAggNode->node.pSlimit == NULL;
 
   pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, hashGroupbyAggregate, NULL, destroyGroupOperatorInfo,
                                          optrDefaultBufFn, NULL, optrDefaultGetNextExtFn, NULL);
@@ -22,6 +22,7 @@
 #include "querytask.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttypes.h"
@@ -167,6 +168,7 @@ static int32_t hJoinInitKeyColsInfo(SHJoinTableCtx* pTable, SNodeList* pList) {
     SColumnNode* pColNode = (SColumnNode*)pNode;
     pTable->keyCols[i].srcSlot = pColNode->slotId;
     pTable->keyCols[i].vardata = IS_VAR_DATA_TYPE(pColNode->node.resType.type);
+    pTable->keyCols[i].type = pColNode->node.resType.type;
     pTable->keyCols[i].bytes = pColNode->node.resType.bytes;
     bufSize += pColNode->node.resType.bytes;
     ++i;
@@ -748,6 +750,9 @@ static FORCE_INLINE int32_t hJoinGetValBufSize(SHJoinTableCtx* pTable, int32_t r
   int32_t varColNum = taosArrayGetSize(pTable->valVarCols);
   for (int32_t i = 0; i < varColNum; ++i) {
     varColIdx = taosArrayGet(pTable->valVarCols, i);
+    if (-1 == pTable->valCols[*varColIdx].offset[rowIdx]) {
+      continue;
+    }
     char* pData = pTable->valCols[*varColIdx].data + pTable->valCols[*varColIdx].offset[rowIdx];
     bufLen += varDataTLen(pData);
   }
@@ -756,7 +761,7 @@ static FORCE_INLINE int32_t hJoinGetValBufSize(SHJoinTableCtx* pTable, int32_t r
 }
 
 
-static int32_t hJoinAddRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, SHJoinTableCtx* pTable, size_t keyLen, int32_t rowIdx) {
+static int32_t hJoinAddRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, char* pKey, size_t keyLen, int32_t bufSize, char** ppBuf) {
   SGroupData group = {0};
   SBufRowInfo* pRow = NULL;
 
@@ -773,7 +778,7 @@ static int32_t hJoinAddRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGro
     }
   }
 
-  int32_t code = hJoinGetValBufFromPages(pJoin->pRowBufs, hJoinGetValBufSize(pTable, rowIdx), &pTable->valData, pRow);
+  int32_t code = hJoinGetValBufFromPages(pJoin->pRowBufs, bufSize, ppBuf, pRow);
   if (code) {
     taosMemoryFree(pRow);
     return code;
@@ -781,15 +786,18 @@ static int32_t hJoinAddRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGro
 
   if (NULL == pGroup) {
     pRow->next = NULL;
-    if (tSimpleHashPut(pJoin->pKeyHash, pTable->keyData, keyLen, &group, sizeof(group))) {
+    if (tSimpleHashPut(pJoin->pKeyHash, pKey, keyLen, &group, sizeof(group))) {
       taosMemoryFree(pRow);
       return TSDB_CODE_OUT_OF_MEMORY;
     }
+    pJoin->spill.memSize += keyLen + sizeof(group);
   } else {
     pRow->next = pGroup->rows;
     pGroup->rows = pRow;
   }
 
+  pJoin->spill.memSize += sizeof(SBufRowInfo) + bufSize;
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -801,7 +809,7 @@ static int32_t hJoinAddRowToHash(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock,
   }
 
   SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pBuild->keyData, keyLen);
-  code = hJoinAddRowToHashImpl(pJoin, pGroup, pBuild, keyLen, rowIdx);
+  code = hJoinAddRowToHashImpl(pJoin, pGroup, pBuild->keyData, keyLen, hJoinGetValBufSize(pBuild, rowIdx), &pBuild->valData);
   if (code) {
     return code;
   }
@@ -853,6 +861,615 @@ static bool hJoinFilterTimeRange(SSDataBlock* pBlock, STimeWindow* pRange, int32
   return true;
 }
 
+static FORCE_INLINE int32_t hJoinGetPartIdx(const char* pKey, size_t keyLen, int32_t level) {
+  // the high bits of the hash choose the partition, the low bits are left to the key hash
+  uint32_t hashVal = MurmurHash3_32(pKey, keyLen);
+  return (hashVal >> (32 - (level + 1) * HJOIN_SPILL_PART_BITS)) & (HJOIN_SPILL_PART_NUM - 1);
+}
+
+static int32_t hJoinGetMaxRecordSize(SHJoinTableCtx* pTable) {
+  int32_t size = sizeof(int32_t) * 2 + pTable->valBitMapSize;
+  for (int32_t i = 0; i < pTable->keyNum; ++i) {
+    size += pTable->keyCols[i].bytes;
+  }
+  for (int32_t i = 0; i < pTable->valNum; ++i) {
+    if (!pTable->valCols[i].keyCol) {
+      size += pTable->valCols[i].bytes;
+    }
+  }
+
+  return size;
+}
+
+static int32_t hJoinGetBufRowValLen(SHJoinTableCtx* pTable, char* pData) {
+  if (NULL == pData) {
+    return 0;
+  }
+
+  int32_t len = pTable->valBitMapSize;
+  for (int32_t i = 0, m = 0; i < pTable->valNum; ++i) {
+    if (pTable->valCols[i].keyCol) {
+      continue;
+    }
+    if (!colDataIsNull_f(pData, m)) {
+      len += pTable->valCols[i].vardata ? varDataTLen(pData + len) : pTable->valCols[i].bytes;
+    }
+    m++;
+  }
+
+  return len;
+}
+
+static int32_t hJoinResetKeyHash(SHJoinOperatorInfo* pJoin, size_t hashCap) {
+  hJoinDestroyKeyHash(&pJoin->pKeyHash);
+  taosArrayDestroyEx(pJoin->pRowBufs, hJoinFreeBufPage);
+  pJoin->pRowBufs = NULL;
+  pJoin->spill.memSize = 0;
+
+  HJ_ERR_RET(hJoinInitBufPages(pJoin));
+
+  pJoin->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (NULL == pJoin->pKeyHash) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void hJoinDestroyPartition(void* param) {
+  SHJoinPartition* pPart = (SHJoinPartition*)param;
+  if (NULL == pPart) {
+    return;
+  }
+
+  taosArrayDestroy(pPart->pBuildPages);
+  taosArrayDestroy(pPart->pProbePages);
+  taosMemoryFree(pPart->pRecBuf);
+  blockDataDestroy(pPart->pProbeBlk);
+  taosMemoryFree(pPart);
+}
+
+static void hJoinDestroyPartitions(SHJoinPartition** parts) {
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    hJoinDestroyPartition(parts[i]);
+    parts[i] = NULL;
+  }
+}
+
+static int32_t hJoinCreatePartition(SHJoinPartition** ppPart, int32_t level) {
+  SHJoinPartition* pPart = taosMemoryCalloc(1, sizeof(SHJoinPartition));
+  if (NULL == pPart) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pPart->level = level;
+  pPart->pBuildPages = taosArrayInit(4, sizeof(int32_t));
+  pPart->pProbePages = taosArrayInit(4, sizeof(int32_t));
+  if (NULL == pPart->pBuildPages || NULL == pPart->pProbePages) {
+    hJoinDestroyPartition(pPart);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *ppPart = pPart;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinCreatePartitions(SHJoinPartition** parts, int32_t level) {
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    int32_t code = hJoinCreatePartition(&parts[i], level);
+    if (code) {
+      hJoinDestroyPartitions(parts);
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillFlushRecords(SHJoinSpillCtx* pSpill, SHJoinPartition* pPart) {
+  if (NULL == pPart->pRecBuf || *(int32_t*)pPart->pRecBuf <= sizeof(int32_t)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pSpill->pBuildBuf, &pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  memcpy(pPage, pPart->pRecBuf, *(int32_t*)pPart->pRecBuf);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pSpill->pBuildBuf, pPage);
+
+  if (NULL == taosArrayPush(pPart->pBuildPages, &pageId)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *(int32_t*)pPart->pRecBuf = sizeof(int32_t);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillAddRecord(SHJoinSpillCtx* pSpill, SHJoinPartition* pPart, const char* pKey, int32_t keyLen,
+                                   int32_t valLen, char** ppVal) {
+  int32_t recLen = sizeof(int32_t) * 2 + keyLen + valLen;
+  if (recLen + sizeof(int32_t) > pSpill->buildPageSize) {
+    qError("invalid join spill record size:%d, pageSize:%d", recLen, pSpill->buildPageSize);
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  if (NULL == pPart->pRecBuf) {
+    pPart->pRecBuf = taosMemoryMalloc(pSpill->buildPageSize);
+    if (NULL == pPart->pRecBuf) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    *(int32_t*)pPart->pRecBuf = sizeof(int32_t);
+  } else if (*(int32_t*)pPart->pRecBuf + recLen > pSpill->buildPageSize) {
+    HJ_ERR_RET(hJoinSpillFlushRecords(pSpill, pPart));
+  }
+
+  char* pRec = pPart->pRecBuf + *(int32_t*)pPart->pRecBuf;
+  *(int32_t*)pRec = keyLen;
+  *(int32_t*)(pRec + sizeof(int32_t)) = valLen;
+  memcpy(pRec + sizeof(int32_t) * 2, pKey, keyLen);
+  *ppVal = pRec + sizeof(int32_t) * 2 + keyLen;
+
+  *(int32_t*)pPart->pRecBuf += recLen;
+  pPart->buildRows++;
+  pPart->buildSize += recLen;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillFlushProbeRows(SHJoinSpillCtx* pSpill, SHJoinPartition* pPart) {
+  if (NULL == pPart->pProbeBlk || pPart->pProbeBlk->info.rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pSpill->pProbeBuf, &pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  // the rows of the block are limited to fit in one page
+  blockDataToBuf(pPage, pPart->pProbeBlk);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pSpill->pProbeBuf, pPage);
+
+  if (NULL == taosArrayPush(pPart->pProbePages, &pageId)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  blockDataCleanup(pPart->pProbeBlk);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillAddProbeRow(SHJoinSpillCtx* pSpill, SHJoinPartition* pPart, SSDataBlock* pBlock, int32_t rowIdx) {
+  if (NULL == pPart->pProbeBlk) {
+    pPart->pProbeBlk = createOneDataBlock(pBlock, false);
+    if (NULL == pPart->pProbeBlk) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    HJ_ERR_RET(blockDataEnsureCapacity(pPart->pProbeBlk, pSpill->probeBlkRows));
+  } else if (pPart->pProbeBlk->info.rows >= pSpill->probeBlkRows) {
+    HJ_ERR_RET(hJoinSpillFlushProbeRows(pSpill, pPart));
+  }
+
+  SSDataBlock* pDst = pPart->pProbeBlk;
+  int32_t      numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pCol = taosArrayGet(pDst->pDataBlock, i);
+    bool             isNull = colDataIsNull_s(pSrc, rowIdx);
+    HJ_ERR_RET(colDataSetVal(pCol, pDst->info.rows, isNull ? NULL : colDataGetData(pSrc, rowIdx), isNull));
+  }
+
+  pDst->info.rows++;
+  pPart->probeRows++;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillBuildRow(SHJoinOperatorInfo* pJoin, size_t keyLen, int32_t rowIdx) {
+  SHJoinTableCtx*  pBuild = pJoin->pBuild;
+  SHJoinPartition* pPart = pJoin->spill.parts[hJoinGetPartIdx(pBuild->keyData, keyLen, 0)];
+
+  HJ_ERR_RET(hJoinSpillAddRecord(&pJoin->spill, pPart, pBuild->keyData, keyLen, hJoinGetValBufSize(pBuild, rowIdx),
+                                 &pBuild->valData));
+  hJoinCopyValColsDataToBuf(pBuild, rowIdx);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillProbeRows(SHJoinOperatorInfo* pJoin, SHJoinPartition** parts, int32_t level,
+                                   SSDataBlock* pBlock, int32_t startIdx, int32_t endIdx) {
+  SHJoinTableCtx* pProbe = pJoin->pProbe;
+  size_t          keyLen = 0;
+
+  HJ_ERR_RET(hJoinLaunchPrimExpr(pBlock, pProbe, startIdx, endIdx));
+  HJ_ERR_RET(hJoinSetKeyColsData(pBlock, pProbe));
+
+  for (int32_t i = startIdx; i <= endIdx; ++i) {
+    // rows of null keys are skipped by the probe as well
+    if (hJoinCopyKeyColsDataToBuf(pProbe, i, &keyLen)) {
+      continue;
+    }
+
+    int32_t idx = hJoinGetPartIdx(pProbe->keyData, keyLen, level);
+    HJ_ERR_RET(hJoinSpillAddProbeRow(&pJoin->spill, parts[idx], pBlock, i));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillPushPartitions(SHJoinOperatorInfo* pJoin, SHJoinPartition** parts) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  bool            outer = !IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType);
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    SHJoinPartition* pPart = parts[i];
+    if (pPart->probeRows <= 0 || (!outer && pPart->buildRows <= 0)) {
+      continue;
+    }
+
+    HJ_ERR_JRET(hJoinSpillFlushRecords(pSpill, pPart));
+    HJ_ERR_JRET(hJoinSpillFlushProbeRows(pSpill, pPart));
+    taosMemoryFreeClear(pPart->pRecBuf);
+    pPart->pProbeBlk = blockDataDestroy(pPart->pProbeBlk);
+
+    if (NULL == taosArrayPush(pSpill->pPending, &pPart)) {
+      HJ_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+    }
+    parts[i] = NULL;
+  }
+
+_return:
+
+  hJoinDestroyPartitions(parts);
+  return code;
+}
+
+static int32_t hJoinSpillInitProbe(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock, const char* id) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int32_t         numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  // the probe rows of a partition are kept in a block that always fits in one page
+  int32_t rowSize = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    rowSize += pCol->info.bytes + (IS_VAR_DATA_TYPE(pCol->info.type) ? sizeof(int32_t) : 1);
+  }
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+  pSpill->probePageSize = TMAX(HJOIN_SPILL_PAGE_SIZE, getProperSortPageSize(rowSize, numOfCols));
+  pSpill->probeBlkRows = (pSpill->probePageSize - metaSize) / rowSize;
+
+  int32_t code = createDiskbasedBuf(&pSpill->pProbeBuf, pSpill->probePageSize,
+                                    TMAX(HJOIN_SPILL_BUF_SIZE, pSpill->probePageSize * 4), id, tsTempDir);
+  if (code) {
+    return code;
+  }
+
+  pSpill->pProbeBlk = createOneDataBlock(pBlock, false);
+  if (NULL == pSpill->pProbeBlk) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillKeyHash(SHJoinOperatorInfo* pJoin) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  void*           pIte = NULL;
+  int32_t         iter = 0;
+
+  while ((pIte = tSimpleHashIterate(pJoin->pKeyHash, pIte, &iter)) != NULL) {
+    SGroupData*      pGroup = pIte;
+    size_t           keyLen = 0;
+    char*            pKey = tSimpleHashGetKey(pIte, &keyLen);
+    SHJoinPartition* pPart = pSpill->parts[hJoinGetPartIdx(pKey, keyLen, 0)];
+
+    for (SBufRowInfo* pRow = pGroup->rows; pRow; pRow = pRow->next) {
+      char*   pData = hJoinRetrieveColDataFromRowBufs(pJoin->pRowBufs, pRow);
+      int32_t valLen = hJoinGetBufRowValLen(pJoin->pBuild, pData);
+      char*   pVal = NULL;
+      HJ_ERR_RET(hJoinSpillAddRecord(pSpill, pPart, pKey, keyLen, valLen, &pVal));
+      if (valLen > 0) {
+        memcpy(pVal, pData, valLen);
+      }
+    }
+  }
+
+  return hJoinResetKeyHash(pJoin, 1024);
+}
+
+static int32_t hJoinSpillStart(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinSpillCtx*     pSpill = &pJoin->spill;
+  const char*         id = GET_TASKID(pOperator->pTaskInfo);
+
+  if (!osTempSpaceAvailable()) {
+    terrno = TSDB_CODE_NO_DISKSPACE;
+    qError("%s hash join spill failed since %s, tempDir:%s", id, terrstr(), tsTempDir);
+    return terrno;
+  }
+
+  qDebug("%s hash join build table exceeds %" PRId64 " bytes, rows:%" PRId64 ", spill to disk", id,
+         pSpill->memLimit, pJoin->execInfo.buildBlkRows);
+
+  pSpill->buildPageSize = TMAX(HJOIN_SPILL_PAGE_SIZE, hJoinGetMaxRecordSize(pJoin->pBuild) + sizeof(int32_t));
+  int32_t code = createDiskbasedBuf(&pSpill->pBuildBuf, pSpill->buildPageSize,
+                                    TMAX(HJOIN_SPILL_BUF_SIZE, pSpill->buildPageSize * 4), id, tsTempDir);
+  if (code) {
+    return code;
+  }
+
+  pSpill->pPending = taosArrayInit(HJOIN_SPILL_PART_NUM, POINTER_BYTES);
+  if (NULL == pSpill->pPending) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  HJ_ERR_RET(hJoinCreatePartitions(pSpill->parts, 0));
+
+  pSpill->spilled = true;
+
+  return hJoinSpillKeyHash(pJoin);
+}
+
+static int32_t hJoinSpillProbeTable(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinSpillCtx*     pSpill = &pJoin->spill;
+  SHJoinTableCtx*     pProbe = pJoin->pProbe;
+  bool                outer = !IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType);
+
+  while (true) {
+    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pProbe->downStreamIdx);
+    if (NULL == pBlock) {
+      break;
+    }
+
+    pJoin->execInfo.probeBlkNum++;
+    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
+
+    if (NULL == pSpill->pProbeBuf) {
+      HJ_ERR_RET(hJoinSpillInitProbe(pJoin, pBlock, GET_TASKID(pOperator->pTaskInfo)));
+    }
+
+    int32_t startIdx = 0, endIdx = pBlock->info.rows - 1;
+    if (pProbe->hasTimeRange &&
+        !hJoinFilterTimeRange(pBlock, &pJoin->tblTimeRange, pProbe->primCol->srcSlot, &startIdx, &endIdx)) {
+      startIdx = pBlock->info.rows;
+      endIdx = pBlock->info.rows - 1;
+    }
+
+    // the rows out of the time range are output by outer join without being probed
+    if (outer && (startIdx > 0 || endIdx < pBlock->info.rows - 1)) {
+      if (NULL == pSpill->pNoMatch) {
+        HJ_ERR_RET(hJoinCreatePartition(&pSpill->pNoMatch, 0));
+        pSpill->pNoMatch->noMatch = true;
+      }
+      for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+        if (i < startIdx || i > endIdx) {
+          HJ_ERR_RET(hJoinSpillAddProbeRow(pSpill, pSpill->pNoMatch, pBlock, i));
+        }
+      }
+    }
+
+    if (startIdx <= endIdx) {
+      HJ_ERR_RET(hJoinSpillProbeRows(pJoin, pSpill->parts, 0, pBlock, startIdx, endIdx));
+    }
+  }
+
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    pSpill->stat.spillBuildRows += pSpill->parts[i]->buildRows;
+    pSpill->stat.spillProbeRows += pSpill->parts[i]->probeRows;
+  }
+
+  if (pSpill->pNoMatch) {
+    pSpill->stat.spillProbeRows += pSpill->pNoMatch->probeRows;
+    HJ_ERR_RET(hJoinSpillFlushProbeRows(pSpill, pSpill->pNoMatch));
+    pSpill->pNoMatch->pProbeBlk = blockDataDestroy(pSpill->pNoMatch->pProbeBlk);
+    if (NULL == taosArrayPush(pSpill->pPending, &pSpill->pNoMatch)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pSpill->pNoMatch = NULL;
+  }
+
+  return hJoinSpillPushPartitions(pJoin, pSpill->parts);
+}
+
+// split a partition too large to be loaded by more bits of the key hash
+static int32_t hJoinSpillRepartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  SHJoinSpillCtx*  pSpill = &pJoin->spill;
+  SHJoinPartition* parts[HJOIN_SPILL_PART_NUM] = {0};
+  int32_t          level = pPart->level + 1;
+  int32_t          code = TSDB_CODE_SUCCESS;
+
+  HJ_ERR_RET(hJoinCreatePartitions(parts, level));
+
+  int32_t pageNum = taosArrayGetSize(pPart->pBuildPages);
+  for (int32_t i = 0; i < pageNum; ++i) {
+    char* pPage = getBufPage(pSpill->pBuildBuf, *(int32_t*)taosArrayGet(pPart->pBuildPages, i));
+    if (NULL == pPage) {
+      HJ_ERR_JRET(terrno);
+    }
+
+    for (int32_t offset = sizeof(int32_t); offset < *(int32_t*)pPage;) {
+      char*   pRec = pPage + offset;
+      int32_t keyLen = *(int32_t*)pRec;
+      int32_t valLen = *(int32_t*)(pRec + sizeof(int32_t));
+      char*   pKey = pRec + sizeof(int32_t) * 2;
+      char*   pVal = NULL;
+
+      code = hJoinSpillAddRecord(pSpill, parts[hJoinGetPartIdx(pKey, keyLen, level)], pKey, keyLen, valLen, &pVal);
+      if (code) {
+        releaseBufPage(pSpill->pBuildBuf, pPage);
+        HJ_ERR_JRET(code);
+      }
+      memcpy(pVal, pKey + keyLen, valLen);
+      offset += sizeof(int32_t) * 2 + keyLen + valLen;
+    }
+
+    dBufSetBufPageRecycled(pSpill->pBuildBuf, pPage);
+  }
+
+  pageNum = taosArrayGetSize(pPart->pProbePages);
+  for (int32_t i = 0; i < pageNum; ++i) {
+    char* pPage = getBufPage(pSpill->pProbeBuf, *(int32_t*)taosArrayGet(pPart->pProbePages, i));
+    if (NULL == pPage) {
+      HJ_ERR_JRET(terrno);
+    }
+
+    code = blockDataFromBuf(pSpill->pProbeBlk, pPage);
+    dBufSetBufPageRecycled(pSpill->pProbeBuf, pPage);
+    HJ_ERR_JRET(code);
+    HJ_ERR_JRET(hJoinSpillProbeRows(pJoin, parts, level, pSpill->pProbeBlk, 0, pSpill->pProbeBlk->info.rows - 1));
+  }
+
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    // all the rows share one key, it can't be split any more
+    if (parts[i]->buildRows == pPart->buildRows) {
+      parts[i]->level = HJOIN_SPILL_MAX_LEVEL;
+    }
+  }
+
+  pSpill->stat.spillLevels = TMAX(pSpill->stat.spillLevels, level);
+  hJoinDestroyPartition(pPart);
+
+  return hJoinSpillPushPartitions(pJoin, parts);
+
+_return:
+
+  hJoinDestroyPartition(pPart);
+  hJoinDestroyPartitions(parts);
+  return code;
+}
+
+static int32_t hJoinSpillLoadPartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  if (pPart->buildSize > pSpill->memLimit && pPart->level + 1 < HJOIN_SPILL_MAX_LEVEL) {
+    return hJoinSpillRepartition(pJoin, pPart);
+  }
+
+  pSpill->pCur = pPart;
+  pSpill->probePageIdx = 0;
+  pSpill->stat.spillPartitions++;
+
+  HJ_ERR_RET(hJoinResetKeyHash(pJoin, pPart->buildRows > 0 ? pPart->buildRows : 1024));
+
+  int32_t pageNum = taosArrayGetSize(pPart->pBuildPages);
+  for (int32_t i = 0; i < pageNum; ++i) {
+    char* pPage = getBufPage(pSpill->pBuildBuf, *(int32_t*)taosArrayGet(pPart->pBuildPages, i));
+    if (NULL == pPage) {
+      return terrno;
+    }
+
+    for (int32_t offset = sizeof(int32_t); offset < *(int32_t*)pPage;) {
+      char*   pRec = pPage + offset;
+      int32_t keyLen = *(int32_t*)pRec;
+      int32_t valLen = *(int32_t*)(pRec + sizeof(int32_t));
+      char*   pKey = pRec + sizeof(int32_t) * 2;
+      char*   pVal = NULL;
+
+      SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pKey, keyLen);
+      code = hJoinAddRowToHashImpl(pJoin, pGroup, pKey, keyLen, valLen, &pVal);
+      if (code) {
+        releaseBufPage(pSpill->pBuildBuf, pPage);
+        return code;
+      }
+      if (valLen > 0) {
+        memcpy(pVal, pKey + keyLen, valLen);
+      }
+      offset += sizeof(int32_t) * 2 + keyLen + valLen;
+    }
+
+    dBufSetBufPageRecycled(pSpill->pBuildBuf, pPage);
+  }
+
+  qDebug("hash join spilled partition loaded, level:%d, buildRows:%" PRId64 ", probeRows:%" PRId64, pPart->level,
+         pPart->buildRows, pPart->probeRows);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillNextProbeBlock(SHJoinOperatorInfo* pJoin, SSDataBlock** ppBlock) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+
+  while (true) {
+    SHJoinPartition* pCur = pSpill->pCur;
+    if (NULL != pCur && pSpill->probePageIdx < taosArrayGetSize(pCur->pProbePages)) {
+      int32_t* pPageId = taosArrayGet(pCur->pProbePages, pSpill->probePageIdx++);
+      char*    pPage = getBufPage(pSpill->pProbeBuf, *pPageId);
+      if (NULL == pPage) {
+        return terrno;
+      }
+
+      int32_t code = blockDataFromBuf(pSpill->pProbeBlk, pPage);
+      dBufSetBufPageRecycled(pSpill->pProbeBuf, pPage);
+      if (code) {
+        return code;
+      }
+
+      *ppBlock = pSpill->pProbeBlk;
+      return TSDB_CODE_SUCCESS;
+    }
+
+    hJoinDestroyPartition(pCur);
+    pSpill->pCur = NULL;
+
+    if (taosArrayGetSize(pSpill->pPending) <= 0) {
+      *ppBlock = NULL;
+      return TSDB_CODE_SUCCESS;
+    }
+
+    SHJoinPartition* pPart = *(SHJoinPartition**)taosArrayPop(pSpill->pPending);
+    if (pPart->noMatch) {
+      pSpill->pCur = pPart;
+      pSpill->probePageIdx = 0;
+      pSpill->stat.spillPartitions++;
+      continue;
+    }
+
+    HJ_ERR_RET(hJoinSpillLoadPartition(pJoin, pPart));
+  }
+}
+
+static int32_t hJoinGetNextProbeBlock(struct SOperatorInfo* pOperator, SSDataBlock** ppBlock) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinSpillCtx*     pSpill = &pJoin->spill;
+
+  if (!pSpill->spilled) {
+    *ppBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    if (*ppBlock) {
+      pJoin->execInfo.probeBlkNum++;
+      pJoin->execInfo.probeBlkRows += (*ppBlock)->info.rows;
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // all the probe rows are partitioned before any partition is joined
+  if (!pSpill->probeSpilled) {
+    pSpill->probeSpilled = true;
+    HJ_ERR_RET(hJoinSpillProbeTable(pOperator));
+  }
+
+  return hJoinSpillNextProbeBlock(pJoin, ppBlock);
+}
+
+static void hJoinDestroySpillCtx(SHJoinSpillCtx* pSpill) {
+  hJoinDestroyPartitions(pSpill->parts);
+  hJoinDestroyPartition(pSpill->pNoMatch);
+  hJoinDestroyPartition(pSpill->pCur);
+  taosArrayDestroyP(pSpill->pPending, hJoinDestroyPartition);
+  pSpill->pProbeBlk = blockDataDestroy(pSpill->pProbeBlk);
+  destroyDiskbasedBuf(pSpill->pBuildBuf);
+  destroyDiskbasedBuf(pSpill->pProbeBuf);
+  pSpill->pBuildBuf = NULL;
+  pSpill->pProbeBuf = NULL;
+}
+
 static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo* pJoin) {
   SHJoinTableCtx* pBuild = pJoin->pBuild;
   int32_t startIdx = 0, endIdx = pBlock->info.rows - 1;
@@ -867,12 +1484,20 @@ static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo*
     return code;
   }
 
+  if (pJoin->spill.spilled) {
+    HJ_ERR_RET(hJoinSetValColsData(pBlock, pBuild));
+  }
+
   size_t bufLen = 0;
   for (int32_t i = startIdx; i <= endIdx; ++i) {
     if (hJoinCopyKeyColsDataToBuf(pBuild, i, &bufLen)) {
       continue;
     }
-    code = hJoinAddRowToHash(pJoin, pBlock, bufLen, i);
+    if (pJoin->spill.spilled) {
+      code = hJoinSpillBuildRow(pJoin, bufLen, i);
+    } else {
+      code = hJoinAddRowToHash(pJoin, pBlock, bufLen, i);
+    }
     if (code) {
       return code;
     }
@@ -881,6 +1506,59 @@ static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo*
   return code;
 }
 
+static void hJoinPushDownKeyFilter(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinTableCtx*     pBuild = pJoin->pBuild;
+  SHJoinTableCtx*     pProbe = pJoin->pProbe;
+  int32_t             keyNum = tSimpleHashGetSize(pJoin->pKeyHash);
+
+  // only the probe rows of an inner join can be dropped for not being matched, and only by the raw scanned key:
+  // a key computed by a prim expr (e.g. timetruncate) is not the value in the scanned column
+  if (pJoin->spill.spilled || !IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) || 1 != pBuild->keyNum ||
+      keyNum <= 0 || keyNum > HJOIN_RT_FILTER_MAX_KEYS || NULL != pProbe->primExpr || NULL != pBuild->primExpr ||
+      QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN != pProbe->downStream->operatorType) {
+    return;
+  }
+
+  SJoinRtFilter* pFilter = taosMemoryCalloc(1, sizeof(SJoinRtFilter));
+  if (NULL == pFilter) {
+    return;
+  }
+  pFilter->slotId = pProbe->keyCols[0].srcSlot;
+  pFilter->type = pBuild->keyCols[0].type;
+  pFilter->bytes = pBuild->keyCols[0].bytes;
+  pFilter->hasRange = IS_SIGNED_NUMERIC_TYPE(pFilter->type) || IS_TIMESTAMP_TYPE(pFilter->type) ||
+                      (IS_UNSIGNED_NUMERIC_TYPE(pFilter->type) && TSDB_DATA_TYPE_UBIGINT != pFilter->type);
+  pFilter->min = INT64_MAX;
+  pFilter->max = INT64_MIN;
+  pFilter->pBloom = tBloomFilterInit(keyNum + 1, HJOIN_RT_FILTER_ERROR_RATE);
+  if (NULL == pFilter->pBloom) {
+    taosMemoryFree(pFilter);
+    return;
+  }
+
+  int32_t iter = 0;
+  void*   pIte = NULL;
+  while (NULL != (pIte = tSimpleHashIterate(pJoin->pKeyHash, pIte, &iter))) {
+    size_t keyLen = 0;
+    char*  pKey = tSimpleHashGetKey(pIte, &keyLen);
+    tBloomFilterPut(pFilter->pBloom, pKey, keyLen);
+    if (pFilter->hasRange) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pFilter->type, pKey);
+      pFilter->min = TMIN(pFilter->min, v);
+      pFilter->max = TMAX(pFilter->max, v);
+    }
+  }
+
+  if (setTableScanJoinFilter(pProbe->downStream, pFilter)) {
+    destroyJoinRtFilter(pFilter);
+    return;
+  }
+
+  qDebug("%s hash join keys pushed down to probe table scan, keys:%d", GET_TASKID(pOperator->pTaskInfo), keyNum);
+}
+
 static int32_t hJoinBuildHash(struct SOperatorInfo* pOperator, bool* queryDone) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SSDataBlock* pBlock = NULL;
@@ -899,12 +1577,23 @@ static int32_t hJoinBuildHash(struct SOperatorInfo* pOperator, bool* queryDone)
     if (code) {
       return code;
     }
+
+    if (!pJoin->spill.spilled && pJoin->spill.memLimit > 0 && pJoin->spill.memSize > pJoin->spill.memLimit) {
+      code = hJoinSpillStart(pOperator);
+      if (code) {
+        return code;
+      }
+    }
   }
 
-  if (IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) && tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
+  if (!pJoin->spill.spilled && IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) &&
+      tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
     hJoinSetDone(pOperator);
     *queryDone = true;
+    return TSDB_CODE_SUCCESS;
   }
+
+  hJoinPushDownKeyFilter(pOperator);
   
   //qTrace("build table rows:%" PRId64, hJoinGetRowsNumOfKeyHash(pJoin->pKeyHash));
 
@@ -915,7 +1604,14 @@ static int32_t hJoinPrepareStart(struct SOperatorInfo* pOperator, SSDataBlock* p
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableCtx* pProbe = pJoin->pProbe;
   int32_t startIdx = 0, endIdx = pBlock->info.rows - 1;
-  if (pProbe->hasTimeRange && !hJoinFilterTimeRange(pBlock, &pJoin->tblTimeRange, pProbe->primCol->srcSlot, &startIdx, &endIdx)) {
+  bool    inRange = true;
+  if (NULL != pJoin->spill.pCur) {
+    // the rows read back from the spill buffer are filtered by the time range already
+    inRange = !pJoin->spill.pCur->noMatch;
+  } else if (pProbe->hasTimeRange) {
+    inRange = hJoinFilterTimeRange(pBlock, &pJoin->tblTimeRange, pProbe->primCol->srcSlot, &startIdx, &endIdx);
+  }
+  if (!inRange) {
     if (!IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType)) {
       pJoin->ctx.probeEndIdx = -1;
       pJoin->ctx.probePostIdx = 0;
@@ -1017,15 +1713,17 @@ static SSDataBlock* hJoinMainProcess(struct SOperatorInfo* pOperator) {
   }
 
   while (true) {
-    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    SSDataBlock* pBlock = NULL;
+    code = hJoinGetNextProbeBlock(pOperator, &pBlock);
+    if (code) {
+      pTaskInfo->code = code;
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
     if (NULL == pBlock) {
       hJoinSetDone(pOperator);
       break;
     }
 
-    pJoin->execInfo.probeBlkNum++;
-    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
-    
     code = hJoinPrepareStart(pOperator, pBlock);
     if (code) {
       pTaskInfo->code = code;
@@ -1061,7 +1759,14 @@ static void destroyHashJoinOperator(void* param) {
          pJoinOperator->execInfo.buildBlkNum, pJoinOperator->execInfo.buildBlkRows, pJoinOperator->execInfo.probeBlkNum, 
          pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows);
 
+  if (pJoinOperator->spill.spilled) {
+    qDebug("hashJoin spill info, partitions:%d, levels:%d, buildRows:%" PRId64 ", probeRows:%" PRId64,
+           pJoinOperator->spill.stat.spillPartitions, pJoinOperator->spill.stat.spillLevels,
+           pJoinOperator->spill.stat.spillBuildRows, pJoinOperator->spill.stat.spillProbeRows);
+  }
+
   hJoinDestroyKeyHash(&pJoinOperator->pKeyHash);
+  hJoinDestroySpillCtx(&pJoinOperator->spill);
 
   hJoinFreeTableInfo(&pJoinOperator->tbs[0]);
   hJoinFreeTableInfo(&pJoinOperator->tbs[1]);
@@ -1105,6 +1810,30 @@ int32_t hJoinHandleConds(SHJoinOperatorInfo* pJoin, SHashJoinPhysiNode* pJoinNod
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t hJoinGetExplainExecInfo(SOperatorInfo* pOperator, void** pOptrExplain, uint32_t* len) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHashJoinExecInfo*  pInfo = taosMemoryCalloc(1, sizeof(SHashJoinExecInfo));
+  if (NULL == pInfo) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *pInfo = pJoin->spill.stat;
+  if (pJoin->spill.pBuildBuf) {
+    SDiskbasedBufStatis stat = getDBufStatis(pJoin->spill.pBuildBuf);
+    pInfo->writeBytes += stat.flushBytes;
+    pInfo->readBytes += stat.loadBytes;
+  }
+  if (pJoin->spill.pProbeBuf) {
+    SDiskbasedBufStatis stat = getDBufStatis(pJoin->spill.pProbeBuf);
+    pInfo->writeBytes += stat.flushBytes;
+    pInfo->readBytes += stat.loadBytes;
+  }
+
+  *pOptrExplain = pInfo;
+  *len = sizeof(SHashJoinExecInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
 static uint32_t hJoinGetFinBlkCapacity(SHJoinOperatorInfo* pJoin, SHashJoinPhysiNode* pJoinNode) {
   uint32_t maxRows = TMAX(HJOIN_DEFAULT_BLK_ROWS_NUM, HJOIN_BLK_SIZE_LIMIT/pJoinNode->node.pOutputDataBlockDesc->totalRowSize);
   if (INT64_MAX != pJoin->ctx.limit && NULL == pJoin->pFinFilter) {
@@ -1148,6 +1877,7 @@ SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t n
   pInfo->tblTimeRange.ekey = pJoinNode->timeRange.ekey;
   
   pInfo->ctx.limit = pJoinNode->node.pLimit ? ((SLimitNode*)pJoinNode->node.pLimit)->limit : INT64_MAX;
+  pInfo->spill.memLimit = (int64_t)tsHashJoinMemThreshold * 1048576;
 
   setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo, pTaskInfo);
 
@@ -1175,7 +1905,7 @@ SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t n
 
   HJ_ERR_JRET(appendDownstream(pOperator, pDownstream, numOfDownstream));
 
-  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, hJoinMainProcess, NULL, destroyHashJoinOperator, optrDefaultBufFn, NULL, optrDefaultGetNextExtFn, NULL);
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, hJoinMainProcess, NULL, destroyHashJoinOperator, optrDefaultBufFn, hJoinGetExplainExecInfo, optrDefaultGetNextExtFn, NULL);
 
   qDebug("create hash Join operator done");
 
@@ -230,6 +230,131 @@ static bool doFilterByBlockSMA(SFilterInfo* pFilterInfo, SColumnDataAgg* pColsAg
   return keep;
 }
 
+#define JOIN_RT_FILTER_CHECK_ROWS 65536  // rows to check before judging the bloom filter of join keys
+#define JOIN_RT_FILTER_MIN_RATIO  16     // at least 1/16 of the checked rows should be dropped to keep it on
+
+int32_t setTableScanJoinFilter(SOperatorInfo* pOperator, SJoinRtFilter* pFilter) {
+  if (pOperator->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  STableScanInfo*  pInfo = pOperator->info;
+  SColumnInfoData* pCol = taosArrayGet(pInfo->pResBlock->pDataBlock, pFilter->slotId);
+  if (pCol == NULL || pCol->info.type != pFilter->type || pCol->info.bytes != pFilter->bytes) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  destroyJoinRtFilter(pInfo->base.pJoinFilter);
+  pInfo->base.pJoinFilter = pFilter;
+  pFilter->rowFilter = true;
+  qDebug("%s join filter set, slotId:%d, range:%d [%" PRId64 ", %" PRId64 "], keys:%" PRIu64,
+         GET_TASKID(pOperator->pTaskInfo), pFilter->slotId, pFilter->hasRange, pFilter->min, pFilter->max,
+         pFilter->pBloom->size);
+  return TSDB_CODE_SUCCESS;
+}
+
+void destroyJoinRtFilter(SJoinRtFilter* pFilter) {
+  if (pFilter == NULL) {
+    return;
+  }
+
+  qDebug("join filter destroyed, filter out blocks:%" PRId64 ", check rows:%" PRId64 ", filter out rows:%" PRId64,
+         pFilter->filterBlocks, pFilter->checkRows, pFilter->filterRows);
+  tBloomFilterDestroy(pFilter->pBloom);
+  taosMemoryFree(pFilter->pKeep);
+  taosMemoryFree(pFilter);
+}
+
+static bool doFilterByJoinKeyRange(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
+  SJoinRtFilter* pFilter = pTableScanInfo->pJoinFilter;
+  if (!pFilter->hasRange) {
+    return true;
+  }
+
+  if (pBlock->pBlockAgg == NULL) {
+    bool    allColumnsHaveAgg = true;
+    bool    hasNullSMA = false;
+    int32_t code = pTaskInfo->storageAPI.tsdReader.tsdReaderRetrieveBlockSMAInfo(pTableScanInfo->dataReader, pBlock,
+                                                                                   &allColumnsHaveAgg, &hasNullSMA);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+    if (pBlock->pBlockAgg == NULL) {
+      return true;
+    }
+  }
+
+  SColumnDataAgg* pAgg = &pBlock->pBlockAgg[pFilter->slotId];
+  if (pAgg->colId == -1) {
+    return true;
+  }
+
+  // all null keys can not be matched either
+  if (pAgg->numOfNull == pBlock->info.rows) {
+    return false;
+  }
+
+  return pAgg->max >= pFilter->min && pAgg->min <= pFilter->max;
+}
+
+static int32_t doFilterByJoinKeyRows(SJoinRtFilter* pFilter, SSDataBlock* pBlock) {
+  if (!pFilter->rowFilter || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t rows = pBlock->info.rows;
+  if (pFilter->keepCap < rows) {
+    bool* p = taosMemoryRealloc(pFilter->pKeep, rows * sizeof(bool));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pFilter->pKeep = p;
+    pFilter->keepCap = rows;
+  }
+
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pFilter->slotId);
+  SBloomFilter*    pBloom = pFilter->pBloom;
+  bool             isVar = IS_VAR_DATA_TYPE(pCol->info.type);
+  int32_t          numOfKeep = 0;
+
+  for (int32_t i = 0; i < rows; ++i) {
+    if (colDataIsNull_s(pCol, i)) {
+      pFilter->pKeep[i] = false;
+      continue;
+    }
+
+    char*    pKey = colDataGetData(pCol, i);
+    uint32_t len = isVar ? varDataTLen(pKey) : pFilter->bytes;
+    if (pFilter->hasRange) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pCol->info.type, pKey);
+      if (v < pFilter->min || v > pFilter->max) {
+        pFilter->pKeep[i] = false;
+        continue;
+      }
+    }
+
+    uint64_t h1 = (uint64_t)pBloom->hashFn1(pKey, len);
+    uint64_t h2 = (uint64_t)pBloom->hashFn2(pKey, len);
+    pFilter->pKeep[i] = (tBloomFilterNoContain(pBloom, h1, h2) != TSDB_CODE_SUCCESS);
+    numOfKeep += pFilter->pKeep[i];
+  }
+
+  pFilter->checkRows += rows;
+  pFilter->filterRows += rows - numOfKeep;
+  if (numOfKeep < rows) {
+    trimDataBlock(pBlock, rows, pFilter->pKeep);
+  }
+
+  // checking each row costs more than it saves if the keys of the probe side are mostly matched
+  if (pFilter->checkRows >= JOIN_RT_FILTER_CHECK_ROWS &&
+      pFilter->filterRows * JOIN_RT_FILTER_MIN_RATIO < pFilter->checkRows) {
+    pFilter->rowFilter = false;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static bool doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
   SStorageAPI* pAPI = &pTaskInfo->storageAPI;
 
@@ -305,7 +430,7 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   bool loadSMA = false;
   *status = pTableScanInfo->dataBlockLoadFlag;
-  if (pOperator->exprSupp.pFilterInfo != NULL ||
+  if (pOperator->exprSupp.pFilterInfo != NULL || pTableScanInfo->pJoinFilter != NULL ||
       overlapWithTimeWindow(&pTableScanInfo->pdInfo.interval, &pBlock->info, pTableScanInfo->cond.order)) {
     (*status) = FUNC_DATA_REQUIRED_DATA_LOAD;
   }
@@ -365,6 +490,20 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     }
   }
 
+  // try to filter data block according to the join keys of the build side
+  if (pTableScanInfo->pJoinFilter != NULL && (!loadSMA) &&
+      !doFilterByJoinKeyRange(pTableScanInfo, pBlock, pTaskInfo)) {
+    qDebug("%s data block filter out by join keys, brange:%" PRId64 "-%" PRId64 ", rows:%" PRId64,
+           GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+    pCost->filterOutBlocks += 1;
+    pTableScanInfo->pJoinFilter->filterBlocks += 1;
+    (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+    taosMemoryFreeClear(pBlock->pBlockAgg);
+
+    pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+    return TSDB_CODE_SUCCESS;
+  }
+
   // free the sma info, since it should not be involved in later computing process.
   taosMemoryFreeClear(pBlock->pBlockAgg);
 
@@ -416,6 +555,17 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     }
   }
 
+  if (pTableScanInfo->pJoinFilter != NULL && pBlock->info.rows > 0) {
+    int32_t code = doFilterByJoinKeyRows(pTableScanInfo->pJoinFilter, pBlock);
+    if (code != TSDB_CODE_SUCCESS) return code;
+
+    if (pBlock->info.rows == 0) {
+      pCost->filterOutBlocks += 1;
+      qDebug("%s data block filter out by join keys, brange:%" PRId64 "-%" PRId64, GET_TASKID(pTaskInfo),
+             pBlockInfo->window.skey, pBlockInfo->window.ekey);
+    }
+  }
+
   bool limitReached = applyLimitOffset(&pTableScanInfo->limitInfo, pBlock, pTaskInfo);
   if (limitReached) {  // set operator flag is done
     setOperatorCompleted(pOperator);
@@ -1009,6 +1159,309 @@ static SSDataBlock* startNextGroupScan(SOperatorInfo* pOperator) {
   return NULL;
 }
 
+typedef struct SFilterColCollectCxt {
+  SColMatchInfo* pMatchInfo;
+  SArray*        pColIds;
+  bool           valid;
+} SFilterColCollectCxt;
+
+static EDealRes collectFilterColIds(SNode* pNode, void* pContext) {
+  SFilterColCollectCxt* pCxt = pContext;
+
+  if (QUERY_NODE_FUNCTION == nodeType(pNode) && fmIsPseudoColumnFunc(((SFunctionNode*)pNode)->funcId)) {
+    pCxt->valid = false;
+    return DEAL_RES_END;
+  }
+
+  if (QUERY_NODE_COLUMN != nodeType(pNode)) {
+    return DEAL_RES_CONTINUE;
+  }
+
+  // only the columns loaded from the data blocks, tags and pseudo columns are filled after the block is retrieved
+  SColumnNode* pCol = (SColumnNode*)pNode;
+  int32_t      num = taosArrayGetSize(pCxt->pMatchInfo->pList);
+  for (int32_t i = 0; i < num; ++i) {
+    SColMatchItem* pItem = taosArrayGet(pCxt->pMatchInfo->pList, i);
+    if (pItem->dstSlotId != pCol->slotId) {
+      continue;
+    }
+
+    int16_t colId = pItem->colId;
+    for (int32_t j = 0; j < taosArrayGetSize(pCxt->pColIds); ++j) {
+      if (*(int16_t*)taosArrayGet(pCxt->pColIds, j) == colId) {
+        return DEAL_RES_CONTINUE;
+      }
+    }
+
+    if (taosArrayPush(pCxt->pColIds, &colId) == NULL) {
+      pCxt->valid = false;
+      return DEAL_RES_END;
+    }
+    return DEAL_RES_CONTINUE;
+  }
+
+  pCxt->valid = false;
+  return DEAL_RES_END;
+}
+
+static SArray* extractFilterColIds(SNode* pConditions, SColMatchInfo* pMatchInfo) {
+  if (pConditions == NULL) {
+    return NULL;
+  }
+
+  SFilterColCollectCxt cxt = {.pMatchInfo = pMatchInfo, .pColIds = taosArrayInit(4, sizeof(int16_t)), .valid = true};
+  if (cxt.pColIds == NULL) {
+    return NULL;
+  }
+
+  nodesWalkExpr(pConditions, collectFilterColIds, &cxt);
+  if (!cxt.valid || taosArrayGetSize(cxt.pColIds) == 0) {
+    taosArrayDestroy(cxt.pColIds);
+    return NULL;
+  }
+
+  return cxt.pColIds;
+}
+
+static SColMatchItem* getFilterColMatchItem(SColMatchInfo* pMatchInfo, SColumnNode* pCol) {
+  int32_t num = taosArrayGetSize(pMatchInfo->pList);
+  for (int32_t i = 0; i < num; ++i) {
+    SColMatchItem* pItem = taosArrayGet(pMatchInfo->pList, i);
+    if (pItem->dstSlotId == pCol->slotId) {
+      return pItem;
+    }
+  }
+  return NULL;
+}
+
+// convert the constant to the representation of the column type, false if the equality can't be checked by value
+static bool equalCondValueFromNode(SValueNode* pValNode, int8_t colType, SValue* pValue) {
+  int8_t valType = pValNode->node.resType.type;
+  if (pValNode->isNull) {
+    return false;
+  }
+
+  pValue->type = colType;
+  if (colType == TSDB_DATA_TYPE_VARCHAR) {
+    if (valType != TSDB_DATA_TYPE_VARCHAR || pValNode->datum.p == NULL) {
+      return false;
+    }
+
+    pValue->nData = varDataLen(pValNode->datum.p);
+    pValue->pData = taosMemoryMalloc(pValue->nData + 1);
+    if (pValue->pData == NULL) {
+      return false;
+    }
+    memcpy(pValue->pData, varDataVal(pValNode->datum.p), pValue->nData);
+    return true;
+  }
+
+  bool    isUnsigned = IS_UNSIGNED_NUMERIC_TYPE(valType);
+  int64_t v = 0;
+  if (IS_SIGNED_NUMERIC_TYPE(valType) || valType == TSDB_DATA_TYPE_TIMESTAMP) {
+    v = pValNode->datum.i;
+  } else if (isUnsigned) {
+    v = (int64_t)pValNode->datum.u;
+  } else {
+    return false;
+  }
+
+  bool inRange = false;
+  switch (colType) {
+    case TSDB_DATA_TYPE_TINYINT:
+      inRange = !(isUnsigned && v < 0) && v >= INT8_MIN && v <= INT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      inRange = !(isUnsigned && v < 0) && v >= INT16_MIN && v <= INT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      inRange = !(isUnsigned && v < 0) && v >= INT32_MIN && v <= INT32_MAX;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      inRange = !(isUnsigned && v < 0);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      inRange = (isUnsigned || v >= 0) && (uint64_t)v <= UINT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      inRange = (isUnsigned || v >= 0) && (uint64_t)v <= UINT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      inRange = (isUnsigned || v >= 0) && (uint64_t)v <= UINT32_MAX;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      inRange = isUnsigned || v >= 0;
+      break;
+    default:
+      break;
+  }
+
+  pValue->val = v;
+  return inRange;
+}
+
+static void destroyEqualCond(void* p) {
+  STsdReaderEqualCond* pCond = p;
+  if (IS_VAR_DATA_TYPE(pCond->type)) {
+    for (int32_t i = 0; i < taosArrayGetSize(pCond->pValues); ++i) {
+      taosMemoryFree(((SValue*)taosArrayGet(pCond->pValues, i))->pData);
+    }
+  }
+  taosArrayDestroy(pCond->pValues);
+}
+
+static bool addEqualCondValue(STsdReaderEqualCond* pCond, SNode* pNode) {
+  SValue value = {0};
+  if (QUERY_NODE_VALUE != nodeType(pNode) || !equalCondValueFromNode((SValueNode*)pNode, pCond->type, &value)) {
+    return false;
+  }
+
+  if (taosArrayPush(pCond->pValues, &value) == NULL) {
+    taosMemoryFree(IS_VAR_DATA_TYPE(pCond->type) ? value.pData : NULL);
+    return false;
+  }
+  return true;
+}
+
+// "col = value" or "col in (value list)" on a data column
+static int32_t extractEqualCond(SNode* pNode, SColMatchInfo* pMatchInfo, SArray* pConds) {
+  if (QUERY_NODE_OPERATOR != nodeType(pNode)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pNode;
+  SNode*         pLeft = pOper->pLeft;
+  SNode*         pRight = pOper->pRight;
+  if (pOper->opType == OP_TYPE_EQUAL && pRight != NULL && QUERY_NODE_COLUMN == nodeType(pRight)) {
+    TSWAP(pLeft, pRight);
+  }
+
+  if ((pOper->opType != OP_TYPE_EQUAL && pOper->opType != OP_TYPE_IN) || pLeft == NULL || pRight == NULL ||
+      QUERY_NODE_COLUMN != nodeType(pLeft)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColMatchItem* pItem = getFilterColMatchItem(pMatchInfo, (SColumnNode*)pLeft);
+  if (pItem == NULL || pItem->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pOper->opType == OP_TYPE_IN && QUERY_NODE_NODE_LIST != nodeType(pRight)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  STsdReaderEqualCond cond = {.colId = pItem->colId, .type = pItem->dataType.type};
+  cond.pValues = taosArrayInit(4, sizeof(SValue));
+  if (cond.pValues == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  bool valid = true;
+  if (pOper->opType == OP_TYPE_EQUAL) {
+    valid = addEqualCondValue(&cond, pRight);
+  } else {
+    SNode* pVal = NULL;
+    FOREACH(pVal, ((SNodeListNode*)pRight)->pNodeList) {
+      if (!(valid = addEqualCondValue(&cond, pVal))) {
+        break;
+      }
+    }
+  }
+
+  if (!valid || taosArrayGetSize(cond.pValues) == 0 || taosArrayPush(pConds, &cond) == NULL) {
+    destroyEqualCond(&cond);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// the equalities in the conjuncts of the filter, a file block whose bloom filters hold none of the values of any of them
+// is skipped by the reader
+static SArray* extractEqualConds(SNode* pConditions, SColMatchInfo* pMatchInfo) {
+  if (pConditions == NULL) {
+    return NULL;
+  }
+
+  SArray* pConds = taosArrayInit(4, sizeof(STsdReaderEqualCond));
+  if (pConds == NULL) {
+    return NULL;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pConditions) &&
+      ((SLogicConditionNode*)pConditions)->condType == LOGIC_COND_TYPE_AND) {
+    SNode* pNode = NULL;
+    FOREACH(pNode, ((SLogicConditionNode*)pConditions)->pParameterList) {
+      code = extractEqualCond(pNode, pMatchInfo, pConds);
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
+    }
+  } else {
+    code = extractEqualCond(pConditions, pMatchInfo, pConds);
+  }
+
+  if (code != TSDB_CODE_SUCCESS || taosArrayGetSize(pConds) == 0) {
+    taosArrayDestroyEx(pConds, destroyEqualCond);
+    return NULL;
+  }
+
+  return pConds;
+}
+
+// evaluate the filter on the filter columns of a file block in the reader, so the other columns are not decompressed
+// if no rows qualify. The rows are still filtered by doFilter after the block is retrieved.
+static int32_t doTableScanPushdownFilter(SSDataBlock* pBlock, bool* keep, void* param) {
+  SOperatorInfo*     pOperator = param;
+  SFilterColumnParam param1 = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
+  SColumnInfoData*   p = NULL;
+  int32_t            status = 0;
+
+  *keep = true;
+  int32_t code = filterSetDataFromSlotId(pOperator->exprSupp.pFilterInfo, &param1);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = filterExecute(pOperator->exprSupp.pFilterInfo, pBlock, &p, NULL, param1.numOfCols, &status);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    *keep = (status != FILTER_RESULT_NONE_QUALIFIED);
+  }
+
+  colDataDestroy(p);
+  taosMemoryFree(p);
+  return code;
+}
+
+// the same check as the block SMA filter in loadDataBlock, done by the reader before a clean file block is loaded
+static int32_t doTableScanSmaFilter(SColumnDataAgg* pAggs, int32_t numOfAggs, int32_t numOfRows, bool* keep,
+                                    void* param) {
+  SOperatorInfo* pOperator = param;
+
+  *keep = doFilterByBlockSMA(pOperator->exprSupp.pFilterInfo, pAggs, numOfAggs, numOfRows);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void setTableScanPushdownFilter(SOperatorInfo* pOperator) {
+  STableScanInfo* pInfo = pOperator->info;
+  SArray*         pColIds = pInfo->base.pFilterColIds;
+
+  if (pOperator->exprSupp.pFilterInfo == NULL) {
+    return;
+  }
+
+  pInfo->base.readerAPI.tsdSetSmaFilter(pInfo->base.dataReader, doTableScanSmaFilter, pOperator);
+  if (pInfo->base.pEqualConds != NULL) {
+    pInfo->base.readerAPI.tsdSetEqualConds(pInfo->base.dataReader, pInfo->base.pEqualConds);
+  }
+
+  if (pColIds == NULL) {
+    return;
+  }
+
+  pInfo->base.readerAPI.tsdSetFilter(pInfo->base.dataReader, taosArrayGet(pColIds, 0), taosArrayGetSize(pColIds),
+                                     doTableScanPushdownFilter, pOperator);
+}
+
 static SSDataBlock* groupSeqTableScan(SOperatorInfo* pOperator) {
   STableScanInfo* pInfo = pOperator->info;
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
@@ -1036,6 +1489,7 @@ static SSDataBlock* groupSeqTableScan(SOperatorInfo* pOperator) {
     if (pInfo->filesetDelimited) {
       pAPI->tsdReader.tsdSetFilesetDelimited(pInfo->base.dataReader);
     }
+    setTableScanPushdownFilter(pOperator);
     if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
       pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
     }
@@ -1147,6 +1601,12 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
   tableListDestroy(pBase->pTableListInfo);
   taosLRUCacheCleanup(pBase->metaCache.pTableMetaEntryCache);
   cleanupExprSupp(&pBase->pseudoSup);
+  destroyJoinRtFilter(pBase->pJoinFilter);
+  pBase->pJoinFilter = NULL;
+  taosArrayDestroy(pBase->pFilterColIds);
+  pBase->pFilterColIds = NULL;
+  taosArrayDestroyEx(pBase->pEqualConds, destroyEqualCond);
+  pBase->pEqualConds = NULL;
 }
 
 static void destroyTableScanOperatorInfo(void* param) {
@@ -1208,6 +1668,9 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+
+  pInfo->base.pFilterColIds = extractFilterColIds(pTableScanNode->scan.node.pConditions, &pInfo->base.matchInfo);
+  pInfo->base.pEqualConds = extractEqualConds(pTableScanNode->scan.node.pConditions, &pInfo->base.matchInfo);
   
   pInfo->currentGroupId = -1;
 
@@ -81,6 +81,7 @@ struct SSortHandle {
   int64_t          currMergeLimitTs;          
 
   int32_t           sourceId;
+  int32_t           numOfSortThreads;  // threads to sort the in-memory buffer before it is flushed as a sorted run
   SSDataBlock*      pDataBlock;
   SMsortComparParam cmpParam;
   int32_t           numOfCompletedSources;
@@ -249,6 +250,7 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
     pSortHandle->pqMaxRows = pqMaxRows;
   }
   pSortHandle->forceUsePQSort = false;
+  pSortHandle->numOfSortThreads = tsNumOfSortThreads;
 
   if (pBlock != NULL) {
     pSortHandle->pDataBlock = createOneDataBlock(pBlock, false);
@@ -291,6 +293,7 @@ static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
     if (pSource->pageIdList) {
       taosArrayDestroy(pSource->pageIdList);
     }
+    taosMemoryFreeClear(pSource->pKeys);
     taosMemoryFreeClear(pSource);
     cmpParam->pSources[i] = NULL;
   }
@@ -321,6 +324,8 @@ void tsortClearOrderdSource(SArray* pOrderedSource, int64_t *fetchUs, int64_t *f
       (*pSource)->param = NULL;
     }
 
+    taosMemoryFreeClear((*pSource)->pKeys);
+
     if (!(*pSource)->onlyRef && (*pSource)->src.pBlock) {
       blockDataDestroy((*pSource)->src.pBlock);
       (*pSource)->src.pBlock = NULL;
@@ -453,6 +458,52 @@ static void setCurrentSourceDone(SSortSource* pSource, SSortHandle* pHandle) {
   ++pHandle->numOfCompletedSources;
 }
 
+// Encode the sort key prefix of all rows in the block of the source, which has just been loaded.
+static int32_t tsortBuildSourceSortKeys(SMsortComparParam* pParam, SSortSource* pSource) {
+  SSDataBlock* pBlock = pSource->src.pBlock;
+
+  pSource->keyValid = false;
+  if (!pParam->useSortKey || pBlock == NULL || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the null value may only be recorded in the block sma, the column is compared one by one
+  if (pBlock->pBlockAgg != NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pSource->keyCapacity < pBlock->info.rows) {
+    SSortKeyPrefix* p = taosMemoryRealloc(pSource->pKeys, pBlock->info.rows * sizeof(SSortKeyPrefix));
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pSource->pKeys = p;
+    pSource->keyCapacity = pBlock->info.rows;
+  }
+
+  blockDataBuildSortKeys(pBlock, pParam->orderInfo, 0, pBlock->info.rows, pSource->pKeys);
+  pSource->keyValid = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tsortPrepareSortKeys(SMsortComparParam* pParam, SSortHandle* pHandle) {
+  pParam->useSortKey = false;
+  if (pParam->sortType == SORT_BLOCK_TS_MERGE) {
+    return;
+  }
+
+  SSDataBlock* pBlock = pHandle->pDataBlock;
+  for (int32_t i = 0; i < pParam->numOfSources && pBlock == NULL; ++i) {
+    SSortSource* pSource = pParam->pSources[i];
+    pBlock = pSource->src.pBlock;
+  }
+
+  if (pBlock != NULL) {
+    pParam->useSortKey = blockDataSortKeyApplicable(pBlock, pParam->orderInfo, &pParam->sortKeyComplete);
+  }
+}
+
 static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32_t startIndex, int32_t endIndex,
                               SSortHandle* pHandle) {
   pParam->pSources = taosArrayGet(pSources, startIndex);
@@ -502,6 +553,8 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
 
       releaseBufPage(pHandle->pBuf, pPage);
     }
+
+    tsortPrepareSortKeys(pParam, pHandle);
   } else {
     qDebug("start init for the multiway merge sort, %s", pHandle->idStr);
     int64_t st = taosGetTimestampUs();
@@ -516,10 +569,20 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       }
     }
 
+    tsortPrepareSortKeys(pParam, pHandle);
+
     int64_t et = taosGetTimestampUs();
     qDebug("init for merge sort completed, elapsed time:%.2f ms, %s", (et - st) / 1000.0, pHandle->idStr);
   }
 
+  for (int32_t i = 0; i < pParam->numOfSources; ++i) {
+    code = tsortBuildSourceSortKeys(pParam, pParam->pSources[i]);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+      return code;
+    }
+  }
+
   return code;
 }
 
@@ -577,6 +640,11 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
           return code;
         }
         releaseBufPage(pHandle->pBuf, pPage);
+
+        code = tsortBuildSourceSortKeys(&pHandle->cmpParam, pSource);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
       }
     } else {
       int64_t st = taosGetTimestampUs();      
@@ -587,6 +655,11 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         (*numOfCompleted) += 1;
         pSource->src.rowIndex = -1;
         qDebug("adjust merge tree. %d source completed", *numOfCompleted);
+      } else {
+        int32_t code = tsortBuildSourceSortKeys(&pHandle->cmpParam, pSource);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
       }
     }
   }
@@ -731,6 +804,14 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     }
     return ret;
   } else {
+    if (pParam->useSortKey && pLeftSource->keyValid && pRightSource->keyValid) {
+      int32_t ret = sortKeyPrefixCompare(&pLeftSource->pKeys[pLeftSource->src.rowIndex],
+                                         &pRightSource->pKeys[pRightSource->src.rowIndex]);
+      if (ret != 0 || pParam->sortKeyComplete) {
+        return ret;
+      }
+    }
+
     bool isVarType;
     for (int32_t i = 0; i < pInfo->size; ++i) {
       SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
@@ -923,8 +1004,8 @@ static int32_t doInternalMergeSort(SSortHandle* pHandle) {
     pHandle->totalElapsed += el;
 
     SDiskbasedBufStatis statis = getDBufStatis(pHandle->pBuf);
-    qDebug("%s %d round mergesort, elapsed:%" PRId64 " readDisk:%.2f Kb, flushDisk:%.2f Kb", pHandle->idStr, t + 1, el,
-           statis.loadBytes / 1024.0, statis.flushBytes / 1024.0);
+    qDebug("%s %d round mergesort, elapsed:%" PRId64 " readDisk:%.2f Kb, flushDisk:%.2f Kb (raw:%.2f Kb)", pHandle->idStr,
+           t + 1, el, statis.loadBytes / 1024.0, statis.flushBytes / 1024.0, statis.flushRawBytes / 1024.0);
 
     if (pHandle->type == SORT_MULTISOURCE_MERGE) {
       pHandle->type = SORT_SINGLESOURCE_SORT;
@@ -1894,6 +1975,7 @@ static void freeSSortSource(SSortSource* source) {
     blockDataDestroy(source->src.pBlock);
     source->src.pBlock = NULL;
   }
+  taosMemoryFree(source->pKeys);
   taosMemoryFree(source);
 }
 
@@ -1937,7 +2019,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     if (size > sortBufSize) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
-      code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+      code = blockDataSortParallel(pHandle->pDataBlock, pHandle->pSortInfo, pHandle->numOfSortThreads);
       if (code != 0) {
         freeSSortSource(source);
         return code;
@@ -1962,7 +2044,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     // Perform the in-memory sort and then flush data in the buffer into disk.
     int64_t p = taosGetTimestampUs();
 
-    code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+    code = blockDataSortParallel(pHandle->pDataBlock, pHandle->pSortInfo, pHandle->numOfSortThreads);
     if (code != 0) {
       return code;
     }
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+
+#include "executorInt.h"
+#include "tdatablock.h"
+#include "tdef.h"
+#include "thash.h"
+
+namespace {
+
+const int32_t kRows = 4096;
+
+SSDataBlock* createGroupBlock(int32_t rows, int32_t numOfKeys) {
+  SSDataBlock* pBlock = createDataBlock();
+
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE, 2);
+  SColumnInfoData c3 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 3);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataAppendColInfo(pBlock, &c3);
+  blockDataEnsureCapacity(pBlock, rows);
+
+  SColumnInfoData* pCol1 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData* pCol2 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData* pCol3 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+
+  char buf[32] = {0};
+  for (int32_t i = 0; i < rows; ++i) {
+    // interleaved keys, every key appears once in numOfKeys rows
+    int32_t k = (int32_t)((i * 7919LL) % numOfKeys);
+    if (k % 13 == 0) {
+      colDataSetNULL(pCol1, i);
+    } else {
+      colDataSetVal(pCol1, i, (const char*)&k, false);
+    }
+
+    int32_t len = snprintf(varDataVal(buf), 16, "k%d", k % 17);
+    varDataSetLen(buf, len);
+    colDataSetVal(pCol2, i, buf, false);
+
+    int64_t v = i;
+    colDataSetVal(pCol3, i, (const char*)&v, false);
+  }
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+SArray* createGroupCols() {
+  SArray* pGroupCols = taosArrayInit(2, sizeof(SColumn));
+
+  SColumn c1 = {0};
+  c1.slotId = 0;
+  c1.type = TSDB_DATA_TYPE_INT;
+  c1.bytes = sizeof(int32_t);
+  taosArrayPush(pGroupCols, &c1);
+
+  SColumn c2 = {0};
+  c2.slotId = 1;
+  c2.type = TSDB_DATA_TYPE_VARCHAR;
+  c2.bytes = 16 + VARSTR_HEADER_SIZE;
+  taosArrayPush(pGroupCols, &c2);
+  return pGroupCols;
+}
+
+}  // namespace
+
+TEST(groupbyTest, keyBatch) {
+  SSDataBlock* pBlock = createGroupBlock(kRows, 100);
+  SArray*      pGroupCols = createGroupCols();
+  int32_t      keyLen = (int32_t)(sizeof(int32_t) + 16 + VARSTR_HEADER_SIZE + taosArrayGetSize(pGroupCols));
+
+  SGroupKeyBatch batch = {0};
+  ASSERT_EQ(groupKeyBatchBuild(&batch, pGroupCols, keyLen, pBlock), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(batch.numOfGroups, 100);
+  ASSERT_EQ(batch.numOfRuns, kRows);
+
+  // rows of the same group have the same key, and different groups have different keys
+  for (int32_t i = 0; i < kRows; ++i) {
+    int32_t first = batch.groupRows[batch.rowGroups[i]];
+    ASSERT_EQ(batch.keyLens[i], batch.keyLens[first]);
+    ASSERT_EQ(memcmp(groupKeyBatchGetKey(&batch, i), groupKeyBatchGetKey(&batch, first), batch.keyLens[i]), 0);
+  }
+  for (int32_t g = 1; g < batch.numOfGroups; ++g) {
+    int32_t r0 = batch.groupRows[g - 1];
+    int32_t r1 = batch.groupRows[g];
+    ASSERT_TRUE(batch.keyLens[r0] != batch.keyLens[r1] ||
+                memcmp(groupKeyBatchGetKey(&batch, r0), groupKeyBatchGetKey(&batch, r1), batch.keyLens[r0]) != 0);
+  }
+
+  groupKeyBatchPartition(&batch, kRows);
+
+  SSDataBlock* pGrouped = createOneDataBlock(pBlock, false);
+  ASSERT_EQ(blockDataGatherRows(pGrouped, pBlock, batch.index, kRows), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(pGrouped->info.rows, kRows);
+
+  SColumnInfoData* pSrcTs = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+  SColumnInfoData* pDstTs = (SColumnInfoData*)taosArrayGet(pGrouped->pDataBlock, 2);
+  SColumnInfoData* pSrcKey = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData* pDstKey = (SColumnInfoData*)taosArrayGet(pGrouped->pDataBlock, 1);
+  int32_t          total = 0;
+  for (int32_t g = 0; g < batch.numOfGroups; ++g) {
+    ASSERT_EQ(batch.groupStarts[g], total);
+    int64_t prev = -1;
+    for (int32_t j = batch.groupStarts[g]; j < batch.groupStarts[g] + batch.groupCounts[g]; ++j) {
+      int32_t row = batch.index[j];
+      ASSERT_EQ(batch.rowGroups[row], g);
+
+      // the gather is stable, rows of a group keep their order
+      int64_t ts = *(int64_t*)colDataGetData(pDstTs, j);
+      ASSERT_EQ(ts, *(int64_t*)colDataGetData(pSrcTs, row));
+      ASSERT_GT(ts, prev);
+      prev = ts;
+
+      char* pDst = colDataGetData(pDstKey, j);
+      char* pSrc = colDataGetData(pSrcKey, row);
+      ASSERT_EQ(varDataTLen(pDst), varDataTLen(pSrc));
+      ASSERT_EQ(memcmp(pDst, pSrc, varDataTLen(pSrc)), 0);
+    }
+    total += batch.groupCounts[g];
+  }
+  ASSERT_EQ(total, kRows);
+
+  groupKeyBatchCleanup(&batch);
+  blockDataDestroy(pGrouped);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pGroupCols);
+}
+
+TEST(groupbyTest, keyBatchBench) {
+  const int32_t loops = 200;
+  SSDataBlock*  pBlock = createGroupBlock(kRows, 1000);
+  SArray*       pGroupCols = createGroupCols();
+  int32_t       keyLen = (int32_t)(sizeof(int32_t) + 16 + VARSTR_HEADER_SIZE + taosArrayGetSize(pGroupCols));
+
+  // row by row: build the key of each row and look it up in a hash table, as the row path of the group operator
+  SHashObj* pHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  char*     pKey = (char*)taosMemoryCalloc(1, keyLen);
+  int64_t   st = taosGetTimestampUs();
+  for (int32_t n = 0; n < loops; ++n) {
+    for (int32_t i = 0; i < kRows; ++i) {
+      char* p = pKey + taosArrayGetSize(pGroupCols);
+      for (int32_t c = 0; c < taosArrayGetSize(pGroupCols); ++c) {
+        SColumn*         pCol = (SColumn*)taosArrayGet(pGroupCols, c);
+        SColumnInfoData* pColData = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+        pKey[c] = colDataIsNull_s(pColData, i);
+        if (pKey[c]) continue;
+        char* pVal = colDataGetData(pColData, i);
+        int32_t len = IS_VAR_DATA_TYPE(pCol->type) ? varDataTLen(pVal) : pCol->bytes;
+        memcpy(p, pVal, len);
+        p += len;
+      }
+      int32_t len = (int32_t)(p - pKey);
+      if (taosHashGet(pHash, pKey, len) == NULL) {
+        taosHashPut(pHash, pKey, len, &i, sizeof(i));
+      }
+    }
+  }
+  int64_t rowUs = taosGetTimestampUs() - st;
+
+  SGroupKeyBatch batch = {0};
+  st = taosGetTimestampUs();
+  for (int32_t n = 0; n < loops; ++n) {
+    ASSERT_EQ(groupKeyBatchBuild(&batch, pGroupCols, keyLen, pBlock), TSDB_CODE_SUCCESS);
+    groupKeyBatchPartition(&batch, kRows);
+  }
+  int64_t batchUs = taosGetTimestampUs() - st;
+
+  ASSERT_EQ(batch.numOfGroups, (int32_t)taosHashGetSize(pHash));
+  std::cout << "group " << loops * kRows << " rows into " << batch.numOfGroups << " groups, row by row:" << rowUs
+            << "us, batch:" << batchUs << "us" << std::endl;
+
+  groupKeyBatchCleanup(&batch);
+  taosMemoryFree(pKey);
+  taosHashCleanup(pHash);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pGroupCols);
+}
@@ -17,6 +17,8 @@
 #include <tglobal.h>
 #include <tsort.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -393,4 +395,157 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+typedef struct {
+  int32_t      numOfBlocks;
+  int32_t      rows;
+  SSDataBlock* pBlock;
+} SPerfSortSource;
+
+SSDataBlock* getPerfSortBlock(void* param) {
+  SPerfSortSource* pSrc = (SPerfSortSource*)param;
+  if (--pSrc->numOfBlocks < 0) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pSrc->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pSrc->rows);
+
+  SColumnInfoData* pKey = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData* pVal = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  for (int32_t i = 0; i < pSrc->rows; ++i) {
+    int64_t k = ((int64_t)taosRand() << 20) ^ taosRand();
+    double  v = k * 0.5;
+    colDataSetVal(pKey, i, (const char*)&k, false);
+    colDataSetVal(pVal, i, (const char*)&v, false);
+  }
+
+  pBlock->info.rows = pSrc->rows;
+  return pBlock;
+}
+
+// sort the same data set with different number of sort threads, and return the elapsed time in us
+int64_t doPerfSort(int32_t numOfThreads, int32_t numOfBlocks, int32_t rows) {
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_ASC;
+  oi.slotId = 0;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData key = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData val = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 2);
+  blockDataAppendColInfo(pBlock, &key);
+  blockDataAppendColInfo(pBlock, &val);
+
+  SPerfSortSource* pSrc = (SPerfSortSource*)taosMemoryCalloc(1, sizeof(SPerfSortSource));
+  pSrc->numOfBlocks = numOfBlocks;
+  pSrc->rows = rows;
+  pSrc->pBlock = pBlock;
+
+  int32_t oldThreads = tsNumOfSortThreads;
+  tsNumOfSortThreads = numOfThreads;
+  taosSeedRand(1);
+
+  int64_t      st = taosGetTimestampUs();
+  SSortHandle* pHandle =
+      tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 4096, 64, NULL, "sort_perf_test", 0, 0, 0);
+  tsortSetFetchRawDataFp(pHandle, getPerfSortBlock, NULL, NULL);
+
+  SSortSource* ps = (SSortSource*)taosMemoryCalloc(1, sizeof(SSortSource));
+  ps->param = pSrc;
+  tsortAddSource(pHandle, ps);
+  EXPECT_EQ(tsortOpen(pHandle), TSDB_CODE_SUCCESS);
+
+  int64_t total = 0;
+  int64_t prev = INT64_MIN;
+  while (1) {
+    STupleHandle* pTuple = tsortNextTuple(pHandle);
+    if (pTuple == NULL) {
+      break;
+    }
+
+    int64_t k = *(int64_t*)tsortGetValue(pTuple, 0);
+    EXPECT_LE(prev, k);
+    EXPECT_EQ(k * 0.5, *(double*)tsortGetValue(pTuple, 1));
+    prev = k;
+    total += 1;
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  EXPECT_EQ(total, (int64_t)numOfBlocks * rows);
+  tsNumOfSortThreads = oldThreads;
+
+  tsortDestroySortHandle(pHandle);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(orderInfo);
+  return el;
+}
+}  // namespace
+
+TEST(testCase, parallel_sort_perf_test) {
+  int32_t numOfBlocks = 200;
+  int32_t rows = 4096;
+
+  int64_t base = doPerfSort(1, numOfBlocks, rows);
+  printf("sort %d rows, threads:1, elapsed:%.2f ms\n", numOfBlocks * rows, base / 1000.0);
+  // the shared sort thread pool is sized by the first parallel sort, the larger ones go first
+  for (int32_t n = 8; n >= 2; n /= 2) {
+    int64_t el = doPerfSort(n, numOfBlocks, rows);
+    printf("sort %d rows, threads:%d, elapsed:%.2f ms, speedup:%.2f\n", numOfBlocks * rows, n, el / 1000.0,
+           (double)base / el);
+  }
+}
+
+TEST(testCase, parallel_sort_concurrent_test) {
+  int32_t numOfSorts = 4;
+  int32_t numOfThreads = 8;
+  int32_t rows = 100000;
+  int32_t oldThreads = tsNumOfSortThreads;
+  tsNumOfSortThreads = numOfThreads;
+
+  // more workers than the threads of the pool, the ones finding no idle thread are run by their callers
+  std::vector<std::thread> sorts;
+  for (int32_t i = 0; i < numOfSorts; ++i) {
+    sorts.emplace_back([=]() {
+      SSDataBlock*    pBlock = createDataBlock();
+      SColumnInfoData key = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+      SColumnInfoData val = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+      blockDataAppendColInfo(pBlock, &key);
+      blockDataAppendColInfo(pBlock, &val);
+      blockDataEnsureCapacity(pBlock, rows);
+
+      SColumnInfoData* pKey = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+      SColumnInfoData* pVal = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+      for (int32_t j = 0; j < rows; ++j) {
+        int64_t k = (int64_t)(j * 7919 % rows) * numOfSorts + i;
+        colDataSetVal(pKey, j, (const char*)&k, false);
+        colDataSetVal(pVal, j, (const char*)&j, false);
+      }
+      pBlock->info.rows = rows;
+
+      SBlockOrderInfo oi = {0};
+      oi.order = TSDB_ORDER_ASC;
+      oi.slotId = 0;
+      SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+      taosArrayPush(orderInfo, &oi);
+
+      EXPECT_EQ(blockDataSortParallel(pBlock, orderInfo, numOfThreads), TSDB_CODE_SUCCESS);
+      for (int32_t j = 0; j < rows; ++j) {
+        int64_t k = *(int64_t*)colDataGetData(pKey, j);
+        ASSERT_EQ(k, (int64_t)j * numOfSorts + i);
+        ASSERT_EQ((int64_t)(*(int32_t*)colDataGetData(pVal, j)) * 7919 % rows, j) << "sort:" << i;
+      }
+
+      taosArrayDestroy(orderInfo);
+      blockDataDestroy(pBlock);
+    });
+  }
+  for (std::thread& t : sorts) {
+    t.join();
+  }
+  tsNumOfSortThreads = oldThreads;
+}
+
 #pragma GCC diagnostic pop
@@ -74,6 +74,20 @@ extern char* tsMonFwUri;
 //#define ERRORS DNODE_TABLE":errors"
 #define VNODES_NUM DNODE_TABLE":vnodes_num"
 #define MASTERS DNODE_TABLE":masters"
+#define WAL_FSYNC_REQS DNODE_TABLE":wal_fsync_reqs"
+#define WAL_FSYNCS DNODE_TABLE":wal_fsyncs"
+#define WAL_FSYNC_US DNODE_TABLE":wal_fsync_us"
+#define WAL_FSYNC_WAIT_US DNODE_TABLE":wal_fsync_wait_us"
+#define COL_CACHE_HITS DNODE_TABLE":col_cache_hits"
+#define COL_CACHE_MISSES DNODE_TABLE":col_cache_misses"
+#define RPC_COMP_MSGS DNODE_TABLE":rpc_comp_msgs"
+#define RPC_COMP_RAW_BYTES DNODE_TABLE":rpc_comp_raw_bytes"
+#define RPC_COMP_BYTES DNODE_TABLE":rpc_comp_bytes"
+#define RPC_COMP_US DNODE_TABLE":rpc_comp_us"
+#define RPC_DECOMP_MSGS DNODE_TABLE":rpc_decomp_msgs"
+#define RPC_DECOMP_RAW_BYTES DNODE_TABLE":rpc_decomp_raw_bytes"
+#define RPC_DECOMP_BYTES DNODE_TABLE":rpc_decomp_bytes"
+#define RPC_DECOMP_US DNODE_TABLE":rpc_decomp_us"
 #define HAS_MNODE DNODE_TABLE":has_mnode"
 #define HAS_QNODE DNODE_TABLE":has_qnode"
 #define HAS_SNODE DNODE_TABLE":has_snode"
@@ -111,8 +125,12 @@ void monInitMonitorFW(){
                            MEM_TOTAL, DISK_ENGINE, DISK_USED, DISK_TOTAL, NET_IN,
                            NET_OUT, IO_READ, IO_WRITE, IO_READ_DISK, IO_WRITE_DISK, /*ERRORS,*/
                            VNODES_NUM, MASTERS, HAS_MNODE, HAS_QNODE, HAS_SNODE,
-                           DNODE_LOG_ERROR, DNODE_LOG_INFO, DNODE_LOG_DEBUG, DNODE_LOG_TRACE};
-  for(int32_t i = 0; i < 25; i++){
+                           DNODE_LOG_ERROR, DNODE_LOG_INFO, DNODE_LOG_DEBUG, DNODE_LOG_TRACE,
+                           WAL_FSYNC_REQS, WAL_FSYNCS, WAL_FSYNC_US, WAL_FSYNC_WAIT_US,
+                           COL_CACHE_HITS, COL_CACHE_MISSES,
+                           RPC_COMP_MSGS, RPC_COMP_RAW_BYTES, RPC_COMP_BYTES, RPC_COMP_US,
+                           RPC_DECOMP_MSGS, RPC_DECOMP_RAW_BYTES, RPC_DECOMP_BYTES, RPC_DECOMP_US};
+  for(int32_t i = 0; i < 39; i++){
     gauge= taos_gauge_new(dnodes_gauges[i], "",  dnodes_label_count, dnodes_sample_labels);
     if(taos_collector_registry_register_metric(gauge) == 1){
       taos_counter_destroy(gauge);
@@ -457,6 +475,48 @@ void monGenDnodeInfoTable(SMonInfo *pMonitor) {
   metric = taosHashGet(tsMonitor.metrics, MASTERS, strlen(MASTERS));
   taos_gauge_set(*metric, pStat->masterNum, sample_labels);
 
+  metric = taosHashGet(tsMonitor.metrics, WAL_FSYNC_REQS, strlen(WAL_FSYNC_REQS));
+  taos_gauge_set(*metric, pStat->walFsyncReqs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, WAL_FSYNCS, strlen(WAL_FSYNCS));
+  taos_gauge_set(*metric, pStat->walFsyncs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, WAL_FSYNC_US, strlen(WAL_FSYNC_US));
+  taos_gauge_set(*metric, pStat->walFsyncUs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, WAL_FSYNC_WAIT_US, strlen(WAL_FSYNC_WAIT_US));
+  taos_gauge_set(*metric, pStat->walFsyncWaitUs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, COL_CACHE_HITS, strlen(COL_CACHE_HITS));
+  taos_gauge_set(*metric, pStat->colCacheHits, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, COL_CACHE_MISSES, strlen(COL_CACHE_MISSES));
+  taos_gauge_set(*metric, pStat->colCacheMisses, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_COMP_MSGS, strlen(RPC_COMP_MSGS));
+  taos_gauge_set(*metric, pInfo->rpc_comp_msgs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_COMP_RAW_BYTES, strlen(RPC_COMP_RAW_BYTES));
+  taos_gauge_set(*metric, pInfo->rpc_comp_raw_bytes, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_COMP_BYTES, strlen(RPC_COMP_BYTES));
+  taos_gauge_set(*metric, pInfo->rpc_comp_bytes, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_COMP_US, strlen(RPC_COMP_US));
+  taos_gauge_set(*metric, pInfo->rpc_comp_us, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_DECOMP_MSGS, strlen(RPC_DECOMP_MSGS));
+  taos_gauge_set(*metric, pInfo->rpc_decomp_msgs, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_DECOMP_RAW_BYTES, strlen(RPC_DECOMP_RAW_BYTES));
+  taos_gauge_set(*metric, pInfo->rpc_decomp_raw_bytes, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_DECOMP_BYTES, strlen(RPC_DECOMP_BYTES));
+  taos_gauge_set(*metric, pInfo->rpc_decomp_bytes, sample_labels);
+
+  metric = taosHashGet(tsMonitor.metrics, RPC_DECOMP_US, strlen(RPC_DECOMP_US));
+  taos_gauge_set(*metric, pInfo->rpc_decomp_us, sample_labels);
+
   metric = taosHashGet(tsMonitor.metrics, HAS_MNODE, strlen(HAS_MNODE));
   taos_gauge_set(*metric, pInfo->has_mnode, sample_labels);
 
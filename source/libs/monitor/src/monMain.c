@@ -438,6 +438,20 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
+  tjsonAddDoubleToObject(pJson, "wal_fsync_reqs", pStat->walFsyncReqs);
+  tjsonAddDoubleToObject(pJson, "wal_fsyncs", pStat->walFsyncs);
+  tjsonAddDoubleToObject(pJson, "wal_fsync_us", pStat->walFsyncUs);
+  tjsonAddDoubleToObject(pJson, "wal_fsync_wait_us", pStat->walFsyncWaitUs);
+  tjsonAddDoubleToObject(pJson, "col_cache_hits", pStat->colCacheHits);
+  tjsonAddDoubleToObject(pJson, "col_cache_misses", pStat->colCacheMisses);
+  tjsonAddDoubleToObject(pJson, "rpc_comp_msgs", pInfo->rpc_comp_msgs);
+  tjsonAddDoubleToObject(pJson, "rpc_comp_raw_bytes", pInfo->rpc_comp_raw_bytes);
+  tjsonAddDoubleToObject(pJson, "rpc_comp_bytes", pInfo->rpc_comp_bytes);
+  tjsonAddDoubleToObject(pJson, "rpc_comp_us", pInfo->rpc_comp_us);
+  tjsonAddDoubleToObject(pJson, "rpc_decomp_msgs", pInfo->rpc_decomp_msgs);
+  tjsonAddDoubleToObject(pJson, "rpc_decomp_raw_bytes", pInfo->rpc_decomp_raw_bytes);
+  tjsonAddDoubleToObject(pJson, "rpc_decomp_bytes", pInfo->rpc_decomp_bytes);
+  tjsonAddDoubleToObject(pJson, "rpc_decomp_us", pInfo->rpc_decomp_us);
   tjsonAddDoubleToObject(pJson, "has_mnode", pInfo->has_mnode);
   tjsonAddDoubleToObject(pJson, "has_qnode", pInfo->has_qnode);
   tjsonAddDoubleToObject(pJson, "has_snode", pInfo->has_snode);
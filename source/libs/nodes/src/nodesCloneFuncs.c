@@ -131,6 +131,7 @@ static int32_t columnDefNodeCopy(const SColumnDefNode* pSrc, SColumnDefNode* pDs
   COPY_CHAR_ARRAY_FIELD(colName);
   COPY_OBJECT_FIELD(dataType, sizeof(SDataType));
   COPY_SCALAR_FIELD(sma);;
+  COPY_SCALAR_FIELD(bloomFilter);
   CLONE_NODE_FIELD(pOptions);
   return TSDB_CODE_SUCCESS;
 }
@@ -534,6 +535,7 @@ static int32_t logicAggCopy(const SAggLogicNode* pSrc, SAggLogicNode* pDst) {
   COPY_SCALAR_FIELD(isGroupTb);
   COPY_SCALAR_FIELD(isPartTb);
   COPY_SCALAR_FIELD(hasGroup);
+  COPY_SCALAR_FIELD(isPartial);
   return TSDB_CODE_SUCCESS;
 }
 
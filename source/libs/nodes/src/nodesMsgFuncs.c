@@ -2856,6 +2856,7 @@ enum {
   PHY_AGG_CODE_MERGE_DATA_BLOCK,
   PHY_AGG_CODE_GROUP_KEY_OPTIMIZE,
   PHY_AGG_CODE_HAS_COUNT_LIKE_FUNCS,
+  PHY_AGG_CODE_IS_PARTIAL,
 };
 
 static int32_t physiAggNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
@@ -2880,6 +2881,9 @@ static int32_t physiAggNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeBool(pEncoder, PHY_AGG_CODE_HAS_COUNT_LIKE_FUNCS, pNode->hasCountLikeFunc);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeBool(pEncoder, PHY_AGG_CODE_IS_PARTIAL, pNode->isPartial);
+  }
 
   return code;
 }
@@ -2912,6 +2916,9 @@ static int32_t msgToPhysiAggNode(STlvDecoder* pDecoder, void* pObj) {
       case PHY_AGG_CODE_HAS_COUNT_LIKE_FUNCS:
         code = tlvDecodeBool(pTlv, &pNode->hasCountLikeFunc);
         break;
+      case PHY_AGG_CODE_IS_PARTIAL:
+        code = tlvDecodeBool(pTlv, &pNode->isPartial);
+        break;
       default:
         break;
     }
@@ -7434,6 +7434,9 @@ static int32_t columnDefNodeToField(SNodeList* pList, SArray** pArray, bool calB
     if (pCol->sma) {
       field.flags |= COL_SMA_ON;
     }
+    if (pCol->bloomFilter) {
+      field.flags |= COL_BLOOM_ON;
+    }
     if (pCol->pOptions && ((SColumnOptions*)pCol->pOptions)->bPrimaryKey) {
       field.flags |= COL_IS_KEY;
     }
@@ -7486,6 +7489,8 @@ static int32_t checkTableSmaOption(STranslateContext* pCxt, SCreateTableStmt* pS
       }
       pSmaCol->node.resType = pColDef->dataType;
       pColDef->sma = true;
+      // all the columns have sma by default, only the ones listed get the block bloom filters
+      pColDef->bloomFilter = true;
     }
   }
   return TSDB_CODE_SUCCESS;
@@ -7849,6 +7854,9 @@ static void toSchema(const SColumnDefNode* pCol, col_id_t colId, SSchema* pSchem
   if (pCol->sma) {
     flags |= COL_SMA_ON;
   }
+  if (pCol->bloomFilter) {
+    flags |= COL_BLOOM_ON;
+  }
   if (pCol->pOptions && ((SColumnOptions*)pCol->pOptions)->bPrimaryKey) {
     flags |= COL_IS_KEY;
   }
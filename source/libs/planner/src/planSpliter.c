@@ -1012,6 +1012,7 @@ static int32_t stbSplCreatePartAggNode(SAggLogicNode* pMergeAgg, SLogicNode** pO
   }
 
   pPartAgg->node.groupAction = GROUP_ACTION_KEEP;
+  pPartAgg->isPartial = true;
 
   int32_t code = TSDB_CODE_SUCCESS;
 
@@ -174,17 +174,25 @@ void destroyAhandle(void *ahandle) {
   destroySendMsgInfo(pSendInfo);
 }
 
+// the body of a submit is handed over to the rpc as a segment, so the rows are written out without another copy
+static bool asyncSendMsgBySeg(SMsgSendInfo* pInfo) {
+  return pInfo->msgType == TDMT_VND_SUBMIT && pInfo->msgInfo.pData != NULL && pInfo->msgInfo.len > 0;
+}
+
 int32_t asyncSendMsgToServerExt(void* pTransporter, SEpSet* epSet, int64_t* pTransporterId, SMsgSendInfo* pInfo,
                                 bool persistHandle, void* rpcCtx) {
-  char* pMsg = rpcMallocCont(pInfo->msgInfo.len);
-  if (NULL == pMsg) {
+  bool        bySeg = asyncSendMsgBySeg(pInfo);
+  char*       pMsg = rpcMallocCont(bySeg ? 0 : pInfo->msgInfo.len);
+  SRpcMsgSeg* pSeg = bySeg ? taosMemoryMalloc(sizeof(SRpcMsgSeg)) : NULL;
+  if (NULL == pMsg || (bySeg && NULL == pSeg)) {
     qError("0x%" PRIx64 " msg:%s malloc failed", pInfo->requestId, TMSG_INFO(pInfo->msgType));
+    rpcFreeCont(pMsg);
+    taosMemoryFree(pSeg);
     destroySendMsgInfo(pInfo);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return terrno;
   }
 
-  memcpy(pMsg, pInfo->msgInfo.pData, pInfo->msgInfo.len);
   SRpcMsg rpcMsg = {
     .msgType = pInfo->msgType,
     .pCont = pMsg,
@@ -194,6 +202,16 @@ int32_t asyncSendMsgToServerExt(void* pTransporter, SEpSet* epSet, int64_t* pTra
     .info.persistHandle = persistHandle,
     .code = 0
   };
+  if (bySeg) {
+    pSeg->pData = pInfo->msgInfo.pData;
+    pSeg->len = pInfo->msgInfo.len;
+    pInfo->msgInfo.pData = NULL;
+    rpcMsg.contLen = 0;
+    rpcMsg.pSegs = pSeg;
+    rpcMsg.numOfSegs = 1;
+  } else {
+    memcpy(pMsg, pInfo->msgInfo.pData, pInfo->msgInfo.len);
+  }
   TRACE_SET_ROOTID(&rpcMsg.info.traceId, pInfo->requestId);
   int code = rpcSendRequestWithCtx(pTransporter, epSet, &rpcMsg, pTransporterId, rpcCtx);
   if (code) {
@@ -112,6 +112,13 @@ typedef struct SQWTaskStatus {
   int8_t  status;
 } SQWTaskStatus;
 
+// the blocks of a fetch rsp, sent as the body segments following SRetrieveTableRsp without being copied into it
+typedef struct SQWRspSegs {
+  SRpcMsgSeg *pSegs;
+  int32_t     numOfSegs;
+  int32_t     capacity;
+} SQWRspSegs;
+
 typedef struct SQWTaskCtx {
   SRWLatch lock;
   int8_t   phase;
@@ -121,6 +128,7 @@ typedef struct SQWTaskCtx {
   int8_t   needFetch;
   int8_t   localExec;
   int8_t   dynamicTask;
+  int8_t   fetchCompress;  // BLOCK_COMPRESS_* the fetcher decodes
   int32_t  queryMsgType;
   int32_t  fetchMsgType;
   int32_t  level;
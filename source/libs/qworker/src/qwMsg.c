@@ -49,6 +49,15 @@ void qwFreeFetchRsp(void *msg) {
   }
 }
 
+void qwFreeRspSegs(SQWRspSegs *pSegs) {
+  for (int32_t i = 0; i < pSegs->numOfSegs; ++i) {
+    taosMemoryFree(pSegs->pSegs[i].pData);
+  }
+  taosMemoryFreeClear(pSegs->pSegs);
+  pSegs->numOfSegs = 0;
+  pSegs->capacity = 0;
+}
+
 int32_t qwBuildAndSendErrorRsp(int32_t rspType, SRpcHandleInfo *pConn, int32_t code) {
   SRpcMsg rpcRsp = {
       .msgType = rspType,
@@ -139,12 +148,14 @@ int32_t qwBuildAndSendHbRsp(SRpcHandleInfo *pConn, SSchedulerHbRsp *pStatus, int
   return TSDB_CODE_SUCCESS;
 }
 
+// the blocks in pSegs are handed over to the rpc, the ones in pRsp->data are counted in dataLength as well
 int32_t qwBuildAndSendFetchRsp(int32_t rspType, SRpcHandleInfo *pConn, SRetrieveTableRsp *pRsp, int32_t dataLength,
-                               int32_t code) {
+                               SQWRspSegs *pSegs, int32_t code) {
   if (NULL == pRsp) {
     pRsp = (SRetrieveTableRsp *)rpcMallocCont(sizeof(SRetrieveTableRsp));
     memset(pRsp, 0, sizeof(SRetrieveTableRsp));
     dataLength = 0;
+    if (pSegs) qwFreeRspSegs(pSegs);
   }
 
   SRpcMsg rpcRsp = {
@@ -155,6 +166,15 @@ int32_t qwBuildAndSendFetchRsp(int32_t rspType, SRpcHandleInfo *pConn, SRetrieve
       .info = *pConn,
   };
 
+  if (pSegs && pSegs->numOfSegs > 0) {
+    for (int32_t i = 0; i < pSegs->numOfSegs; ++i) {
+      rpcRsp.contLen -= pSegs->pSegs[i].len;
+    }
+    rpcRsp.pSegs = pSegs->pSegs;
+    rpcRsp.numOfSegs = pSegs->numOfSegs;
+    memset(pSegs, 0, sizeof(*pSegs));
+  }
+
   rpcRsp.info.compressed = pRsp->compressed;
   tmsgSendRsp(&rpcRsp);
 
@@ -525,6 +545,7 @@ int32_t qWorkerProcessFetchMsg(void *node, void *qWorkerMgmt, SRpcMsg *pMsg, int
   int32_t  eId = req.execId;
 
   SQWMsg qwMsg = {.node = node, .msg = req.pOpParam, .msgLen = 0, .connInfo = pMsg->info, .msgType = pMsg->msgType};
+  qwMsg.msgInfo.compressMsg = req.compress;
 
   QW_SCH_TASK_DLOG("processFetch start, node:%p, handle:%p", node, pMsg->info.handle);
 
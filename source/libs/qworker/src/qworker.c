@@ -283,8 +283,44 @@ int32_t qwGenerateSchHbRsp(SQWorker *mgmt, SQWSchStatus *sch, SQWHbInfo *hbInfo)
   return TSDB_CODE_SUCCESS;
 }
 
+// append a block of len bytes to the segments, and return the buffer of it
+static char *qwAppendRspSeg(SQWRspSegs *pSegs, int32_t len) {
+  if (pSegs->numOfSegs >= pSegs->capacity) {
+    int32_t     capacity = pSegs->capacity > 0 ? pSegs->capacity * 2 : 4;
+    SRpcMsgSeg *p = taosMemoryRealloc(pSegs->pSegs, capacity * sizeof(SRpcMsgSeg));
+    if (NULL == p) {
+      return NULL;
+    }
+    pSegs->pSegs = p;
+    pSegs->capacity = capacity;
+  }
+
+  char *pData = taosMemoryMalloc(len);
+  if (NULL == pData) {
+    return NULL;
+  }
+  pSegs->pSegs[pSegs->numOfSegs].pData = pData;
+  pSegs->pSegs[pSegs->numOfSegs].len = len;
+  pSegs->numOfSegs++;
+  return pData;
+}
+
+// decode a block of the columnar codec in place, for the fetchers of older versions
+static int32_t qwDecompressColumnarBlock(char *pData, int32_t compLen, int32_t rawLen) {
+  char *pBuf = taosMemoryMalloc(compLen);
+  if (NULL == pBuf) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  memcpy(pBuf, pData, compLen);
+  int32_t len = blockDecompress(BLOCK_COMPRESS_COLUMNAR, pBuf, compLen, pData, rawLen);
+  taosMemoryFree(pBuf);
+  return len == rawLen ? TSDB_CODE_SUCCESS : TSDB_CODE_INVALID_DATA_FMT;
+}
+
+// the blocks go to pSegs if it is given and the rsp is sent by rpc, or are copied after the rsp otherwise
 int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen, int32_t *pRawDataLen, void **rspMsg,
-                              SOutputData *pOutput) {
+                              SQWRspSegs *pSegs, SOutputData *pOutput) {
   int64_t            len = 0;
   int64_t            rawLen = 0;
   SRetrieveTableRsp *pRsp = NULL;
@@ -341,13 +377,26 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
     // Got data from sink
     QW_TASK_DLOG("there are data in sink, dataLength:%" PRId64 "", len);
 
-    *dataLen += len + PAYLOAD_PREFIX_LEN;
-    *pRawDataLen += rawLen + PAYLOAD_PREFIX_LEN;
+    // the fetcher may not decode the codec of the block, leave room for the raw block then
+    bool    rawOnly = (ctx->fetchCompress != BLOCK_COMPRESS_COLUMNAR);
+    int64_t outLen = rawOnly ? rawLen : len;
 
-    QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &pRsp));
+    *dataLen += outLen + PAYLOAD_PREFIX_LEN;
+    *pRawDataLen += rawLen + PAYLOAD_PREFIX_LEN;
 
     // set the serialize start position
-    output.pData = pRsp->data + *dataLen - (len + PAYLOAD_PREFIX_LEN);
+    if (pSegs && !ctx->localExec) {
+      if (NULL == pRsp) {
+        QW_ERR_RET(qwMallocFetchRsp(true, 0, &pRsp));
+      }
+      output.pData = qwAppendRspSeg(pSegs, outLen + PAYLOAD_PREFIX_LEN);
+      if (NULL == output.pData) {
+        QW_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+      }
+    } else {
+      QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &pRsp));
+      output.pData = pRsp->data + *dataLen - (outLen + PAYLOAD_PREFIX_LEN);
+    }
 
     ((int32_t *)output.pData)[0] = len;
     ((int32_t *)output.pData)[1] = rawLen;
@@ -359,6 +408,17 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
       QW_ERR_RET(code);
     }
 
+    if (rawOnly && output.compressed == BLOCK_COMPRESS_COLUMNAR) {
+      QW_ERR_RET(qwDecompressColumnarBlock(output.pData, len, rawLen));
+      ((int32_t *)output.pData)[-2] = rawLen;
+      output.compressed = BLOCK_COMPRESS_NONE;
+    } else if (outLen > len) {
+      *dataLen -= outLen - len;
+      if (pSegs && !ctx->localExec) {
+        pSegs->pSegs[pSegs->numOfSegs - 1].len -= outLen - len;
+      }
+    }
+
     pOutput->queryEnd = output.queryEnd;
     pOutput->precision = output.precision;
     pOutput->bufStatus = output.bufStatus;
@@ -443,9 +503,10 @@ int32_t qwQuickRspFetchReq(QW_FPARAMS_DEF, SQWTaskCtx *ctx, SQWMsg *qwMsg, int32
       void       *rsp = NULL;
       int32_t     dataLen = 0;
       int32_t     rawLen = 0;
+      SQWRspSegs  segs = {0};
       SOutputData sOutput = {0};
       if (TSDB_CODE_SUCCESS == code) {
-        code = qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, &sOutput);
+        code = qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, &segs, &sOutput);
       }
 
       if (NULL == rsp && TSDB_CODE_SUCCESS == code) {
@@ -464,7 +525,7 @@ int32_t qwQuickRspFetchReq(QW_FPARAMS_DEF, SQWTaskCtx *ctx, SQWMsg *qwMsg, int32
       qwMsg->connInfo = ctx->dataConnInfo;
       QW_SET_EVENT_PROCESSED(ctx, QW_EVENT_FETCH);
 
-      qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, rsp, dataLen, code);
+      qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, rsp, dataLen, &segs, code);
       rsp = NULL;
 
       QW_TASK_DLOG("fetch rsp send, handle:%p, code:%x - %s, dataLen:%d", qwMsg->connInfo.handle, code, tstrerror(code),
@@ -792,6 +853,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
   void         *rsp = NULL;
   int32_t       dataLen = 0;
   int32_t       rawLen = 0;
+  SQWRspSegs    segs = {0};
   bool          queryStop = false;
   bool          qComplete = false;
 
@@ -811,7 +873,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
 
     if (QW_EVENT_RECEIVED(ctx, QW_EVENT_FETCH)) {
       SOutputData sOutput = {0};
-      QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, &sOutput));
+      QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, &segs, &sOutput));
 
       if ((!sOutput.queryEnd) && (DS_BUF_LOW == sOutput.bufStatus || DS_BUF_EMPTY == sOutput.bufStatus)) {
         QW_TASK_DLOG("task not end and buf is %s, need to continue query", qwBufStatusStr(sOutput.bufStatus));
@@ -831,7 +893,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
         qwMsg->connInfo = ctx->dataConnInfo;
         QW_SET_EVENT_PROCESSED(ctx, QW_EVENT_FETCH);
 
-        qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, rsp, dataLen, code);
+        qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, rsp, dataLen, &segs, code);
         rsp = NULL;
 
         QW_TASK_DLOG("fetch rsp send, handle:%p, code:%x - %s, dataLen:%d", qwMsg->connInfo.handle, code,
@@ -843,6 +905,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
 
   _return:
 
+    qwFreeRspSegs(&segs);
     if (NULL == ctx) {
       break;
     }
@@ -853,7 +916,7 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
       rsp = NULL;
 
       qwMsg->connInfo = ctx->dataConnInfo;
-      qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, NULL, 0, code);
+      qwBuildAndSendFetchRsp(ctx->fetchMsgType + 1, &qwMsg->connInfo, NULL, 0, NULL, code);
       QW_TASK_DLOG("fetch rsp send, handle:%p, code:%x - %s, dataLen:%d", qwMsg->connInfo.handle, code, tstrerror(code),
                    0);
     }
@@ -884,6 +947,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
   bool          locked = false;
   SQWTaskCtx   *ctx = NULL;
   void         *rsp = NULL;
+  SQWRspSegs    segs = {0};
   SQWPhaseInput input = {0};
 
   QW_ERR_JRET(qwHandlePrePhaseEvents(QW_FPARAMS(), QW_PHASE_PRE_FETCH, &input, NULL));
@@ -891,6 +955,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
   QW_ERR_JRET(qwGetTaskCtx(QW_FPARAMS(), &ctx));
 
   ctx->fetchMsgType = qwMsg->msgType;
+  ctx->fetchCompress = qwMsg->msgInfo.compressMsg;
   ctx->dataConnInfo = qwMsg->connInfo;
 
   if (qwMsg->msg) {
@@ -899,7 +964,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
   }
 
   SOutputData sOutput = {0};
-  QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawDataLen, &rsp, &sOutput));
+  QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawDataLen, &rsp, &segs, &sOutput));
 
   if (NULL == rsp) {
     QW_SET_EVENT_RECEIVED(ctx, QW_EVENT_FETCH);
@@ -942,6 +1007,7 @@ _return:
 
   if (code) {
     qwFreeFetchRsp(rsp);
+    qwFreeRspSegs(&segs);
     rsp = NULL;
     dataLen = 0;
   }
@@ -954,11 +1020,12 @@ _return:
     }
 
     if (!rsped) {
-      qwBuildAndSendFetchRsp(qwMsg->msgType + 1, &qwMsg->connInfo, rsp, dataLen, code);
+      qwBuildAndSendFetchRsp(qwMsg->msgType + 1, &qwMsg->connInfo, rsp, dataLen, &segs, code);
       QW_TASK_DLOG("fetch rsp send, msgType:%s, handle:%p, code:%x - %s, dataLen:%d", TMSG_INFO(qwMsg->msgType + 1),
                    qwMsg->connInfo.handle, code, tstrerror(code), dataLen);
     } else {
       qwFreeFetchRsp(rsp);
+      qwFreeRspSegs(&segs);
       rsp = NULL;
     }
   } else {
@@ -1480,12 +1547,13 @@ int32_t qWorkerProcessLocalFetch(void *pMgmt, uint64_t sId, uint64_t qId, uint64
   QW_ERR_JRET(qwGetTaskCtx(QW_FPARAMS(), &ctx));
 
   ctx->fetchMsgType = TDMT_SCH_MERGE_FETCH;
+  ctx->fetchCompress = BLOCK_COMPRESS_COLUMNAR;
   ctx->explainRes = explainRes;
 
   SOutputData sOutput = {0};
 
   while (true) {
-    QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, &sOutput));
+    QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rawLen, &rsp, NULL, &sOutput));
 
     if (NULL == rsp) {
       QW_ERR_JRET(qwExecTask(QW_FPARAMS(), ctx, &queryStop));
@@ -38,6 +38,9 @@ extern "C" {
 
 #define FILTER_RM_UNIT_MIN_ROWS 100
 
+// unit statistics are halved once a unit has evaluated so many rows, so the unit order follows the data
+#define FILTER_UNIT_STAT_DECAY_ROWS (1 << 20)
+
 enum {
   FLD_TYPE_COLUMN = 1,
   FLD_TYPE_VALUE = 2,
@@ -214,6 +217,11 @@ typedef struct SFilterComUnit {
   int8_t   rfunc;
 } SFilterComUnit;
 
+typedef struct SFilterUnitStat {
+  uint64_t evalRows;  // rows evaluated by the unit
+  uint64_t passRows;  // rows passed the unit
+} SFilterUnitStat;
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -267,6 +275,9 @@ struct SFilterInfo {
   int8_t           *blkUnitRes;
   void             *pTable;
   SArray           *blkList;
+  SFilterUnitStat  *unitStat;  // observed selectivity, units in a group are evaluated in ascending order of it
+  int32_t          *selRows;   // selection vectors of the rows still to be evaluated
+  int32_t           selSize;
 
   SFilterPCtx pctx;
 };
@@ -494,6 +505,10 @@ struct SFilterInfo {
 #define FILTER_EMPTY_RES(i) FILTER_GET_FLAG((i)->status, FI_STATUS_EMPTY)
 
 extern bool          filterDoCompare(__compar_fn_t func, uint8_t optr, void *left, void *right);
+extern bool          filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                                       int16_t numOfCols, int32_t *numOfQualified);
+extern bool          filterExecuteImplSel(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                                          int16_t numOfCols, int32_t *numOfQualified);
 extern __compar_fn_t filterGetCompFunc(int32_t type, int32_t optr);
 extern __compar_fn_t filterGetCompFuncEx(int32_t lType, int32_t rType, int32_t optr);
 
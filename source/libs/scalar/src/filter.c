@@ -1891,6 +1891,8 @@ void filterFreeInfo(SFilterInfo *info) {
   taosMemoryFreeClear(info->cunits);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
+  taosMemoryFreeClear(info->unitStat);
+  taosMemoryFreeClear(info->selRows);
 
   for (int32_t i = 0; i < FLD_TYPE_MAX; ++i) {
     for (uint32_t f = 0; f < info->fields[i].num; ++f) {
@@ -3327,6 +3329,221 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+#define FLT_SELECT_ROWS_BY_COMPARE(_cond)                                 \
+  do {                                                                    \
+    for (int32_t i = 0; i < numOfRows; ++i) {                             \
+      if (colDataIsNull_s(pData, rows[i])) {                              \
+        continue;                                                         \
+      }                                                                   \
+      int32_t ret = func(colDataGetData(pData, rows[i]), cunit->valData); \
+      rows[num] = rows[i];                                                \
+      num += (_cond);                                                     \
+    }                                                                     \
+    return num;                                                           \
+  } while (0)
+
+// Keep the rows passing the unit in the selection vector, and return the number of them.
+static int32_t filterSelectRowsByUnit(SFilterComUnit *cunit, int32_t *rows, int32_t numOfRows) {
+  SColumnInfoData *pData = (SColumnInfoData *)cunit->colData;
+  uint8_t          optr = cunit->optr;
+  int32_t          num = 0;
+
+  if (optr == OP_TYPE_IS_NULL || optr == OP_TYPE_IS_NOT_NULL) {
+    bool isNullOptr = (optr == OP_TYPE_IS_NULL);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      rows[num] = rows[i];
+      num += (colDataIsNull_s(pData, rows[i]) == isNullOptr);
+    }
+    return num;
+  }
+
+  if (cunit->rfunc >= 0) {
+    rangeCompFunc rfunc = gRangeCompare[cunit->rfunc];
+    __compar_fn_t func = gDataCompare[cunit->func];
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (colDataIsNull_s(pData, rows[i])) {
+        continue;
+      }
+
+      void *colData = colDataGetData(pData, rows[i]);
+      if ((*rfunc)(colData, colData, cunit->valData, cunit->valData2, func)) {
+        rows[num++] = rows[i];
+      }
+    }
+    return num;
+  }
+
+  __compar_fn_t func = gDataCompare[cunit->func];
+  bool convertNchar = cunit->dataType == TSDB_DATA_TYPE_NCHAR && (optr == OP_TYPE_MATCH || optr == OP_TYPE_NMATCH);
+
+  // resolve the operator once for the whole column, instead of once for each row as filterDoCompare does
+  if (!convertNchar) {
+    switch (optr) {
+      case OP_TYPE_EQUAL:
+        FLT_SELECT_ROWS_BY_COMPARE(ret == 0);
+      case OP_TYPE_NOT_EQUAL:
+        FLT_SELECT_ROWS_BY_COMPARE(ret != 0);
+      case OP_TYPE_GREATER_EQUAL:
+        FLT_SELECT_ROWS_BY_COMPARE(ret >= 0);
+      case OP_TYPE_GREATER_THAN:
+        FLT_SELECT_ROWS_BY_COMPARE(ret > 0);
+      case OP_TYPE_LOWER_EQUAL:
+        FLT_SELECT_ROWS_BY_COMPARE(ret <= 0);
+      case OP_TYPE_LOWER_THAN:
+        FLT_SELECT_ROWS_BY_COMPARE(ret < 0);
+      default:
+        break;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_s(pData, rows[i])) {
+      continue;
+    }
+
+    void *colData = colDataGetData(pData, rows[i]);
+    bool  res = false;
+
+    // match/nmatch for nchar type need convert from ucs4 to mbs
+    if (convertNchar) {
+      char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+      int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+      if (len < 0) {
+        qError("castConvert1 taosUcs4ToMbs error");
+      } else {
+        varDataSetLen(newColData, len);
+        res = filterDoCompare(func, optr, newColData, cunit->valData);
+      }
+      taosMemoryFreeClear(newColData);
+    } else {
+      res = filterDoCompare(func, optr, colData, cunit->valData);
+    }
+
+    if (res) {
+      rows[num++] = rows[i];
+    }
+  }
+
+  return num;
+}
+
+// Reorder the units of each group by the ratio of rows they passed so far, so that the most selective unit of a group
+// runs first and the following ones only see the few rows it left.
+static void filterOrderUnitsBySelectivity(SFilterInfo *info) {
+  for (uint32_t u = 0; u < info->unitNum; ++u) {
+    SFilterUnitStat *pStat = &info->unitStat[u];
+    if (pStat->evalRows > FILTER_UNIT_STAT_DECAY_ROWS) {
+      pStat->evalRows >>= 1;
+      pStat->passRows >>= 1;
+    }
+  }
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+
+    // insertion sort, which is stable and there are only a few units in a group
+    for (uint32_t i = 1; i < group->unitNum; ++i) {
+      uint32_t         uidx = group->unitIdxs[i];
+      SFilterUnitStat *pStat = &info->unitStat[uidx];
+
+      int32_t j = (int32_t)i - 1;
+      while (j >= 0) {
+        SFilterUnitStat *pPrev = &info->unitStat[group->unitIdxs[j]];
+        if (pStat->passRows * pPrev->evalRows >= pPrev->passRows * pStat->evalRows) {
+          break;
+        }
+        group->unitIdxs[j + 1] = group->unitIdxs[j];
+        --j;
+      }
+      group->unitIdxs[j + 1] = uidx;
+    }
+  }
+}
+
+static int32_t filterEnsureSelRows(SFilterInfo *info, int32_t numOfRows) {
+  if (info->unitStat == NULL) {
+    info->unitStat = taosMemoryCalloc(info->unitNum, sizeof(*info->unitStat));
+    if (info->unitStat == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (info->selSize < numOfRows) {
+    // two selection vectors: rows not qualified by any group yet, and rows still alive in the current group
+    int32_t *p = taosMemoryRealloc(info->selRows, sizeof(int32_t) * numOfRows * 2);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    info->selRows = p;
+    info->selSize = numOfRows;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Evaluate the filter column by column with selection vectors, instead of row by row as filterExecuteImpl does. Each
+// unit only evaluates the rows still alive in its group, and a group only evaluates the rows not qualified by the
+// previous groups.
+bool filterExecuteImplSel(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                          int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  if (filterEnsureSelRows(info, numOfRows) != TSDB_CODE_SUCCESS) {
+    return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+  }
+
+  int8_t  *p = (int8_t *)pRes->pData;
+  int32_t *pending = info->selRows;
+  int32_t *alive = info->selRows + info->selSize;
+  int32_t  numOfPending = numOfRows;
+  int32_t  qualified = 0;
+
+  memset(p, 0, numOfRows);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pending[i] = i;
+  }
+
+  for (uint32_t g = 0; g < info->groupNum && numOfPending > 0; ++g) {
+    SFilterGroup *group = &info->groups[g];
+    int32_t       numOfAlive = numOfPending;
+
+    memcpy(alive, pending, numOfPending * sizeof(int32_t));
+    for (uint32_t u = 0; u < group->unitNum && numOfAlive > 0; ++u) {
+      uint32_t uidx = group->unitIdxs[u];
+      int32_t  num = filterSelectRowsByUnit(&info->cunits[uidx], alive, numOfAlive);
+
+      info->unitStat[uidx].evalRows += numOfAlive;
+      info->unitStat[uidx].passRows += num;
+      numOfAlive = num;
+    }
+
+    for (int32_t i = 0; i < numOfAlive; ++i) {
+      p[alive[i]] = 1;
+    }
+    qualified += numOfAlive;
+
+    // remove the qualified rows from the rows to be evaluated by the following groups
+    if (numOfAlive > 0 && g + 1 < info->groupNum) {
+      int32_t num = 0;
+      for (int32_t i = 0; i < numOfPending; ++i) {
+        pending[num] = pending[i];
+        num += (p[pending[i]] == 0);
+      }
+      numOfPending = num;
+    }
+  }
+
+  filterOrderUnitsBySelectivity(info);
+
+  (*numOfQualified) += qualified;
+  return qualified == numOfRows;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3339,7 +3556,7 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
   }
 
   if (info->unitNum > 1) {
-    info->func = filterExecuteImpl;
+    info->func = filterExecuteImplSel;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -1145,6 +1145,241 @@ static void doReleaseVec(SColumnInfoData *pCol, int32_t type) {
   }
 }
 
+// Type-specialized arithmetic kernels.
+//
+// Each kernel works on the whole payload of a fixed-length column without any per-row null check or indirect call,
+// so that the compiler is able to vectorize the loop. The null bitmap is merged separately, one word at a time.
+typedef enum {
+  SCL_MATH_ADD = 0,
+  SCL_MATH_SUB,
+  SCL_MATH_MULTI,
+  SCL_MATH_DIV,
+  SCL_MATH_MAX,
+} ESclMathOp;
+
+typedef void (*_sclMathVV_fn_t)(const void *pLeft, const void *pRight, double *pOut, int32_t numOfRows);
+typedef void (*_sclMathVC_fn_t)(const void *pVec, double val, double *pOut, int32_t numOfRows);
+typedef bool (*_sclMathZero_fn_t)(const void *pVec, char *nullBitmap, int32_t numOfRows);
+
+#define SCL_MATH_OPS(_X, ...)               \
+  _X(SCL_MATH_ADD, Add, +, __VA_ARGS__)     \
+  _X(SCL_MATH_SUB, Sub, -, __VA_ARGS__)     \
+  _X(SCL_MATH_MULTI, Multi, *, __VA_ARGS__) \
+  _X(SCL_MATH_DIV, Div, /, __VA_ARGS__)
+
+#define SCL_MATH_TYPES(_X, ...)        \
+  _X(BOOL, bool, __VA_ARGS__)          \
+  _X(TINYINT, int8_t, __VA_ARGS__)     \
+  _X(SMALLINT, int16_t, __VA_ARGS__)   \
+  _X(INT, int32_t, __VA_ARGS__)        \
+  _X(BIGINT, int64_t, __VA_ARGS__)     \
+  _X(FLOAT, float, __VA_ARGS__)        \
+  _X(DOUBLE, double, __VA_ARGS__)      \
+  _X(UTINYINT, uint8_t, __VA_ARGS__)   \
+  _X(USMALLINT, uint16_t, __VA_ARGS__) \
+  _X(UINT, uint32_t, __VA_ARGS__)      \
+  _X(UBIGINT, uint64_t, __VA_ARGS__)
+
+// the right operand type list is a copy of SCL_MATH_TYPES, since a macro can not be expanded inside itself
+#define SCL_MATH_RTYPES(_X, ...)       \
+  _X(BOOL, bool, __VA_ARGS__)          \
+  _X(TINYINT, int8_t, __VA_ARGS__)     \
+  _X(SMALLINT, int16_t, __VA_ARGS__)   \
+  _X(INT, int32_t, __VA_ARGS__)        \
+  _X(BIGINT, int64_t, __VA_ARGS__)     \
+  _X(FLOAT, float, __VA_ARGS__)        \
+  _X(DOUBLE, double, __VA_ARGS__)      \
+  _X(UTINYINT, uint8_t, __VA_ARGS__)   \
+  _X(USMALLINT, uint16_t, __VA_ARGS__) \
+  _X(UINT, uint32_t, __VA_ARGS__)      \
+  _X(UBIGINT, uint64_t, __VA_ARGS__)
+
+// column op column
+#define SCL_MATH_DEF_VV(_rn, _rt, _op, _name, _sym, _ln, _lt)                                       \
+  static void sclMathVV##_name##_##_ln##_##_rn(const void *pLeft, const void *pRight, double *pOut, \
+                                               int32_t numOfRows) {                                 \
+    const _lt *l = (const _lt *)pLeft;                                                              \
+    const _rt *r = (const _rt *)pRight;                                                             \
+    double    *o = pOut;                                                                            \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                       \
+      o[i] = (double)l[i] _sym (double)r[i];                                                        \
+    }                                                                                               \
+  }
+#define SCL_MATH_DEF_VV_R(_ln, _lt, _op, _name, _sym) SCL_MATH_RTYPES(SCL_MATH_DEF_VV, _op, _name, _sym, _ln, _lt)
+#define SCL_MATH_DEF_VV_L(_op, _name, _sym, ...)      SCL_MATH_TYPES(SCL_MATH_DEF_VV_R, _op, _name, _sym)
+
+// column op constant, and constant op column
+#define SCL_MATH_DEF_VC(_tn, _t, _op, _name, _sym)                                                      \
+  static void sclMathVC##_name##_##_tn(const void *pVec, double val, double *pOut, int32_t numOfRows) { \
+    const _t *v = (const _t *)pVec;                                                                     \
+    double   *o = pOut;                                                                                 \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                           \
+      o[i] = (double)v[i] _sym val;                                                                     \
+    }                                                                                                   \
+  }                                                                                                     \
+  static void sclMathCV##_name##_##_tn(const void *pVec, double val, double *pOut, int32_t numOfRows) { \
+    const _t *v = (const _t *)pVec;                                                                     \
+    double   *o = pOut;                                                                                 \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                           \
+      o[i] = val _sym (double)v[i];                                                                     \
+    }                                                                                                   \
+  }
+#define SCL_MATH_DEF_VC_T(_op, _name, _sym, ...) SCL_MATH_TYPES(SCL_MATH_DEF_VC, _op, _name, _sym)
+
+// mark the rows with a zero divisor as null, without branch
+#define SCL_MATH_DEF_ZERO(_tn, _t, ...)                                                  \
+  static bool sclMathZero_##_tn(const void *pVec, char *nullBitmap, int32_t numOfRows) { \
+    const _t *v = (const _t *)pVec;                                                      \
+    uint8_t   any = 0;                                                                   \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                            \
+      uint8_t z = (uint8_t)(v[i] == 0);                                                  \
+      nullBitmap[CharPos(i)] |= (char)(z << (7u - BitPos(i)));                           \
+      any |= z;                                                                          \
+    }                                                                                    \
+    return any != 0;                                                                     \
+  }
+
+SCL_MATH_OPS(SCL_MATH_DEF_VV_L)
+SCL_MATH_OPS(SCL_MATH_DEF_VC_T)
+SCL_MATH_TYPES(SCL_MATH_DEF_ZERO)
+
+#define SCL_MATH_REG_VV(_rn, _rt, _op, _name, _ln) \
+  [_op][TSDB_DATA_TYPE_##_ln][TSDB_DATA_TYPE_##_rn] = sclMathVV##_name##_##_ln##_##_rn,
+#define SCL_MATH_REG_VV_R(_ln, _lt, _op, _name)  SCL_MATH_RTYPES(SCL_MATH_REG_VV, _op, _name, _ln)
+#define SCL_MATH_REG_VV_L(_op, _name, _sym, ...) SCL_MATH_TYPES(SCL_MATH_REG_VV_R, _op, _name)
+#define SCL_MATH_REG_VC(_tn, _t, _op, _name)     [_op][TSDB_DATA_TYPE_##_tn] = sclMathVC##_name##_##_tn,
+#define SCL_MATH_REG_CV(_tn, _t, _op, _name)     [_op][TSDB_DATA_TYPE_##_tn] = sclMathCV##_name##_##_tn,
+#define SCL_MATH_REG_VC_T(_op, _name, _sym, ...) SCL_MATH_TYPES(SCL_MATH_REG_VC, _op, _name)
+#define SCL_MATH_REG_CV_T(_op, _name, _sym, ...) SCL_MATH_TYPES(SCL_MATH_REG_CV, _op, _name)
+#define SCL_MATH_REG_ZERO(_tn, _t, ...)          [TSDB_DATA_TYPE_##_tn] = sclMathZero_##_tn,
+
+static const _sclMathVV_fn_t gSclMathVVFn[SCL_MATH_MAX][TSDB_DATA_TYPE_MAX][TSDB_DATA_TYPE_MAX] = {
+    SCL_MATH_OPS(SCL_MATH_REG_VV_L)};
+static const _sclMathVC_fn_t gSclMathVCFn[SCL_MATH_MAX][TSDB_DATA_TYPE_MAX] = {SCL_MATH_OPS(SCL_MATH_REG_VC_T)};
+static const _sclMathVC_fn_t gSclMathCVFn[SCL_MATH_MAX][TSDB_DATA_TYPE_MAX] = {SCL_MATH_OPS(SCL_MATH_REG_CV_T)};
+static const _sclMathZero_fn_t gSclMathZeroFn[TSDB_DATA_TYPE_MAX] = {SCL_MATH_TYPES(SCL_MATH_REG_ZERO)};
+
+static FORCE_INLINE int32_t sclMathKernelType(const SColumnInfoData *pCol) {
+  int32_t type = pCol->info.type;
+  if (type == TSDB_DATA_TYPE_TIMESTAMP) {
+    return TSDB_DATA_TYPE_BIGINT;
+  }
+
+  return (IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) ? type : -1;
+}
+
+// merge the null bitmap of the first numOfRows rows of pSrc into pDst, return true if there is any null value
+static bool sclMathMergeNullBitmap(char *pDst, const SColumnInfoData *pSrc, int32_t numOfRows) {
+  if (!pSrc->hasNull || pSrc->nullbitmap == NULL || numOfRows <= 0) {
+    return false;
+  }
+
+  const char *pBm = pSrc->nullbitmap;
+  int32_t     len = BitmapLen(numOfRows);
+  int32_t     tail = numOfRows & ((1 << NBIT) - 1);
+  int32_t     full = (tail == 0) ? len : len - 1;
+  uint64_t    any = 0;
+
+  int32_t k = 0;
+  for (; k + (int32_t)sizeof(uint64_t) <= full; k += sizeof(uint64_t)) {
+    uint64_t d, s;
+    memcpy(&d, pDst + k, sizeof(uint64_t));
+    memcpy(&s, pBm + k, sizeof(uint64_t));
+    d |= s;
+    any |= s;
+    memcpy(pDst + k, &d, sizeof(uint64_t));
+  }
+
+  for (; k < full; ++k) {
+    pDst[k] |= pBm[k];
+    any |= (uint8_t)pBm[k];
+  }
+
+  if (tail != 0) {  // the bits of the rows beyond numOfRows are not copied
+    uint8_t s = (uint8_t)pBm[k] & (uint8_t)(0xFFu << (8 - tail));
+    pDst[k] |= (char)s;
+    any |= s;
+  }
+
+  return any != 0;
+}
+
+// the value of a null row is always set to be 0, the same as colDataSetNULL
+static void sclMathResetNullRows(SColumnInfoData *pOutputCol, int32_t numOfRows) {
+  const char *pBm = pOutputCol->nullbitmap;
+  double     *output = (double *)pOutputCol->pData;
+  int32_t     len = BitmapLen(numOfRows);
+
+  for (int32_t k = 0; k < len; ++k) {
+    if (pBm[k] == 0) {
+      continue;
+    }
+
+    int32_t end = TMIN((k + 1) << NBIT, numOfRows);
+    for (int32_t i = k << NBIT; i < end; ++i) {
+      if (colDataIsNull_f(pBm, i)) {
+        output[i] = 0;
+      }
+    }
+  }
+}
+
+// Try to do the arithmetic operation by the type-specialized kernels. The results are identical to the generic row by
+// row path, return false if the input is not supported here and the caller should go on with the generic path.
+static bool vectorMathByKernel(SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                               int32_t rightRows, SColumnInfoData *pOutputCol, int32_t op, int32_t _ord) {
+  int32_t lt = sclMathKernelType(pLeftCol);
+  int32_t rt = sclMathKernelType(pRightCol);
+  if (_ord != TSDB_ORDER_ASC || lt < 0 || rt < 0 || pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE ||
+      pOutputCol->nullbitmap == NULL) {
+    return false;
+  }
+
+  int32_t numOfRows = TMAX(leftRows, rightRows);
+  double *output = (double *)pOutputCol->pData;
+  char   *pBm = pOutputCol->nullbitmap;
+  bool    hasNull = false;
+
+  if (leftRows == rightRows) {
+    gSclMathVVFn[op][lt][rt](pLeftCol->pData, pRightCol->pData, output, numOfRows);
+    hasNull |= sclMathMergeNullBitmap(pBm, pLeftCol, numOfRows);
+    hasNull |= sclMathMergeNullBitmap(pBm, pRightCol, numOfRows);
+    if (op == SCL_MATH_DIV) {
+      hasNull |= gSclMathZeroFn[rt](pRightCol->pData, pBm, numOfRows);
+    }
+  } else if (rightRows == 1) {
+    double val = getVectorDoubleValueFn(rt)(pRightCol->pData, 0);
+    if (colDataIsNull_s(pRightCol, 0) || (op == SCL_MATH_DIV && val == 0)) {
+      colDataSetNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+
+    gSclMathVCFn[op][lt](pLeftCol->pData, val, output, numOfRows);
+    hasNull |= sclMathMergeNullBitmap(pBm, pLeftCol, numOfRows);
+  } else if (leftRows == 1) {
+    double val = getVectorDoubleValueFn(lt)(pLeftCol->pData, 0);
+    if (colDataIsNull_s(pLeftCol, 0)) {
+      colDataSetNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+
+    gSclMathCVFn[op][rt](pRightCol->pData, val, output, numOfRows);
+    hasNull |= sclMathMergeNullBitmap(pBm, pRightCol, numOfRows);
+    if (op == SCL_MATH_DIV) {
+      hasNull |= gSclMathZeroFn[rt](pRightCol->pData, pBm, numOfRows);
+    }
+  } else {
+    return false;
+  }
+
+  if (hasNull) {
+    pOutputCol->hasNull = true;
+    sclMathResetNullRows(pOutputCol, numOfRows);
+  }
+
+  return true;
+}
+
 void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t _ord) {
   SColumnInfoData *pOutputCol = pOut->columnData;
 
@@ -1185,7 +1420,8 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) + getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathByKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, SCL_MATH_ADD,
+                                  _ord)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1286,7 +1522,8 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) - getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathByKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, SCL_MATH_SUB,
+                                  _ord)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1342,6 +1579,12 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   SColumnInfoData *pLeftCol = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorMathByKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, SCL_MATH_MULTI, _ord)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1375,6 +1618,12 @@ void vectorMathDivide(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *p
   SColumnInfoData *pLeftCol = vectorConvertVarToDouble(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = vectorConvertVarToDouble(pRight, &rightConvert);
 
+  if (vectorMathByKernel(pLeftCol, pLeft->numOfRows, pRightCol, pRight->numOfRows, pOutputCol, SCL_MATH_DIV, _ord)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1341,6 +1341,99 @@ TEST(scalarModelogicTest, diff_columns_or_and_or) {
 }
 #endif
 
+TEST(filterModelogicTest, selection_vector_perf_test) {
+  const int32_t rowNum = 100000;
+  const int32_t loops = 20;
+
+  int32_t *v0 = (int32_t *)taosMemoryMalloc(rowNum * sizeof(int32_t));
+  int32_t *v1 = (int32_t *)taosMemoryMalloc(rowNum * sizeof(int32_t));
+  int32_t *v2 = (int32_t *)taosMemoryMalloc(rowNum * sizeof(int32_t));
+  int8_t  *eRes = (int8_t *)taosMemoryMalloc(rowNum);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    v0[i] = taosRand() % 1000;
+    v1[i] = taosRand() % 1000;
+    v2[i] = taosRand() % 1000;
+    eRes[i] = (v0[i] > 100 && v1[i] < 10 && v2[i] >= 500) || (v0[i] < 5 && v2[i] > 990);
+  }
+
+  // (c0 > 100 and c1 < 10 and c2 >= 500) or (c0 < 5 and c2 > 990), the most selective unit comes second
+  SSDataBlock *src = NULL;
+  SNode       *pCol = NULL, *pVal = NULL, *opNode = NULL, *logicNode1 = NULL, *logicNode2 = NULL;
+  int32_t      val[5] = {100, 10, 500, 5, 990};
+
+  SNodeList *list = nodesMakeList();
+  flttMakeColumnNode(&pCol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v0);
+  flttMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &val[0]);
+  flttMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pCol, pVal);
+  nodesListAppend(list, opNode);
+  flttMakeColumnNode(&pCol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v1);
+  flttMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &val[1]);
+  flttMakeOpNode(&opNode, OP_TYPE_LOWER_THAN, TSDB_DATA_TYPE_BOOL, pCol, pVal);
+  nodesListAppend(list, opNode);
+  flttMakeColumnNode(&pCol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v2);
+  flttMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &val[2]);
+  flttMakeOpNode(&opNode, OP_TYPE_GREATER_EQUAL, TSDB_DATA_TYPE_BOOL, pCol, pVal);
+  nodesListAppend(list, opNode);
+  flttMakeLogicNodeFromList(&logicNode1, LOGIC_COND_TYPE_AND, list);
+
+  list = nodesMakeList();
+  flttMakeColumnNode(&pCol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v0);
+  flttMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &val[3]);
+  flttMakeOpNode(&opNode, OP_TYPE_LOWER_THAN, TSDB_DATA_TYPE_BOOL, pCol, pVal);
+  nodesListAppend(list, opNode);
+  flttMakeColumnNode(&pCol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, v2);
+  flttMakeValueNode(&pVal, TSDB_DATA_TYPE_INT, &val[4]);
+  flttMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pCol, pVal);
+  nodesListAppend(list, opNode);
+  flttMakeLogicNodeFromList(&logicNode2, LOGIC_COND_TYPE_AND, list);
+
+  list = nodesMakeList();
+  nodesListAppend(list, logicNode1);
+  nodesListAppend(list, logicNode2);
+  flttMakeLogicNodeFromList(&logicNode1, LOGIC_COND_TYPE_OR, list);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(logicNode1, &filter, 0);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(filter->scalarMode, false);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+  code = filterSetDataFromSlotId(filter, &param);
+  ASSERT_EQ(code, 0);
+
+  filter_exec_func funcs[2] = {filterExecuteImpl, filterExecuteImplSel};
+  const char      *names[2] = {"row", "selection vector"};
+  for (int32_t f = 0; f < 2; ++f) {
+    filter->func = funcs[f];
+
+    int64_t st = taosGetTimestampUs();
+    for (int32_t k = 0; k < loops; ++k) {
+      SColumnInfoData *pRes = NULL;
+      int32_t          status = 0;
+      code = filterExecute(filter, src, &pRes, NULL, (int16_t)taosArrayGetSize(src->pDataBlock), &status);
+      ASSERT_EQ(code, 0);
+      ASSERT_EQ(status, FILTER_RESULT_PARTIAL_QUALIFIED);
+
+      for (int32_t i = 0; i < rowNum; ++i) {
+        ASSERT_EQ(((int8_t *)pRes->pData)[i], eRes[i]);
+      }
+
+      colDataDestroy(pRes);
+      taosMemoryFree(pRes);
+    }
+
+    std::cout << names[f] << " filter elapsed time:" << taosGetTimestampUs() - st << " us" << std::endl;
+  }
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(logicNode1);
+  blockDataDestroy(src);
+  taosMemoryFree(v0);
+  taosMemoryFree(v1);
+  taosMemoryFree(v2);
+  taosMemoryFree(eRes);
+}
+
 template <class SignedT, class UnsignedT>
 int32_t compareSignedWithUnsigned(SignedT l, UnsignedT r) {
   if (l < 0) return -1;
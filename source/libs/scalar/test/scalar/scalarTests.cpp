@@ -36,6 +36,7 @@
 #include "nodes.h"
 #include "parUtil.h"
 #include "scalar.h"
+#include "sclvector.h"
 #include "stub.h"
 #include "taos.h"
 #include "tdatablock.h"
@@ -2020,6 +2021,10 @@ void scltMakeDataBlock(SScalarParam **pInput, int32_t type, void *pVal, int32_t
       bytes = sizeof(double);
       break;
     }
+    default: {
+      bytes = tDataTypes[type].bytes;
+      break;
+    }
   }
 
   input->columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
@@ -3631,6 +3636,143 @@ TEST(ScalarFunctionTest, powFunction_column) {
   taosMemoryFree(pInput);
 }
 
+// the value of a numeric or bool column, converted from an int as the C cast does
+static void scltSetArithValue(SColumnInfoData *pCol, int32_t i, int32_t v) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+      ((bool *)pCol->pData)[i] = (v != 0);
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      ((int8_t *)pCol->pData)[i] = (int8_t)v;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      ((int16_t *)pCol->pData)[i] = (int16_t)v;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      ((int32_t *)pCol->pData)[i] = v;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      ((int64_t *)pCol->pData)[i] = v;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      ((float *)pCol->pData)[i] = (float)v;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      ((double *)pCol->pData)[i] = v;
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      ((uint8_t *)pCol->pData)[i] = (uint8_t)v;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      ((uint16_t *)pCol->pData)[i] = (uint16_t)v;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      ((uint32_t *)pCol->pData)[i] = (uint32_t)v;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      ((uint64_t *)pCol->pData)[i] = (uint64_t)v;
+      break;
+  }
+}
+
+// compare the type-specialized kernels of a (left type, right type) pair with the row by row reference
+static void scltArithKernelPerf(int32_t leftType, int32_t rightType, int32_t rowNum, int32_t loop) {
+  SScalarParam *pLeft = NULL, *pRight = NULL, *pOutput = NULL;
+
+  scltMakeDataBlock(&pLeft, leftType, NULL, rowNum, false);
+  scltMakeDataBlock(&pRight, rightType, NULL, rowNum, false);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    scltSetArithValue(pLeft->columnData, i, i % 7 - 3);
+    scltSetArithValue(pRight->columnData, i, i % 5 - 2);
+  }
+  for (int32_t i = 0; i < rowNum; i += 13) {
+    colDataSetNULL(pLeft->columnData, i);
+  }
+  for (int32_t i = 0; i < rowNum; i += 17) {
+    colDataSetNULL(pRight->columnData, i);
+  }
+
+  EOperatorType        op[4] = {OP_TYPE_ADD, OP_TYPE_SUB, OP_TYPE_MULTI, OP_TYPE_DIV};
+  _getDoubleValue_fn_t getLeft = getVectorDoubleValueFn(leftType);
+  _getDoubleValue_fn_t getRight = getVectorDoubleValueFn(rightType);
+  double              *expect = (double *)taosMemoryCalloc(rowNum, sizeof(double));
+  bool                *expectNull = (bool *)taosMemoryCalloc(rowNum, sizeof(bool));
+
+  for (int32_t k = 0; k < sizeof(op) / sizeof(op[0]); ++k) {
+    _bin_scalar_fn_t fn = getBinScalarOperatorFn(op[k]);
+
+    // the row by row reference, which is the same as the generic path in sclvector.c
+    int64_t st = taosGetTimestampUs();
+    for (int32_t j = 0; j < loop; ++j) {
+      for (int32_t i = 0; i < rowNum; ++i) {
+        expectNull[i] = colDataIsNull_s(pLeft->columnData, i) || colDataIsNull_s(pRight->columnData, i);
+        double l = getLeft(pLeft->columnData->pData, i);
+        double r = getRight(pRight->columnData->pData, i);
+        if (op[k] == OP_TYPE_DIV && r == 0) {
+          expectNull[i] = true;
+        }
+        if (expectNull[i]) {
+          expect[i] = 0;
+          continue;
+        }
+        if (op[k] == OP_TYPE_ADD) {
+          expect[i] = l + r;
+        } else if (op[k] == OP_TYPE_SUB) {
+          expect[i] = l - r;
+        } else if (op[k] == OP_TYPE_MULTI) {
+          expect[i] = l * r;
+        } else {
+          expect[i] = l / r;
+        }
+      }
+    }
+    int64_t el1 = taosGetTimestampUs() - st;
+
+    int64_t el2 = 0;
+    for (int32_t j = 0; j < loop; ++j) {
+      scltMakeDataBlock(&pOutput, TSDB_DATA_TYPE_DOUBLE, 0, rowNum, false);
+      st = taosGetTimestampUs();
+      fn(pLeft, pRight, pOutput, TSDB_ORDER_ASC);
+      el2 += taosGetTimestampUs() - st;
+
+      if (j == loop - 1) {
+        ASSERT_EQ(pOutput->numOfRows, rowNum);
+        for (int32_t i = 0; i < rowNum; ++i) {
+          ASSERT_EQ(colDataIsNull_s(pOutput->columnData, i), expectNull[i])
+              << tDataTypes[leftType].name << "-" << tDataTypes[rightType].name << " op:" << op[k] << " row:" << i;
+          ASSERT_EQ(*((double *)colDataGetData(pOutput->columnData, i)), expect[i])
+              << tDataTypes[leftType].name << "-" << tDataTypes[rightType].name << " op:" << op[k] << " row:" << i;
+        }
+      }
+      scltDestroyDataBlock(pOutput);
+    }
+
+    std::cout << "op:" << op[k] << " " << tDataTypes[leftType].name << "-" << tDataTypes[rightType].name
+              << " row by row elapsed time:" << el1 << " us, kernel elapsed time:" << el2 << " us" << std::endl;
+  }
+
+  taosMemoryFree(expect);
+  taosMemoryFree(expectNull);
+  scltDestroyDataBlock(pLeft);
+  scltDestroyDataBlock(pRight);
+}
+
+TEST(columnTest, arith_column_kernel_perf_test) {
+  // all the type pairs that the kernels are specialized for
+  int32_t types[] = {
+      TSDB_DATA_TYPE_BOOL,     TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+      TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE,   TSDB_DATA_TYPE_UTINYINT,
+      TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,    TSDB_DATA_TYPE_UBIGINT,
+  };
+  int32_t numOfTypes = sizeof(types) / sizeof(types[0]);
+
+  for (int32_t l = 0; l < numOfTypes; ++l) {
+    for (int32_t r = 0; r < numOfTypes; ++r) {
+      ASSERT_NO_FATAL_FAILURE(scltArithKernelPerf(types[l], types[r], 100000, 5));
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   taosSeedRand(taosGetTimestampSec());
   testing::InitGoogleTest(&argc, argv);
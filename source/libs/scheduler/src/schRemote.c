@@ -22,6 +22,7 @@
 #include "trpc.h"
 #include "tglobal.h"
 #include "tmisce.h"
+#include "tdatablock.h"
 
 // clang-format off
 int32_t schValidateRspMsgType(SSchJob *pJob, SSchTask *pTask, int32_t msgType) {
@@ -1131,9 +1132,10 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       qMsg.msg = pTask->msg;
 
       if (strcmp(tsLocalFqdn, GET_ACTIVE_EP(&addr->epSet)->fqdn) == 0) {
-        qMsg.compress = 0;
+        qMsg.compress = BLOCK_COMPRESS_NONE;
       } else {
-        qMsg.compress = 1;
+        // the fetchers tell whether they decode the columnar blocks, the blocks are decompressed for them otherwise
+        qMsg.compress = BLOCK_COMPRESS_COLUMNAR;
       }
 
       msgSize = tSerializeSSubQueryMsg(NULL, 0, &qMsg);
@@ -1166,6 +1168,7 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       req.queryId = pJob->queryId;
       req.taskId = pTask->taskId;
       req.execId = pTask->execId;
+      req.compress = BLOCK_COMPRESS_COLUMNAR;
 
       msgSize = tSerializeSResFetchReq(NULL, 0, &req);
       if (msgSize < 0) {
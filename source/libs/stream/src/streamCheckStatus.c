@@ -150,6 +150,7 @@ void streamTaskProcessCheckMsg(SStreamMeta* pMeta, SStreamTaskCheckReq* pReq, SS
       .downstreamTaskId = pReq->downstreamTaskId,
       .upstreamNodeId = pReq->upstreamNodeId,
       .upstreamTaskId = pReq->upstreamTaskId,
+      .compress = BLOCK_COMPRESS_COLUMNAR,
   };
 
   // only the leader node handle the check request
@@ -199,6 +200,13 @@ int32_t streamTaskProcessCheckRsp(SStreamTask* pTask, const SStreamTaskCheckRsp*
       return TSDB_CODE_SUCCESS;
     }
 
+    // a downstream task of an older version decodes lz4 only, so do all the dispatched blocks
+    if (pRsp->compress != BLOCK_COMPRESS_COLUMNAR) {
+      atomic_store_8(&pTask->outputInfo.compress, BLOCK_COMPRESS_LZ4);
+      stDebug("s-task:%s downstream task:0x%x (vgId:%d) decodes lz4 blocks only", id, pRsp->downstreamTaskId,
+              pRsp->downstreamNodeId);
+    }
+
     if (left == 0) {
       processDownstreamReadyRsp(pTask);  // all downstream tasks are ready, set the complete check downstream flag
       streamTaskStopMonitorCheckRsp(pInfo, id);
@@ -378,6 +386,9 @@ int32_t streamTaskInitTaskCheckInfo(STaskCheckInfo* pInfo, STaskOutputInfo* pOut
     ASSERT(pInfo->notReadyTasks == pOutputInfo->shuffleDispatcher.dbInfo.vgNum);
   }
 
+  // lowered by the check rsps of the downstream tasks of older versions
+  atomic_store_8(&pOutputInfo->compress, BLOCK_COMPRESS_COLUMNAR);
+
   pInfo->startTs = startTs;
   pInfo->timeoutStartTs = startTs;
   pInfo->stopCheckProcess = 0;
@@ -43,7 +43,7 @@ SStreamDataBlock* createStreamBlockFromDispatchMsg(const SStreamDispatchReq* pRe
     char* pInput = pRetrieve->data + PAYLOAD_PREFIX_LEN;
     if (pRetrieve->compressed && compLen < fullLen) {
       char* p = taosMemoryMalloc(fullLen);
-      int32_t len = tsDecompressString(pInput, compLen, 1, p, fullLen, ONE_STAGE_COMP, NULL, 0);
+      int32_t len = blockDecompress(pRetrieve->compressed, pInput, compLen, p, fullLen);
       ASSERT(len == fullLen);
       pInput = p;
     }
@@ -25,7 +25,7 @@ typedef struct SBlockName {
 
 static void    doMonitorDispatchData(void* param, void* tmrId);
 static int32_t doSendDispatchMsg(SStreamTask* pTask, const SStreamDispatchReq* pReq, int32_t vgId, SEpSet* pEpSet);
-static int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatchReq* pReq);
+static int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, int8_t codec, SStreamDispatchReq* pReq);
 static int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock,
                                        int64_t groupId, int64_t now);
 static int32_t tInitStreamDispatchReq(SStreamDispatchReq* pReq, const SStreamTask* pTask, int32_t vgId,
@@ -316,7 +316,7 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
   if (pTask->outputInfo.type == TASK_OUTPUT__FIXED_DISPATCH) {
     for (int32_t i = 0; i < numOfBlocks; i++) {
       SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
-      code = streamAddBlockIntoDispatchMsg(pDataBlock, pReqs);
+      code = streamAddBlockIntoDispatchMsg(pDataBlock, pTask->outputInfo.compress, pReqs);
       if (code != TSDB_CODE_SUCCESS) {
         destroyDispatchMsg(pReqs, 1);
         return code;
@@ -336,7 +336,7 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
       if (pDataBlock->info.type == STREAM_DELETE_RESULT || pDataBlock->info.type == STREAM_CHECKPOINT ||
           pDataBlock->info.type == STREAM_TRANS_STATE) {
         for (int32_t j = 0; j < numOfVgroups; j++) {
-          code = streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]);
+          code = streamAddBlockIntoDispatchMsg(pDataBlock, pTask->outputInfo.compress, &pReqs[j]);
           if (code != 0) {
             destroyDispatchMsg(pReqs, numOfVgroups);
             return code;
@@ -639,7 +639,7 @@ int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, S
     SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, j);
 
     if (hashValue >= pVgInfo->hashBegin && hashValue <= pVgInfo->hashEnd) {
-      if (streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
+      if (streamAddBlockIntoDispatchMsg(pDataBlock, pTask->outputInfo.compress, &pReqs[j]) < 0) {
         taosThreadMutexUnlock(&pTask->msgInfo.lock);
         return -1;
       }
@@ -965,7 +965,32 @@ int32_t streamTaskSendCheckpointSourceRsp(SStreamTask* pTask) {
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatchReq* pReq) {
+// compress the encoded block in place with the codec agreed on with the downstream tasks
+static int32_t streamCompressDispatchBlock(SRetrieveTableRsp* pRetrieve, int8_t codec, int32_t dataLen) {
+  if (codec == BLOCK_COMPRESS_NONE || tsCompressMsgSize <= 0 || dataLen <= tsCompressMsgSize) {
+    return dataLen;
+  }
+
+  // one more byte for the flag of the lz4 codec
+  char* pBuf = taosMemoryMalloc(dataLen + 1);
+  if (pBuf == NULL) {
+    return dataLen;
+  }
+
+  char*   pData = pRetrieve->data + PAYLOAD_PREFIX_LEN;
+  int32_t len = blockCompress(codec, pData, dataLen, pBuf, dataLen + 1);
+  if (len > 0 && len < dataLen) {
+    memcpy(pData, pBuf, len);
+    pRetrieve->compressed = codec;
+  } else {
+    len = dataLen;
+  }
+
+  taosMemoryFree(pBuf);
+  return len;
+}
+
+int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, int8_t codec, SStreamDispatchReq* pReq) {
   int32_t dataStrLen = sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pBlock) + PAYLOAD_PREFIX_LEN;
   ASSERT(dataStrLen > 0);
 
@@ -991,10 +1016,11 @@ int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatch
   pRetrieve->numOfCols = htonl(numOfCols);
 
   int32_t actualLen = blockEncode(pBlock, pRetrieve->data + PAYLOAD_PREFIX_LEN, numOfCols);
-  SET_PAYLOAD_LEN(pRetrieve->data, actualLen, actualLen);
+  int32_t compLen = streamCompressDispatchBlock(pRetrieve, codec, actualLen);
+  SET_PAYLOAD_LEN(pRetrieve->data, compLen, actualLen);
 
-  int32_t payloadLen = actualLen + PAYLOAD_PREFIX_LEN;
-  pRetrieve->payloadLen = htonl(payloadLen);
+  int32_t payloadLen = compLen + PAYLOAD_PREFIX_LEN;
+  pRetrieve->payloadLen = htonl(actualLen + PAYLOAD_PREFIX_LEN);
   pRetrieve->compLen = htonl(payloadLen);
 
   payloadLen += sizeof(SRetrieveTableRsp);
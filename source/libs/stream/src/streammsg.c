@@ -159,6 +159,7 @@ int32_t tEncodeStreamTaskCheckRsp(SEncoder* pEncoder, const SStreamTaskCheckRsp*
   if (tEncodeI32(pEncoder, pRsp->childId) < 0) return -1;
   if (tEncodeI64(pEncoder, pRsp->oldStage) < 0) return -1;
   if (tEncodeI8(pEncoder, pRsp->status) < 0) return -1;
+  if (tEncodeI8(pEncoder, pRsp->compress) < 0) return -1;
   tEndEncode(pEncoder);
   return pEncoder->pos;
 }
@@ -174,6 +175,11 @@ int32_t tDecodeStreamTaskCheckRsp(SDecoder* pDecoder, SStreamTaskCheckRsp* pRsp)
   if (tDecodeI32(pDecoder, &pRsp->childId) < 0) return -1;
   if (tDecodeI64(pDecoder, &pRsp->oldStage) < 0) return -1;
   if (tDecodeI8(pDecoder, &pRsp->status) < 0) return -1;
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI8(pDecoder, &pRsp->compress) < 0) return -1;
+  } else {
+    pRsp->compress = BLOCK_COMPRESS_LZ4;
+  }
   tEndDecode(pDecoder);
   return 0;
 }
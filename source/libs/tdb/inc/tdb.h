@@ -44,8 +44,12 @@ int32_t tdbAbort(TDB *pDb, TXN *pTxn);
 int32_t tdbAlter(TDB *pDb, int pages);
 
 // TTB
+#define TDB_TB_KEY_PREFIX 0x1  // factor the key prefix shared by the cells of a page out of them
+
 int32_t tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb,
                   int8_t rollback);
+int32_t tdbTbOpenEx(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb,
+                    int8_t rollback, int32_t flags);
 int32_t tdbTbClose(TTB *pTb);
 bool    tdbTbExist(const char *tbname, TDB *pEnv);
 int     tdbTbDropByName(const char *tbname, TDB *pEnv, TXN* pTxn);
@@ -19,6 +19,11 @@
 #define TDB_BTREE_LEAF 0x2
 #define TDB_BTREE_OVFL 0x4
 
+// the bits of the page flags above the page type keep the length of the key prefix shared by the cells of the page,
+// the prefix bytes follow the btree page header
+#define TDB_BTREE_PREFIX_SHIFT 3
+#define TDB_BTREE_MAX_PREFIX   31
+
 struct SBTree {
   SPgno         root;
   int           keyLen;
@@ -30,6 +35,7 @@ struct SBTree {
   int           minLocal;
   int           maxLeaf;
   int           minLeaf;
+  int           flags;
   SBtInfo       info;
   char         *tbname;
   void         *pBuf;
@@ -42,10 +48,14 @@ struct SBTree {
 #define TDB_BTREE_PAGE_IS_ROOT(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_ROOT)
 #define TDB_BTREE_PAGE_IS_LEAF(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_LEAF)
 #define TDB_BTREE_PAGE_IS_OVFL(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_OVFL)
-#define TDB_BTREE_ASSERT_FLAG(flags)                                                     \
-  ASSERT(TDB_FLAG_IS(flags, TDB_BTREE_ROOT) || TDB_FLAG_IS(flags, TDB_BTREE_LEAF) ||     \
-         TDB_FLAG_IS(flags, TDB_BTREE_ROOT | TDB_BTREE_LEAF) || TDB_FLAG_IS(flags, 0) || \
-         TDB_FLAG_IS(flags, TDB_BTREE_OVFL))
+#define TDB_BTREE_PAGE_TYPE(flags)            ((flags) & (TDB_BTREE_ROOT | TDB_BTREE_LEAF | TDB_BTREE_OVFL))
+#define TDB_BTREE_PAGE_NPREFIX(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) >> TDB_BTREE_PREFIX_SHIFT)
+#define TDB_BTREE_PAGE_PREFIX(PAGE)           ((PAGE)->pPageHdr - TDB_BTREE_PAGE_NPREFIX(PAGE))
+#define TDB_BTREE_ASSERT_FLAG(flags)                                                                        \
+  ASSERT(TDB_FLAG_IS(TDB_BTREE_PAGE_TYPE(flags), TDB_BTREE_ROOT) ||                                         \
+         TDB_FLAG_IS(TDB_BTREE_PAGE_TYPE(flags), TDB_BTREE_LEAF) ||                                         \
+         TDB_FLAG_IS(TDB_BTREE_PAGE_TYPE(flags), TDB_BTREE_ROOT | TDB_BTREE_LEAF) ||                        \
+         TDB_FLAG_IS(TDB_BTREE_PAGE_TYPE(flags), 0) || TDB_FLAG_IS(flags, TDB_BTREE_OVFL))
 
 #pragma pack(push, 1)
 typedef struct {
@@ -69,8 +79,8 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
 static int tdbBtcMoveDownward(SBTC *pBtc);
 static int tdbBtcMoveUpward(SBTC *pBtc);
 
-int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPgno pgno, tdb_cmpr_fn_t kcmpr, TDB *pEnv,
-                 SBTree **ppBt) {
+int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPgno pgno, tdb_cmpr_fn_t kcmpr, int flags,
+                 TDB *pEnv, SBTree **ppBt) {
   SBTree *pBt;
   int     ret;
 
@@ -104,6 +114,9 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPg
   pBt->maxLeaf = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr));
   // pBt->minLeaf
   pBt->minLeaf = pBt->minLocal;
+  // pBt->flags: pages written by balance factor the shared key prefix out of their cells when TDB_TB_KEY_PREFIX is
+  // set, the pages are self-describing so the tree is readable with or without it
+  pBt->flags = flags;
 
   // if pgno == 0 fetch new btree root leaf page
   if (pgno == 0) {
@@ -392,6 +405,8 @@ int tdbBtreePGet(SBTree *pBt, const void *pKey, int kLen, void **ppKey, int *pkL
     tdbFree(cd.pVal);
   }
 
+  tdbFree(cd.pBuf);
+
   tdbTrace("tdb pget end, btc decoder: %p/0x%x, local decoder:%p", &btc.coder, btc.coder.freeKV, &cd);
 
   tdbBtcClose(&btc);
@@ -425,6 +440,7 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   SBTree *pBt;
   u8      flags;
   u8      leaf;
+  int     szAmHdr;
 
   pBt = ((SBtreeInitPageArg *)arg)->pBt;
 
@@ -434,14 +450,19 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
     leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
     TDB_BTREE_ASSERT_FLAG(flags);
 
-    tdbPageInit(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    szAmHdr = (leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr)) + (flags >> TDB_BTREE_PREFIX_SHIFT);
+
+    tdbPageInit(pPage, szAmHdr, tdbBtreeCellSize);
   } else {
     // zero page
     flags = ((SBtreeInitPageArg *)arg)->flags;
     leaf = flags & TDB_BTREE_LEAF;
     TDB_BTREE_ASSERT_FLAG(flags);
 
-    tdbPageZero(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    // the prefix bytes are left to the caller
+    szAmHdr = (leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr)) + (flags >> TDB_BTREE_PREFIX_SHIFT);
+
+    tdbPageZero(pPage, szAmHdr, tdbBtreeCellSize);
 
     if (leaf) {
       SLeafHdr *pLeafHdr = (SLeafHdr *)(pPage->pData);
@@ -474,6 +495,128 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   return 0;
 }
 
+// TDB_BTREE_PREFIX =====================
+// On a page with a key prefix, a cell is [header][nShared][key bytes from nShared on][the rest of the local part],
+// the first nShared bytes of the key are those of the page prefix. The local part and the overflow pages are laid
+// out as if the key were stored in full, so factoring the prefix out never changes what goes to overflow pages.
+typedef struct {
+  int nHeader;    // [pgno][kLen][vLen], nShared not included
+  int kLen;
+  int nPayload;   // kLen + vLen, vLen is not a part of the payload on interior pages
+  int szLocal;    // size of the local part with the key stored in full
+  int nKeyLocal;  // key bytes in the local part
+  int nShared;    // key bytes taken from the page prefix
+} SBtreeCellLayout;
+
+static int tdbBtreeLocalSize(const SPage *pPage, int nHeader, int nPayload) {
+  if (nHeader + nPayload <= pPage->maxLocal) {
+    return nHeader + nPayload;
+  }
+
+  int maxLocal = pPage->maxLocal;
+  int minLocal = pPage->minLocal;
+  int surplus = minLocal + (nPayload + nHeader - minLocal) % (maxLocal - sizeof(SPgno));
+  return surplus <= maxLocal ? surplus : minLocal;
+}
+
+static void tdbBtreeCellLayout(const SPage *pPage, const SCell *pCell, SBtreeCellLayout *pLayout) {
+  u8  leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
+  int vLen = 0;
+
+  pLayout->nHeader = leaf ? 0 : sizeof(SPgno);
+  if (pPage->kLen == TDB_VARIANT_LEN) {
+    pLayout->nHeader += tdbGetVarInt(pCell + pLayout->nHeader, &pLayout->kLen);
+  } else {
+    pLayout->kLen = pPage->kLen;
+  }
+  if (pPage->vLen == TDB_VARIANT_LEN) {
+    pLayout->nHeader += tdbGetVarInt(pCell + pLayout->nHeader, &vLen);
+  } else if (leaf) {
+    vLen = pPage->vLen;
+  }
+
+  pLayout->nPayload = pLayout->kLen + vLen;
+  pLayout->szLocal = tdbBtreeLocalSize(pPage, pLayout->nHeader, pLayout->nPayload);
+  if (pLayout->szLocal == pLayout->nHeader + pLayout->nPayload) {
+    pLayout->nKeyLocal = pLayout->kLen;
+  } else {
+    pLayout->nKeyLocal = TMIN(pLayout->kLen, pLayout->szLocal - pLayout->nHeader - (int)sizeof(SPgno));
+  }
+  pLayout->nShared = TDB_BTREE_PAGE_NPREFIX(pPage) > 0 ? pCell[pLayout->nHeader] : 0;
+}
+
+static int tdbBtreeSharedLen(const u8 *pPrefix, int nPrefix, const u8 *pKey) {
+  int n = 0;
+  while (n < nPrefix && pPrefix[n] == pKey[n]) n++;
+  return n;
+}
+
+// copy the first n bytes of the key of a cell, n must not exceed the key bytes in the local part
+static void tdbBtreeCellKeyHead(const SPage *pPage, const SCell *pCell, const SBtreeCellLayout *pLayout, u8 *pHead,
+                                int n) {
+  int nShared = TMIN(n, pLayout->nShared);
+
+  if (TDB_BTREE_PAGE_NPREFIX(pPage) == 0) {
+    memcpy(pHead, pCell + pLayout->nHeader, n);
+    return;
+  }
+
+  memcpy(pHead, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+  memcpy(pHead + nShared, pCell + pLayout->nHeader + 1, n - nShared);
+}
+
+// re-encode a cell of pFrom as a cell of pTo, two pages of the same type which may have different key prefixes
+static int tdbBtreeRecodeCell(const SPage *pFrom, const SCell *pCell, const SPage *pTo, SCell *pOut) {
+  SBtreeCellLayout layout;
+  u8               aHead[TDB_BTREE_MAX_PREFIX];
+  int              nHead;
+  int              nShared;
+  int              szOut;
+  const SCell     *pSuffix;
+
+  tdbBtreeCellLayout(pFrom, pCell, &layout);
+  nHead = TMIN(layout.nKeyLocal, TDB_BTREE_MAX_PREFIX);
+  tdbBtreeCellKeyHead(pFrom, pCell, &layout, aHead, nHead);
+  nShared = tdbBtreeSharedLen(TDB_BTREE_PAGE_PREFIX(pTo), TMIN(TDB_BTREE_PAGE_NPREFIX(pTo), nHead), aHead);
+
+  memcpy(pOut, pCell, layout.nHeader);
+  szOut = layout.nHeader;
+  if (TDB_BTREE_PAGE_NPREFIX(pTo) > 0) {
+    pOut[szOut++] = nShared;
+  }
+
+  // the key bytes pFrom takes from its prefix but pTo does not
+  if (nShared < layout.nShared) {
+    memcpy(pOut + szOut, aHead + nShared, layout.nShared - nShared);
+    szOut += layout.nShared - nShared;
+  }
+
+  // the rest of the local part
+  pSuffix = pCell + layout.nHeader + (TDB_BTREE_PAGE_NPREFIX(pFrom) > 0 ? 1 : 0);
+  if (nShared > layout.nShared) {
+    pSuffix += nShared - layout.nShared;
+  }
+  memcpy(pOut + szOut, pSuffix, layout.szLocal - layout.nHeader - TMAX(nShared, layout.nShared));
+  szOut += layout.szLocal - layout.nHeader - TMAX(nShared, layout.nShared);
+
+  return szOut;
+}
+
+// zero a page whose cells share the key prefix pPrefix, nPrefix may be zero
+static int tdbBtreeZeroPrefixPage(SPage *pPage, u8 flags, const u8 *pPrefix, int nPrefix, SBTree *pBt) {
+  SBtreeInitPageArg zArg;
+
+  zArg.flags = TDB_BTREE_PAGE_TYPE(flags) | (nPrefix << TDB_BTREE_PREFIX_SHIFT);
+  zArg.pBt = pBt;
+  if (tdbBtreeInitPage(pPage, &zArg, 0) < 0) {
+    return -1;
+  }
+
+  memcpy(TDB_BTREE_PAGE_PREFIX(pPage), pPrefix, nPrefix);
+  return 0;
+}
+// TDB_BTREE_PREFIX
+
 // TDB_BTREE_BALANCE =====================
 static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN *pTxn) {
   SPager           *pPager;
@@ -510,6 +653,7 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
 
   // Copy the root page content to the child page
   tdbPageCopy(pRoot, pChild, 0);
+  memcpy(TDB_BTREE_PAGE_PREFIX(pChild), TDB_BTREE_PAGE_PREFIX(pRoot), TDB_BTREE_PAGE_NPREFIX(pRoot));
 
   // Reinitialize the root page
   zArg.flags = TDB_BTREE_ROOT;
@@ -526,9 +670,95 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   return 0;
 }
 
+// the local size and the leading key bytes of a cell, to size it on pages with other key prefixes
+typedef struct {
+  int szLocal;
+  int nHead;
+  u8  aHead[TDB_BTREE_MAX_PREFIX];
+} SBtreeCellHead;
+
+// a new page being filled by balance, sized with each key prefix it may take: none, the prefix of the old page its
+// first cell comes from, or the prefix shared by all its cells
+typedef struct {
+  int       nCell;
+  int       szNone;
+  int       szOld;
+  const u8 *pOld;
+  int       nOld;
+  int       nAll;
+  u8        aAll[TDB_BTREE_MAX_PREFIX];
+} SBtreeNewPage;
+
+static void tdbBtreeGetCellHead(const SPage *pPage, const SCell *pCell, SBtreeCellHead *pHead) {
+  SBtreeCellLayout layout;
+
+  tdbBtreeCellLayout(pPage, pCell, &layout);
+  pHead->szLocal = layout.szLocal;
+  pHead->nHead = TMIN(layout.nKeyLocal, TDB_BTREE_MAX_PREFIX);
+  tdbBtreeCellKeyHead(pPage, pCell, &layout, pHead->aHead, pHead->nHead);
+}
+
+static int tdbBtreeCellSizeWith(const SBtreeCellHead *pHead, const u8 *pPrefix, int nPrefix) {
+  if (nPrefix == 0) {
+    return pHead->szLocal;
+  }
+
+  return pHead->szLocal + 1 - tdbBtreeSharedLen(pPrefix, TMIN(nPrefix, pHead->nHead), pHead->aHead);
+}
+
+static void tdbBtreeNewPageAdd(SBtreeNewPage *pNew, const SBtreeCellHead *pHead, const SPage *pOld, int szOffset,
+                               int keyPrefix) {
+  if (pNew->nCell == 0) {
+    pNew->szNone = 0;
+    pNew->pOld = TDB_BTREE_PAGE_PREFIX(pOld);
+    pNew->nOld = TDB_BTREE_PAGE_NPREFIX(pOld);
+    pNew->szOld = pNew->nOld;
+    pNew->nAll = keyPrefix ? pHead->nHead : 0;
+    memcpy(pNew->aAll, pHead->aHead, pNew->nAll);
+  } else {
+    pNew->nAll = tdbBtreeSharedLen(pNew->aAll, TMIN(pNew->nAll, pHead->nHead), pHead->aHead);
+  }
+
+  pNew->nCell++;
+  pNew->szNone += pHead->szLocal + szOffset;
+  pNew->szOld += tdbBtreeCellSizeWith(pHead, pNew->pOld, pNew->nOld) + szOffset;
+}
+
+// the bytes the cells and the key prefix take on the new page with its best prefix
+static int tdbBtreeNewPageSize(const SBtreeNewPage *pNew, const u8 **ppPrefix, int *nPrefix) {
+  int size = pNew->szNone;
+  int szAll;
+
+  *ppPrefix = NULL;
+  *nPrefix = 0;
+  if (pNew->nCell == 0) {
+    return 0;
+  }
+
+  if (pNew->nOld > 0 && pNew->szOld < size) {
+    size = pNew->szOld;
+    *ppPrefix = pNew->pOld;
+    *nPrefix = pNew->nOld;
+  }
+
+  szAll = pNew->szNone + pNew->nCell * (1 - pNew->nAll) + pNew->nAll;
+  if (pNew->nAll > 0 && szAll < size) {
+    size = szAll;
+    *ppPrefix = pNew->aAll;
+    *nPrefix = pNew->nAll;
+  }
+
+  return size;
+}
+
 static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTxn) {
   int ret;
 
+  SCell *pCellBuf = tdbOsMalloc(pBt->pageSize);
+  if (pCellBuf == NULL) {
+    return -1;
+  }
+
   int    nOlds, pageIdx;
   SPage *pOlds[3] = {0};
   SCell *pDivCell[3] = {0};
@@ -599,7 +829,9 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         if (i < nOlds - 1) {
           ((SPgno *)pDivCell[i])[0] = ((SIntHdr *)pOlds[i]->pData)->pgno;
           ((SIntHdr *)pOlds[i]->pData)->pgno = 0;
-          tdbPageInsertCell(pOlds[i], TDB_PAGE_TOTAL_CELLS(pOlds[i]), pDivCell[i], szDivCell[i], 1);
+          // the divider cell moves down to the child, re-encode it with the key prefix of the child
+          int szCell = tdbBtreeRecodeCell(pParent, pDivCell[i], pOlds[i], pCellBuf);
+          tdbPageInsertCell(pOlds[i], TDB_PAGE_TOTAL_CELLS(pOlds[i]), pCellBuf, szCell, 1);
         }
       }
       rPgno = ((SIntHdr *)pOlds[nOlds - 1]->pData)->pgno;
@@ -651,26 +883,42 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     int size;
     int iPage;
     int oIdx;
+    int nPrefix;
+    u8  aPrefix[TDB_BTREE_MAX_PREFIX];
   } infoNews[5] = {0};
 
   {  // Get how many new pages are needed and the new distribution
+    // the bytes for cells and key prefix on a page
+    int            szUsable = TDB_PAGE_USABLE_SIZE(pOlds[0]) + TDB_BTREE_PAGE_NPREFIX(pOlds[0]);
+    int            szOffset = TDB_PAGE_OFFSET_SIZE(pOlds[0]);
+    int            keyPrefix = pBt->flags & TDB_TB_KEY_PREFIX;
+    SBtreeNewPage  newPage = {0};
+    SBtreeNewPage  tryPage;
+    SBtreeCellHead head;
+    const u8      *pPrefix;
 
     // first loop to find minimum number of pages needed
     for (int oPage = 0; oPage < nOlds; oPage++) {
       SPage *pPage = pOlds[oPage];
       SCell *pCell;
-      int    cellBytes;
       int    oIdx;
 
       for (oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
         pCell = tdbPageGetCell(pPage, oIdx);
-        cellBytes = TDB_BYTES_CELL_TAKEN(pPage, pCell);
+        tdbBtreeGetCellHead(pPage, pCell, &head);
 
-        if (infoNews[nNews].size + cellBytes > TDB_PAGE_USABLE_SIZE(pPage)) {
+        tryPage = newPage;
+        tdbBtreeNewPageAdd(&tryPage, &head, pPage, szOffset, keyPrefix);
+        if (tdbBtreeNewPageSize(&tryPage, &pPrefix, &infoNews[nNews].nPrefix) > szUsable) {
           // page is full, use a new page
+          infoNews[nNews].size = tdbBtreeNewPageSize(&newPage, &pPrefix, &infoNews[nNews].nPrefix);
+          memcpy(infoNews[nNews].aPrefix, pPrefix, infoNews[nNews].nPrefix);
           nNews++;
 
-          ASSERT(infoNews[nNews].size + cellBytes <= TDB_PAGE_USABLE_SIZE(pPage));
+          newPage.nCell = 0;
+          tryPage = newPage;
+          tdbBtreeNewPageAdd(&tryPage, &head, pPage, szOffset, keyPrefix);
+          ASSERT(tdbBtreeNewPageSize(&tryPage, &pPrefix, &infoNews[nNews].nPrefix) <= szUsable);
 
           if (childNotLeaf) {
             // for non-child page, this cell is used as the right-most child,
@@ -678,16 +926,18 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
             continue;
           }
         }
+        newPage = tryPage;
         infoNews[nNews].cnt++;
-        infoNews[nNews].size += cellBytes;
         infoNews[nNews].iPage = oPage;
         infoNews[nNews].oIdx = oIdx;
       }
     }
 
+    infoNews[nNews].size = tdbBtreeNewPageSize(&newPage, &pPrefix, &infoNews[nNews].nPrefix);
+    memcpy(infoNews[nNews].aPrefix, pPrefix, infoNews[nNews].nPrefix);
     nNews++;
 
-    // back loop to make the distribution even
+    // back loop to make the distribution even, each page keeps its key prefix
     for (int iNew = nNews - 1; iNew > 0; iNew--) {
       SCell *pCell;
       int    szLCell, szRCell;
@@ -695,11 +945,10 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
       // balance page (iNew) and (iNew-1)
       for (;;) {
         pCell = tdbPageGetCell(pOlds[infoNews[iNew - 1].iPage], infoNews[iNew - 1].oIdx);
+        tdbBtreeGetCellHead(pOlds[infoNews[iNew - 1].iPage], pCell, &head);
 
-        szLCell = tdbBtreeCellSize(pOlds[infoNews[iNew - 1].iPage], pCell, 0, NULL, NULL);
-        if (!childNotLeaf) {
-          szRCell = szLCell;
-        } else {
+        szLCell = tdbBtreeCellSizeWith(&head, infoNews[iNew - 1].aPrefix, infoNews[iNew - 1].nPrefix) + szOffset;
+        if (childNotLeaf) {
           int    iPage = infoNews[iNew - 1].iPage;
           int    oIdx = infoNews[iNew - 1].oIdx + 1;
           SPage *pPage;
@@ -714,14 +963,16 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
           }
 
           pCell = tdbPageGetCell(pPage, oIdx);
-          szRCell = tdbBtreeCellSize(pPage, pCell, 0, NULL, NULL);
+          tdbBtreeGetCellHead(pPage, pCell, &head);
         }
+        szRCell = tdbBtreeCellSizeWith(&head, infoNews[iNew].aPrefix, infoNews[iNew].nPrefix) + szOffset;
 
         if (ASSERT(infoNews[iNew - 1].cnt > 0)) {
           return -1;
         }
 
-        if (infoNews[iNew].size + szRCell >= infoNews[iNew - 1].size - szRCell) {
+        if (infoNews[iNew].size + szRCell >= infoNews[iNew - 1].size - szLCell ||
+            infoNews[iNew].size + szRCell > szUsable) {
           break;
         }
 
@@ -751,7 +1002,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     SBtreeInitPageArg iarg;
     u8                flags;
 
-    flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
+    flags = TDB_BTREE_PAGE_TYPE(TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]));
 
     for (int iNew = 0; iNew < nNews; iNew++) {
       if (iNew < nOlds) {
@@ -777,26 +1028,26 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     // TODO: sort the page according to the page number
   }
 
-  {  // Do the real cell distribution
-    SPage            *pOldsCopy[3] = {0};
-    SCell            *pCell;
-    int               szCell;
-    SBtreeInitPageArg iarg;
-    int               iNew, nNewCells;
-    SCellDecoder      cd = {0};
+  {  // Do the real cell distribution, cells are re-encoded with the key prefix of the page they move to
+    SPage       *pOldsCopy[3] = {0};
+    SCell       *pCell;
+    int          szCell;
+    u8           flags;
+    int          iNew, nNewCells;
+    SCellDecoder cd = {0};
 
-    iarg.pBt = pBt;
-    iarg.flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
+    flags = TDB_BTREE_PAGE_TYPE(TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]));
     for (int i = 0; i < nOlds; i++) {
       tdbPageCreate(pOlds[0]->pageSize, &pOldsCopy[i], tdbDefaultMalloc, NULL);
-      tdbBtreeInitPage(pOldsCopy[i], &iarg, 0);
+      tdbBtreeZeroPrefixPage(pOldsCopy[i], flags, TDB_BTREE_PAGE_PREFIX(pOlds[i]), TDB_BTREE_PAGE_NPREFIX(pOlds[i]),
+                             pBt);
       tdbPageCopy(pOlds[i], pOldsCopy[i], 0);
       pOlds[i]->nOverflow = 0;
     }
 
     iNew = 0;
     nNewCells = 0;
-    tdbBtreeInitPage(pNews[iNew], &iarg, 0);
+    tdbBtreeZeroPrefixPage(pNews[iNew], flags, infoNews[iNew].aPrefix, infoNews[iNew].nPrefix, pBt);
 
     for (int iOld = 0; iOld < nOlds; iOld++) {
       SPage *pPage;
@@ -805,7 +1056,6 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
 
       for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
         pCell = tdbPageGetCell(pPage, oIdx);
-        szCell = tdbBtreeCellSize(pPage, pCell, 0, NULL, NULL);
 
         if (ASSERT(nNewCells <= infoNews[iNew].cnt)) {
           return -1;
@@ -815,7 +1065,8 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         }
 
         if (nNewCells < infoNews[iNew].cnt) {
-          tdbPageInsertCell(pNews[iNew], nNewCells, pCell, szCell, 0);
+          szCell = tdbBtreeRecodeCell(pPage, pCell, pNews[iNew], pCellBuf);
+          tdbPageInsertCell(pNews[iNew], nNewCells, pCellBuf, szCell, 0);
           nNewCells++;
 
           // insert parent page
@@ -828,7 +1079,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
               tdbBtreeDecodeCell(pPage, pCell, &cd, pTxn, pBt);
 
               // TODO: pCell here may be inserted as an overflow cell, handle it
-              SCell *pNewCell = tdbOsMalloc(cd.kLen + 9);
+              SCell *pNewCell = tdbOsMalloc(cd.kLen + 10);
               int    szNewCell;
               SPgno  pgno;
               pgno = TDB_PAGE_PGNO(pNews[iNew]);
@@ -847,7 +1098,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
             iNew++;
             nNewCells = 0;
             if (iNew < nNews) {
-              tdbBtreeInitPage(pNews[iNew], &iarg, 0);
+              tdbBtreeZeroPrefixPage(pNews[iNew], flags, infoNews[iNew].aPrefix, infoNews[iNew].nPrefix, pBt);
             }
           }
         } else {
@@ -866,13 +1117,14 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
             return -1;
           }
           ((SPgno *)pCell)[0] = TDB_PAGE_PGNO(pNews[iNew]);
-          tdbPageInsertCell(pParent, sIdx++, pCell, szCell, 0);
+          szCell = tdbBtreeRecodeCell(pPage, pCell, pParent, pCellBuf);
+          tdbPageInsertCell(pParent, sIdx++, pCellBuf, szCell, 0);
 
           // move to next new page
           iNew++;
           nNewCells = 0;
           if (iNew < nNews) {
-            tdbBtreeInitPage(pNews[iNew], &iarg, 0);
+            tdbBtreeZeroPrefixPage(pNews[iNew], flags, infoNews[iNew].aPrefix, infoNews[iNew].nPrefix, pBt);
           }
         }
       }
@@ -896,12 +1148,17 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     for (int i = 0; i < nOlds; i++) {
       tdbPageDestroy(pOldsCopy[i], tdbDefaultFree, NULL);
     }
+
+    if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+      tdbFree(cd.pKey);
+    }
+    tdbFree(cd.pBuf);
   }
 
   if (TDB_BTREE_PAGE_IS_ROOT(pParent) && TDB_PAGE_TOTAL_CELLS(pParent) == 0) {
-    i8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]);
+    u8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]);
     // copy content to the parent page
-    tdbBtreeInitPage(pParent, &(SBtreeInitPageArg){.flags = flags, .pBt = pBt}, 0);
+    tdbBtreeZeroPrefixPage(pParent, flags, TDB_BTREE_PAGE_PREFIX(pNews[0]), TDB_BTREE_PAGE_NPREFIX(pNews[0]), pBt);
     tdbPageCopy(pNews[0], pParent, 1);
 
     if (!TDB_BTREE_PAGE_IS_LEAF(pNews[0])) {
@@ -927,6 +1184,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     tdbPagerReturnPage(pBt->pPager, pNews[pageIdx], pTxn);
   }
 
+  tdbOsFree(pCellBuf);
   return 0;
 }
 
@@ -1293,6 +1551,17 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
     return -1;
   }
 
+  // 3. Factor the key prefix of the page out
+  if (TDB_BTREE_PAGE_NPREFIX(pPage) > 0) {
+    int nKeyLocal = nPayload < kLen + vLen ? TMIN(kLen, nPayload - (int)sizeof(SPgno)) : kLen;
+    int nShared = tdbBtreeSharedLen(TDB_BTREE_PAGE_PREFIX(pPage), TMIN(TDB_BTREE_PAGE_NPREFIX(pPage), nKeyLocal),
+                                    (const u8 *)pKey);
+
+    memmove(pCell + nHeader + 1, pCell + nHeader + nShared, nPayload - nShared);
+    pCell[nHeader] = nShared;
+    nPayload = nPayload + 1 - nShared;
+  }
+
   *szCell = nHeader + nPayload;
   return 0;
 }
@@ -1500,6 +1769,59 @@ static int tdbBtreeDecodePayload(SPage *pPage, const SCell *pCell, int nHeader,
   return 0;
 }
 
+// decode a cell of a page with a key prefix, the key is rebuilt in the buffer of the decoder
+static int tdbBtreeDecodePrefixPayload(SPage *pPage, const SCell *pCell, int nHeader, SCellDecoder *pDecoder,
+                                       TXN *pTxn, SBTree *pBt) {
+  int    nShared = pCell[nHeader];
+  int    kLen = pDecoder->kLen;
+  int    nPayload = pDecoder->pVal ? kLen : kLen + pDecoder->vLen;
+  int    nLocal = tdbBtreeLocalSize(pPage, nHeader, nPayload);
+  SCell *pLocal;
+  u8    *pBuf;
+  int    ret;
+
+  if (nHeader + nPayload <= pPage->maxLocal) {
+    // no over flow case
+    pBuf = tdbRealloc(pDecoder->pBuf, kLen);
+    if (pBuf == NULL) {
+      return -1;
+    }
+    pDecoder->pBuf = pBuf;
+
+    memcpy(pBuf, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+    memcpy(pBuf + nShared, pCell + nHeader + 1, kLen - nShared);
+    pDecoder->pKey = pBuf;
+    if (pDecoder->pVal == NULL && pDecoder->vLen > 0) {
+      pDecoder->pVal = (SCell *)pCell + nHeader + 1 + kLen - nShared;
+    }
+    return 0;
+  }
+
+  // rebuild the local part with the key stored in full and decode it as usual
+  pLocal = tdbOsMalloc(nLocal);
+  if (pLocal == NULL) {
+    return -1;
+  }
+  memcpy(pLocal, pCell, nHeader);
+  memcpy(pLocal + nHeader, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+  memcpy(pLocal + nHeader + nShared, pCell + nHeader + 1, nLocal - nHeader - nShared);
+
+  ret = tdbBtreeDecodePayload(pPage, pLocal, nHeader, pDecoder, pTxn, pBt);
+  if (ret == 0 && pDecoder->pKey == pLocal + nHeader) {
+    pBuf = tdbRealloc(pDecoder->pBuf, kLen);
+    if (pBuf == NULL) {
+      ret = -1;
+    } else {
+      pDecoder->pBuf = pBuf;
+      memcpy(pBuf, pLocal + nHeader, kLen);
+      pDecoder->pKey = pBuf;
+    }
+  }
+
+  tdbOsFree(pLocal);
+  return ret;
+}
+
 static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pDecoder, TXN *pTxn, SBTree *pBt) {
   u8  leaf;
   int nHeader;
@@ -1554,7 +1876,11 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
   }
 
   // 2. Decode payload part
-  ret = tdbBtreeDecodePayload(pPage, pCell, nHeader, pDecoder, pTxn, pBt);
+  if (TDB_BTREE_PAGE_NPREFIX(pPage) > 0) {
+    ret = tdbBtreeDecodePrefixPayload(pPage, pCell, nHeader, pDecoder, pTxn, pBt);
+  } else {
+    ret = tdbBtreeDecodePayload(pPage, pCell, nHeader, pDecoder, pTxn, pBt);
+  }
   if (ret < 0) {
     return -1;
   }
@@ -1565,6 +1891,7 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
 static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *pTxn, SBTree *pBt) {
   u8  leaf;
   int kLen = 0, vLen = 0, nHeader = 0;
+  int delta = 0;  // bytes saved by the key prefix of the page
 
   leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
 
@@ -1588,9 +1915,13 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
     vLen = pPage->vLen;
   }
 
+  if (TDB_BTREE_PAGE_NPREFIX(pPage) > 0) {
+    delta = pCell[nHeader] - 1;
+  }
+
   int nPayload = kLen + vLen;
   if (nHeader + nPayload <= pPage->maxLocal) {
-    return nHeader + nPayload;
+    return nHeader + nPayload - delta;
   } else {
     int maxLocal = pPage->maxLocal;
 
@@ -1602,7 +1933,7 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
     // free ofp pages' cells
     if (dropOfp) {
       int    ret = 0;
-      SPgno  pgno = *(SPgno *)(pCell + nLocal - sizeof(SPgno));
+      SPgno  pgno = *(SPgno *)(pCell + nLocal - delta - sizeof(SPgno));
       int    nLeft = nPayload - nLocal + sizeof(SPgno) + nHeader;
       SPage *ofp;
       int    bytes;
@@ -1648,7 +1979,7 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
       }
     }
 
-    return nLocal;
+    return nLocal - delta;
   }
 }
 // TDB_BTREE_CELL
@@ -1906,6 +2237,11 @@ int tdbBtreeNext(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     }
   }
 
+  if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+    tdbFree(cd.pKey);
+  }
+  tdbFree(cd.pBuf);
+
   ret = tdbBtcMoveToNext(pBtc);
   if (ret < 0) {
     tdbError("tdb/btree-next: btc move to next failed with ret: %d.", ret);
@@ -1956,6 +2292,14 @@ int tdbBtreePrev(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     memcpy(pVal, cd.pVal, (size_t)cd.vLen);
   }
 
+  if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+    tdbFree(cd.pKey);
+  }
+  if (TDB_CELLDECODER_FREE_VAL(&cd)) {
+    tdbFree(cd.pVal);
+  }
+  tdbFree(cd.pBuf);
+
   ret = tdbBtcMoveToPrev(pBtc);
   if (ret < 0) {
     tdbError("tdb/btree-prev: btc move to prev failed with ret: %d.", ret);
@@ -2204,7 +2548,7 @@ int tdbBtcDelete(SBTC *pBtc) {
           }
 
           // update the cell with new key
-          pCell = tdbOsMalloc(nKey + 9);
+          pCell = tdbOsMalloc(nKey + 10);
           tdbBtreeEncodeCell(pPage, pKey, nKey, &pgno, sizeof(pgno), pCell, &szCell, pBtc->pTxn, pBtc->pBt);
 
           ret = tdbPageUpdateCell(pPage, idx, pCell, szCell, pBtc->pTxn, pBtc->pBt);
@@ -2265,6 +2609,7 @@ int tdbBtcUpsert(SBTC *pBtc, const void *pKey, int kLen, const void *pData, int
   int    szBuf;
   void  *pBuf;
   int    ret;
+  u8     asOvfl;
 
   if (pBtc->idx < 0) {
     tdbError("tdb/btc-upsert: invalid idx: %d.", pBtc->idx);
@@ -2295,6 +2640,10 @@ int tdbBtcUpsert(SBTC *pBtc, const void *pKey, int kLen, const void *pData, int
     return -1;
   }
 
+  // a cell sharing less than the whole key prefix of the page may not fit in the page at all, keep it as an overflow
+  // cell and the balance moves it to a page it fits in
+  asOvfl = szCell + TDB_PAGE_OFFSET_SIZE(pBtc->pPage) > TDB_PAGE_USABLE_SIZE(pBtc->pPage);
+
   // insert or update
   if (insert) {
     if (pBtc->idx > nCells) {
@@ -2302,14 +2651,21 @@ int tdbBtcUpsert(SBTC *pBtc, const void *pKey, int kLen, const void *pData, int
       return -1;
     }
 
-    ret = tdbPageInsertCell(pBtc->pPage, pBtc->idx, pCell, szCell, 0);
+    ret = tdbPageInsertCell(pBtc->pPage, pBtc->idx, pCell, szCell, asOvfl);
   } else {
     if (pBtc->idx >= nCells) {
       tdbError("tdb/btc-upsert: invalid idx: %d, nCells: %d.", pBtc->idx, nCells);
       return -1;
     }
 
-    ret = tdbPageUpdateCell(pBtc->pPage, pBtc->idx, pCell, szCell, pBtc->pTxn, pBtc->pBt);
+    if (asOvfl) {
+      ret = tdbPageDropCell(pBtc->pPage, pBtc->idx, pBtc->pTxn, pBtc->pBt);
+      if (ret == 0) {
+        ret = tdbPageInsertCell(pBtc->pPage, pBtc->idx, pCell, szCell, asOvfl);
+      }
+    } else {
+      ret = tdbPageUpdateCell(pBtc->pPage, pBtc->idx, pCell, szCell, pBtc->pTxn, pBtc->pBt);
+    }
   }
   if (ret < 0) {
     tdbError("tdb/btc-upsert: page insert/update cell failed with ret: %d.", ret);
@@ -2347,6 +2703,74 @@ int tdbBtcUpsert(SBTC *pBtc, const void *pKey, int kLen, const void *pData, int
   return 0;
 }
 
+// locate the key of a cell in the page without decoding the cell, return -1 if part of the key is in overflow pages.
+// On a page with a key prefix the key is rebuilt in the buffer of the decoder.
+static int tdbBtreeCellLocalKey(const SPage *pPage, const SCell *pCell, SCellDecoder *pDecoder, const void **ppKey,
+                                int *kLen) {
+  u8  leaf;
+  int vLen = 0, nHeader = 0;
+
+  leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
+
+  if (!leaf) {
+    nHeader += sizeof(SPgno);
+  }
+
+  if (pPage->kLen == TDB_VARIANT_LEN) {
+    nHeader += tdbGetVarInt(pCell + nHeader, kLen);
+  } else {
+    *kLen = pPage->kLen;
+  }
+
+  if (pPage->vLen == TDB_VARIANT_LEN) {
+    if (!leaf) return -1;
+    nHeader += tdbGetVarInt(pCell + nHeader, &vLen);
+  } else if (leaf) {
+    vLen = pPage->vLen;
+  }
+
+  int nPayload = *kLen + vLen;
+  if (nHeader + nPayload > pPage->maxLocal) {
+    int maxLocal = pPage->maxLocal;
+    int minLocal = pPage->minLocal;
+    int surplus = minLocal + (nPayload + nHeader - minLocal) % (maxLocal - sizeof(SPgno));
+    int nLocal = surplus <= maxLocal ? surplus : minLocal;
+
+    if (nLocal < *kLen + nHeader + sizeof(SPgno)) return -1;
+  }
+
+  if (TDB_BTREE_PAGE_NPREFIX(pPage) > 0) {
+    int nShared = pCell[nHeader];
+    u8 *pBuf = tdbRealloc(pDecoder->pBuf, *kLen);
+    if (pBuf == NULL) return -1;
+
+    pDecoder->pBuf = pBuf;
+    memcpy(pBuf, TDB_BTREE_PAGE_PREFIX(pPage), nShared);
+    memcpy(pBuf + nShared, pCell + nHeader + 1, *kLen - nShared);
+    *ppKey = pBuf;
+    return 0;
+  }
+
+  *ppKey = pCell + nHeader;
+  return 0;
+}
+
+// get the key at the cursor position for comparison, the value is neither decoded nor loaded from overflow pages
+static int tdbBtcGetKey(SBTC *pBtc, const void **ppKey, int *kLen) {
+  SCell *pCell;
+
+  if (pBtc->idx < 0 || pBtc->idx >= TDB_PAGE_TOTAL_CELLS(pBtc->pPage)) {
+    return -1;
+  }
+
+  pCell = tdbPageGetCell(pBtc->pPage, pBtc->idx);
+  if (tdbBtreeCellLocalKey(pBtc->pPage, pCell, &pBtc->coder, ppKey, kLen) == 0) {
+    return 0;
+  }
+
+  return tdbBtcGet(pBtc, ppKey, kLen, NULL, NULL);
+}
+
 int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
   int         ret;
   int         nCells;
@@ -2432,7 +2856,7 @@ int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
 
     // compare first cell
     pBtc->idx = lidx;
-    tdbBtcGet(pBtc, &pTKey, &tkLen, NULL, NULL);
+    tdbBtcGetKey(pBtc, &pTKey, &tkLen);
     c = pBt->kcmpr(pKey, kLen, pTKey, tkLen);
     if (c <= 0) {
       ridx = lidx - 1;
@@ -2442,7 +2866,7 @@ int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
     // compare last cell
     if (lidx <= ridx) {
       pBtc->idx = ridx;
-      tdbBtcGet(pBtc, &pTKey, &tkLen, NULL, NULL);
+      tdbBtcGetKey(pBtc, &pTKey, &tkLen);
       c = pBt->kcmpr(pKey, kLen, pTKey, tkLen);
       if (c >= 0) {
         lidx = ridx + 1;
@@ -2457,7 +2881,7 @@ int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
       if (lidx > ridx) break;
 
       pBtc->idx = (lidx + ridx) >> 1;
-      tdbBtcGet(pBtc, &pTKey, &tkLen, NULL, NULL);
+      tdbBtcGetKey(pBtc, &pTKey, &tkLen);
       c = pBt->kcmpr(pKey, kLen, pTKey, tkLen);
       if (c < 0) {
         // pKey < cd.pKey
@@ -2490,6 +2914,7 @@ int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
 
 int tdbBtcClose(SBTC *pBtc) {
   if (pBtc->iPage < 0) {
+    tdbFree(pBtc->coder.pBuf);
     if (pBtc->freeTxn) {
       tdbTxnClose(pBtc->pTxn);
     }
@@ -2521,6 +2946,8 @@ int tdbBtcClose(SBTC *pBtc) {
     tdbFree(pBtc->coder.pVal);
   }
 
+  tdbFree(pBtc->coder.pBuf);
+
   if (pBtc->freeTxn) {
     tdbTxnClose(pBtc->pTxn);
   }
@@ -26,6 +26,11 @@ struct STBC {
 
 int tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb,
               int8_t rollback) {
+  return tdbTbOpenEx(tbname, keyLen, valLen, keyCmprFn, pEnv, ppTb, rollback, 0);
+}
+
+int tdbTbOpenEx(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb,
+                int8_t rollback, int32_t flags) {
   TTB    *pTb;
   SPager *pPager;
   int     ret;
@@ -116,7 +121,7 @@ int tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprF
   }
 
   // pTb->pBt
-  ret = tdbBtreeOpen(keyLen, valLen, pPager, tbname, pgno, keyCmprFn, pEnv, &(pTb->pBt));
+  ret = tdbBtreeOpen(keyLen, valLen, pPager, tbname, pgno, keyCmprFn, flags, pEnv, &(pTb->pBt));
   if (ret < 0) {
     tdbOsFree(pTb);
     return -1;
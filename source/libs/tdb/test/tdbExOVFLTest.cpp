@@ -495,3 +495,79 @@ TEST(tdb_test, simple_insert1) {
   ret = tdbClose(pEnv);
   GTEST_ASSERT_EQ(ret, 0);
 }
+
+static std::string mixedKey(int i, bool longKey) {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%08d", i);
+  // every third long key is larger than the local limit and spills into overflow pages
+  return std::string(buf) + std::string((longKey && i % 3 == 0) ? 1500 : 8, 'k');
+}
+
+static std::string mixedVal(int i) {
+  // odd entries keep their keys in the page while the values overflow
+  return std::string(i % 2 ? 3000 : 24, (char)('a' + i % 26));
+}
+
+static void mixedKeyGet(TDB *pEnv, char const *tbName, bool longKey) {
+  int const nData = 600;
+  int       ret = 0;
+
+  TTB *pDb = NULL;
+  ret = tdbTbOpen(tbName, -1, longKey ? 0 : -1, tDefaultKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  SPoolMem *pPool = openPool();
+  TXN      *txn = NULL;
+  tdbBegin(pEnv, &txn, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+
+  // insert out of order so that the searches go through interior pages
+  for (int n = 0; n < nData; n++) {
+    int         i = (n * 7) % nData;
+    std::string key = mixedKey(i, longKey);
+    std::string val = longKey ? std::string() : mixedVal(i);
+    ret = tdbTbInsert(pDb, key.data(), key.size(), val.data(), val.size(), txn);
+    GTEST_ASSERT_EQ(ret, 0);
+  }
+
+  tdbCommit(pEnv, txn);
+  tdbPostCommit(pEnv, txn);
+  closePool(pPool);
+
+  for (int i = 0; i < nData; i++) {
+    std::string key = mixedKey(i, longKey);
+    std::string val = longKey ? std::string() : mixedVal(i);
+    void       *pVal = NULL;
+    int         vLen = 0;
+
+    ret = tdbTbGet(pDb, key.data(), key.size(), &pVal, &vLen);
+    GTEST_ASSERT_EQ(ret, 0);
+    GTEST_ASSERT_EQ(vLen, (int)val.size());
+    GTEST_ASSERT_EQ(memcmp(val.data(), pVal, vLen), 0);
+    tdbFree(pVal);
+  }
+
+  {  // keys between and beyond the existing ones
+    void       *pVal = NULL;
+    int         vLen = 0;
+    std::string key = mixedKey(nData / 2, longKey) + "z";
+    GTEST_ASSERT_EQ(tdbTbGet(pDb, key.data(), key.size(), &pVal, &vLen), -1);
+    key = mixedKey(nData, longKey);
+    GTEST_ASSERT_EQ(tdbTbGet(pDb, key.data(), key.size(), &pVal, &vLen), -1);
+    tdbFree(pVal);
+  }
+
+  tdbTbClose(pDb);
+}
+
+TEST(TdbOVFLPagesTest, TbMixedKeyGetTest) {
+  taosRemoveDir("tdb");
+
+  TDB *pEnv = openEnv("tdb", 4096, 64);
+  GTEST_ASSERT_NE(pEnv, nullptr);
+
+  mixedKeyGet(pEnv, "ofp_mixed_val.db", false);
+  mixedKeyGet(pEnv, "ofp_mixed_key.db", true);
+
+  int ret = tdbClose(pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+}
@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "tdb.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::map<std::string, std::string> SModel;
+
+void *tMalloc(void *arg, size_t size) { return taosMemoryMalloc(size); }
+void  tFree(void *arg, void *ptr) { taosMemoryFree(ptr); }
+
+// keys of the meta tables: table names under a few db prefixes, most of them sharing a long prefix
+std::string nameKey(int i) {
+  switch (i % 7) {
+    case 0:
+      return "a" + std::to_string(i);
+    case 1:
+      return "vnode2.meta.t" + std::to_string(i);
+    default:
+      return "vnode2.meta.table.power.meters.d" + std::to_string(i);
+  }
+}
+
+std::string nameVal(int i, int round) {
+  // large values go to overflow pages
+  if (i % 211 == 0) return std::string(9000 + i % 100, 'a' + round);
+  return std::to_string(i * 10 + round);
+}
+
+// (suid, tag value, uid) as in the tag index, compared field by field
+#pragma pack(push, 1)
+typedef struct {
+  int64_t suid;
+  char    tag[24];
+  int64_t uid;
+} STagKey;
+#pragma pack(pop)
+
+int tagKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  const STagKey *pTag1 = (const STagKey *)pKey1;
+  const STagKey *pTag2 = (const STagKey *)pKey2;
+
+  if (pTag1->suid != pTag2->suid) return pTag1->suid < pTag2->suid ? -1 : 1;
+  int c = memcmp(pTag1->tag, pTag2->tag, sizeof(pTag1->tag));
+  if (c != 0) return c;
+  if (pTag1->uid != pTag2->uid) return pTag1->uid < pTag2->uid ? -1 : 1;
+  return 0;
+}
+
+STagKey tagKey(int i) {
+  STagKey key = {0};
+  key.suid = 1000 + i % 3;
+  snprintf(key.tag, sizeof(key.tag), "location.%d", i % 17);
+  key.uid = i;
+  return key;
+}
+
+void insertAll(TDB *pEnv, TTB *pTb, const std::vector<std::pair<std::string, std::string>> &kvs, SModel &model) {
+  TXN *txn = NULL;
+
+  for (size_t i = 0; i < kvs.size(); i++) {
+    if (txn == NULL) tdbBegin(pEnv, &txn, tMalloc, tFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+
+    ASSERT_EQ(tdbTbUpsert(pTb, kvs[i].first.data(), kvs[i].first.size(), kvs[i].second.data(), kvs[i].second.size(),
+                          txn),
+              0);
+    model[kvs[i].first] = kvs[i].second;
+
+    if (i % 2000 == 1999) {
+      tdbCommit(pEnv, txn);
+      tdbPostCommit(pEnv, txn);
+      txn = NULL;
+    }
+  }
+
+  if (txn) {
+    tdbCommit(pEnv, txn);
+    tdbPostCommit(pEnv, txn);
+  }
+}
+
+void deleteSome(TDB *pEnv, TTB *pTb, SModel &model, int step) {
+  TXN *txn = NULL;
+  int  i = 0;
+
+  tdbBegin(pEnv, &txn, tMalloc, tFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  for (auto it = model.begin(); it != model.end(); i++) {
+    if (i % step == 0) {
+      ASSERT_EQ(tdbTbDelete(pTb, it->first.data(), it->first.size(), txn), 0);
+      it = model.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  tdbCommit(pEnv, txn);
+  tdbPostCommit(pEnv, txn);
+}
+
+void checkAll(TTB *pTb, const SModel &model) {
+  void *pKey = NULL;
+  void *pVal = NULL;
+  int   kLen, vLen;
+
+  for (auto &kv : model) {
+    ASSERT_EQ(tdbTbGet(pTb, kv.first.data(), kv.first.size(), &pVal, &vLen), 0) << kv.first;
+    ASSERT_EQ(std::string((char *)pVal, vLen), kv.second) << kv.first;
+  }
+
+  // forward and backward scans return the keys in order
+  TBC *pTbc = NULL;
+  ASSERT_EQ(tdbTbcOpen(pTb, &pTbc, NULL), 0);
+  tdbTbcMoveToFirst(pTbc);
+  for (auto &kv : model) {
+    ASSERT_EQ(tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+    ASSERT_EQ(std::string((char *)pKey, kLen), kv.first);
+    ASSERT_EQ(std::string((char *)pVal, vLen), kv.second);
+  }
+  ASSERT_NE(tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+  tdbTbcClose(pTbc);
+
+  ASSERT_EQ(tdbTbcOpen(pTb, &pTbc, NULL), 0);
+  tdbTbcMoveToLast(pTbc);
+  for (auto it = model.rbegin(); it != model.rend(); ++it) {
+    ASSERT_EQ(tdbTbcPrev(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+    ASSERT_EQ(std::string((char *)pKey, kLen), it->first);
+  }
+  tdbTbcClose(pTbc);
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+}
+
+std::vector<std::pair<std::string, std::string>> nameKvs(int start, int end, int round) {
+  std::vector<std::pair<std::string, std::string>> kvs;
+  for (int i = start; i < end; i++) {
+    kvs.push_back({nameKey(i), nameVal(i, round)});
+  }
+  std::shuffle(kvs.begin(), kvs.end(), std::mt19937(start + round));
+  return kvs;
+}
+
+int64_t dbFileSize(const char *dbname) {
+  int64_t size = 0;
+  taosStatFile((std::string(dbname) + "/main.tdb").c_str(), &size, NULL, NULL);
+  return size;
+}
+
+}  // namespace
+
+TEST(TdbKeyPrefixTest, nameIdx) {
+  TDB   *pEnv;
+  TTB   *pTb;
+  SModel model;
+
+  taosRemoveDir("tdb_prefix");
+  ASSERT_EQ(tdbOpen("tdb_prefix", 4096, 256, &pEnv, 0, 0, NULL), 0);
+  ASSERT_EQ(tdbTbOpenEx("name.idx", -1, -1, NULL, pEnv, &pTb, 0, TDB_TB_KEY_PREFIX), 0);
+
+  // the tree grows with keys sharing the prefix and keys sharing less of it in between
+  ASSERT_NO_FATAL_FAILURE(insertAll(pEnv, pTb, nameKvs(0, 30000, 0), model));
+  ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+  ASSERT_NO_FATAL_FAILURE(deleteSome(pEnv, pTb, model, 3));
+  ASSERT_NO_FATAL_FAILURE(insertAll(pEnv, pTb, nameKvs(10000, 40000, 1), model));
+  ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+  // pages are self-describing, the tree is readable and writable without the option
+  tdbTbClose(pTb);
+  tdbClose(pEnv);
+  ASSERT_EQ(tdbOpen("tdb_prefix", 4096, 256, &pEnv, 0, 0, NULL), 0);
+  ASSERT_EQ(tdbTbOpen("name.idx", -1, -1, NULL, pEnv, &pTb, 0), 0);
+  ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+  ASSERT_NO_FATAL_FAILURE(deleteSome(pEnv, pTb, model, 2));
+  ASSERT_NO_FATAL_FAILURE(insertAll(pEnv, pTb, nameKvs(35000, 45000, 2), model));
+  ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+  // and deleting everything empties it
+  ASSERT_NO_FATAL_FAILURE(deleteSome(pEnv, pTb, model, 1));
+  ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+  tdbTbClose(pTb);
+  tdbClose(pEnv);
+  taosRemoveDir("tdb_prefix");
+}
+
+TEST(TdbKeyPrefixTest, tagIdx) {
+  TDB   *pEnv;
+  TTB   *pTb;
+  TXN   *txn;
+  int    nData = 20000;
+  void  *pKey = NULL;
+  void  *pVal = NULL;
+  int    kLen, vLen, c;
+
+  taosRemoveDir("tdb_prefix");
+  ASSERT_EQ(tdbOpen("tdb_prefix", 4096, 256, &pEnv, 0, 0, NULL), 0);
+  ASSERT_EQ(tdbTbOpenEx("tag.idx", sizeof(STagKey), 0, tagKeyCmpr, pEnv, &pTb, 0, TDB_TB_KEY_PREFIX), 0);
+
+  tdbBegin(pEnv, &txn, tMalloc, tFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  for (int i = 0; i < nData; i++) {
+    STagKey key = tagKey((i * 7919) % nData);
+    ASSERT_EQ(tdbTbInsert(pTb, &key, sizeof(key), NULL, 0, txn), 0);
+  }
+  tdbCommit(pEnv, txn);
+  tdbPostCommit(pEnv, txn);
+
+  // the comparator sees the full keys, a scan from a (suid, tag) returns its uids in order
+  for (int i = 0; i < 51; i++) {
+    STagKey key = tagKey(i);
+    key.uid = 0;
+
+    TBC *pTbc = NULL;
+    ASSERT_EQ(tdbTbcOpen(pTb, &pTbc, NULL), 0);
+    ASSERT_EQ(tdbTbcMoveTo(pTbc, &key, sizeof(key), &c), 0);
+    if (c > 0) tdbTbcMoveToNext(pTbc);
+
+    int64_t lastUid = -1;
+    int     nUid = 0;
+    while (tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen) == 0) {
+      STagKey *pTag = (STagKey *)pKey;
+      ASSERT_EQ(kLen, (int)sizeof(STagKey));
+      if (pTag->suid != key.suid || memcmp(pTag->tag, key.tag, sizeof(key.tag)) != 0) break;
+      ASSERT_GT(pTag->uid, lastUid);
+      ASSERT_EQ(tagKey(pTag->uid).suid, key.suid);
+      lastUid = pTag->uid;
+      nUid++;
+    }
+    tdbTbcClose(pTbc);
+
+    int nExpected = 0;
+    for (int j = 0; j < nData; j++) {
+      STagKey exp = tagKey(j);
+      if (exp.suid == key.suid && memcmp(exp.tag, key.tag, sizeof(key.tag)) == 0) nExpected++;
+    }
+    ASSERT_EQ(nUid, nExpected) << i;
+  }
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tdbTbClose(pTb);
+  tdbClose(pEnv);
+  taosRemoveDir("tdb_prefix");
+}
+
+TEST(TdbKeyPrefixTest, pagesSaved) {
+  int64_t size[2];
+
+  // the same table names with and without the prefix factored out
+  for (int i = 0; i < 2; i++) {
+    TDB   *pEnv;
+    TTB   *pTb;
+    SModel model;
+
+    taosRemoveDir("tdb_prefix");
+    ASSERT_EQ(tdbOpen("tdb_prefix", 4096, 256, &pEnv, 0, 0, NULL), 0);
+    ASSERT_EQ(tdbTbOpenEx("name.idx", -1, sizeof(int64_t), NULL, pEnv, &pTb, 0, i ? TDB_TB_KEY_PREFIX : 0), 0);
+
+    std::vector<std::pair<std::string, std::string>> kvs;
+    for (int64_t uid = 0; uid < 50000; uid++) {
+      kvs.push_back({"vnode2.meta.table.power.meters.d" + std::to_string(uid), std::string((char *)&uid, sizeof(uid))});
+    }
+    ASSERT_NO_FATAL_FAILURE(insertAll(pEnv, pTb, kvs, model));
+    ASSERT_NO_FATAL_FAILURE(checkAll(pTb, model));
+
+    tdbTbClose(pTb);
+    tdbClose(pEnv);
+    size[i] = dbFileSize("tdb_prefix");
+  }
+
+  EXPECT_LT(size[1], size[0] * 3 / 4);
+  taosRemoveDir("tdb_prefix");
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "tdb.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// multi-threaded point lookups on one table, the page cache is shared by all the readers
+
+static void *benchMalloc(void *arg, size_t size) { return taosMemoryMalloc(size); }
+static void  benchFree(void *arg, void *ptr) { taosMemoryFree(ptr); }
+
+static int benchKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  int64_t k1 = *(int64_t *)pKey1;
+  int64_t k2 = *(int64_t *)pKey2;
+  return k1 < k2 ? -1 : (k1 > k2 ? 1 : 0);
+}
+
+static const int64_t nBenchKeys = 200000;
+static const int     nBenchVLen = 64;
+
+static void benchFillVal(int64_t key, char *val) {
+  for (int i = 0; i < nBenchVLen; i++) {
+    val[i] = (char)((key + i) & 0x7f);
+  }
+}
+
+static void benchLoad(TDB *pEnv, TTB *pDb) {
+  TXN *txn = NULL;
+  char val[nBenchVLen];
+
+  ASSERT_EQ(tdbBegin(pEnv, &txn, benchMalloc, benchFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED), 0);
+  for (int64_t key = 0; key < nBenchKeys; key++) {
+    benchFillVal(key, val);
+    ASSERT_EQ(tdbTbInsert(pDb, &key, sizeof(key), val, nBenchVLen, txn), 0);
+  }
+  ASSERT_EQ(tdbCommit(pEnv, txn), 0);
+  ASSERT_EQ(tdbPostCommit(pEnv, txn), 0);
+}
+
+static void benchLookup(TTB *pDb, int tid, int64_t nLookups, std::atomic<int64_t> *nErrors) {
+  uint64_t seed = 0x9e3779b97f4a7c15ULL * (tid + 1);
+  char     expect[nBenchVLen];
+
+  for (int64_t i = 0; i < nLookups; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t key = (int64_t)((seed >> 33) % nBenchKeys);
+    void   *pVal = NULL;
+    int     vLen = 0;
+
+    if (tdbTbGet(pDb, &key, sizeof(key), &pVal, &vLen) < 0 || vLen != nBenchVLen) {
+      (*nErrors)++;
+    } else {
+      benchFillVal(key, expect);
+      if (memcmp(pVal, expect, nBenchVLen) != 0) (*nErrors)++;
+    }
+    tdbFree(pVal);
+  }
+}
+
+TEST(TdbLookupBenchTest, concurrent_lookup) {
+  TDB *pEnv = NULL;
+  TTB *pDb = NULL;
+
+  taosRemoveDir("tdb_bench");
+
+  // a cache smaller than the table keeps replacing pages while looking up
+  ASSERT_EQ(tdbOpen("tdb_bench", 4096, 1024, &pEnv, 0, 0, NULL), 0);
+  ASSERT_EQ(tdbTbOpen("bench.db", sizeof(int64_t), -1, benchKeyCmpr, pEnv, &pDb, 0), 0);
+  benchLoad(pEnv, pDb);
+
+  const int64_t nLookups = 400000;
+  for (int nThreads = 1; nThreads <= 8; nThreads *= 2) {
+    std::atomic<int64_t>     nErrors(0);
+    std::vector<std::thread> threads;
+
+    int64_t start = taosGetTimestampUs();
+    for (int tid = 0; tid < nThreads; tid++) {
+      threads.emplace_back(benchLookup, pDb, tid, nLookups / nThreads, &nErrors);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    int64_t elapsed = taosGetTimestampUs() - start;
+
+    printf("threads:%d lookups:%" PRId64 " elapsed:%" PRId64 "us throughput:%.0f/s\n", nThreads, nLookups, elapsed,
+           nLookups * 1000000.0 / (elapsed > 0 ? elapsed : 1));
+    EXPECT_EQ(nErrors.load(), 0);
+  }
+
+  tdbTbClose(pDb);
+  tdbClose(pEnv);
+  taosRemoveDir("tdb_bench");
+}
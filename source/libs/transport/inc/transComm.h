@@ -170,11 +170,11 @@ typedef struct {
 #define TRANS_VER 2
 typedef struct {
   char version : 4;  // RPC version
-  char comp : 2;     // compression algorithm, 0:no compression 1:lz4
+  char comp : 2;     // compression algorithm, RPC_COMP_*, read it by TRANS_COMP_ALGO
   char noResp : 2;   // noResp bits, 0: resp, 1: resp
   char persist : 2;  // persist handle,0: no persit, 1: persist handle
   char release : 2;
-  char secured : 2;
+  char compAlgos : 2;  // algorithms the sender decompresses besides lz4, TRANS_COMP_*_MASK, 0 from older versions
   char spi : 2;
   char hasEpSet : 2;  // contain epset or not, 0(default): no epset, 1: contain epset
 
@@ -207,6 +207,15 @@ typedef struct {
 
 #pragma pack(pop)
 
+#define TRANS_COMP_ALGO(pHead)  ((int8_t)((uint8_t)(pHead)->comp & 0x3))
+#define TRANS_COMP_ALGOS(pHead) ((int8_t)((uint8_t)(pHead)->compAlgos & 0x3))
+
+#define TRANS_COMP_ZSTD_MASK 0x1
+#define TRANS_COMP_DICT_MASK 0x2  // a dictionary is loaded, the peer must load the same one
+
+// compression counters of a conn
+typedef SRpcCompStat STransCompStat;
+
 typedef enum { Normal, Quit, Release, Register, Update } STransMsgType;
 typedef enum { ConnNormal, ConnAcquire, ConnRelease, ConnBroken, ConnInPool } ConnStatus;
 
@@ -438,8 +447,24 @@ void transCleanup();
 void transPrintEpSet(SEpSet* pEpSet);
 
 void    transFreeMsg(void* msg);
-int32_t transCompressMsg(char* msg, int32_t len);
-int32_t transDecompressMsg(char** msg, int32_t len);
+// algorithms the peer is told to be able to decompress, see STransMsgHead.compAlgos
+int8_t  transCompAlgos();
+bool    transShouldCompress(STrans* pTransInst, tmsg_t msgType, int32_t contLen, int8_t peerAlgos, int8_t* algo);
+int32_t transCompressMsg(char* msg, int32_t len, int8_t algo, int8_t level, STransCompStat* pStat);
+int32_t transDecompressMsg(char** msg, int32_t len, STransCompStat* pStat);
+int32_t transLoadCompressDict(const char* path, int32_t level);
+void    transFreeCompressDict();
+// free the zstd contexts cached by the calling thread, called before a transport thread quits
+void    transFreeZstdCtx();
+void    transPrintCompStat(const char* label, void* conn, STransCompStat* pStat);
+void    transGetCompStat(SRpcCompStat* pStat);
+
+/*
+ * body segments of msg, see SRpcMsg
+ */
+int32_t transMsgSegsLen(const STransMsg* pMsg);
+int32_t transMergeMsgSegs(STransMsg* pMsg);
+void    transFreeMsgSegs(STransMsg* pMsg);
 
 int32_t transOpenRefMgt(int size, void (*func)(void*));
 void    transCloseRefMgt(int32_t refMgt);
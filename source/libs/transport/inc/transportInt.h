@@ -47,8 +47,10 @@ typedef struct {
   char     label[TSDB_LABEL_LEN];
   char     user[TSDB_UNI_LEN];  // meter ID
   int32_t  compatibilityVer;
-  int32_t  compressSize;  // -1: no compress, 0 : all data compressed, size: compress data if larger than size
-  int8_t   encryption;    // encrypt or not
+  int32_t  compressSize;   // -1: no compress, 0 : all data compressed, size: compress data if larger than size
+  int8_t   compressAlgo;   // RPC_COMP_*
+  int8_t   compressLevel;  // level of zstd
+  int8_t   encryption;     // encrypt or not
 
   int32_t retryMinInterval;  // retry init interval
   int32_t retryStepFactor;   // retry interval factor
@@ -64,8 +66,11 @@ typedef struct {
   void (*destroyFp)(void* ahandle);
   bool (*failFastFp)(tmsg_t msgType);
   bool (*noDelayFp)(tmsg_t msgType);
+  int8_t (*compFp)(tmsg_t msgType);
+  bool (*muxFp)(tmsg_t msgType);
 
   int32_t       connLimitNum;
+  int32_t       muxLimit;
   int8_t        connLimitLock;  // 0: no lock. 1. lock
   int8_t        supportBatch;   // 0: no batch, 1: support batch
   int32_t       batchSize;
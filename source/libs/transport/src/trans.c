@@ -50,6 +50,12 @@ void* rpcOpen(const SRpcInit* pInit) {
     pRpc->compressSize = -1;
   }
 
+  pRpc->compressAlgo = pInit->compressAlgo == RPC_COMP_NONE ? RPC_COMP_LZ4 : pInit->compressAlgo;
+  pRpc->compressLevel = pInit->compressLevel;
+  if (pInit->compressDict != NULL && pInit->compressDict[0] != 0) {
+    // msgs selected for the dictionary fall back to zstd without it
+    (void)transLoadCompressDict(pInit->compressDict, pInit->compressLevel);
+  }
   pRpc->encryption = pInit->encryption;
   pRpc->compatibilityVer = pInit->compatibilityVer;
 
@@ -68,6 +74,12 @@ void* rpcOpen(const SRpcInit* pInit) {
   pRpc->destroyFp = pInit->dfp;
   pRpc->failFastFp = pInit->ffp;
   pRpc->noDelayFp = pInit->noDelayFp;
+  pRpc->compFp = pInit->compFp;
+  pRpc->muxFp = pInit->muxFp;
+  pRpc->muxLimit = pInit->muxLimit;
+  if (pRpc->muxLimit <= 0) {
+    pRpc->muxLimit = 32;
+  }
   pRpc->connLimitNum = pInit->connLimitNum;
   if (pRpc->connLimitNum == 0) {
     pRpc->connLimitNum = 20;
@@ -202,6 +214,8 @@ int32_t rpcCvtErrCode(int32_t code) {
   return code;
 }
 
+void rpcGetCompStat(SRpcCompStat* pStat) { transGetCompStat(pStat); }
+
 int32_t rpcInit() {
   transInit();
   return 0;
@@ -26,6 +26,8 @@ typedef struct SConnList {
   queue     conns;
   int32_t   size;
   SMsgList* list;
+  queue     muxConns;  // conns carrying multiplexed msgs
+  int64_t   connUs;    // moving average of the cost to set up a conn
 } SConnList;
 
 typedef struct {
@@ -68,6 +70,11 @@ typedef struct SCliConn {
   queue      q;
   SConnList* list;
 
+  queue   muxq;
+  bool    mux;          // msgs are multiplexed and matched by seq
+  int64_t connSt;       // time to start connecting
+  int64_t sendDelayUs;  // moving average of the delay of msgs from enqueue to send
+
   STransCtx  ctx;
   bool       broken;  // link broken or not
   ConnStatus status;  //
@@ -76,6 +83,9 @@ typedef struct SCliConn {
 
   SDelayTask* task;
 
+  STransCompStat compStat;
+  int8_t         peerCompAlgos;  // see STransMsgHead.compAlgos, lz4 only until the first response
+
   uint32_t clientIp;
   uint32_t serverIp;
 
@@ -96,6 +106,7 @@ typedef struct SCliMsg {
   uint64_t st;
   int      sent;  //(0: no send, 1: alread sent)
   queue    seqq;
+  uint64_t seq;  // id of multiplexed msg, echoed by server
 } SCliMsg;
 
 typedef struct SCliThrd {
@@ -126,6 +137,8 @@ typedef struct SCliThrd {
 
   SCliMsg* stopMsg;
   bool     quit;
+
+  uint64_t nextSeq;
 } SCliThrd;
 
 typedef struct SCliObj {
@@ -151,6 +164,13 @@ static SCliConn* getConnFromPool(SCliThrd* thread, char* key, bool* exceed);
 static void      addConnToPool(void* pool, SCliConn* conn);
 static void      doCloseIdleConn(void* param);
 
+// multiplexed conn
+static bool      cliMayMux(STrans* pTransInst, SCliMsg* pMsg);
+static void      cliMuxAttach(SCliConn* conn);
+static void      cliMuxDetach(SCliConn* conn);
+static SCliConn* cliMuxGetConn(SCliThrd* pThrd, SConnList* plist);
+static SCliMsg*  cliMuxGetMsg(SCliConn* conn, uint64_t seq);
+
 // register conn timer
 static void cliConnTimeout(uv_timer_t* handle);
 // register timer for read
@@ -249,6 +269,7 @@ static void cliWalkCb(uv_handle_t* handle, void* arg);
   } while (0)
 
 #define CONN_PERSIST_TIME(para)   ((para) <= 90000 ? 90000 : (para))
+#define CONN_MOVING_AVG(avg, val) ((avg) == 0 ? (val) : ((avg)*7 + (val)) / 8)
 #define CONN_GET_INST_LABEL(conn) (((STrans*)(((SCliThrd*)(conn)->hostThrd)->pTransInst))->label)
 
 #define CONN_GET_MSGCTX_BY_AHANDLE(conn, ahandle)                         \
@@ -398,7 +419,8 @@ void cliHandleResp(SCliConn* conn) {
     tTrace("%s conn %p not reset read buf", transLabel(pTransInst), conn);
   }
 
-  if (transDecompressMsg((char**)&pHead, msgLen) < 0) {
+  conn->peerCompAlgos = TRANS_COMP_ALGOS(pHead);
+  if (transDecompressMsg((char**)&pHead, msgLen, &conn->compStat) < 0) {
     tDebug("%s conn %p recv invalid packet, failed to decompress", CONN_GET_INST_LABEL(conn), conn);
   }
   pHead->code = htonl(pHead->code);
@@ -419,7 +441,15 @@ void cliHandleResp(SCliConn* conn) {
 
   SCliMsg*       pMsg = NULL;
   STransConnCtx* pCtx = NULL;
-  if (CONN_NO_PERSIST_BY_APP(conn)) {
+  if (conn->mux) {
+    pMsg = cliMuxGetMsg(conn, (uint64_t)pHead->ahandle);
+    if (pMsg != NULL) transMsg.msgType = pMsg->msg.msgType + 1;
+
+    pCtx = pMsg ? pMsg->ctx : NULL;
+    transMsg.info.ahandle = pCtx ? pCtx->ahandle : NULL;
+    tDebug("%s conn %p get ahandle %p by seq:%" PRIu64 ", in flight:%d", CONN_GET_INST_LABEL(conn), conn,
+           transMsg.info.ahandle, (uint64_t)pHead->ahandle, transQueueSize(&conn->cliMsgs));
+  } else if (CONN_NO_PERSIST_BY_APP(conn)) {
     pMsg = transQueuePop(&conn->cliMsgs);
 
     pCtx = pMsg ? pMsg->ctx : NULL;
@@ -618,6 +648,12 @@ void* destroyConnPool(SCliThrd* pThrd) {
       SCliConn* c = QUEUE_DATA(h, SCliConn, q);
       cliDestroyConn(c, true);
     }
+    while (!QUEUE_IS_EMPTY(&connList->muxConns)) {
+      queue*    h = QUEUE_HEAD(&connList->muxConns);
+      SCliConn* c = QUEUE_DATA(h, SCliConn, muxq);
+      cliMuxDetach(c);
+      c->list = NULL;
+    }
 
     SMsgList* msglist = connList->list;
     while (!QUEUE_IS_EMPTY(&msglist->msgQ)) {
@@ -640,6 +676,82 @@ void* destroyConnPool(SCliThrd* pThrd) {
   return NULL;
 }
 
+/*
+ * Msgs selected by muxFp are multiplexed: several of them are in flight on one conn, each is identified by a seq
+ * carried in the ahandle field of the head, which the server echoes back, so responses are matched out of order. A
+ * multiplexed conn stays out of the idle pool until all its msgs are answered.
+ */
+static bool cliMayMux(STrans* pTransInst, SCliMsg* pMsg) {
+  STransMsg* pReq = &pMsg->msg;
+  if (pTransInst->muxFp == NULL || pTransInst->muxLimit <= 1) return false;
+  if (pMsg->type != Normal || pReq->info.handle != 0 || REQUEST_NO_RESP(pReq) || REQUEST_PERSIS_HANDLE(pReq)) {
+    return false;
+  }
+  // the read timer and the retry on broken link are bound to the whole conn
+  if (pTransInst->startTimer != NULL && pTransInst->startTimer(0, pReq->msgType)) return false;
+  if (pTransInst->retry != NULL && (pTransInst->retry(TSDB_CODE_RPC_BROKEN_LINK, pReq->msgType) ||
+                                    pTransInst->retry(TSDB_CODE_RPC_NETWORK_UNAVAIL, pReq->msgType))) {
+    return false;
+  }
+  return pTransInst->muxFp(pReq->msgType);
+}
+static void cliMuxAttach(SCliConn* conn) {
+  if (conn->mux) return;
+
+  SCliThrd* pThrd = conn->hostThrd;
+  if (conn->list == NULL) {
+    conn->list = taosHashGet((SHashObj*)pThrd->pool, conn->dstAddr, strlen(conn->dstAddr));
+  }
+  if (conn->list == NULL) return;
+
+  conn->mux = true;
+  conn->sendDelayUs = 0;
+  QUEUE_PUSH(&conn->list->muxConns, &conn->muxq);
+  tTrace("%s conn %p multiplexed, dst:%s", CONN_GET_INST_LABEL(conn), conn, conn->dstAddr);
+}
+static void cliMuxDetach(SCliConn* conn) {
+  if (!conn->mux) return;
+
+  conn->mux = false;
+  QUEUE_REMOVE(&conn->muxq);
+  QUEUE_INIT(&conn->muxq);
+}
+// choose the least loaded multiplexed conn, or NULL to set up a new one. A new conn is preferred when the limit allows
+// and msgs wait longer in the write queue than it takes to set up a conn
+static SCliConn* cliMuxGetConn(SCliThrd* pThrd, SConnList* plist) {
+  STrans*   pTransInst = pThrd->pTransInst;
+  SCliConn* conn = NULL;
+  int32_t   minLoad = INT32_MAX;
+  queue*    h = NULL;
+
+  QUEUE_FOREACH(h, &plist->muxConns) {
+    SCliConn* c = QUEUE_DATA(h, SCliConn, muxq);
+    int32_t   load = transQueueSize(&c->cliMsgs);
+    if (load < pTransInst->muxLimit && load < minLoad) {
+      conn = c;
+      minLoad = load;
+    }
+  }
+  if (conn == NULL) return NULL;
+
+  if (plist->list->numOfConn < pTransInst->connLimitNum && conn->sendDelayUs > plist->connUs) {
+    tTrace("%s conn %p send delay:%" PRId64 "us, conn cost:%" PRId64 "us, set up new conn", pTransInst->label, conn,
+           conn->sendDelayUs, plist->connUs);
+    return NULL;
+  }
+  return conn;
+}
+static SCliMsg* cliMuxGetMsg(SCliConn* conn, uint64_t seq) {
+  int32_t sz = transQueueSize(&conn->cliMsgs);
+  for (int32_t i = 0; i < sz; i++) {
+    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, i);
+    if (pMsg->seq == seq) {
+      return transQueueRm(&conn->cliMsgs, i);
+    }
+  }
+  return NULL;
+}
+
 static SCliConn* getConnFromPool(SCliThrd* pThrd, char* key, bool* exceed) {
   void*      pool = pThrd->pool;
   STrans*    pTranInst = pThrd->pTransInst;
@@ -655,6 +767,7 @@ static SCliConn* getConnFromPool(SCliThrd* pThrd, char* key, bool* exceed) {
     nList->numOfConn++;
 
     QUEUE_INIT(&plist->conns);
+    QUEUE_INIT(&plist->muxConns);
     plist->list = nList;
   }
 
@@ -696,9 +809,19 @@ static SCliConn* getConnFromPool2(SCliThrd* pThrd, char* key, SCliMsg** pMsg) {
     nList->numOfConn++;
 
     QUEUE_INIT(&plist->conns);
+    QUEUE_INIT(&plist->muxConns);
     plist->list = nList;
   }
 
+  if (QUEUE_IS_EMPTY(&plist->conns) && cliMayMux(pTransInst, *pMsg)) {
+    SCliConn* conn = cliMuxGetConn(pThrd, plist);
+    if (conn != NULL) {
+      tTrace("%s conn %p multiplexed, in flight:%d, dst:%s", pTransInst->label, conn, transQueueSize(&conn->cliMsgs),
+             key);
+      return conn;
+    }
+  }
+
   STraceId* trace = &(*pMsg)->msg.info.traceId;
   // no avaliable conn in pool
   if (QUEUE_IS_EMPTY(&plist->conns)) {
@@ -767,6 +890,13 @@ static void addConnToPool(void* pool, SCliConn* conn) {
   if (conn->status == ConnInPool) {
     return;
   }
+  if (conn->mux) {
+    if (!transQueueEmpty(&conn->cliMsgs)) {
+      // other multiplexed msgs are still in flight
+      return;
+    }
+    cliMuxDetach(conn);
+  }
   allocConnRef(conn, true);
 
   SCliThrd* thrd = conn->hostThrd;
@@ -930,6 +1060,7 @@ static SCliConn* cliCreateConn(SCliThrd* pThrd) {
   transQueueInit(&conn->cliMsgs, NULL);
   transInitBuffer(&conn->readBuf);
   QUEUE_INIT(&conn->q);
+  QUEUE_INIT(&conn->muxq);
   conn->hostThrd = pThrd;
   conn->status = ConnNormal;
   conn->broken = false;
@@ -946,6 +1077,7 @@ static void cliDestroyConn(SCliConn* conn, bool clear) {
   conn->broken = true;
   QUEUE_REMOVE(&conn->q);
   QUEUE_INIT(&conn->q);
+  cliMuxDetach(conn);
 
   conn->broken = true;
   if (conn->list == NULL) {
@@ -1006,6 +1138,7 @@ static void cliDestroy(uv_handle_t* handle) {
 
   cliDestroyConnMsgs(conn, true);
 
+  transPrintCompStat(CONN_GET_INST_LABEL(conn), conn, &conn->compStat);
   tTrace("%s conn %p destroy successfully", CONN_GET_INST_LABEL(conn), conn);
   transReqQueueClear(&conn->wreqQueue);
   transDestroyBuffer(&conn->readBuf);
@@ -1044,7 +1177,7 @@ static void cliSendCb(uv_write_t* req, int status) {
       tTrace("%s conn %p send cost:%dus ", CONN_GET_INST_LABEL(pConn), pConn, (int)cost);
     }
   }
-  if (pMsg != NULL && pMsg->msg.contLen == 0 && pMsg->msg.pCont != 0) {
+  if (pMsg != NULL && pMsg->msg.contLen == 0 && pMsg->msg.numOfSegs == 0 && pMsg->msg.pCont != 0) {
     rpcFreeCont(pMsg->msg.pCont);
     pMsg->msg.pCont = 0;
   }
@@ -1064,19 +1197,49 @@ static void cliSendCb(uv_write_t* req, int status) {
   }
   uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
 }
+// msgs between the same ip are on the same host, they are never compressed
+static bool cliShouldCompress(SCliConn* pConn, STransMsg* pMsg, int8_t* algo) {
+  SCliThrd* pThrd = pConn->hostThrd;
+  if (pMsg->info.compressed != 0 || pConn->clientIp == pConn->serverIp) return false;
+  return transShouldCompress(pThrd->pTransInst, pMsg->msgType, pMsg->contLen + transMsgSegsLen(pMsg),
+                             pConn->peerCompAlgos, algo);
+}
+// the body segments are written out as they are, merge them into pCont only when the msg is to be compressed
+static void cliPrepareMsgSegs(SCliConn* pConn, STransMsg* pMsg) {
+  int8_t algo = RPC_COMP_NONE;
+  if (pMsg->numOfSegs == 0 || !cliShouldCompress(pConn, pMsg, &algo)) return;
+
+  if (transMergeMsgSegs(pMsg) != 0) {
+    tWarn("%s conn %p failed to merge msg segments, send without compression", CONN_GET_INST_LABEL(pConn), pConn);
+  }
+}
+// head and pCont are contiguous, each body segment takes one more buf
+static int32_t cliFillWriteBufs(STransMsg* pMsg, STransMsgHead* pHead, int32_t msgLen, uv_buf_t* wb) {
+  int32_t segsLen = transMsgSegsLen(pMsg);
+  wb[0] = uv_buf_init((char*)pHead, msgLen - segsLen);
+  for (int32_t i = 0; i < pMsg->numOfSegs; i++) {
+    wb[i + 1] = uv_buf_init(pMsg->pSegs[i].pData, pMsg->pSegs[i].len);
+  }
+  return pMsg->numOfSegs + 1;
+}
 void cliSendBatch(SCliConn* pConn) {
   SCliThrd* pThrd = pConn->hostThrd;
   STrans*   pTransInst = pThrd->pTransInst;
 
   SCliBatch* pBatch = pConn->pBatch;
-  int32_t    wLen = pBatch->wLen;
 
   pBatch->pList->connCnt += 1;
 
-  uv_buf_t* wb = taosMemoryCalloc(wLen, sizeof(uv_buf_t));
+  int32_t nBuf = 0;
+  queue*  h = NULL;
+  QUEUE_FOREACH(h, &pBatch->wq) {
+    SCliMsg* pCliMsg = QUEUE_DATA(h, SCliMsg, q);
+    nBuf += 1 + pCliMsg->msg.numOfSegs;
+  }
+
+  uv_buf_t* wb = taosMemoryCalloc(nBuf, sizeof(uv_buf_t));
   int       i = 0;
 
-  queue* h = NULL;
   QUEUE_FOREACH(h, &pBatch->wq) {
     SCliMsg* pCliMsg = QUEUE_DATA(h, SCliMsg, q);
 
@@ -1087,8 +1250,9 @@ void cliSendBatch(SCliConn* pConn) {
       pMsg->pCont = (void*)rpcMallocCont(0);
       pMsg->contLen = 0;
     }
+    cliPrepareMsgSegs(pConn, pMsg);
 
-    int            msgLen = transMsgLenFromCont(pMsg->contLen);
+    int            msgLen = transMsgLenFromCont(pMsg->contLen) + transMsgSegsLen(pMsg);
     STransMsgHead* pHead = transHeadFromCont(pMsg->pCont);
 
     if (pHead->comp == 0) {
@@ -1102,26 +1266,27 @@ void cliSendBatch(SCliConn* pConn) {
       pHead->traceId = pMsg->info.traceId;
       pHead->magicNum = htonl(TRANS_MAGIC_NUM);
       pHead->version = TRANS_VER;
+      pHead->compAlgos = transCompAlgos();
       pHead->compatibilityVer = htonl(pTransInst->compatibilityVer);
     }
     pHead->timestamp = taosHton64(taosGetTimestampUs());
 
-    if (pHead->comp == 0 && pMsg->info.compressed == 0 && pConn->clientIp != pConn->serverIp) {
-      if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-        msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
-        pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
-      }
-    } else {
+    int8_t algo = RPC_COMP_NONE;
+    if (pHead->comp != 0) {
       msgLen = (int32_t)ntohl((uint32_t)(pHead->msgLen));
+    } else if (pMsg->numOfSegs == 0 && cliShouldCompress(pConn, pMsg, &algo)) {
+      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, algo, pTransInst->compressLevel, &pConn->compStat) +
+               sizeof(STransMsgHead);
+      pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
     }
-    wb[i++] = uv_buf_init((char*)pHead, msgLen);
+    i += cliFillWriteBufs(pMsg, pHead, msgLen, wb + i);
   }
 
   uv_write_t* req = taosMemoryCalloc(1, sizeof(uv_write_t));
   req->data = pConn;
-  tDebug("%s conn %p start to send batch msg, batch size:%d, msgLen:%d", CONN_GET_INST_LABEL(pConn), pConn,
-         pBatch->wLen, pBatch->batchSize);
-  uv_write(req, (uv_stream_t*)pConn->stream, wb, wLen, cliSendBatchCb);
+  tDebug("%s conn %p start to send batch msg, batch size:%d, msgLen:%d, bufs:%d", CONN_GET_INST_LABEL(pConn), pConn,
+         pBatch->wLen, pBatch->batchSize, i);
+  uv_write(req, (uv_stream_t*)pConn->stream, wb, i, cliSendBatchCb);
   taosMemoryFree(wb);
 }
 void cliSend(SCliConn* pConn) {
@@ -1146,12 +1311,13 @@ void cliSend(SCliConn* pConn) {
     tDebug("malloc memory: %p", pMsg->pCont);
     pMsg->contLen = 0;
   }
+  cliPrepareMsgSegs(pConn, pMsg);
 
-  int            msgLen = transMsgLenFromCont(pMsg->contLen);
+  int            msgLen = transMsgLenFromCont(pMsg->contLen) + transMsgSegsLen(pMsg);
   STransMsgHead* pHead = transHeadFromCont(pMsg->pCont);
 
   if (pHead->comp == 0) {
-    pHead->ahandle = pCtx != NULL ? (uint64_t)pCtx->ahandle : 0;
+    pHead->ahandle = pCliMsg->seq != 0 ? pCliMsg->seq : (pCtx != NULL ? (uint64_t)pCtx->ahandle : 0);
     pHead->noResp = REQUEST_NO_RESP(pMsg) ? 1 : 0;
     pHead->persist = REQUEST_PERSIS_HANDLE(pMsg) ? 1 : 0;
     pHead->msgType = pMsg->msgType;
@@ -1161,6 +1327,7 @@ void cliSend(SCliConn* pConn) {
     pHead->traceId = pMsg->info.traceId;
     pHead->magicNum = htonl(TRANS_MAGIC_NUM);
     pHead->version = TRANS_VER;
+    pHead->compAlgos = transCompAlgos();
     pHead->compatibilityVer = htonl(pTransInst->compatibilityVer);
   }
   pHead->timestamp = taosHton64(taosGetTimestampUs());
@@ -1185,22 +1352,30 @@ void cliSend(SCliConn* pConn) {
     uv_timer_start((uv_timer_t*)pConn->timer, cliReadTimeoutCb, TRANS_READ_TIMEOUT, 0);
   }
 
-  if (pHead->comp == 0 && pMsg->info.compressed == 0 && pConn->clientIp != pConn->serverIp) {
-    if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
-      pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
-    }
-  } else {
+  int8_t algo = RPC_COMP_NONE;
+  if (pHead->comp != 0) {
     msgLen = (int32_t)ntohl((uint32_t)(pHead->msgLen));
+  } else if (pMsg->numOfSegs == 0 && cliShouldCompress(pConn, pMsg, &algo)) {
+    msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, algo, pTransInst->compressLevel, &pConn->compStat) +
+             sizeof(STransMsgHead);
+    pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
   }
 
-  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
-          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
+  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d, segs:%d", CONN_GET_INST_LABEL(pConn), pConn,
+          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen, pMsg->numOfSegs);
+
+  uv_buf_t  wbSml[4];
+  uv_buf_t* wb = pMsg->numOfSegs < tListLen(wbSml) ? wbSml : taosMemoryCalloc(pMsg->numOfSegs + 1, sizeof(uv_buf_t));
+  int32_t   nBuf = cliFillWriteBufs(pMsg, pHead, msgLen, wb);
+
+  if (pConn->mux) {
+    pConn->sendDelayUs = CONN_MOVING_AVG(pConn->sendDelayUs, (int64_t)(taosGetTimestampUs() - pCliMsg->st));
+  }
 
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
 
-  int status = uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
+  int status = uv_write(req, (uv_stream_t*)pConn->stream, wb, nBuf, cliSendCb);
+  if (wb != wbSml) taosMemoryFree(wb);
   if (status != 0) {
     tGError("%s conn %p failed to send msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType),
             uv_err_name(status));
@@ -1427,6 +1602,14 @@ void cliConnCb(uv_connect_t* req, int status) {
   if (pConn->pBatch != NULL) {
     cliSendBatch(pConn);
   } else {
+    SCliMsg* pMsg = transQueueGet(&pConn->cliMsgs, 0);
+    if (pMsg != NULL && cliMayMux(pThrd->pTransInst, pMsg)) {
+      cliMuxAttach(pConn);
+      if (pConn->mux) {
+        pConn->list->connUs = CONN_MOVING_AVG(pConn->list->connUs, taosGetTimestampUs() - pConn->connSt);
+        pMsg->seq = ++pThrd->nextSeq;
+      }
+    }
     cliSend(pConn);
   }
 }
@@ -1657,6 +1840,10 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   STraceId* trace = &pMsg->msg.info.traceId;
 
   if (conn != NULL) {
+    if (cliMayMux(pTransInst, pMsg)) {
+      cliMuxAttach(conn);
+      if (conn->mux) pMsg->seq = ++pThrd->nextSeq;
+    }
     transCtxMerge(&conn->ctx, &pMsg->ctx->appCtx);
     transQueuePush(&conn->cliMsgs, pMsg);
     cliSend(conn);
@@ -1710,6 +1897,7 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
       return;
     }
 
+    conn->connSt = taosGetTimestampUs();
     ret = uv_tcp_connect(&conn->connReq, (uv_tcp_t*)(conn->stream), (const struct sockaddr*)&addr, cliConnCb);
     if (ret != 0) {
       uv_timer_stop(conn->timer);
@@ -1988,6 +2176,7 @@ static void* cliWorkThread(void* arg) {
   setThreadName(threadName);
 
   uv_run(pThrd->loop, UV_RUN_DEFAULT);
+  transFreeZstdCtx();
 
   tDebug("thread quit-thread:%08" PRId64, pThrd->pid);
   return NULL;
@@ -2032,6 +2221,7 @@ static FORCE_INLINE void destroyCmsg(void* arg) {
 
   transDestroyConnCtx(pMsg->ctx);
   transFreeMsg(pMsg->msg.pCont);
+  transFreeMsgSegs(&pMsg->msg);
   taosMemoryFree(pMsg);
 }
 static FORCE_INLINE void destroyCmsgWrapper(void* arg, void* param) {
@@ -2059,6 +2249,7 @@ static FORCE_INLINE void destroyCmsgAndAhandle(void* param) {
 
   transDestroyConnCtx(pMsg->ctx);
   transFreeMsg(pMsg->msg.pCont);
+  transFreeMsgSegs(&pMsg->msg);
   taosMemoryFree(pMsg);
 }
 
@@ -2615,6 +2806,7 @@ int transSendRequest(void* shandle, const SEpSet* pEpSet, STransMsg* pReq, STran
   STrans* pTransInst = (STrans*)transAcquireExHandle(transGetInstMgt(), (int64_t)shandle);
   if (pTransInst == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     return TSDB_CODE_RPC_BROKEN_LINK;
   }
 
@@ -2622,6 +2814,7 @@ int transSendRequest(void* shandle, const SEpSet* pEpSet, STransMsg* pReq, STran
   SCliThrd* pThrd = transGetWorkThrd(pTransInst, handle);
   if (pThrd == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     transReleaseExHandle(transGetInstMgt(), (int64_t)shandle);
     return TSDB_CODE_RPC_BROKEN_LINK;
   }
@@ -2661,6 +2854,7 @@ int transSendRecv(void* shandle, const SEpSet* pEpSet, STransMsg* pReq, STransMs
   STransMsg* pTransRsp = taosMemoryCalloc(1, sizeof(STransMsg));
   if (pTransInst == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     taosMemoryFree(pTransRsp);
     return TSDB_CODE_RPC_BROKEN_LINK;
   }
@@ -2668,6 +2862,7 @@ int transSendRecv(void* shandle, const SEpSet* pEpSet, STransMsg* pReq, STransMs
   SCliThrd* pThrd = transGetWorkThrd(pTransInst, (int64_t)pReq->info.handle);
   if (pThrd == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     taosMemoryFree(pTransRsp);
     transReleaseExHandle(transGetInstMgt(), (int64_t)shandle);
     return TSDB_CODE_RPC_BROKEN_LINK;
@@ -2734,6 +2929,7 @@ int transSendRecvWithTimeout(void* shandle, SEpSet* pEpSet, STransMsg* pReq, STr
   STransMsg* pTransMsg = taosMemoryCalloc(1, sizeof(STransMsg));
   if (pTransInst == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     taosMemoryFree(pTransMsg);
     return TSDB_CODE_RPC_BROKEN_LINK;
   }
@@ -2741,6 +2937,7 @@ int transSendRecvWithTimeout(void* shandle, SEpSet* pEpSet, STransMsg* pReq, STr
   SCliThrd* pThrd = transGetWorkThrd(pTransInst, (int64_t)pReq->info.handle);
   if (pThrd == NULL) {
     transFreeMsg(pReq->pCont);
+    transFreeMsgSegs(pReq);
     taosMemoryFree(pTransMsg);
     transReleaseExHandle(transGetInstMgt(), (int64_t)shandle);
     return TSDB_CODE_RPC_BROKEN_LINK;
@@ -14,6 +14,8 @@
  */
 
 #include "transComm.h"
+#define ZSTD_STATIC_LINKING_ONLY  // ZSTD_getDictID_fromDict/ZSTD_getDictID_fromFrame
+#include "zstd.h"
 
 #define BUFFER_CAP 4096
 
@@ -25,7 +27,130 @@ static int32_t transSyncMsgMgt;
 
 void transDestroySyncMsg(void* msg);
 
-int32_t transCompressMsg(char* msg, int32_t len) {
+/*
+ * zstd contexts are cached by each transport thread, the dictionary is shared by all of them and loaded only once
+ */
+static threadlocal ZSTD_CCtx* transZstdCCtx = NULL;
+static threadlocal ZSTD_DCtx* transZstdDCtx = NULL;
+
+static int8_t      transDictLoaded = 0;
+static ZSTD_CDict* transCDict = NULL;
+static ZSTD_DDict* transDDict = NULL;
+static uint32_t    transDictId = 0;
+
+// counters of all the conns, reported by the monitor
+static SRpcCompStat transCompStat = {0};
+
+int32_t transLoadCompressDict(const char* path, int32_t level) {
+  if (atomic_val_compare_exchange_8(&transDictLoaded, 0, 1) != 0) {
+    return 0;
+  }
+
+  int64_t   size = 0;
+  char*     buf = NULL;
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_READ);
+  if (pFile == NULL || taosFStatFile(pFile, &size, NULL) < 0 || size <= 0) {
+    tError("failed to open rpc compression dict %s since %s", path, strerror(errno));
+    goto _err;
+  }
+  if ((buf = taosMemoryMalloc(size)) == NULL || taosReadFile(pFile, buf, size) != size) {
+    tError("failed to read rpc compression dict %s, size:%" PRId64, path, size);
+    goto _err;
+  }
+
+  transDictId = ZSTD_getDictID_fromDict(buf, size);
+  transCDict = ZSTD_createCDict(buf, size, level);
+  transDDict = ZSTD_createDDict(buf, size);
+  if (transDictId == 0 || transCDict == NULL || transDDict == NULL) {
+    tError("invalid rpc compression dict %s, dictId:%u", path, transDictId);
+    goto _err;
+  }
+  tInfo("rpc compression dict %s is loaded, dictId:%u size:%" PRId64 " level:%d", path, transDictId, size, level);
+  taosMemoryFree(buf);
+  taosCloseFile(&pFile);
+  return 0;
+
+_err:
+  taosMemoryFree(buf);
+  taosCloseFile(&pFile);
+  transFreeCompressDict();
+  return -1;
+}
+void transFreeCompressDict() {
+  ZSTD_freeCDict(transCDict);
+  ZSTD_freeDDict(transDDict);
+  transCDict = NULL;
+  transDDict = NULL;
+  transDictId = 0;
+  atomic_store_8(&transDictLoaded, 0);
+}
+
+int8_t transCompAlgos() { return TRANS_COMP_ZSTD_MASK | (transDDict != NULL ? TRANS_COMP_DICT_MASK : 0); }
+
+bool transShouldCompress(STrans* pTransInst, tmsg_t msgType, int32_t contLen, int8_t peerAlgos, int8_t* algo) {
+  *algo = pTransInst->compFp != NULL ? (*pTransInst->compFp)(msgType) : pTransInst->compressAlgo;
+  if (*algo == RPC_COMP_NONE) return false;
+  if (*algo == RPC_COMP_ZSTD_DICT) {
+    // the dictionary is meant for small msgs, neither the size threshold nor compressSize of -1 is applied
+    if (transCDict != NULL && (peerAlgos & TRANS_COMP_DICT_MASK)) return true;
+    *algo = RPC_COMP_ZSTD;
+  }
+  // all versions decompress lz4
+  if (*algo == RPC_COMP_ZSTD && !(peerAlgos & TRANS_COMP_ZSTD_MASK)) {
+    *algo = RPC_COMP_LZ4;
+  }
+
+  if (pTransInst->compressSize == -1) return false;
+  return pTransInst->compressSize < contLen;
+}
+
+static int32_t transCompressImpl(int8_t algo, int8_t level, const char* src, int32_t srcLen, char* dst,
+                                 int32_t dstCap) {
+  if (algo == RPC_COMP_LZ4) {
+    return LZ4_compress_default(src, dst, srcLen, dstCap);
+  }
+
+  if (transZstdCCtx == NULL && (transZstdCCtx = ZSTD_createCCtx()) == NULL) {
+    return -1;
+  }
+  size_t len = 0;
+  if (algo == RPC_COMP_ZSTD_DICT && transCDict != NULL) {
+    len = ZSTD_compress_usingCDict(transZstdCCtx, dst, dstCap, src, srcLen, transCDict);
+  } else {
+    len = ZSTD_compressCCtx(transZstdCCtx, dst, dstCap, src, srcLen, level);
+  }
+  return ZSTD_isError(len) ? -1 : (int32_t)len;
+}
+static int32_t transDecompressImpl(int8_t algo, const char* src, int32_t srcLen, char* dst, int32_t oriLen) {
+  if (algo == RPC_COMP_LZ4) {
+    return LZ4_decompress_safe(src, dst, srcLen, oriLen);
+  }
+
+  if (transZstdDCtx == NULL && (transZstdDCtx = ZSTD_createDCtx()) == NULL) {
+    return -1;
+  }
+  size_t len = 0;
+  if (algo == RPC_COMP_ZSTD_DICT) {
+    uint32_t dictId = ZSTD_getDictID_fromFrame(src, srcLen);
+    if (transDDict == NULL || dictId != transDictId) {
+      tError("failed to decompress rpc msg, dictId:%u, local dictId:%u", dictId, transDictId);
+      return -1;
+    }
+    len = ZSTD_decompress_usingDDict(transZstdDCtx, dst, oriLen, src, srcLen, transDDict);
+  } else {
+    len = ZSTD_decompressDCtx(transZstdDCtx, dst, oriLen, src, srcLen);
+  }
+  return ZSTD_isError(len) ? -1 : (int32_t)len;
+}
+
+void transFreeZstdCtx() {
+  ZSTD_freeCCtx(transZstdCCtx);
+  ZSTD_freeDCtx(transZstdDCtx);
+  transZstdCCtx = NULL;
+  transZstdDCtx = NULL;
+}
+
+int32_t transCompressMsg(char* msg, int32_t len, int8_t algo, int8_t level, STransCompStat* pStat) {
   int32_t        ret = 0;
   int            compHdr = sizeof(STransCompMsg);
   STransMsgHead* pHead = transHeadFromCont(msg);
@@ -37,7 +162,8 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     return ret;
   }
 
-  int32_t clen = LZ4_compress_default(msg, buf, len, len + compHdr);
+  int64_t st = taosGetTimestampUs();
+  int32_t clen = transCompressImpl(algo, level, msg, len, buf, len + compHdr);
   /*
    * only the compressed size is less than the value of contLen - overhead, the compression is applied
    * The first four bytes is set to 0, the second four bytes are utilized to keep the original length of message
@@ -48,17 +174,28 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     pComp->contLen = htonl(len);
     memcpy(msg + compHdr, buf, clen);
 
-    tDebug("compress rpc msg, before:%d, after:%d", len, clen);
+    tDebug("compress rpc msg, algo:%d, before:%d, after:%d", algo, len, clen);
     ret = clen + compHdr;
-    pHead->comp = 1;
+    pHead->comp = algo;
   } else {
     ret = len;
     pHead->comp = 0;
   }
+  int64_t cost = taosGetTimestampUs() - st;
+  if (pStat != NULL) {
+    pStat->numOfComp++;
+    pStat->compRawBytes += len;
+    pStat->compBytes += ret;
+    pStat->compUs += cost;
+  }
+  atomic_add_fetch_64(&transCompStat.numOfComp, 1);
+  atomic_add_fetch_64(&transCompStat.compRawBytes, len);
+  atomic_add_fetch_64(&transCompStat.compBytes, ret);
+  atomic_add_fetch_64(&transCompStat.compUs, cost);
   taosMemoryFree(buf);
   return ret;
 }
-int32_t transDecompressMsg(char** msg, int32_t len) {
+int32_t transDecompressMsg(char** msg, int32_t len, STransCompStat* pStat) {
   STransMsgHead* pHead = (STransMsgHead*)(*msg);
   if (pHead->comp == 0) return 0;
 
@@ -66,23 +203,61 @@ int32_t transDecompressMsg(char** msg, int32_t len) {
 
   STransCompMsg* pComp = (STransCompMsg*)pCont;
   int32_t        oriLen = htonl(pComp->contLen);
+  int8_t         algo = TRANS_COMP_ALGO(pHead);
 
+  int64_t        st = taosGetTimestampUs();
   char*          buf = taosMemoryCalloc(1, oriLen + sizeof(STransMsgHead));
   STransMsgHead* pNewHead = (STransMsgHead*)buf;
-  int32_t        decompLen = LZ4_decompress_safe(pCont + sizeof(STransCompMsg), (char*)pNewHead->content,
-                                                 len - sizeof(STransMsgHead) - sizeof(STransCompMsg), oriLen);
+  if (buf == NULL) {
+    return -1;
+  }
+  int32_t decompLen = transDecompressImpl(algo, pCont + sizeof(STransCompMsg),
+                                          len - sizeof(STransMsgHead) - sizeof(STransCompMsg), (char*)pNewHead->content,
+                                          oriLen);
   memcpy((char*)pNewHead, (char*)pHead, sizeof(STransMsgHead));
 
   pNewHead->msgLen = htonl(oriLen + sizeof(STransMsgHead));
 
   taosMemoryFree(pHead);
   *msg = buf;
+  int64_t cost = taosGetTimestampUs() - st;
+  if (pStat != NULL) {
+    pStat->numOfDecomp++;
+    pStat->decompRawBytes += oriLen;
+    pStat->decompBytes += len - sizeof(STransMsgHead);
+    pStat->decompUs += cost;
+  }
+  atomic_add_fetch_64(&transCompStat.numOfDecomp, 1);
+  atomic_add_fetch_64(&transCompStat.decompRawBytes, oriLen);
+  atomic_add_fetch_64(&transCompStat.decompBytes, len - sizeof(STransMsgHead));
+  atomic_add_fetch_64(&transCompStat.decompUs, cost);
   if (decompLen != oriLen) {
     return -1;
   }
   return 0;
 }
 
+void transPrintCompStat(const char* label, void* conn, STransCompStat* pStat) {
+  if (pStat->numOfComp == 0 && pStat->numOfDecomp == 0) return;
+
+  tDebug("%s conn %p compression, msgs:%" PRId64 " ratio:%.2f cost:%" PRId64 "us, decompression, msgs:%" PRId64
+         " ratio:%.2f cost:%" PRId64 "us",
+         label, conn, pStat->numOfComp, pStat->compBytes == 0 ? 0 : (double)pStat->compRawBytes / pStat->compBytes,
+         pStat->compUs, pStat->numOfDecomp,
+         pStat->decompBytes == 0 ? 0 : (double)pStat->decompRawBytes / pStat->decompBytes, pStat->decompUs);
+}
+
+void transGetCompStat(SRpcCompStat* pStat) {
+  pStat->numOfComp = atomic_load_64(&transCompStat.numOfComp);
+  pStat->compRawBytes = atomic_load_64(&transCompStat.compRawBytes);
+  pStat->compBytes = atomic_load_64(&transCompStat.compBytes);
+  pStat->compUs = atomic_load_64(&transCompStat.compUs);
+  pStat->numOfDecomp = atomic_load_64(&transCompStat.numOfDecomp);
+  pStat->decompRawBytes = atomic_load_64(&transCompStat.decompRawBytes);
+  pStat->decompBytes = atomic_load_64(&transCompStat.decompBytes);
+  pStat->decompUs = atomic_load_64(&transCompStat.decompUs);
+}
+
 void transFreeMsg(void* msg) {
   if (msg == NULL) {
     return;
@@ -90,6 +265,45 @@ void transFreeMsg(void* msg) {
   tTrace("rpc free cont:%p", (char*)msg - TRANS_MSG_OVERHEAD);
   taosMemoryFree((char*)msg - sizeof(STransMsgHead));
 }
+int32_t transMsgSegsLen(const STransMsg* pMsg) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < pMsg->numOfSegs; i++) {
+    len += pMsg->pSegs[i].len;
+  }
+  return len;
+}
+int32_t transMergeMsgSegs(STransMsg* pMsg) {
+  if (pMsg->numOfSegs == 0) return 0;
+
+  int32_t contLen = pMsg->contLen + transMsgSegsLen(pMsg);
+  char*   pCont = rpcMallocCont(contLen);
+  if (pCont == NULL) {
+    return -1;
+  }
+  int32_t offset = 0;
+  if (pMsg->pCont != NULL) {
+    memcpy(pCont, pMsg->pCont, pMsg->contLen);
+    offset += pMsg->contLen;
+    transFreeMsg(pMsg->pCont);
+  }
+  for (int32_t i = 0; i < pMsg->numOfSegs; i++) {
+    memcpy(pCont + offset, pMsg->pSegs[i].pData, pMsg->pSegs[i].len);
+    offset += pMsg->pSegs[i].len;
+  }
+  transFreeMsgSegs(pMsg);
+
+  pMsg->pCont = pCont;
+  pMsg->contLen = contLen;
+  return 0;
+}
+void transFreeMsgSegs(STransMsg* pMsg) {
+  for (int32_t i = 0; i < pMsg->numOfSegs; i++) {
+    taosMemoryFree(pMsg->pSegs[i].pData);
+  }
+  taosMemoryFree(pMsg->pSegs);
+  pMsg->pSegs = NULL;
+  pMsg->numOfSegs = 0;
+}
 int transSockInfo2Str(struct sockaddr* sockname, char* dst) {
   struct sockaddr_in addr = *(struct sockaddr_in*)sockname;
 
@@ -135,6 +349,20 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf, int8_t resetBuf) {
   }
   int total = p->total;
   if (total >= HEADSIZE && !p->invalid) {
+    if (total > BUFFER_CAP && total == p->len) {
+      // the buffer was grown to hold exactly this msg, hand it over instead of copying the body out
+      char* pNew = taosMemoryCalloc(1, BUFFER_CAP);
+      if (pNew == NULL) {
+        return -1;
+      }
+      *buf = p->buf;
+      p->buf = pNew;
+      p->cap = BUFFER_CAP;
+      p->left = -1;
+      p->total = 0;
+      p->len = 0;
+      return total;
+    }
     *buf = taosMemoryCalloc(1, total);
     memcpy(*buf, p->buf, total);
     if (transResetBuffer(connBuf, resetBuf) < 0) {
@@ -628,6 +856,7 @@ static void transInitEnv() {
   uv_os_setenv("UV_TCP_SINGLE_ACCEPT", "1");
 }
 static void transDestroyEnv() {
+  transFreeCompressDict();
   transCloseRefMgt(refMgt);
   transCloseRefMgt(instMgt);
   transCloseRefMgt(transSyncMsgMgt);
@@ -645,6 +874,7 @@ int32_t transGetSyncMsgMgt() { return transSyncMsgMgt; }
 void transCleanup() {
   // clean env
   transDestroyEnv();
+  transFreeZstdCtx();
 }
 int32_t transOpenRefMgt(int size, void (*func)(void*)) {
   // added into once later
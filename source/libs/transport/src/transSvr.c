@@ -58,6 +58,9 @@ typedef struct SSvrConn {
   char    ckey[TSDB_PASSWORD_LEN];  // ciphering key
 
   int64_t whiteListVer;
+
+  STransCompStat compStat;
+  int8_t         peerCompAlgos;  // see STransMsgHead.compAlgos, taken from the requests
 } SSvrConn;
 
 typedef struct SSvrMsg {
@@ -352,7 +355,8 @@ static bool uvHandleReq(SSvrConn* pConn) {
     tTrace("%s conn %p not reset read buf", transLabel(pTransInst), pConn);
   }
 
-  if (transDecompressMsg((char**)&pHead, msgLen) < 0) {
+  pConn->peerCompAlgos = TRANS_COMP_ALGOS(pHead);
+  if (transDecompressMsg((char**)&pHead, msgLen, &pConn->compStat) < 0) {
     tError("%s conn %p recv invalid packet, failed to decompress", transLabel(pTransInst), pConn);
     return false;
   }
@@ -579,6 +583,14 @@ static void uvOnPipeWriteCb(uv_write_t* req, int status) {
   taosMemoryFree(req);
 }
 
+// msgs between the same ip are on the same host, they are never compressed
+static bool uvShouldCompress(SSvrConn* pConn, STransMsg* pMsg, tmsg_t msgType, int8_t* algo) {
+  if (pMsg->info.compressed != 0 || pConn->clientIp == pConn->serverIp) return false;
+  return transShouldCompress(pConn->pTransInst, msgType, pMsg->contLen + transMsgSegsLen(pMsg), pConn->peerCompAlgos,
+                             algo);
+}
+
+// return the number of bufs to write, the head and pCont take one, each body segment takes one more
 static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   SSvrConn*  pConn = smsg->pConn;
   STransMsg* pMsg = &smsg->msg;
@@ -586,6 +598,13 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
     pMsg->pCont = (void*)rpcMallocCont(0);
     pMsg->contLen = 0;
   }
+
+  // the body segments are written out as they are, merge them into pCont only when the msg is to be compressed
+  int8_t algo = RPC_COMP_NONE;
+  tmsg_t msgType = (0 == pMsg->msgType ? pConn->inType + 1 : pMsg->msgType);
+  if (pMsg->numOfSegs > 0 && uvShouldCompress(pConn, pMsg, msgType, &algo) && transMergeMsgSegs(pMsg) != 0) {
+    tWarn("conn %p failed to merge msg segments, send without compression", pConn);
+  }
   STransMsgHead* pHead = transHeadFromCont(pMsg->pCont);
   pHead->ahandle = (uint64_t)pMsg->info.ahandle;
   pHead->traceId = pMsg->info.traceId;
@@ -593,6 +612,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   pHead->magicNum = htonl(TRANS_MAGIC_NUM);
   pHead->compatibilityVer = htonl(((STrans*)pConn->pTransInst)->compatibilityVer);
   pHead->version = TRANS_VER;
+  pHead->compAlgos = transCompAlgos();
 
   // handle invalid drop_task resp, TD-20098
   if (pConn->inType == TDMT_SCH_DROP_TASK && pMsg->code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
@@ -618,25 +638,27 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
 
   pHead->release = smsg->type == Release ? 1 : 0;
   pHead->code = htonl(pMsg->code);
-  pHead->msgLen = htonl(pMsg->contLen + sizeof(STransMsgHead));
 
-  char*   msg = (char*)pHead;
-  int32_t len = transMsgLenFromCont(pMsg->contLen);
+  int32_t segsLen = transMsgSegsLen(pMsg);
+  int32_t len = transMsgLenFromCont(pMsg->contLen) + segsLen;
+  pHead->msgLen = htonl(len);
 
   STrans* pTransInst = pConn->pTransInst;
-  if (pMsg->info.compressed == 0 && pConn->clientIp != pConn->serverIp && pTransInst->compressSize != -1 &&
-      pTransInst->compressSize < pMsg->contLen) {
-    len = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+  if (pMsg->numOfSegs == 0 && uvShouldCompress(pConn, pMsg, pHead->msgType, &algo)) {
+    len = transCompressMsg(pMsg->pCont, pMsg->contLen, algo, pTransInst->compressLevel, &pConn->compStat) +
+          sizeof(STransMsgHead);
     pHead->msgLen = (int32_t)htonl((uint32_t)len);
   }
 
   STraceId* trace = &pMsg->info.traceId;
-  tGDebug("%s conn %p %s is sent to %s, local info:%s, len:%d", transLabel(pTransInst), pConn,
-          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, len);
+  tGDebug("%s conn %p %s is sent to %s, local info:%s, len:%d, segs:%d", transLabel(pTransInst), pConn,
+          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, len, pMsg->numOfSegs);
 
-  wb->base = (char*)pHead;
-  wb->len = len;
-  return 0;
+  wb[0] = uv_buf_init((char*)pHead, len - segsLen);
+  for (int32_t i = 0; i < pMsg->numOfSegs; i++) {
+    wb[i + 1] = uv_buf_init(pMsg->pSegs[i].pData, pMsg->pSegs[i].len);
+  }
+  return pMsg->numOfSegs + 1;
 }
 
 static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
@@ -645,14 +667,20 @@ static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
     return;
   }
 
-  uv_buf_t wb;
-  if (uvPrepareSendData(smsg, &wb) < 0) {
+  // libuv copies the bufs, only the memory they point to is kept until the write is done
+  uv_buf_t  wbSml[4];
+  uv_buf_t* wb = smsg->msg.numOfSegs < tListLen(wbSml) ? wbSml
+                                                         : taosMemoryCalloc(smsg->msg.numOfSegs + 1, sizeof(uv_buf_t));
+  int       nBuf = uvPrepareSendData(smsg, wb);
+  if (nBuf < 0) {
+    if (wb != wbSml) taosMemoryFree(wb);
     return;
   }
 
   transRefSrvHandle(pConn);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
-  uv_write(req, (uv_stream_t*)pConn->pTcp, &wb, 1, uvOnSendCb);
+  uv_write(req, (uv_stream_t*)pConn->pTcp, wb, nBuf, uvOnSendCb);
+  if (wb != wbSml) taosMemoryFree(wb);
 }
 static void uvStartSendResp(SSvrMsg* smsg) {
   // impl
@@ -679,6 +707,7 @@ static FORCE_INLINE void destroySmsg(SSvrMsg* smsg) {
     return;
   }
   transFreeMsg(smsg->msg.pCont);
+  transFreeMsgSegs(&smsg->msg);
   taosMemoryFree(smsg);
 }
 static FORCE_INLINE void destroySmsgWrapper(void* smsg, void* param) { destroySmsg((SSvrMsg*)smsg); }
@@ -1071,6 +1100,7 @@ void* transWorkerThread(void* arg) {
   setThreadName("trans-svr-work");
   SWorkThrd* pThrd = (SWorkThrd*)arg;
   uv_run(pThrd->loop, UV_RUN_DEFAULT);
+  transFreeZstdCtx();
 
   return NULL;
 }
@@ -1152,6 +1182,7 @@ static void uvDestroyConn(uv_handle_t* handle) {
 
   STrans* pTransInst = thrd->pTransInst;
   tDebug("%s conn %p destroy", transLabel(pTransInst), conn);
+  transPrintCompStat(transLabel(pTransInst), conn, &conn->compStat);
 
   for (int i = 0; i < transQueueSize(&conn->srvMsgs); i++) {
     SSvrMsg* msg = transQueueGet(&conn->srvMsgs, i);
@@ -1515,8 +1546,10 @@ _return2:
 }
 
 int transSendResponse(const STransMsg* msg) {
+  STransMsg tmsg = *msg;
   if (msg->info.noResp) {
     rpcFreeCont(msg->pCont);
+    transFreeMsgSegs(&tmsg);
     tTrace("no need send resp");
     return 0;
   }
@@ -1524,12 +1557,12 @@ int transSendResponse(const STransMsg* msg) {
 
   if (exh == NULL) {
     rpcFreeCont(msg->pCont);
+    transFreeMsgSegs(&tmsg);
     return 0;
   }
   int64_t refId = msg->info.refId;
   ASYNC_CHECK_HANDLE(exh, refId);
 
-  STransMsg tmsg = *msg;
   tmsg.info.refId = refId;
 
   SWorkThrd* pThrd = exh->pThrd;
@@ -1550,12 +1583,14 @@ int transSendResponse(const STransMsg* msg) {
 
 _return1:
   tDebug("handle %p failed to send resp", exh);
-  rpcFreeCont(msg->pCont);
+  rpcFreeCont(tmsg.pCont);
+  transFreeMsgSegs(&tmsg);
   transReleaseExHandle(transGetRefMgt(), refId);
   return -1;
 _return2:
   tDebug("handle %p failed to send resp", exh);
-  rpcFreeCont(msg->pCont);
+  rpcFreeCont(tmsg.pCont);
+  transFreeMsgSegs(&tmsg);
   return -1;
 }
 int transRegisterMsg(const STransMsg* msg) {
@@ -27,6 +27,7 @@ typedef struct {
   int      num;
   int      numOfReqs;
   int      msgSize;
+  int      numOfSegs;
   tsem_t   rspSem;
   tsem_t  *pOverSem;
   TdThread thread;
@@ -69,8 +70,21 @@ static void *sendRequest(void *param) {
 
   while (pInfo->numOfReqs == 0 || pInfo->num < pInfo->numOfReqs) {
     pInfo->num++;
-    rpcMsg.pCont = rpcMallocCont(pInfo->msgSize);
-    rpcMsg.contLen = pInfo->msgSize;
+    if (pInfo->numOfSegs > 0) {
+      // the body is split into one pCont and numOfSegs segments, which are written out without copying
+      int segSize = pInfo->msgSize / (pInfo->numOfSegs + 1);
+      rpcMsg.contLen = pInfo->msgSize - segSize * pInfo->numOfSegs;
+      rpcMsg.pCont = rpcMallocCont(rpcMsg.contLen);
+      rpcMsg.pSegs = taosMemoryCalloc(pInfo->numOfSegs, sizeof(SRpcMsgSeg));
+      rpcMsg.numOfSegs = pInfo->numOfSegs;
+      for (int i = 0; i < pInfo->numOfSegs; i++) {
+        rpcMsg.pSegs[i].pData = taosMemoryCalloc(1, segSize);
+        rpcMsg.pSegs[i].len = segSize;
+      }
+    } else {
+      rpcMsg.pCont = rpcMallocCont(pInfo->msgSize);
+      rpcMsg.contLen = pInfo->msgSize;
+    }
     rpcMsg.info.ahandle = pInfo;
     rpcMsg.info.noResp = 1;
     rpcMsg.msgType = 1;
@@ -90,6 +104,7 @@ int main(int argc, char *argv[]) {
   SRpcInit       rpcInit;
   SEpSet         epSet;
   int            msgSize = 128;
+  int            numOfSegs = 0;
   int            numOfReqs = 0;
   int            appThreads = 1;
   char           serverIp[40] = "127.0.0.1";
@@ -128,6 +143,8 @@ int main(int argc, char *argv[]) {
       rpcInit.numOfThreads = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
       msgSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-g") == 0 && i < argc - 1) {
+      numOfSegs = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
       rpcInit.sessions = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
@@ -146,6 +163,7 @@ int main(int argc, char *argv[]) {
       printf("  [-i ip]: first server IP address, default is:%s\n", serverIp);
       printf("  [-t threads]: number of rpc threads, default is:%d\n", rpcInit.numOfThreads);
       printf("  [-m msgSize]: message body size, default is:%d\n", msgSize);
+      printf("  [-g segments]: number of body segments sent without copying, default is:%d\n", numOfSegs);
       printf("  [-a threads]: number of app threads, default is:%d\n", appThreads);
       printf("  [-n requests]: number of requests per thread, default is:%d\n", numOfReqs);
       printf("  [-u user]: user name for the connection, default is:%s\n", rpcInit.user);
@@ -164,7 +182,7 @@ int main(int argc, char *argv[]) {
   }
 
   tInfo("client is initialized");
-  tInfo("threads:%d msgSize:%d requests:%d", appThreads, msgSize, numOfReqs);
+  tInfo("threads:%d msgSize:%d segments:%d requests:%d", appThreads, msgSize, numOfSegs, numOfReqs);
 
   int64_t now = taosGetTimestampUs();
 
@@ -175,6 +193,7 @@ int main(int argc, char *argv[]) {
     pInfo->epSet = epSet;
     pInfo->numOfReqs = numOfReqs;
     pInfo->msgSize = msgSize;
+    pInfo->numOfSegs = numOfSegs;
     tsem_init(&pInfo->rspSem, 0, 0);
     pInfo->pRpc = pRpc;
 
@@ -190,6 +209,8 @@ int main(int argc, char *argv[]) {
 
   tInfo("it takes %.3f mseconds to send %d requests to server", usedTime, numOfReqs * appThreads);
   tInfo("Performance: %.3f requests per second, msgSize:%d bytes", 1000.0 * numOfReqs * appThreads / usedTime, msgSize);
+  tInfo("Throughput: %.3f MB per second, segments:%d", 1000.0 * numOfReqs * appThreads * msgSize / usedTime / 1048576,
+        numOfSegs);
 
   for (int i = 0; i < appThreads; i++) {
     SInfo *pInfo = p;
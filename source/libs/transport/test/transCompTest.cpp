@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3 * or later ("AGPL"), as published by the Free
+ * Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "transComm.h"
+#include "transTestUtil.h"
+#include "zdict.h"
+
+namespace {
+
+const char *label = "COMP";
+const int   port = 7010;
+
+// small msgs that look alike, as heartbeats do
+std::string sampleMsg(int32_t i, int32_t seed) {
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+           "{\"dnodeId\":%d,\"clusterId\":%d,\"rebootTime\":%d,\"numOfCores\":%d,\"vnodes\":[%d,%d,%d],\"seed\":%d}",
+           i % 7, 1000 + seed, i * 13, i % 64, i, i + 1, i + 2, seed);
+  return std::string(buf);
+}
+
+// train a dictionary from the samples of seed and save it to a file
+std::string trainDict(int32_t seed) {
+  std::string         samples;
+  std::vector<size_t> sizes;
+  for (int32_t i = 0; i < 2000; ++i) {
+    std::string msg = sampleMsg(i, seed);
+    samples += msg;
+    sizes.push_back(msg.size());
+  }
+
+  std::vector<char> dict(4096);
+  size_t dictSize = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples.data(), sizes.data(), sizes.size());
+  EXPECT_FALSE(ZDICT_isError(dictSize));
+
+  std::string path = std::string(TD_TMP_DIR_PATH) + "transCompDict" + std::to_string(seed);
+  TdFilePtr   pFile = taosOpenFile(path.c_str(), TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  EXPECT_NE(pFile, nullptr);
+  EXPECT_EQ(taosWriteFile(pFile, dict.data(), dictSize), (int64_t)dictSize);
+  taosCloseFile(&pFile);
+  return path;
+}
+
+int8_t compAlgoDict(tmsg_t msgType) { return RPC_COMP_ZSTD_DICT; }
+
+// compress a copy of msg by algo, returns false if the body is left uncompressed
+bool compressMsg(const std::string &msg, int8_t algo, STransMsgHead **ppHead, int32_t *pLen) {
+  char *pCont = (char *)rpcMallocCont(msg.size());
+  memcpy(pCont, msg.data(), msg.size());
+
+  STransMsgHead *pHead = transHeadFromCont(pCont);
+  memset(pHead, 0, sizeof(STransMsgHead));
+  int32_t len = transCompressMsg(pCont, msg.size(), algo, 3, NULL);
+
+  *ppHead = pHead;
+  *pLen = len + sizeof(STransMsgHead);
+  return TRANS_COMP_ALGO(pHead) == algo;
+}
+
+int32_t decompressMsg(STransMsgHead **ppHead, int32_t len, std::string *pMsg) {
+  int32_t code = transDecompressMsg((char **)ppHead, len, NULL);
+  if (code == 0) {
+    *pMsg = std::string(transContFromHead(*ppHead), htonl((*ppHead)->msgLen) - sizeof(STransMsgHead));
+  }
+  taosMemoryFree(*ppHead);
+  *ppHead = NULL;
+  return code;
+}
+
+}  // namespace
+
+TEST(transCompTest, shouldCompress) {
+  STrans  inst = {0};
+  int8_t  algo = 0;
+  int32_t smallLen = 64;
+  int8_t  peerAlgos = TRANS_COMP_ZSTD_MASK | TRANS_COMP_DICT_MASK;
+
+  inst.compressSize = -1;
+  inst.compressAlgo = RPC_COMP_ZSTD;
+  EXPECT_FALSE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, 1 << 20, peerAlgos, &algo));
+
+  inst.compressSize = 100;
+  EXPECT_FALSE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, smallLen, peerAlgos, &algo));
+  EXPECT_TRUE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, 1000, peerAlgos, &algo));
+  EXPECT_EQ(algo, RPC_COMP_ZSTD);
+
+  // a peer of an older version decompresses lz4 only
+  EXPECT_TRUE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, 1000, 0, &algo));
+  EXPECT_EQ(algo, RPC_COMP_LZ4);
+
+  // without a dictionary the msgs selected for it fall back to zstd and the threshold
+  inst.compFp = compAlgoDict;
+  EXPECT_FALSE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, smallLen, peerAlgos, &algo));
+  inst.compressSize = -1;
+  EXPECT_FALSE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, 1000, peerAlgos, &algo));
+
+  // the dictionary applies to small msgs even if compression is off by compressSize
+  ASSERT_EQ(transLoadCompressDict(trainDict(1).c_str(), 3), 0);
+  EXPECT_EQ(transCompAlgos(), TRANS_COMP_ZSTD_MASK | TRANS_COMP_DICT_MASK);
+  EXPECT_TRUE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, smallLen, peerAlgos, &algo));
+  EXPECT_EQ(algo, RPC_COMP_ZSTD_DICT);
+
+  // but not if the peer has no dictionary
+  inst.compressSize = 100;
+  EXPECT_FALSE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, smallLen, TRANS_COMP_ZSTD_MASK, &algo));
+  EXPECT_TRUE(transShouldCompress(&inst, TDMT_MND_HEARTBEAT, 1000, TRANS_COMP_ZSTD_MASK, &algo));
+  EXPECT_EQ(algo, RPC_COMP_ZSTD);
+  transFreeCompressDict();
+  EXPECT_EQ(transCompAlgos(), TRANS_COMP_ZSTD_MASK);
+}
+
+TEST(transCompTest, roundTrip) {
+  ASSERT_EQ(transLoadCompressDict(trainDict(1).c_str(), 3), 0);
+
+  std::string large;
+  for (int32_t i = 0; i < 100; ++i) {
+    large += sampleMsg(i, 5);
+  }
+  std::string small = sampleMsg(123, 1);
+
+  for (int8_t algo : {RPC_COMP_LZ4, RPC_COMP_ZSTD, RPC_COMP_ZSTD_DICT}) {
+    for (const std::string *msg : {&large, &small}) {
+      STransMsgHead *pHead = NULL;
+      int32_t        len = 0;
+      std::string    out;
+      bool           compressed = compressMsg(*msg, algo, &pHead, &len);
+
+      // small msgs are only worth compressing with the dictionary
+      if (msg == &large || algo == RPC_COMP_ZSTD_DICT) {
+        EXPECT_TRUE(compressed) << "algo:" << (int)algo << " len:" << msg->size();
+        EXPECT_LT(len, msg->size() + sizeof(STransMsgHead));
+      }
+      if (!compressed) {
+        taosMemoryFree(pHead);
+        continue;
+      }
+      ASSERT_EQ(decompressMsg(&pHead, len, &out), 0);
+      EXPECT_EQ(out, *msg);
+    }
+  }
+
+  transFreeCompressDict();
+  transFreeZstdCtx();
+}
+
+TEST(transCompTest, dictIdMismatch) {
+  std::string    small = sampleMsg(7, 1);
+  STransMsgHead *pHead = NULL;
+  int32_t        len = 0;
+  std::string    out;
+
+  ASSERT_EQ(transLoadCompressDict(trainDict(1).c_str(), 3), 0);
+  ASSERT_TRUE(compressMsg(small, RPC_COMP_ZSTD_DICT, &pHead, &len));
+  transFreeCompressDict();
+
+  // the peer loaded another dictionary
+  ASSERT_EQ(transLoadCompressDict(trainDict(2).c_str(), 3), 0);
+  EXPECT_LT(decompressMsg(&pHead, len, &out), 0);
+  transFreeCompressDict();
+
+  // or none at all
+  ASSERT_EQ(transLoadCompressDict(trainDict(1).c_str(), 3), 0);
+  ASSERT_TRUE(compressMsg(small, RPC_COMP_ZSTD_DICT, &pHead, &len));
+  transFreeCompressDict();
+  EXPECT_LT(decompressMsg(&pHead, len, &out), 0);
+  transFreeZstdCtx();
+}
+
+namespace {
+
+struct SEchoClient {
+  tsem_t  sem;
+  SRpcMsg resp;
+};
+
+// echo the request back, so the response is compressed the same way
+void processEchoReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) { TransTestEnv::echoReq(pMsg); }
+
+void processEchoResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  SEchoClient *pCli = (SEchoClient *)parent;
+  pCli->resp = *pMsg;
+  tsem_post(&pCli->sem);
+}
+
+class TransCompEnv : public TransTestEnv {
+ protected:
+  void SetUp() override {
+    TransTestEnv::SetUp();
+    tsem_init(&cli.sem, 0, 0);
+  }
+
+  void TearDown() override {
+    TransTestEnv::TearDown();
+    tsem_destroy(&cli.sem);
+  }
+
+  void initCompRpc(SRpcInit *pInit, int8_t connType, int8_t algo, RpcCompFp compFp, const char *dict) {
+    initRpc(pInit, label, connType, connType == TAOS_CONN_SERVER ? processEchoReq : processEchoResp, &cli);
+    pInit->compressSize = 0;
+    pInit->compressAlgo = algo;
+    pInit->compressLevel = 3;
+    pInit->compressDict = (char *)dict;
+    pInit->compFp = compFp;
+  }
+
+  // send msgs of both sizes from a client to a server configured alike, and check the echoed ones
+  void echoMsgs(int8_t algo, RpcCompFp compFp, const char *dict) {
+    SRpcCompStat before = {0}, after = {0};
+    rpcGetCompStat(&before);
+
+    SRpcInit srvInit, cliInit;
+
+    initCompRpc(&srvInit, TAOS_CONN_SERVER, algo, compFp, dict);
+    ASSERT_NO_FATAL_FAILURE(openServer(&srvInit, port));
+    initCompRpc(&cliInit, TAOS_CONN_CLIENT, algo, compFp, dict);
+    ASSERT_NO_FATAL_FAILURE(openClient(&cliInit));
+
+    // msgs between the same ip are not compressed, the server listens on all addresses and the client is bound to
+    // 127.0.0.1 when connecting to 127.0.0.2
+    SEpSet epSet = {0};
+    addEpIntoEpSet(&epSet, "127.0.0.2", port);
+
+    std::string large;
+    for (int32_t i = 0; i < 200; ++i) {
+      large += sampleMsg(i, 9);
+    }
+    for (const std::string &msg : {sampleMsg(42, 1), large}) {
+      SRpcMsg req = {0};
+      req.msgType = TDMT_MND_HEARTBEAT;
+      req.pCont = rpcMallocCont(msg.size());
+      req.contLen = msg.size();
+      memcpy(req.pCont, msg.data(), msg.size());
+
+      rpcSendRequest(pCli, &epSet, &req, NULL);
+      tsem_wait(&cli.sem);
+
+      EXPECT_EQ(cli.resp.code, 0);
+      ASSERT_EQ(cli.resp.contLen, (int32_t)msg.size());
+      EXPECT_EQ(std::string((char *)cli.resp.pCont, cli.resp.contLen), msg);
+      rpcFreeCont(cli.resp.pCont);
+    }
+
+    // the large msg is compressed both ways, with the algorithms the ends learned from each other by the small one
+    rpcGetCompStat(&after);
+    EXPECT_GE(after.numOfComp - before.numOfComp, 2);
+    EXPECT_GE(after.numOfDecomp - before.numOfDecomp, 2);
+    EXPECT_LT(after.compBytes - before.compBytes, after.compRawBytes - before.compRawBytes);
+  }
+
+  SEchoClient cli = {0};
+};
+
+}  // namespace
+
+TEST_F(TransCompEnv, echoZstd) { echoMsgs(RPC_COMP_ZSTD, NULL, NULL); }
+
+TEST_F(TransCompEnv, echoZstdDict) {
+  std::string dict = trainDict(1);
+  echoMsgs(RPC_COMP_ZSTD, compAlgoDict, dict.c_str());
+  transFreeCompressDict();
+}
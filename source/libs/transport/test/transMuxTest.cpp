@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3 * or later ("AGPL"), as published by the Free
+ * Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "transComm.h"
+#include "transTestUtil.h"
+
+namespace {
+
+const char   *label = "MUX";
+const int     port = 7011;
+const int32_t numOfMsgs = 8;
+
+std::string reqCont(int64_t i) { return "mux req " + std::to_string(i); }
+
+// the server holds the requests until a round is complete, then answers them in reverse order
+struct SMuxServer {
+  std::mutex           mutex;
+  std::vector<SRpcMsg> held;
+  int32_t              roundSize = 1;
+  bool                 answer = true;
+  int32_t              numOfReqs = 0;
+  uint16_t             clientPort = 0;
+  bool                 sameConn = true;
+};
+
+struct SMuxResp {
+  int64_t     ahandle;
+  int32_t     code;
+  std::string cont;
+};
+
+struct SMuxClient {
+  std::mutex            mutex;
+  std::vector<SMuxResp> resps;
+  tsem_t                sem;
+};
+
+SMuxServer srv;
+
+void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  std::lock_guard<std::mutex> lock(srv.mutex);
+  if (srv.numOfReqs++ > 0 && srv.clientPort != pMsg->info.conn.clientPort) srv.sameConn = false;
+  srv.clientPort = pMsg->info.conn.clientPort;
+
+  srv.held.push_back(*pMsg);
+  if (!srv.answer || (int32_t)srv.held.size() < srv.roundSize) return;
+
+  for (auto it = srv.held.rbegin(); it != srv.held.rend(); ++it) {
+    TransTestEnv::echoReq(&*it);
+  }
+  srv.held.clear();
+}
+
+void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  SMuxClient *pCli = (SMuxClient *)parent;
+  {
+    std::lock_guard<std::mutex> lock(pCli->mutex);
+    pCli->resps.push_back({(int64_t)pMsg->info.ahandle, pMsg->code, std::string((char *)pMsg->pCont, pMsg->contLen)});
+  }
+  rpcFreeCont(pMsg->pCont);
+  tsem_post(&pCli->sem);
+}
+
+bool muxAll(tmsg_t msgType) { return true; }
+
+class TransMuxEnv : public TransTestEnv {
+ protected:
+  void SetUp() override {
+    TransTestEnv::SetUp();
+    srv.held.clear();
+    srv.roundSize = 1;
+    srv.answer = true;
+    srv.numOfReqs = 0;
+    srv.sameConn = true;
+
+    SRpcInit srvInit;
+    initRpc(&srvInit, label, TAOS_CONN_SERVER, processReq, NULL);
+    ASSERT_NO_FATAL_FAILURE(openServer(&srvInit, port));
+
+    // a single conn is set up, further msgs are multiplexed on it
+    SRpcInit cliInit;
+    initRpc(&cliInit, label, TAOS_CONN_CLIENT, processResp, &cli);
+    cliInit.connLimitNum = 2;
+    cliInit.muxFp = muxAll;
+    cliInit.muxLimit = numOfMsgs;
+    tsem_init(&cli.sem, 0, 0);
+    ASSERT_NO_FATAL_FAILURE(openClient(&cliInit));
+  }
+
+  void TearDown() override {
+    TransTestEnv::TearDown();
+    tsem_destroy(&cli.sem);
+    for (SRpcMsg &msg : srv.held) {
+      rpcFreeCont(msg.pCont);
+    }
+    srv.held.clear();
+    cli.resps.clear();
+  }
+
+  void sendReqs(int64_t start, int32_t num) {
+    SEpSet epSet = {0};
+    addEpIntoEpSet(&epSet, "127.0.0.1", port);
+    for (int64_t i = start; i < start + num; ++i) {
+      std::string cont = reqCont(i);
+      SRpcMsg     req = {0};
+      req.msgType = TDMT_SCH_QUERY;
+      req.pCont = rpcMallocCont(cont.size());
+      req.contLen = cont.size();
+      req.info.ahandle = (void *)i;
+      memcpy(req.pCont, cont.data(), cont.size());
+      rpcSendRequest(pCli, &epSet, &req, NULL);
+    }
+  }
+
+  void waitResps(int32_t num) {
+    for (int32_t i = 0; i < num; ++i) {
+      tsem_wait(&cli.sem);
+    }
+  }
+
+  // one request to set up the conn and return it to the pool
+  void warmUp() {
+    sendReqs(1000, 1);
+    waitResps(1);
+    ASSERT_EQ(cli.resps[0].code, 0);
+    cli.resps.clear();
+  }
+
+  SMuxClient cli;
+};
+
+}  // namespace
+
+TEST_F(TransMuxEnv, reverseOrder) {
+  warmUp();
+
+  {
+    std::lock_guard<std::mutex> lock(srv.mutex);
+    srv.roundSize = numOfMsgs;
+  }
+  sendReqs(1, numOfMsgs);
+  waitResps(numOfMsgs);
+
+  // all in flight on one conn, each response matched to its own request
+  EXPECT_TRUE(srv.sameConn);
+  ASSERT_EQ((int32_t)cli.resps.size(), numOfMsgs);
+  for (int32_t i = 0; i < numOfMsgs; ++i) {
+    SMuxResp &resp = cli.resps[i];
+    EXPECT_EQ(resp.code, 0);
+    EXPECT_EQ(resp.ahandle, numOfMsgs - i);
+    EXPECT_EQ(resp.cont, reqCont(resp.ahandle));
+  }
+
+  // and the conn is reused once all of them are answered
+  cli.resps.clear();
+  sendReqs(1, numOfMsgs);
+  waitResps(numOfMsgs);
+  EXPECT_TRUE(srv.sameConn);
+  EXPECT_EQ(cli.resps[0].ahandle, numOfMsgs);
+}
+
+TEST_F(TransMuxEnv, brokenLink) {
+  warmUp();
+
+  {
+    std::lock_guard<std::mutex> lock(srv.mutex);
+    srv.answer = false;
+  }
+  sendReqs(1, numOfMsgs);
+  for (int32_t i = 0; i < 100; ++i) {
+    {
+      std::lock_guard<std::mutex> lock(srv.mutex);
+      if ((int32_t)srv.held.size() == numOfMsgs) break;
+    }
+    taosMsleep(20);
+  }
+  ASSERT_EQ((int32_t)srv.held.size(), numOfMsgs);
+  EXPECT_TRUE(srv.sameConn);
+
+  // the server goes away, all the msgs in flight on the conn fail
+  closeServer();
+  waitResps(numOfMsgs);
+
+  ASSERT_EQ((int32_t)cli.resps.size(), numOfMsgs);
+  std::vector<bool> failed(numOfMsgs + 1, false);
+  for (SMuxResp &resp : cli.resps) {
+    EXPECT_NE(resp.code, 0);
+    ASSERT_GE(resp.ahandle, 1);
+    ASSERT_LE(resp.ahandle, numOfMsgs);
+    failed[resp.ahandle] = true;
+  }
+  for (int32_t i = 1; i <= numOfMsgs; ++i) {
+    EXPECT_TRUE(failed[i]) << "msg " << i;
+  }
+}
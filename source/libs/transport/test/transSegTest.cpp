@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3 * or later ("AGPL"), as published by the Free
+ * Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "transComm.h"
+#include "transTestUtil.h"
+
+namespace {
+
+const char *label = "SEG";
+const int   port = 7012;
+
+// split msg into pCont and the body segments following it, at the given offsets
+void fillMsg(SRpcMsg *pMsg, const std::string &msg, const std::vector<size_t> &aSplit) {
+  size_t first = aSplit.empty() ? msg.size() : aSplit[0];
+  pMsg->pCont = rpcMallocCont(first);
+  pMsg->contLen = first;
+  memcpy(pMsg->pCont, msg.data(), first);
+
+  pMsg->numOfSegs = aSplit.size();
+  pMsg->pSegs = (SRpcMsgSeg *)taosMemoryCalloc(aSplit.size() + 1, sizeof(SRpcMsgSeg));
+  for (size_t i = 0; i < aSplit.size(); ++i) {
+    size_t end = i + 1 < aSplit.size() ? aSplit[i + 1] : msg.size();
+    pMsg->pSegs[i].len = end - aSplit[i];
+    pMsg->pSegs[i].pData = taosMemoryMalloc(end - aSplit[i] + 1);
+    memcpy(pMsg->pSegs[i].pData, msg.data() + aSplit[i], end - aSplit[i]);
+  }
+}
+
+std::vector<size_t> splitOf(const std::string &msg) { return {msg.size() / 3, msg.size() / 2, msg.size() - 1}; }
+
+// the server gets the body in one piece and answers with a copy of it in segments again
+void processSegReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  std::string msg((char *)pMsg->pCont, pMsg->contLen);
+  SRpcMsg     rsp = {0};
+  fillMsg(&rsp, msg, splitOf(msg));
+  rsp.info = pMsg->info;
+  rpcFreeCont(pMsg->pCont);
+  rpcSendResponse(&rsp);
+}
+
+struct SSegClient {
+  tsem_t  sem;
+  SRpcMsg resp;
+};
+
+void processSegResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  SSegClient *pCli = (SSegClient *)parent;
+  pCli->resp = *pMsg;
+  tsem_post(&pCli->sem);
+}
+
+class TransSegEnv : public TransTestEnv {
+ protected:
+  void SetUp() override {
+    TransTestEnv::SetUp();
+    tsem_init(&cli.sem, 0, 0);
+  }
+
+  void TearDown() override {
+    TransTestEnv::TearDown();
+    tsem_destroy(&cli.sem);
+  }
+
+  // both ends compress msgs of any size by algo, or none of them if algo is RPC_COMP_NONE
+  void openRpc(int8_t algo) {
+    SRpcInit srvInit, cliInit;
+
+    initRpc(&srvInit, label, TAOS_CONN_SERVER, processSegReq, NULL);
+    initRpc(&cliInit, label, TAOS_CONN_CLIENT, processSegResp, &cli);
+    for (SRpcInit *pInit : {&srvInit, &cliInit}) {
+      pInit->compressSize = algo == RPC_COMP_NONE ? -1 : 0;
+      pInit->compressAlgo = algo;
+      pInit->compressLevel = 3;
+    }
+    ASSERT_NO_FATAL_FAILURE(openServer(&srvInit, port));
+    ASSERT_NO_FATAL_FAILURE(openClient(&cliInit));
+  }
+
+  void echo(const char *ip, const std::string &msg) {
+    SEpSet epSet = {0};
+    addEpIntoEpSet(&epSet, ip, port);
+
+    SRpcMsg req = {0};
+    req.msgType = TDMT_VND_SUBMIT;
+    fillMsg(&req, msg, splitOf(msg));
+    rpcSendRequest(pCli, &epSet, &req, NULL);
+    tsem_wait(&cli.sem);
+
+    EXPECT_EQ(cli.resp.code, 0);
+    ASSERT_EQ(cli.resp.contLen, (int32_t)msg.size());
+    EXPECT_EQ(std::string((char *)cli.resp.pCont, cli.resp.contLen), msg);
+    rpcFreeCont(cli.resp.pCont);
+  }
+
+  SSegClient cli = {0};
+};
+
+std::string largeMsg() {
+  std::string msg;
+  for (int32_t i = 0; i < 20000; ++i) {
+    msg += "row " + std::to_string(i) + ";";
+  }
+  return msg;
+}
+
+}  // namespace
+
+TEST_F(TransSegEnv, segsWrittenAsTheyAre) {
+  ASSERT_NO_FATAL_FAILURE(openRpc(RPC_COMP_NONE));
+
+  // the server listens on all addresses, the client is bound to 127.0.0.1 when connecting to 127.0.0.2
+  for (const char *ip : {"127.0.0.1", "127.0.0.2"}) {
+    echo(ip, "small msg in segments");
+    echo(ip, largeMsg());
+  }
+}
+
+TEST_F(TransSegEnv, segsMergedToCompress) {
+  ASSERT_NO_FATAL_FAILURE(openRpc(RPC_COMP_ZSTD));
+
+  // msgs between different ips are compressed, between the same ip they are not
+  for (const char *ip : {"127.0.0.2", "127.0.0.1"}) {
+    echo(ip, largeMsg());
+  }
+  transFreeZstdCtx();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANS_TEST_UTIL_H
+#define TRANS_TEST_UTIL_H
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "tglobal.h"
+#include "tlog.h"
+#include "tmisce.h"
+#include "trpc.h"
+#include "tversion.h"
+
+// a server and a client of the transport in the same process, the tests set up SRpcInit by initRpc and change the
+// fields of their own before the rpc is opened
+class TransTestEnv : public ::testing::Test {
+ public:
+  // answer a request with a copy of its body
+  static void echoReq(const SRpcMsg *pMsg) {
+    SRpcMsg rsp = {0};
+    rsp.pCont = rpcMallocCont(pMsg->contLen);
+    rsp.contLen = pMsg->contLen;
+    memcpy(rsp.pCont, pMsg->pCont, pMsg->contLen);
+    rsp.info = pMsg->info;
+    rpcFreeCont(pMsg->pCont);
+    rpcSendResponse(&rsp);
+  }
+
+ protected:
+  void SetUp() override { initLog(); }
+
+  void TearDown() override {
+    closeClient();
+    closeServer();
+  }
+
+  static void initLog() {
+    rpcDebugFlag = 143;
+    tsLogEmbedded = 1;
+    tsAsyncLog = 0;
+
+    std::string path = TD_TMP_DIR_PATH "transport";
+    taosMkDir(path.c_str());
+    tstrncpy(tsLogDir, path.c_str(), PATH_MAX);
+    if (taosInitLog("taosdlog", 1) != 0) {
+      printf("failed to init log file\n");
+    }
+  }
+
+  static void initRpc(SRpcInit *pInit, const char *label, int8_t connType, RpcCfp cfp, void *parent) {
+    memset(pInit, 0, sizeof(SRpcInit));
+    pInit->label = (char *)label;
+    pInit->numOfThreads = 1;
+    pInit->user = (char *)"user";
+    pInit->connType = connType;
+    pInit->compressSize = -1;
+    pInit->cfp = cfp;
+    pInit->parent = parent;
+    taosVersionStrToInt(version, &pInit->compatibilityVer);
+  }
+
+  // the server listens on all the addresses of the port
+  void openServer(SRpcInit *pInit, int port) {
+    memcpy(pInit->localFqdn, "localhost", strlen("localhost"));
+    pInit->localPort = port;
+    pSrv = rpcOpen(pInit);
+    ASSERT_NE(pSrv, nullptr);
+    taosMsleep(500);
+  }
+
+  void openClient(SRpcInit *pInit) {
+    pCli = rpcOpen(pInit);
+    ASSERT_NE(pCli, nullptr);
+  }
+
+  void closeServer() {
+    if (pSrv != NULL) rpcClose(pSrv);
+    pSrv = NULL;
+  }
+
+  void closeClient() {
+    if (pCli != NULL) rpcClose(pCli);
+    pCli = NULL;
+  }
+
+  void *pSrv = NULL;
+  void *pCli = NULL;
+};
+
+#endif  // TRANS_TEST_UTIL_H
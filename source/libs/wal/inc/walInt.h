@@ -163,6 +163,15 @@ int     walInitWriteFile(SWal* pWal);
 // seek section end
 
 int64_t walGetSeq();
+
+// group commit section
+int32_t walGroupCommitStart();
+void    walGroupCommitStop();
+bool    walGroupCommitEnabled();
+void    walGroupCommitFsync(SWal* pWal);
+void    walGroupCommitReset(SWal* pWal, int64_t ver);
+void    walGroupCommitDetach(SWal* pWal);
+// group commit section end
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "walInt.h"
+
+/*
+ * Group commit of wal files.
+ *
+ * With walLevel 2 and fsync period 0 every write is synced before it is acknowledged, and each vnode issues its own
+ * fsync. When the group commit is enabled, writers queue their wal to a small pool of service threads instead. A
+ * service thread takes the last version of the wal, syncs the file and marks the logs up to that version durable, so
+ * every writer whose logs are covered is released by a single fsync, including the ones that queued during it. The
+ * wals of different vnodes are synced by different threads in parallel.
+ */
+
+#define WAL_GC_STATE_IDLE    0
+#define WAL_GC_STATE_PENDING 1
+#define WAL_GC_STATE_SYNCING 2
+
+typedef struct {
+  int8_t              running;
+  int8_t              stop;
+  int32_t             numOfThreads;
+  TdThread           *threads;
+  TdThreadMutex       mutex;
+  TdThreadCond        reqCond;   // signaled when a wal is queued
+  TdThreadCond        doneCond;  // broadcast when a wal is synced
+  SArray             *pPending;  // SArray<SWal*>, wals waiting for a service thread
+  SWalGroupCommitStat stat;
+} SWalGroupCommit;
+
+static SWalGroupCommit tsWalGc = {0};
+
+// sync the wal and return the version it covers, the wal mutex keeps the file from being rolled or closed meanwhile
+static int64_t walGroupCommitSyncWal(SWal *pWal, int32_t *pEpoch) {
+  taosThreadMutexLock(&pWal->mutex);
+  int64_t ver = pWal->vers.lastVer;
+  *pEpoch = pWal->syncEpoch;
+  if (pWal->pLogFile != NULL) {
+    wTrace("vgId:%d, fileId:%" PRId64 ".log, do group fsync, ver:%" PRId64, pWal->cfg.vgId,
+           walGetCurFileFirstVer(pWal), ver);
+    // same as walFsync, a failure is logged and the writers go on
+    if (taosFsyncFile(pWal->pLogFile) < 0) {
+      wError("vgId:%d, file:%" PRId64 ".log, group fsync failed since %s", pWal->cfg.vgId,
+             walGetCurFileFirstVer(pWal), strerror(errno));
+    }
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+  return ver;
+}
+
+static void *walGroupCommitThreadFp(void *param) {
+  setThreadName("wal-gc");
+
+  taosThreadMutexLock(&tsWalGc.mutex);
+  while (1) {
+    while (taosArrayGetSize(tsWalGc.pPending) == 0 && !tsWalGc.stop) {
+      taosThreadCondWait(&tsWalGc.reqCond, &tsWalGc.mutex);
+    }
+    if (taosArrayGetSize(tsWalGc.pPending) == 0) {
+      // stopped and nothing left to sync
+      break;
+    }
+
+    SWal *pWal = taosArrayGetP(tsWalGc.pPending, 0);
+    taosArrayRemove(tsWalGc.pPending, 0);
+    pWal->syncState = WAL_GC_STATE_SYNCING;
+    taosThreadMutexUnlock(&tsWalGc.mutex);
+
+    int32_t epoch = 0;
+    int64_t startUs = taosGetTimestampUs();
+    int64_t ver = walGroupCommitSyncWal(pWal, &epoch);
+    int64_t fsyncUs = taosGetTimestampUs() - startUs;
+
+    taosThreadMutexLock(&tsWalGc.mutex);
+    // a rollback during the fsync rewrites the logs after it, they are not covered
+    if (pWal->syncEpoch == epoch && ver > pWal->syncedVer) {
+      pWal->syncedVer = ver;
+    }
+    if (pWal->syncReqVer > pWal->syncedVer) {
+      pWal->syncState = WAL_GC_STATE_PENDING;
+      taosArrayPush(tsWalGc.pPending, &pWal);
+    } else {
+      pWal->syncState = WAL_GC_STATE_IDLE;
+    }
+    tsWalGc.stat.numOfFsyncs++;
+    tsWalGc.stat.fsyncUs += fsyncUs;
+    taosThreadCondBroadcast(&tsWalGc.doneCond);
+  }
+  taosThreadMutexUnlock(&tsWalGc.mutex);
+
+  return NULL;
+}
+
+int32_t walGroupCommitStart() {
+  if (atomic_load_8(&tsWalGc.running)) return 0;
+
+  tsWalGc.stop = 0;
+  tsWalGc.numOfThreads = 0;
+  memset(&tsWalGc.stat, 0, sizeof(tsWalGc.stat));
+  tsWalGc.pPending = taosArrayInit(TSDB_MIN_VNODES, sizeof(SWal *));
+  tsWalGc.threads = taosMemoryCalloc(TMAX(tsWalGroupCommitThreads, 1), sizeof(TdThread));
+  if (tsWalGc.pPending == NULL || tsWalGc.threads == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosThreadMutexInit(&tsWalGc.mutex, NULL);
+  taosThreadCondInit(&tsWalGc.reqCond, NULL);
+  taosThreadCondInit(&tsWalGc.doneCond, NULL);
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  for (int32_t i = 0; i < TMAX(tsWalGroupCommitThreads, 1); ++i) {
+    if (taosThreadCreate(&tsWalGc.threads[i], &thAttr, walGroupCommitThreadFp, NULL) != 0) {
+      wError("failed to create wal group commit thread since %s", strerror(errno));
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+    tsWalGc.numOfThreads++;
+  }
+  taosThreadAttrDestroy(&thAttr);
+
+  if (tsWalGc.numOfThreads == 0) {
+    taosThreadCondDestroy(&tsWalGc.doneCond);
+    taosThreadCondDestroy(&tsWalGc.reqCond);
+    taosThreadMutexDestroy(&tsWalGc.mutex);
+    goto _err;
+  }
+
+  atomic_store_8(&tsWalGc.running, 1);
+  wInfo("wal group commit is started, threads:%d", tsWalGc.numOfThreads);
+  return 0;
+
+_err:
+  taosArrayDestroy(tsWalGc.pPending);
+  taosMemoryFreeClear(tsWalGc.threads);
+  tsWalGc.pPending = NULL;
+  return -1;
+}
+
+void walGroupCommitStop() {
+  if (!atomic_load_8(&tsWalGc.running)) return;
+
+  // the service drains the queued wals before it exits
+  taosThreadMutexLock(&tsWalGc.mutex);
+  tsWalGc.stop = 1;
+  taosThreadCondBroadcast(&tsWalGc.reqCond);
+  taosThreadMutexUnlock(&tsWalGc.mutex);
+
+  for (int32_t i = 0; i < tsWalGc.numOfThreads; ++i) {
+    if (taosCheckPthreadValid(tsWalGc.threads[i])) {
+      taosThreadJoin(tsWalGc.threads[i], NULL);
+      taosThreadClear(&tsWalGc.threads[i]);
+    }
+  }
+  atomic_store_8(&tsWalGc.running, 0);
+
+  SWalGroupCommitStat *pStat = &tsWalGc.stat;
+  wInfo("wal group commit is stopped, fsyncs:%" PRId64 " requests:%" PRId64 " fsync:%" PRId64 "us wait:%" PRId64
+        "us max wait:%" PRId64 "us",
+        pStat->numOfFsyncs, pStat->numOfRequests, pStat->fsyncUs, pStat->waitUs, pStat->maxWaitUs);
+
+  taosThreadCondDestroy(&tsWalGc.doneCond);
+  taosThreadCondDestroy(&tsWalGc.reqCond);
+  taosThreadMutexDestroy(&tsWalGc.mutex);
+  taosArrayDestroy(tsWalGc.pPending);
+  taosMemoryFreeClear(tsWalGc.threads);
+  tsWalGc.pPending = NULL;
+  tsWalGc.numOfThreads = 0;
+}
+
+bool walGroupCommitEnabled() { return atomic_load_8(&tsWalGc.running) && !atomic_load_8(&tsWalGc.stop); }
+
+void walGroupCommitFsync(SWal *pWal) {
+  int64_t startUs = taosGetTimestampUs();
+  bool    synced = true;
+
+  // the logs of the caller are written, they are all covered once the last version is durable
+  taosThreadMutexLock(&pWal->mutex);
+  int64_t ver = pWal->vers.lastVer;
+  int32_t epoch = pWal->syncEpoch;
+  taosThreadMutexUnlock(&pWal->mutex);
+
+  taosThreadMutexLock(&tsWalGc.mutex);
+  if (tsWalGc.stop) {
+    synced = false;
+  } else if (pWal->syncEpoch == epoch && pWal->syncedVer < ver) {
+    if (ver > pWal->syncReqVer) pWal->syncReqVer = ver;
+    if (pWal->syncState == WAL_GC_STATE_IDLE) {
+      pWal->syncState = WAL_GC_STATE_PENDING;
+      if (taosArrayPush(tsWalGc.pPending, &pWal) == NULL) {
+        pWal->syncState = WAL_GC_STATE_IDLE;
+        synced = false;
+      } else {
+        taosThreadCondSignal(&tsWalGc.reqCond);
+      }
+    }
+    // released once a fsync covers the version, or the logs are rolled back
+    while (synced && pWal->syncEpoch == epoch && pWal->syncedVer < ver) {
+      taosThreadCondWait(&tsWalGc.doneCond, &tsWalGc.mutex);
+    }
+  }
+
+  if (synced) {
+    int64_t waitUs = taosGetTimestampUs() - startUs;
+    tsWalGc.stat.numOfRequests++;
+    tsWalGc.stat.waitUs += waitUs;
+    if (waitUs > tsWalGc.stat.maxWaitUs) tsWalGc.stat.maxWaitUs = waitUs;
+  }
+  taosThreadMutexUnlock(&tsWalGc.mutex);
+
+  if (!synced) {
+    // the service is stopping or out of memory, do it in place
+    taosThreadMutexLock(&pWal->mutex);
+    if (taosFsyncFile(pWal->pLogFile) < 0) {
+      wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
+             strerror(errno));
+    }
+    taosThreadMutexUnlock(&pWal->mutex);
+  }
+}
+
+void walGroupCommitReset(SWal *pWal, int64_t ver) {
+  // called with the wal mutex held, the service threads never wait for it while holding their own
+  bool running = atomic_load_8(&tsWalGc.running);
+  if (running) taosThreadMutexLock(&tsWalGc.mutex);
+
+  pWal->syncEpoch++;
+  pWal->syncReqVer = TMIN(pWal->syncReqVer, ver - 1);
+  pWal->syncedVer = TMIN(pWal->syncedVer, ver - 1);
+
+  if (running) {
+    taosThreadCondBroadcast(&tsWalGc.doneCond);
+    taosThreadMutexUnlock(&tsWalGc.mutex);
+  }
+}
+
+void walGroupCommitDetach(SWal *pWal) {
+  if (!atomic_load_8(&tsWalGc.running)) return;
+
+  taosThreadMutexLock(&tsWalGc.mutex);
+  while (pWal->syncState == WAL_GC_STATE_SYNCING) {
+    taosThreadCondWait(&tsWalGc.doneCond, &tsWalGc.mutex);
+  }
+  if (pWal->syncState == WAL_GC_STATE_PENDING) {
+    int32_t nWal = taosArrayGetSize(tsWalGc.pPending);
+    for (int32_t i = 0; i < nWal; ++i) {
+      if (taosArrayGetP(tsWalGc.pPending, i) == pWal) {
+        taosArrayRemove(tsWalGc.pPending, i);
+        break;
+      }
+    }
+    pWal->syncState = WAL_GC_STATE_IDLE;
+  }
+  taosThreadMutexUnlock(&tsWalGc.mutex);
+}
+
+void walGetGroupCommitStat(SWalGroupCommitStat *pStat) {
+  if (!atomic_load_8(&tsWalGc.running)) {
+    *pStat = tsWalGc.stat;
+    return;
+  }
+
+  taosThreadMutexLock(&tsWalGc.mutex);
+  *pStat = tsWalGc.stat;
+  taosThreadMutexUnlock(&tsWalGc.mutex);
+}
@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "walInt.h"
 
@@ -52,6 +53,14 @@ int32_t walInit() {
       return code;
     }
 
+    if (tsWalGroupCommit && (code = walGroupCommitStart()) != 0) {
+      wError("failed to init wal module since %s", tstrerror(terrno));
+      walStopThread();
+      taosCloseRef(tsWal.refSetId);
+      atomic_store_8(&tsWal.inited, 0);
+      return code;
+    }
+
     wInfo("wal module is initialized, rsetId:%d", tsWal.refSetId);
     atomic_store_8(&tsWal.inited, 1);
   }
@@ -67,6 +76,7 @@ void walCleanUp() {
   }
 
   if (old == 1) {
+    walGroupCommitStop();
     walStopThread();
     taosCloseRef(tsWal.refSetId);
     wInfo("wal module is cleaned up");
@@ -116,6 +126,8 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
 
   // open meta
   walResetVer(&pWal->vers);
+  pWal->syncReqVer = -1;
+  pWal->syncedVer = -1;
   pWal->pLogFile = NULL;
   pWal->pIdxFile = NULL;
   pWal->writeCur = -1;
@@ -210,6 +222,8 @@ int32_t walPersist(SWal *pWal) {
 }
 
 void walClose(SWal *pWal) {
+  walGroupCommitDetach(pWal);
+
   taosThreadMutexLock(&pWal->mutex);
   (void)walSaveMeta(pWal);
   taosCloseFile(&pWal->pLogFile);
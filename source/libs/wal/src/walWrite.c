@@ -37,6 +37,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
     }
   }
 
+  walGroupCommitReset(pWal, ver + 1);
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
 
@@ -110,6 +111,9 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
+  // the logs from ver on are rewritten, their earlier fsyncs do not count
+  walGroupCommitReset(pWal, ver);
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
@@ -698,8 +702,14 @@ void walFsync(SWal *pWal, bool forceFsync) {
     return;
   }
 
+  bool needFsync = forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0);
+  if (needFsync && walGroupCommitEnabled()) {
+    walGroupCommitFsync(pWal);
+    return;
+  }
+
   taosThreadMutexLock(&pWal->mutex);
-  if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+  if (needFsync) {
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "walInt.h"
 
@@ -234,6 +238,112 @@ TEST_F(WalCleanEnv, write) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, groupCommit) {
+  int code = walGroupCommitStart();
+  ASSERT_EQ(code, 0);
+  ASSERT_TRUE(walGroupCommitEnabled());
+  for (int i = 0; i < 10; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    walFsync(pWal, true);
+    ASSERT_EQ(pWal->syncedVer, i);
+  }
+  // covered by the last fsync
+  walFsync(pWal, true);
+  SWalGroupCommitStat stat = {0};
+  walGetGroupCommitStat(&stat);
+  EXPECT_EQ(stat.numOfRequests, 11);
+  EXPECT_EQ(stat.numOfFsyncs, 10);
+  walGroupCommitStop();
+  ASSERT_FALSE(walGroupCommitEnabled());
+  ASSERT_EQ(pWal->vers.lastVer, 9);
+}
+
+TEST_F(WalCleanEnv, groupCommitRollback) {
+  int code = walGroupCommitStart();
+  ASSERT_EQ(code, 0);
+  for (int i = 0; i < 10; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+  }
+  walFsync(pWal, true);
+  ASSERT_EQ(pWal->syncedVer, 9);
+
+  // the rewritten logs are synced again
+  code = walRollback(pWal, 5);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->syncedVer, 4);
+  for (int i = 5; i < 8; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+  }
+  walFsync(pWal, true);
+  ASSERT_EQ(pWal->syncedVer, 7);
+
+  SWalGroupCommitStat stat = {0};
+  walGetGroupCommitStat(&stat);
+  EXPECT_EQ(stat.numOfRequests, 2);
+  EXPECT_EQ(stat.numOfFsyncs, 2);
+  walGroupCommitStop();
+}
+
+TEST_F(WalCleanEnv, groupCommitParallel) {
+  const int nWal = 4;
+  const int nWriter = 3;
+  const int nRow = 200;
+
+  int code = walGroupCommitStart();
+  ASSERT_EQ(code, 0);
+
+  SWal* pWals[nWal] = {0};
+  for (int i = 0; i < nWal; i++) {
+    std::string path = std::string(pathName) + "_gc" + std::to_string(i);
+    taosRemoveDir(path.c_str());
+    SWalCfg cfg = {0};
+    cfg.vgId = i + 2;
+    cfg.rollPeriod = -1;
+    cfg.segSize = -1;
+    cfg.level = TAOS_WAL_FSYNC;
+    pWals[i] = walOpen(path.c_str(), &cfg);
+    ASSERT_NE(pWals[i], nullptr);
+  }
+
+  // a few writers on each wal, each write waits until its log is durable
+  std::vector<std::thread> writers;
+  std::mutex               writeMutex[nWal];
+  int64_t                  nextVer[nWal] = {0};
+  for (int i = 0; i < nWal * nWriter; i++) {
+    writers.emplace_back([&, i]() {
+      int w = i % nWal;
+      for (int r = 0; r < nRow / nWriter; r++) {
+        int64_t ver = 0;
+        {
+          std::lock_guard<std::mutex> lock(writeMutex[w]);
+          ver = nextVer[w]++;
+          ASSERT_EQ(walWrite(pWals[w], ver, 1, (void*)ranStr, ranStrLen), 0);
+        }
+        walFsync(pWals[w], false);
+        ASSERT_GE(atomic_load_64(&pWals[w]->syncedVer), ver);
+      }
+    });
+  }
+  for (auto& t : writers) {
+    t.join();
+  }
+
+  SWalGroupCommitStat stat = {0};
+  walGetGroupCommitStat(&stat);
+  EXPECT_EQ(stat.numOfRequests, nWal * nWriter * (nRow / nWriter));
+  EXPECT_LE(stat.numOfFsyncs, stat.numOfRequests);
+  EXPECT_GT(stat.numOfFsyncs, 0);
+
+  walGroupCommitStop();
+  for (int i = 0; i < nWal; i++) {
+    EXPECT_EQ(pWals[i]->syncedVer, nextVer[i] - 1);
+    walClose(pWals[i]);
+  }
+}
+
 TEST_F(WalCleanEnv, rollback) {
   int code;
   for (int i = 0; i < 10; i++) {
@@ -1194,6 +1194,28 @@ int32_t taosFsyncFile(TdFilePtr pFile) {
   return 0;
 }
 
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t len) {
+  if (pFile == NULL) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+  if (pFile->fd < 0) {
+    return 0;
+  }
+
+  // the kernel starts to read the range into the page cache and returns without waiting for the io
+  int32_t code = posix_fadvise(pFile->fd, offset, len, POSIX_FADV_WILLNEED);
+  if (code != 0) {
+    errno = code;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 void taosFprintfFile(TdFilePtr pFile, const char *format, ...) {
   if (pFile == NULL || pFile->fp == NULL) {
     return;
@@ -637,7 +637,9 @@ int32_t taosGetCpuInstructions(char* sse42, char* avx, char* avx2, char* fma, ch
   // Ref to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=77756
   __cpuid_fix(7u, eax, ebx, ecx, edx);
   *avx2 = (char) ((ebx & bit_AVX2) == bit_AVX2);
-  *avx512 = (char)((ebx & bit_AVX512F) == bit_AVX512F);
+  // the AVX512 kernels use the 128/256-bit forms and byte masks, so VL and BW are required as well as F.
+  uint32_t avx512Bits = bit_AVX512F | bit_AVX512VL | bit_AVX512BW;
+  *avx512 = (char)((ebx & avx512Bits) == avx512Bits);
 #endif   // _TD_X86_
 #endif
 
@@ -168,6 +168,32 @@ TEST(osTest, osFile) {
   //printf("remove file success");
 }
 
+TEST(osTest, osFileReadAhead) {
+  char   *fname = "./osfiletest2.txt";
+  char    wbuf[64 * 1024];
+  char    rbuf[4096];
+  int64_t offset = 20 * 1024;
+
+  for (int32_t i = 0; i < sizeof(wbuf); ++i) {
+    wbuf[i] = (char)(i % 251);
+  }
+
+  TdFilePtr pFile = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, wbuf, sizeof(wbuf)), sizeof(wbuf));
+
+  // a hint only, the content read afterwards is not changed
+  ASSERT_EQ(taosReadAheadFile(pFile, offset, sizeof(rbuf)), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, sizeof(wbuf), sizeof(rbuf)), 0);
+  ASSERT_EQ(taosReadAheadFile(NULL, offset, sizeof(rbuf)), 0);
+
+  ASSERT_EQ(taosPReadFile(pFile, rbuf, sizeof(rbuf), offset), sizeof(rbuf));
+  ASSERT_EQ(memcmp(rbuf, wbuf + offset, sizeof(rbuf)), 0);
+
+  ASSERT_EQ(taosCloseFile(&pFile), 0);
+  ASSERT_EQ(taosRemoveFile(fname), 0);
+}
+
 #ifndef OSFILE_PERFORMANCE_TEST
 
 #define MAX_WORDS          100
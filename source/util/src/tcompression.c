@@ -315,10 +315,7 @@ int8_t tsGetCompressL2Level(uint8_t alg, uint8_t lvl) {
 }
 
 static const int32_t TEST_NUMBER = 1;
-#define is_bigendian()     ((*(char *)&TEST_NUMBER) == 0)
-#define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
-
-#define safeInt64Add(a, b) (((a >= 0) && (b <= INT64_MAX - a)) || ((a < 0) && (b >= INT64_MIN - a)))
+#define is_bigendian() ((*(char *)&TEST_NUMBER) == 0)
 
 bool lossyFloat = false;
 bool lossyDouble = false;
@@ -342,6 +339,11 @@ void tsCompressExit() { tdszExit(); }
  * Compress Integer (Simple8B).
  */
 int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
+  int32_t len = tsCompressIntImpl_Hw(input, nelements, output, type);
+  if (len > 0) {
+    return len;
+  }
+
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
@@ -467,10 +469,10 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     return nelements * word_length;
   }
 
-#if __AVX2__
-  tsDecompressIntImpl_Hw(input, nelements, output, type);
-  return nelements * word_length;
-#else
+  if (tsDecompressIntImpl_Hw(input, nelements, output, type) == 0) {
+    return nelements * word_length;
+  }
+
   // Selector value: 0    1   2   3   4   5   6   7   8  9  10  11 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
   int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
@@ -530,7 +532,6 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
   }
 
   return nelements * word_length;
-#endif
 }
 
 /* ----------------------------------------------Bool Compression ---------------------------------------------- */
@@ -722,6 +723,11 @@ int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements,
 
   if (nelements == 0) return 0;
 
+  int32_t len = tsCompressTimestampImpl_Hw(input, nelements, output);
+  if (len > 0) {
+    return len;
+  }
+
   int64_t *istream = (int64_t *)input;
 
   int64_t prev_value = istream[0];
@@ -822,11 +828,7 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
     memcpy(output, input + 1, nelements * longBytes);
     return nelements * longBytes;
   } else if (input[0] == 1) {  // Decompress
-    if (tsSIMDEnable && tsAVX512Supported && tsAVX512Enable) {
-      tsDecompressTimestampAvx512(input, nelements, output, false);
-    } else if (tsSIMDEnable && tsAVX2Supported) {
-      tsDecompressTimestampAvx2(input, nelements, output, false);
-    } else {
+    if (tsDecompressTimestampImpl_Hw(input, nelements, output) != 0) {
       int64_t *ostream = (int64_t *)output;
 
       int32_t ipos = 1, opos = 0;
@@ -1198,11 +1200,8 @@ int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, c
     return nelements * FLOAT_BYTES;
   }
 
-  if (tsSIMDEnable && tsAVX2Supported) {
-    tsDecompressFloatImplAvx2(input, nelements, output);
-  } else if (tsSIMDEnable && tsAVX512Supported && tsAVX512Enable) {
-    tsDecompressFloatImplAvx512(input, nelements, output);
-  } else {  // alternative implementation without SIMD instructions.
+  // alternative implementation without SIMD instructions.
+  if (tsDecompressFloatImpl_Hw(input, nelements, output) != 0) {
     tsDecompressFloatHelper(input, nelements, (float *)output);
   }
 
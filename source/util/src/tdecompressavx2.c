@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * AVX2 compression and decompression kernels.
+ *
+ * This file is always compiled with -mavx2 when the compiler supports it, no matter whether the whole build targets
+ * AVX2 or not, and the kernels are selected at runtime according to tsAVX2Supported. So the kernels must only be
+ * called after checking the CPU flags, and each of them returns -1 if it is not compiled in.
+ */
+
+#include "os.h"
+#include "tcompression.h"
+#include "ttypes.h"
+
+int32_t tsDecompressBigintImplAvx2(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX2__
+  // Selector value:           0  1   2   3   4   5   6   7   8  9  10  11 12  13  14  15
+  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+  const char *ip = input + 1;
+  int32_t     _pos = 0;
+  int64_t     prevValue = 0;
+  int64_t    *p = (int64_t *)output;
+
+  while (_pos < nelements) {
+    uint64_t w = *(uint64_t *)ip;
+
+    char    selector = (char)(w & INT64MASK(4));       // selector = 4
+    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
+    int32_t elems = selector_to_elems[(int32_t)selector];
+
+    int32_t  v = 4;
+    uint64_t zigzag_value = 0;
+    uint64_t mask = INT64MASK(bit);
+
+    int32_t gRemainder = (nelements - _pos);
+    int32_t num = (gRemainder > elems) ? elems : gRemainder;
+
+    int32_t batch = num >> 2;
+    int32_t remain = num & 0x03;
+
+    if (selector == 0 || selector == 1) {
+      for (int32_t i = 0; i < batch; ++i) {
+        __m256i prev = _mm256_set1_epi64x(prevValue);
+        _mm256_storeu_si256((__m256i *)&p[_pos], prev);
+        _pos += 4;
+      }
+
+      for (int32_t i = 0; i < remain; ++i) {
+        p[_pos++] = prevValue;
+      }
+    } else {
+      __m256i base = _mm256_set1_epi64x(w);
+      __m256i maskVal = _mm256_set1_epi64x(mask);
+
+      __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+      __m256i inc = _mm256_set1_epi64x(bit << 2);
+
+      for (int32_t i = 0; i < batch; ++i) {
+        __m256i after = _mm256_srlv_epi64(base, shiftBits);
+        __m256i zigzagVal = _mm256_and_si256(after, maskVal);
+
+        // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+        __m256i signmask = _mm256_and_si256(_mm256_set1_epi64x(1), zigzagVal);
+        signmask = _mm256_sub_epi64(_mm256_setzero_si256(), signmask);
+
+        // get four zigzag values here
+        __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
+
+        // calculate the cumulative sum (prefix sum) for each number
+        // decode[0] = prevValue + final[0]
+        // decode[1] = decode[0] + final[1]   -----> prevValue + final[0] + final[1]
+        // decode[2] = decode[1] + final[2]   -----> prevValue + final[0] + final[1] + final[2]
+        // decode[3] = decode[2] + final[3]   -----> prevValue + final[0] + final[1] + final[2] + final[3]
+
+        //  1, 2, 3, 4
+        //+ 0, 1, 0, 3
+        //  1, 3, 3, 7
+        // shift and add for the first round
+        __m128i prev = _mm_set1_epi64x(prevValue);
+        __m256i x = _mm256_slli_si256(delta, 8);
+
+        delta = _mm256_add_epi64(delta, x);
+        _mm256_storeu_si256((__m256i *)&p[_pos], delta);
+
+        //  1, 3, 3, 7
+        //+ 0, 0, 3, 3
+        //  1, 3, 6, 10
+        // shift and add operation for the second round
+        __m128i firstPart = _mm_loadu_si128((__m128i *)&p[_pos]);
+        __m128i secondItem = _mm_set1_epi64x(p[_pos + 1]);
+        __m128i secPart = _mm_add_epi64(_mm_loadu_si128((__m128i *)&p[_pos + 2]), secondItem);
+        firstPart = _mm_add_epi64(firstPart, prev);
+        secPart = _mm_add_epi64(secPart, prev);
+
+        // save it in the memory
+        _mm_storeu_si128((__m128i *)&p[_pos], firstPart);
+        _mm_storeu_si128((__m128i *)&p[_pos + 2], secPart);
+
+        shiftBits = _mm256_add_epi64(shiftBits, inc);
+        prevValue = p[_pos + 3];
+        _pos += 4;
+      }
+
+      // handle the remain value
+      for (int32_t i = 0; i < remain; i++) {
+        zigzag_value = ((w >> (v + (batch * bit * 4))) & mask);
+        prevValue += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+        p[_pos++] = prevValue;
+        v += bit;
+      }
+    }
+
+    ip += LONG_BYTES;
+  }
+
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+// todo add later
+int32_t tsDecompressFloatImplAvx2(const char *const input, const int32_t nelements, char *const output) {
+  return -1;
+}
+
+// decode two timestamps in one loop.
+int32_t tsDecompressTimestampAvx2(const char *const input, const int32_t nelements, char *const output,
+                                  bool bigEndian) {
+#if __AVX2__
+  int64_t *ostream = (int64_t *)output;
+  int32_t  ipos = 1, opos = 0;
+
+  __m128i prevVal = _mm_setzero_si128();
+  __m128i prevDelta = _mm_setzero_si128();
+
+  int32_t batch = nelements >> 1;
+  int32_t remainder = nelements & 0x01;
+
+  int32_t i = 0;
+  if (batch > 0) {
+    // first loop
+    uint8_t flags = input[ipos++];
+
+    int8_t nbytes1 = flags & INT8MASK(4);  // range of nbytes starts from 0 to 7
+    int8_t nbytes2 = (flags >> 4) & INT8MASK(4);
+
+    __m128i data1 = _mm_setzero_si128();
+    if (nbytes1 > 0) {
+      int64_t tmp = 0;
+      memcpy(&tmp, (const void *)(input + ipos), nbytes1);
+      data1 = _mm_set1_epi64x(tmp);
+    }
+
+    __m128i data2 = _mm_setzero_si128();
+    if (nbytes2 > 0) {
+      int64_t tmp = 0;
+      memcpy(&tmp, (const void *)(input + ipos + nbytes1), nbytes2);
+      data2 = _mm_set1_epi64x(tmp);
+    }
+
+    data2 = _mm_broadcastq_epi64(data2);
+    __m128i zzVal = _mm_blend_epi32(data2, data1, 0x03);
+
+    // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+    __m128i signmask = _mm_and_si128(_mm_set1_epi64x(1), zzVal);
+    signmask = _mm_sub_epi64(_mm_setzero_si128(), signmask);
+
+    // get two zigzag values here
+    __m128i deltaOfDelta = _mm_xor_si128(_mm_srli_epi64(zzVal, 1), signmask);
+
+    __m128i deltaCurrent = _mm_add_epi64(deltaOfDelta, prevDelta);
+    deltaCurrent = _mm_add_epi64(_mm_slli_si128(deltaOfDelta, 8), deltaCurrent);
+
+    __m128i finalVal = _mm_add_epi64(deltaCurrent, prevVal);
+    _mm_storeu_si128((__m128i *)&ostream[opos], finalVal);
+
+    // keep the previous value
+    prevVal = _mm_shuffle_epi32(finalVal, 0xEE);
+
+    // keep the previous delta of delta, for the first item
+    prevDelta = _mm_shuffle_epi32(deltaOfDelta, 0xEE);
+
+    opos += 2;
+    ipos += nbytes1 + nbytes2;
+    i += 1;
+  }
+
+  // the remain
+  for (; i < batch; ++i) {
+    uint8_t flags = input[ipos++];
+
+    int8_t nbytes1 = flags & INT8MASK(4);  // range of nbytes starts from 0 to 7
+    int8_t nbytes2 = (flags >> 4) & INT8MASK(4);
+
+    __m128i data1 = _mm_setzero_si128();
+    if (nbytes1 > 0) {
+      int64_t dd = 0;
+      memcpy(&dd, (const void *)(input + ipos), nbytes1);
+      data1 = _mm_loadu_si64(&dd);
+    }
+
+    __m128i data2 = _mm_setzero_si128();
+    if (nbytes2 > 0) {
+      int64_t dd = 0;
+      memcpy(&dd, (const void *)(input + ipos + nbytes1), nbytes2);
+      data2 = _mm_loadu_si64(&dd);
+    }
+
+    data2 = _mm_broadcastq_epi64(data2);
+
+    __m128i zzVal = _mm_blend_epi32(data2, data1, 0x03);
+
+    // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+    __m128i signmask = _mm_and_si128(_mm_set1_epi64x(1), zzVal);
+    signmask = _mm_sub_epi64(_mm_setzero_si128(), signmask);
+
+    // get two zigzag values here
+    __m128i deltaOfDelta = _mm_xor_si128(_mm_srli_epi64(zzVal, 1), signmask);
+
+    __m128i deltaCurrent = _mm_add_epi64(deltaOfDelta, prevDelta);
+    deltaCurrent = _mm_add_epi64(_mm_slli_si128(deltaOfDelta, 8), deltaCurrent);
+
+    __m128i finalVal = _mm_add_epi64(deltaCurrent, prevVal);
+    finalVal = _mm_add_epi64(_mm_slli_si128(deltaCurrent, 8), finalVal);
+
+    _mm_storeu_si128((__m128i *)&ostream[opos], finalVal);
+
+    // keep the previous value
+    prevVal = _mm_shuffle_epi32(finalVal, 0xEE);
+
+    // keep the previous delta of delta
+    prevDelta = _mm_shuffle_epi32(deltaCurrent, 0xEE);
+
+    opos += 2;
+    ipos += nbytes1 + nbytes2;
+  }
+
+  if (remainder > 0) {
+    uint64_t dd = 0;
+    uint8_t  flags = input[ipos++];
+
+    int32_t nbytes = flags & INT8MASK(4);
+    int64_t deltaOfDelta = 0;
+    if (nbytes == 0) {
+      deltaOfDelta = 0;
+    } else {
+      memcpy(&dd, input + ipos, nbytes);
+      deltaOfDelta = ZIGZAG_DECODE(int64_t, dd);
+    }
+
+    ipos += nbytes;
+    if (opos == 0) {
+      ostream[opos++] = deltaOfDelta;
+    } else {
+      int64_t prevDeltaX = deltaOfDelta + prevDelta[1];
+      ostream[opos++] = prevVal[1] + prevDeltaX;
+    }
+  }
+
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+// Compute the zigzag encoded deltas of the integers in [start, end) for simple8b, start must be larger than 0. Returns
+// the number of the integers done, the remaining ones less than a vector are left to the caller, or -1 if any delta
+// overflows or is out of the range of simple8b.
+int32_t tsCompressIntZigzagAvx2(const char *const input, const int32_t start, const int32_t end, const char type,
+                                uint64_t *const zigzag) {
+#if __AVX2__
+  __m256i zero = _mm256_setzero_si256();
+  __m256i invalid = _mm256_setzero_si256();
+
+  // there is no unsigned 64bit comparison in AVX2, flip the sign bit and compare them as signed ones
+  __m256i signBit = _mm256_set1_epi64x(INT64_MIN);
+  __m256i maxVal = _mm256_set1_epi64x((int64_t)((SIMPLE8B_MAX_INT64 - 1) ^ (uint64_t)INT64_MIN));
+
+  int32_t i = start;
+  for (; i + 4 <= end; i += 4) {
+    __m256i curr, prev;
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT: {
+        int32_t c = 0, p = 0;
+        memcpy(&c, (const int8_t *)input + i, sizeof(int32_t));
+        memcpy(&p, (const int8_t *)input + i - 1, sizeof(int32_t));
+        curr = _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(c));
+        prev = _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(p));
+        break;
+      }
+      case TSDB_DATA_TYPE_SMALLINT:
+        curr = _mm256_cvtepi16_epi64(_mm_loadl_epi64((const __m128i *)((const int16_t *)input + i)));
+        prev = _mm256_cvtepi16_epi64(_mm_loadl_epi64((const __m128i *)((const int16_t *)input + i - 1)));
+        break;
+      case TSDB_DATA_TYPE_INT:
+        curr = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)((const int32_t *)input + i)));
+        prev = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)((const int32_t *)input + i - 1)));
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        curr = _mm256_loadu_si256((const __m256i *)((const int64_t *)input + i));
+        prev = _mm256_loadu_si256((const __m256i *)((const int64_t *)input + i - 1));
+        break;
+      default:
+        return -1;
+    }
+
+    // the same overflow check as safeInt64Add(curr, -prev)
+    __m256i neg = _mm256_sub_epi64(zero, prev);
+    __m256i delta = _mm256_add_epi64(curr, neg);
+    invalid = _mm256_or_si256(invalid, _mm256_and_si256(_mm256_xor_si256(curr, delta), _mm256_xor_si256(neg, delta)));
+
+    // ZIGZAG_ENCODE(T, v) (((uT)((v) >> (sizeof(T) * 8 - 1))) ^ (((uT)(v)) << 1))
+    __m256i zigzagVal = _mm256_xor_si256(_mm256_slli_epi64(delta, 1), _mm256_cmpgt_epi64(zero, delta));
+    invalid = _mm256_or_si256(invalid, _mm256_cmpgt_epi64(_mm256_xor_si256(zigzagVal, signBit), maxVal));
+
+    _mm256_storeu_si256((__m256i *)&zigzag[i - start], zigzagVal);
+  }
+
+  if (_mm256_movemask_pd(_mm256_castsi256_pd(invalid)) != 0) {
+    return -1;
+  }
+
+  return i - start;
+#else
+  return -1;
+#endif
+}
+
+// Compute the zigzag encoded delta of deltas of the timestamps in [start, end), start must be larger than 1. Returns
+// the number of the timestamps done, or -1 if any delta overflows.
+int32_t tsCompressTimestampZigzagAvx2(const char *const input, const int32_t start, const int32_t end,
+                                      uint64_t *const zigzag) {
+#if __AVX2__
+  const int64_t *istream = (const int64_t *)input;
+
+  __m256i zero = _mm256_setzero_si256();
+  __m256i invalid = _mm256_setzero_si256();
+
+  int32_t i = start;
+  for (; i + 4 <= end; i += 4) {
+    __m256i curr = _mm256_loadu_si256((const __m256i *)&istream[i]);
+    __m256i prev = _mm256_loadu_si256((const __m256i *)&istream[i - 1]);
+    __m256i prev2 = _mm256_loadu_si256((const __m256i *)&istream[i - 2]);
+
+    // the same overflow check as safeInt64Add(curr, -prev)
+    __m256i neg = _mm256_sub_epi64(zero, prev);
+    __m256i delta = _mm256_add_epi64(curr, neg);
+    invalid = _mm256_or_si256(invalid, _mm256_and_si256(_mm256_xor_si256(curr, delta), _mm256_xor_si256(neg, delta)));
+
+    // the previous deltas have been checked along with the previous timestamps
+    __m256i negDelta = _mm256_sub_epi64(zero, _mm256_sub_epi64(prev, prev2));
+    __m256i deltaOfDelta = _mm256_add_epi64(delta, negDelta);
+    invalid = _mm256_or_si256(
+        invalid, _mm256_and_si256(_mm256_xor_si256(delta, deltaOfDelta), _mm256_xor_si256(negDelta, deltaOfDelta)));
+
+    __m256i zigzagVal =
+        _mm256_xor_si256(_mm256_slli_epi64(deltaOfDelta, 1), _mm256_cmpgt_epi64(zero, deltaOfDelta));
+    _mm256_storeu_si256((__m256i *)&zigzag[i - start], zigzagVal);
+  }
+
+  if (_mm256_movemask_pd(_mm256_castsi256_pd(invalid)) != 0) {
+    return -1;
+  }
+
+  return i - start;
+#else
+  return -1;
+#endif
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * AVX512 compression and decompression kernels.
+ *
+ * This file is always compiled with -mavx512f -mavx512vl -mavx512bw when the compiler supports them, and the kernels
+ * are selected at runtime according to tsAVX512Supported and tsAVX512Enable. Each of them returns -1 if it is not
+ * compiled in.
+ */
+
+#include "os.h"
+#include "tcompression.h"
+#include "ttypes.h"
+
+int32_t tsDecompressBigintImplAvx512(const char *const input, const int32_t nelements, char *const output) {
+#if __AVX512F__
+  // Selector value:           0  1   2   3   4   5   6   7   8  9  10  11 12  13  14  15
+  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+  const char *ip = input + 1;
+  int32_t     _pos = 0;
+  int64_t     prevValue = 0;
+  int64_t    *p = (int64_t *)output;
+
+  while (_pos < nelements) {
+    uint64_t w = *(uint64_t *)ip;
+
+    char    selector = (char)(w & INT64MASK(4));       // selector = 4
+    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
+    int32_t elems = selector_to_elems[(int32_t)selector];
+
+    int32_t  v = 4;
+    uint64_t zigzag_value = 0;
+    uint64_t mask = INT64MASK(bit);
+
+    int32_t gRemainder = (nelements - _pos);
+    int32_t num = (gRemainder > elems) ? elems : gRemainder;
+
+    int32_t batch = num >> 3;
+    int32_t remain = num & 0x07;
+
+    if (selector == 0 || selector == 1) {
+      for (int32_t i = 0; i < batch; ++i) {
+        __m512i prev = _mm512_set1_epi64(prevValue);
+        _mm512_storeu_si512((__m512i *)&p[_pos], prev);
+        _pos += 8;  // handle 64bit x 8 = 512bit
+      }
+      for (int32_t i = 0; i < remain; ++i) {
+        p[_pos++] = prevValue;
+      }
+    } else {
+      __m512i sum_mask1 = _mm512_set_epi64(6, 6, 4, 4, 2, 2, 0, 0);
+      __m512i sum_mask2 = _mm512_set_epi64(5, 5, 5, 5, 1, 1, 1, 1);
+      __m512i sum_mask3 = _mm512_set_epi64(3, 3, 3, 3, 3, 3, 3, 3);
+      __m512i base = _mm512_set1_epi64(w);
+      __m512i maskVal = _mm512_set1_epi64(mask);
+      __m512i shiftBits = _mm512_set_epi64(bit * 7 + 4, bit * 6 + 4, bit * 5 + 4, bit * 4 + 4, bit * 3 + 4,
+                                           bit * 2 + 4, bit + 4, 4);
+      __m512i inc = _mm512_set1_epi64(bit << 3);
+
+      for (int32_t i = 0; i < batch; ++i) {
+        __m512i after = _mm512_srlv_epi64(base, shiftBits);
+        __m512i zigzagVal = _mm512_and_si512(after, maskVal);
+
+        // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+        __m512i signmask = _mm512_and_si512(_mm512_set1_epi64(1), zigzagVal);
+        signmask = _mm512_sub_epi64(_mm512_setzero_si512(), signmask);
+        __m512i delta = _mm512_xor_si512(_mm512_srli_epi64(zigzagVal, 1), signmask);
+
+        // calculate the cumulative sum (prefix sum) for each number in three rounds of shift and add:
+        // D0, D1+D0, D2, D3+D2, D4, D5+D4, D6, D7+D6
+        // D0, D1~D0, D2~D0, D3~D0, D4, D5~D4, D6~D4, D7~D4
+        // D0, D1~D0, D2~D0, D3~D0, D4~D0, D5~D0, D6~D0, D7~D0
+        __m512i prev = _mm512_set1_epi64(prevValue);
+        __m512i cum_sum = _mm512_add_epi64(delta, _mm512_maskz_permutexvar_epi64(0xaa, sum_mask1, delta));
+        cum_sum = _mm512_add_epi64(cum_sum, _mm512_maskz_permutexvar_epi64(0xcc, sum_mask2, cum_sum));
+        cum_sum = _mm512_add_epi64(cum_sum, _mm512_maskz_permutexvar_epi64(0xf0, sum_mask3, cum_sum));
+
+        cum_sum = _mm512_add_epi64(cum_sum, prev);
+        _mm512_storeu_si512((__m512i *)&p[_pos], cum_sum);
+
+        shiftBits = _mm512_add_epi64(shiftBits, inc);
+        prevValue = p[_pos + 7];
+        _pos += 8;
+      }
+      // handle the remain value
+      for (int32_t i = 0; i < remain; i++) {
+        zigzag_value = ((w >> (v + (batch * bit * 8))) & mask);
+        prevValue += ZIGZAG_DECODE(int64_t, zigzag_value);
+
+        p[_pos++] = prevValue;
+        v += bit;
+      }
+    }
+
+    ip += LONG_BYTES;
+  }
+
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+// todo add it
+int32_t tsDecompressFloatImplAvx512(const char *const input, const int32_t nelements, char *const output) {
+  return -1;
+}
+
+int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
+                                    bool UNUSED_PARAM(bigEndian)) {
+#if __AVX512VL__ && __AVX512BW__
+  int64_t *ostream = (int64_t *)output;
+  int32_t  ipos = 1, opos = 0;
+
+  __m128i prevVal = _mm_setzero_si128();
+  __m128i prevDelta = _mm_setzero_si128();
+
+  int32_t   numOfBatch = nelements >> 1;
+  int32_t   remainder = nelements & 0x01;
+  __mmask16 mask2[16] = {0, 0x0001, 0x0003, 0x0007, 0x000f, 0x001f, 0x003f, 0x007f, 0x00ff};
+
+  int32_t i = 0;
+  if (numOfBatch > 0) {
+    // first loop
+    uint8_t flags = input[ipos++];
+
+    int8_t nbytes1 = flags & INT8MASK(4);  // range of nbytes starts from 0 to 7
+    int8_t nbytes2 = (flags >> 4) & INT8MASK(4);
+
+    __m128i data1 = _mm_maskz_loadu_epi8(mask2[nbytes1], (const void *)(input + ipos));
+    __m128i data2 = _mm_maskz_loadu_epi8(mask2[nbytes2], (const void *)(input + ipos + nbytes1));
+    data2 = _mm_broadcastq_epi64(data2);
+
+    __m128i zzVal = _mm_blend_epi32(data2, data1, 0x03);
+
+    // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+    __m128i signmask = _mm_and_si128(_mm_set1_epi64x(1), zzVal);
+    signmask = _mm_sub_epi64(_mm_setzero_si128(), signmask);
+
+    // get two zigzag values here
+    __m128i deltaOfDelta = _mm_xor_si128(_mm_srli_epi64(zzVal, 1), signmask);
+
+    __m128i deltaCurrent = _mm_add_epi64(deltaOfDelta, prevDelta);
+    deltaCurrent = _mm_add_epi64(_mm_slli_si128(deltaOfDelta, 8), deltaCurrent);
+
+    __m128i val = _mm_add_epi64(deltaCurrent, prevVal);
+    _mm_storeu_si128((__m128i *)&ostream[opos], val);
+
+    // keep the previous value
+    prevVal = _mm_shuffle_epi32(val, 0xEE);
+
+    // keep the previous delta of delta, for the first item
+    prevDelta = _mm_shuffle_epi32(deltaOfDelta, 0xEE);
+
+    opos += 2;
+    ipos += nbytes1 + nbytes2;
+    i += 1;
+  }
+
+  // the remain
+  for (; i < numOfBatch; ++i) {
+    uint8_t flags = input[ipos++];
+
+    int8_t nbytes1 = flags & INT8MASK(4);  // range of nbytes starts from 0 to 7
+    int8_t nbytes2 = (flags >> 4) & INT8MASK(4);
+
+    __m128i data1 = _mm_maskz_loadu_epi8(mask2[nbytes1], (const void *)(input + ipos));
+    __m128i data2 = _mm_maskz_loadu_epi8(mask2[nbytes2], (const void *)(input + ipos + nbytes1));
+    data2 = _mm_broadcastq_epi64(data2);
+
+    __m128i zzVal = _mm_blend_epi32(data2, data1, 0x03);
+
+    // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+    __m128i signmask = _mm_and_si128(_mm_set1_epi64x(1), zzVal);
+    signmask = _mm_sub_epi64(_mm_setzero_si128(), signmask);
+
+    // get two zigzag values here
+    __m128i deltaOfDelta = _mm_xor_si128(_mm_srli_epi64(zzVal, 1), signmask);
+
+    // the delta of the two values, and the two values
+    __m128i deltaCurrent = _mm_add_epi64(deltaOfDelta, prevDelta);
+    deltaCurrent = _mm_add_epi64(_mm_slli_si128(deltaOfDelta, 8), deltaCurrent);
+
+    __m128i val = _mm_add_epi64(deltaCurrent, prevVal);
+    val = _mm_add_epi64(_mm_slli_si128(deltaCurrent, 8), val);
+    _mm_storeu_si128((__m128i *)&ostream[opos], val);
+
+    // keep the previous value
+    prevVal = _mm_shuffle_epi32(val, 0xEE);
+
+    // keep the previous delta
+    prevDelta = _mm_shuffle_epi32(deltaCurrent, 0xEE);
+
+    opos += 2;
+    ipos += nbytes1 + nbytes2;
+  }
+
+  if (remainder > 0) {
+    uint64_t dd = 0;
+    uint8_t  flags = input[ipos++];
+
+    int32_t nbytes = flags & INT8MASK(4);
+    int64_t deltaOfDelta = 0;
+    if (nbytes == 0) {
+      deltaOfDelta = 0;
+    } else {
+      memcpy(&dd, input + ipos, nbytes);
+      deltaOfDelta = ZIGZAG_DECODE(int64_t, dd);
+    }
+
+    ipos += nbytes;
+    if (opos == 0) {
+      ostream[opos++] = deltaOfDelta;
+    } else {
+      int64_t prevDeltaX = deltaOfDelta + prevDelta[1];
+      ostream[opos++] = prevVal[1] + prevDeltaX;
+    }
+  }
+
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+// Compute the zigzag encoded deltas of the integers in [start, end) for simple8b, see tsCompressIntZigzagAvx2.
+int32_t tsCompressIntZigzagAvx512(const char *const input, const int32_t start, const int32_t end, const char type,
+                                  uint64_t *const zigzag) {
+#if __AVX512F__
+  __m512i  zero = _mm512_setzero_si512();
+  __m512i  maxVal = _mm512_set1_epi64(SIMPLE8B_MAX_INT64);
+  __mmask8 invalid = 0;
+
+  int32_t i = start;
+  for (; i + 8 <= end; i += 8) {
+    __m512i curr, prev;
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        curr = _mm512_cvtepi8_epi64(_mm_loadl_epi64((const __m128i *)((const int8_t *)input + i)));
+        prev = _mm512_cvtepi8_epi64(_mm_loadl_epi64((const __m128i *)((const int8_t *)input + i - 1)));
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        curr = _mm512_cvtepi16_epi64(_mm_loadu_si128((const __m128i *)((const int16_t *)input + i)));
+        prev = _mm512_cvtepi16_epi64(_mm_loadu_si128((const __m128i *)((const int16_t *)input + i - 1)));
+        break;
+      case TSDB_DATA_TYPE_INT:
+        curr = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)((const int32_t *)input + i)));
+        prev = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)((const int32_t *)input + i - 1)));
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        curr = _mm512_loadu_si512((const void *)((const int64_t *)input + i));
+        prev = _mm512_loadu_si512((const void *)((const int64_t *)input + i - 1));
+        break;
+      default:
+        return -1;
+    }
+
+    // the same overflow check as safeInt64Add(curr, -prev)
+    __m512i neg = _mm512_sub_epi64(zero, prev);
+    __m512i delta = _mm512_add_epi64(curr, neg);
+    invalid |= _mm512_cmplt_epi64_mask(
+        _mm512_and_si512(_mm512_xor_si512(curr, delta), _mm512_xor_si512(neg, delta)), zero);
+
+    __m512i zigzagVal = _mm512_xor_si512(_mm512_slli_epi64(delta, 1), _mm512_srai_epi64(delta, 63));
+    invalid |= _mm512_cmpge_epu64_mask(zigzagVal, maxVal);
+
+    _mm512_storeu_si512((void *)&zigzag[i - start], zigzagVal);
+  }
+
+  return (invalid != 0) ? -1 : i - start;
+#else
+  return -1;
+#endif
+}
+
+// Compute the zigzag encoded delta of deltas of the timestamps in [start, end), see tsCompressTimestampZigzagAvx2.
+int32_t tsCompressTimestampZigzagAvx512(const char *const input, const int32_t start, const int32_t end,
+                                        uint64_t *const zigzag) {
+#if __AVX512F__
+  const int64_t *istream = (const int64_t *)input;
+
+  __m512i  zero = _mm512_setzero_si512();
+  __mmask8 invalid = 0;
+
+  int32_t i = start;
+  for (; i + 8 <= end; i += 8) {
+    __m512i curr = _mm512_loadu_si512((const void *)&istream[i]);
+    __m512i prev = _mm512_loadu_si512((const void *)&istream[i - 1]);
+    __m512i prev2 = _mm512_loadu_si512((const void *)&istream[i - 2]);
+
+    // the same overflow check as safeInt64Add(curr, -prev)
+    __m512i neg = _mm512_sub_epi64(zero, prev);
+    __m512i delta = _mm512_add_epi64(curr, neg);
+    invalid |= _mm512_cmplt_epi64_mask(
+        _mm512_and_si512(_mm512_xor_si512(curr, delta), _mm512_xor_si512(neg, delta)), zero);
+
+    // the previous deltas have been checked along with the previous timestamps
+    __m512i negDelta = _mm512_sub_epi64(zero, _mm512_sub_epi64(prev, prev2));
+    __m512i deltaOfDelta = _mm512_add_epi64(delta, negDelta);
+    invalid |= _mm512_cmplt_epi64_mask(
+        _mm512_and_si512(_mm512_xor_si512(delta, deltaOfDelta), _mm512_xor_si512(negDelta, deltaOfDelta)), zero);
+
+    __m512i zigzagVal = _mm512_xor_si512(_mm512_slli_epi64(deltaOfDelta, 1), _mm512_srai_epi64(deltaOfDelta, 63));
+    _mm512_storeu_si512((void *)&zigzag[i - start], zigzagVal);
+  }
+
+  return (invalid != 0) ? -1 : i - start;
+#else
+  return -1;
+#endif
+}
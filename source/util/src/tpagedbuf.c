@@ -1,6 +1,7 @@
 #define _DEFAULT_SOURCE
 #include "tpagedbuf.h"
 #include "taoserror.h"
+#include "lz4.h"
 #include "tcompression.h"
 #include "tsimplehash.h"
 #include "tlog.h"
@@ -24,6 +25,7 @@ struct SPageInfo {
   int32_t    length : 29;
   bool       used : 1;   // set current page is in used
   bool       dirty : 1;  // set current buffer page is dirty or not
+  bool       comp : 1;   // the on disk copy of this page is compressed
 };
 
 struct SDiskbasedBuf {
@@ -42,13 +44,14 @@ struct SDiskbasedBuf {
   SList*    lruList;
   void*     emptyDummyIdList;  // dummy id list
   void*     assistBuf;         // assistant buffer for compress/decompress data
-  SArray*   pFree;             // free area in file
+  SArray*   pFree;             // free area in file, ordered by offset
   bool      comp;              // compressed before flushed to disk
-  uint64_t  nextPos;           // next page flush position
+  int64_t   nextPos;           // next page flush position
 
-  char*               id;           // for debug purpose
-  bool                printStatis;  // Print statistics info when closing this buffer.
-  SDiskbasedBufStatis statis;
+  const SBufPageCodec* pCodec;       // codec used to compress the pages on disk
+  char*                id;           // for debug purpose
+  bool                 printStatis;  // Print statistics info when closing this buffer.
+  SDiskbasedBufStatis  statis;
 };
 
 static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
@@ -70,52 +73,126 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
-  }
+static int32_t lz4PageBound(int32_t srcSize) { return LZ4_compressBound(srcSize); }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+static int32_t lz4PageCompress(const char* src, int32_t srcSize, char* dst, int32_t dstCap) {
+  return LZ4_compress_default(src, dst, srcSize, dstCap);
+}
+
+static int32_t lz4PageDecompress(const char* src, int32_t srcSize, char* dst, int32_t dstCap) {
+  return LZ4_decompress_safe(src, dst, srcSize, dstCap);
+}
+
+static const SBufPageCodec lz4PageCodec = {
+    .name = "lz4", .bound = lz4PageBound, .compress = lz4PageCompress, .decompress = lz4PageDecompress};
+
+static int32_t prepareAssistBuf(SDiskbasedBuf* pBuf) {
+  if (pBuf->assistBuf == NULL) {
+    pBuf->assistBuf = taosMemoryMalloc(pBuf->pCodec->bound(pBuf->pageSize + sizeof(SFilePage)));
+    if (pBuf->assistBuf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  return TSDB_CODE_SUCCESS;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
+// The page is kept uncompressed on disk if compression is disabled, failed or did not save any space.
+static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, bool* comp, SDiskbasedBuf* pBuf) {
+  *dst = srcSize;
+  *comp = false;
+
+  if (!pBuf->comp || prepareAssistBuf(pBuf) != TSDB_CODE_SUCCESS) {
     return data;
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  int32_t cap = pBuf->pCodec->bound(srcSize);
+  int32_t len = pBuf->pCodec->compress(data, srcSize, pBuf->assistBuf, cap);
+  if (len <= 0 || len >= srcSize) {
+    return data;
   }
-  return data;
+
+  *dst = len;
+  *comp = true;
+  return pBuf->assistBuf;
+}
+
+static int32_t doDecompressData(const char* src, int32_t srcSize, void* data, int32_t dstSize, SDiskbasedBuf* pBuf) {
+  int32_t len = pBuf->pCodec->decompress(src, srcSize, data, dstSize);
+  if (len != dstSize) {
+    uError("failed to decompress buf page, compressed:%d, expected:%d, actual:%d, %s", srcSize, dstSize, len, pBuf->id);
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  return TSDB_CODE_SUCCESS;
 }
 
-static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
+// Return the area to the free list, which is ordered by offset and has adjacent areas merged. Any free area at the
+// end of the file is given back to nextPos directly.
+static int32_t releasePositionInFile(SDiskbasedBuf* pBuf, int64_t offset, int32_t size) {
+  if (size <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  if (offset + size == pBuf->nextPos) {
+    pBuf->nextPos = offset;
+
+    SFreeListItem* pLast = (num > 0) ? taosArrayGetLast(pBuf->pFree) : NULL;
+    if (pLast != NULL && pLast->offset + pLast->length == pBuf->nextPos) {
+      pBuf->nextPos = pLast->offset;
+      taosArrayPop(pBuf->pFree);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t i = 0;
+  while (i < num && ((SFreeListItem*)taosArrayGet(pBuf->pFree, i))->offset < offset) {
+    i += 1;
+  }
+
+  SFreeListItem* pPrev = (i > 0) ? taosArrayGet(pBuf->pFree, i - 1) : NULL;
+  SFreeListItem* pNext = (i < num) ? taosArrayGet(pBuf->pFree, i) : NULL;
+
+  if (pPrev != NULL && pPrev->offset + pPrev->length == offset) {
+    pPrev->length += size;
+    if (pNext != NULL && pPrev->offset + pPrev->length == pNext->offset) {
+      pPrev->length += pNext->length;
+      taosArrayRemove(pBuf->pFree, i);
+    }
+  } else if (pNext != NULL && offset + size == pNext->offset) {
+    pNext->offset = offset;
+    pNext->length += size;
   } else {
-    int32_t offset = -1;
+    SFreeListItem item = {.offset = offset, .length = size};
+    if (taosArrayInsert(pBuf->pFree, i, &item) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;  // the area is leaked, which only wastes some disk space
+    }
+  }
 
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
+  return TSDB_CODE_SUCCESS;
+}
 
-        return offset;
+static int64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, int32_t size) {
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size) {
+      int64_t offset = pi->offset;
+      pi->offset += size;
+      pi->length -= size;
+      if (pi->length == 0) {
+        taosArrayRemove(pBuf->pFree, i);
       }
-    }
 
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
+      return offset;
+    }
   }
+
+  // no available recycle space, allocate new area in file
+  int64_t offset = pBuf->nextPos;
+  pBuf->nextPos += size;
+  return offset;
 }
 
 /**
@@ -160,49 +237,31 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return NULL;
   }
 
-  int32_t size = pBuf->pageSize;
+  int32_t rawSize = pBuf->pageSize + sizeof(SFilePage);
+  int32_t size = pg->length;
   int64_t offset = pg->offset;
+  bool    comp = pg->comp;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize + sizeof(SFilePage), &size, pBuf);
-    if (size < 0) {
-      uError("failed to compress data when flushing data to disk, %s", pBuf->id);
-      terrno = TSDB_CODE_INVALID_PARA;
-      return NULL;
-    }
-  }
-
-  // this page is flushed to disk for the first time
+  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
   if (pg->dirty) {
-    if (!HAS_DATA_IN_DISK(pg)) {
-      offset = allocateNewPositionInFile(pBuf, size);
-      pBuf->nextPos += size;
+    char* t = doCompressData(GET_PAYLOAD_DATA(pg), rawSize, &size, &comp, pBuf);
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+    if (!HAS_DATA_IN_DISK(pg)) {  // this page is flushed to disk for the first time
+      offset = allocateNewPositionInFile(pBuf, size);
+    } else if (pg->length >= size) {  // overwrite the old area, and recycle the remain space
+      (void)releasePositionInFile(pBuf, offset + size, pg->length - size);
+    } else {  // length becomes greater, current space is not enough, allocate new place
+      (void)releasePositionInFile(pBuf, offset, pg->length);
+      offset = allocateNewPositionInFile(pBuf, size);
+    }
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+    int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
-  } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
-    size = pg->length;
+
+    pBuf->statis.flushRawBytes += rawSize;
+    pBuf->statis.compPages += comp ? 1 : 0;
   }
 
   char* pDataBuf = pg->pData;
@@ -214,6 +273,7 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
   pg->offset = offset;
   pg->length = size;  // on disk size
+  pg->comp = comp;
   return pDataBuf;
 }
 
@@ -248,7 +308,15 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   }
 
   void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
+  char* pDst = pPage;
+  if (pg->comp) {
+    if ((ret = prepareAssistBuf(pBuf)) != TSDB_CODE_SUCCESS) {
+      return ret;
+    }
+    pDst = pBuf->assistBuf;
+  }
+
+  ret = (int32_t)taosReadFile(pBuf->pFile, pDst, pg->length);
   if (ret != pg->length) {
     ret = TAOS_SYSTEM_ERROR(errno);
     return ret;
@@ -257,9 +325,11 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  if (pg->comp) {
+    return doDecompressData(pDst, pg->length, pPage, pBuf->pageSize + sizeof(SFilePage), pBuf);
+  }
+
+  return TSDB_CODE_SUCCESS;
 }
 
 static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -278,6 +348,7 @@ static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->used = true;
   ppi->pn = NULL;
   ppi->dirty = false;
+  ppi->comp = false;
 
   return *(SPageInfo**)taosArrayPush(pBuf->pIdList, &ppi);
 }
@@ -355,6 +426,8 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->fileSize = 0;
   pPBuf->pFree = taosArrayInit(4, sizeof(SFreeListItem));
   pPBuf->freePgList = tdListNew(POINTER_BYTES);
+  pPBuf->comp = true;
+  pPBuf->pCodec = &lz4PageCodec;
 
   // at least more than 2 pages must be in memory
   if (inMemBufSize < pagesize * 2) {
@@ -586,6 +659,12 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   // print the statistics information
   {
     SDiskbasedBufStatis* ps = &pBuf->statis;
+    if (ps->flushPages > 0) {
+      uDebug("Spill to disk:%.2f Kb, before compress:%.2f Kb, ratio:%.2f, compressed pages:%d/%d, codec:%s",
+             ps->flushBytes / 1024.0f, ps->flushRawBytes / 1024.0f, ps->flushRawBytes / (double)ps->flushBytes,
+             ps->compPages, ps->flushPages, pBuf->pCodec->name);
+    }
+
     if (ps->loadPages == 0) {
       uDebug("Get/Release pages:%d/%d, flushToDisk:%.2f Kb (%d Pages), loadFromDisk:%.2f Kb (%d Pages)", ps->getPages,
              ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f, ps->loadPages);
@@ -647,11 +726,21 @@ void setBufPageDirty(void* pPage, bool dirty) {
   ppi->dirty = dirty;
 }
 
-void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
-  pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) { pBuf->comp = comp; }
+
+int32_t dBufSetPageCodec(SDiskbasedBuf* pBuf, const SBufPageCodec* pCodec) {
+  if (pBuf->pFile != NULL) {  // pages on disk must be decompressed with the codec they were written with
+    uError("failed to set page codec, pages have been flushed to disk, %s", pBuf->id);
+    return TSDB_CODE_INVALID_PARA;
   }
+
+  if (pCodec != NULL && (pCodec->bound == NULL || pCodec->compress == NULL || pCodec->decompress == NULL)) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  pBuf->pCodec = (pCodec != NULL) ? pCodec : &lz4PageCodec;
+  taosMemoryFreeClear(pBuf->assistBuf);  // the required size depends on the codec
+  return TSDB_CODE_SUCCESS;
 }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
@@ -660,6 +749,14 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
   ppi->used = false;
   ppi->dirty = false;
 
+  // the disk space of this page can be reused by others
+  if (HAS_DATA_IN_DISK(ppi)) {
+    (void)releasePositionInFile(pBuf, ppi->offset, ppi->length);
+    ppi->offset = -1;
+    ppi->length = -1;
+    ppi->comp = false;
+  }
+
   // add this pageinfo into the free page info list
   SListNode* pNode = tdListPopNode(pBuf->lruList, ppi->pn);
   taosMemoryFreeClear(ppi->pData);
@@ -697,6 +794,12 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   } else {
     // printf("no page loaded\n");
   }
+
+  if (ps->flushPages > 0) {
+    printf("Spill to disk:%.2f Kb, before compress:%.2f Kb, ratio:%.2f, compressed pages:%d/%d\n",
+           ps->flushBytes / 1024.0f, ps->flushRawBytes / 1024.0f, ps->flushRawBytes / (double)ps->flushBytes,
+           ps->compPages, ps->flushPages);
+  }
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
@@ -721,4 +824,5 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
   pBuf->totalBufSize = 0;
   pBuf->allocateId = -1;
   pBuf->fileSize = 0;
+  pBuf->nextPos = 0;
 }
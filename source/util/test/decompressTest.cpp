@@ -161,6 +161,180 @@ TEST(utilTest, decompress_perf_test) {
   taosMemoryFree(px);
 }
 
+TEST(utilTest, decompress_simd_perf_test) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  char simd = tsSIMDEnable, avx2Supported = tsAVX2Supported;
+  char avx512Supported = tsAVX512Supported, avx512Enable = tsAVX512Enable;
+
+  // one data block of 4096 rows, with the timestamp of one sensor sampled per second and a slowly increasing counter
+  const int32_t num = 4096;
+  const int32_t loops = 10000;
+
+  int64_t* pTs = static_cast<int64_t*>(taosMemoryCalloc(num, sizeof(int64_t)));
+  int64_t* pVal = static_cast<int64_t*>(taosMemoryCalloc(num, sizeof(int64_t)));
+
+  uint32_t v = 100;
+  int64_t  ts = 1700000000000, val = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    ts += 1000 + taosRandR(&v) % 5;
+    val += taosRandR(&v) % 100;
+    pTs[i] = ts;
+    pVal[i] = val;
+  }
+
+  int32_t cap = num * sizeof(int64_t) + 64;
+  char*   pTsComp = static_cast<char*>(taosMemoryMalloc(cap));
+  char*   pValComp = static_cast<char*>(taosMemoryMalloc(cap));
+  char*   pOutput = static_cast<char*>(taosMemoryMalloc(cap));
+
+  int32_t tsLen = tsCompressTimestamp(pTs, num * sizeof(int64_t), num, pTsComp, cap, ONE_STAGE_COMP, NULL, 0);
+  int32_t valLen = tsCompressBigint(pVal, num * sizeof(int64_t), num, pValComp, cap, ONE_STAGE_COMP, NULL, 0);
+
+  struct {
+    const char* name;
+    bool        available;
+    char        avx2;
+    char        avx512;
+  } levels[] = {{"scalar", true, 0, 0}, {"avx2", avx2 != 0, 1, 0}, {"avx512", avx512 != 0, 0, 1}};
+
+  for (int32_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+    if (!levels[l].available) {
+      std::cout << levels[l].name << " is not supported, skip it" << std::endl;
+      continue;
+    }
+
+    tsSIMDEnable = (levels[l].avx2 || levels[l].avx512);
+    tsAVX2Supported = levels[l].avx2;
+    tsAVX512Supported = levels[l].avx512;
+    tsAVX512Enable = levels[l].avx512;
+
+    memset(pOutput, 0, cap);
+    int64_t st = taosGetTimestampUs();
+    for (int32_t k = 0; k < loops; ++k) {
+      tsDecompressTimestamp(pTsComp, tsLen, num, pOutput, cap, ONE_STAGE_COMP, NULL, 0);
+    }
+    int64_t el1 = taosGetTimestampUs() - st;
+    ASSERT_EQ(memcmp(pOutput, pTs, num * sizeof(int64_t)), 0);
+
+    memset(pOutput, 0, cap);
+    st = taosGetTimestampUs();
+    for (int32_t k = 0; k < loops; ++k) {
+      tsDecompressBigint(pValComp, valLen, num, pOutput, cap, ONE_STAGE_COMP, NULL, 0);
+    }
+    int64_t el2 = taosGetTimestampUs() - st;
+    ASSERT_EQ(memcmp(pOutput, pVal, num * sizeof(int64_t)), 0);
+
+    std::cout << levels[l].name << " decompress timestamp elapsed time:" << el1 << " us, bigint elapsed time:" << el2
+              << " us" << std::endl;
+  }
+
+  tsSIMDEnable = simd;
+  tsAVX2Supported = avx2Supported;
+  tsAVX512Supported = avx512Supported;
+  tsAVX512Enable = avx512Enable;
+
+  taosMemoryFree(pTs);
+  taosMemoryFree(pVal);
+  taosMemoryFree(pTsComp);
+  taosMemoryFree(pValComp);
+  taosMemoryFree(pOutput);
+}
+
+TEST(utilTest, compress_simd_perf_test) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  char simd = tsSIMDEnable, avx2Supported = tsAVX2Supported;
+  char avx512Supported = tsAVX512Supported, avx512Enable = tsAVX512Enable;
+
+  // typical sensor data of one block: timestamps sampled per second with jitter, an increasing counter and a
+  // temperature fluctuating in a small range
+  const int32_t num = 4096;
+  const int32_t loops = 10000;
+
+  int64_t* pTs = static_cast<int64_t*>(taosMemoryCalloc(num, sizeof(int64_t)));
+  int64_t* pCounter = static_cast<int64_t*>(taosMemoryCalloc(num, sizeof(int64_t)));
+  int32_t* pTemp = static_cast<int32_t*>(taosMemoryCalloc(num, sizeof(int32_t)));
+
+  uint32_t v = 100;
+  int64_t  ts = 1700000000000, counter = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    ts += 1000 + taosRandR(&v) % 5;
+    counter += taosRandR(&v) % 100;
+    pTs[i] = ts;
+    pCounter[i] = counter;
+    pTemp[i] = 200 + taosRandR(&v) % 20;
+  }
+
+  int32_t cap = num * sizeof(int64_t) + 64;
+  char*   pExpect[3] = {0};
+  int32_t expectLen[3] = {0};
+  char*   pOutput = static_cast<char*>(taosMemoryMalloc(cap));
+
+  struct {
+    const char* name;
+    bool        available;
+    char        avx2;
+    char        avx512;
+  } levels[] = {{"scalar", true, 0, 0}, {"avx2", avx2 != 0, 1, 0}, {"avx512", avx512 != 0, 0, 1}};
+
+  for (int32_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+    if (!levels[l].available) {
+      std::cout << levels[l].name << " is not supported, skip it" << std::endl;
+      continue;
+    }
+
+    tsSIMDEnable = (levels[l].avx2 || levels[l].avx512);
+    tsAVX2Supported = levels[l].avx2;
+    tsAVX512Supported = levels[l].avx512;
+    tsAVX512Enable = levels[l].avx512;
+
+    int64_t el[3] = {0};
+    for (int32_t c = 0; c < 3; ++c) {
+      int32_t len = 0;
+      int64_t st = taosGetTimestampUs();
+      for (int32_t k = 0; k < loops; ++k) {
+        if (c == 0) {
+          len = tsCompressTimestamp(pTs, num * sizeof(int64_t), num, pOutput, cap, ONE_STAGE_COMP, NULL, 0);
+        } else if (c == 1) {
+          len = tsCompressBigint(pCounter, num * sizeof(int64_t), num, pOutput, cap, ONE_STAGE_COMP, NULL, 0);
+        } else {
+          len = tsCompressInt(pTemp, num * sizeof(int32_t), num, pOutput, cap, ONE_STAGE_COMP, NULL, 0);
+        }
+      }
+      el[c] = taosGetTimestampUs() - st;
+
+      // the SIMD kernels must generate exactly the same data as the scalar implementation
+      if (l == 0) {
+        pExpect[c] = static_cast<char*>(taosMemoryMalloc(cap));
+        memcpy(pExpect[c], pOutput, len);
+        expectLen[c] = len;
+      } else {
+        ASSERT_EQ(len, expectLen[c]);
+        ASSERT_EQ(memcmp(pOutput, pExpect[c], len), 0);
+      }
+    }
+
+    std::cout << levels[l].name << " compress timestamp elapsed time:" << el[0] << " us, bigint elapsed time:" << el[1]
+              << " us, int elapsed time:" << el[2] << " us" << std::endl;
+  }
+
+  tsSIMDEnable = simd;
+  tsAVX2Supported = avx2Supported;
+  tsAVX512Supported = avx512Supported;
+  tsAVX512Enable = avx512Enable;
+
+  for (int32_t c = 0; c < 3; ++c) {
+    taosMemoryFree(pExpect[c]);
+  }
+  taosMemoryFree(pTs);
+  taosMemoryFree(pCounter);
+  taosMemoryFree(pTemp);
+  taosMemoryFree(pOutput);
+}
+
 void setColEncode(uint32_t* compress, uint8_t l1) {
   *compress &= 0x00FFFFFF;
   *compress |= (l1 << 24);
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "taos.h"
 #include "tpagedbuf.h"
@@ -220,6 +221,107 @@ void testFlushAndReadBackBuffer() {
   taosMemoryFree(rowData);
 }
 
+void fillPage(SFilePage* pPg, int32_t pageSize, int32_t seed, bool random) {
+  pPg->num = pageSize;
+  for (int32_t i = 0; i < pageSize - (int32_t)sizeof(SFilePage); ++i) {
+    pPg->data[i] = random ? (char)taosRand() : (char)(seed + i % 16);
+  }
+  setBufPageDirty(pPg, true);
+}
+
+bool checkPage(SFilePage* pPg, int32_t pageSize, int32_t seed) {
+  if (pPg->num != pageSize) {
+    return false;
+  }
+  for (int32_t i = 0; i < pageSize - (int32_t)sizeof(SFilePage); ++i) {
+    if (pPg->data[i] != (char)(seed + i % 16)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int32_t noCompressBound(int32_t srcSize) { return srcSize; }
+
+int32_t noCompress(const char* src, int32_t srcSize, char* dst, int32_t dstCap) { return 0; }
+
+// spill compressible pages through a small in-memory buffer, rewrite and recycle some of them, and read all back
+void compressedSpillTest(const SBufPageCodec* pCodec) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        pageSize = 4096;
+  int32_t        numOfPages = 64;
+  int32_t        code = createDiskbasedBuf(&pBuf, pageSize, pageSize * 4, "1", TD_TMP_DIR_PATH);
+  ASSERT_EQ(code, 0);
+  if (pCodec != NULL) {
+    ASSERT_EQ(dBufSetPageCodec(pBuf, pCodec), 0);
+  }
+
+  std::vector<int32_t> ids(numOfPages);
+  std::vector<int32_t> seeds(numOfPages);
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pPg = static_cast<SFilePage*>(getNewBufPage(pBuf, &ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    seeds[i] = i;
+    fillPage(pPg, pageSize, seeds[i], false);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  // the codec can not be changed once any page is on disk
+  ASSERT_NE(dBufSetPageCodec(pBuf, NULL), 0);
+
+  // rewrite half of the pages with incompressible data and then with compressible data again, so the on disk slots
+  // of these pages grow and shrink
+  for (int32_t i = 0; i < numOfPages; i += 2) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    ASSERT_TRUE(checkPage(pPg, pageSize, seeds[i]));
+    fillPage(pPg, pageSize, 0, true);
+    releaseBufPage(pBuf, pPg);
+  }
+  for (int32_t i = 0; i < numOfPages; i += 2) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    seeds[i] = i + 7;
+    fillPage(pPg, pageSize, seeds[i], false);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  // recycle some pages and let the freed disk space be reused by the new ones
+  for (int32_t i = 1; i < numOfPages; i += 4) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    dBufSetBufPageRecycled(pBuf, pPg);
+  }
+  for (int32_t i = 1; i < numOfPages; i += 4) {
+    SFilePage* pPg = static_cast<SFilePage*>(getNewBufPage(pBuf, &ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    seeds[i] = i * 3;
+    fillPage(pPg, pageSize, seeds[i], false);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, ids[i]));
+    ASSERT_TRUE(pPg != NULL);
+    ASSERT_TRUE(checkPage(pPg, pageSize, seeds[i])) << "page:" << ids[i];
+    releaseBufPage(pBuf, pPg);
+  }
+
+  SDiskbasedBufStatis st = getDBufStatis(pBuf);
+  ASSERT_GT(st.flushPages, numOfPages);
+  ASSERT_EQ(st.flushRawBytes, (int64_t)st.flushPages * (pageSize + sizeof(SFilePage)));
+  if (pCodec == NULL) {
+    ASSERT_GT(st.compPages, 0);
+    ASSERT_LT(st.compPages, st.flushPages);  // the random pages are stored as they are
+    ASSERT_LT(st.flushBytes * 3, st.flushRawBytes);
+  } else {
+    ASSERT_EQ(st.compPages, 0);
+    ASSERT_EQ(st.flushBytes, st.flushRawBytes);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
+
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -230,4 +332,13 @@ TEST(testCase, resultBufferTest) {
   testFlushAndReadBackBuffer();
 }
 
+TEST(testCase, compressedSpillTest) {
+  taosSeedRand(taosGetTimestampSec());
+  compressedSpillTest(NULL);
+
+  // a codec never succeeds to compress, all pages are kept as they are on disk
+  SBufPageCodec codec = {"none", noCompressBound, noCompress, noCompress};
+  compressedSpillTest(&codec);
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,110 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """file blocks skipped by the tsdb reader since the bloom filters of their columns hold none of the compared values"""
+    updatecfgDict = {'tsdbBloomFilter': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rowNum = 40000
+        self.batch = 1000
+        self.ts = 1537146000000
+
+    def insertData(self, dbname):
+        # bloom filters are built on the columns listed in the sma option only, not on all the columns with SMA
+        tdSql.execute(f"create stable {dbname}.stb(ts timestamp, dev varchar(32), code bigint, ucode int unsigned, "
+                      f"other varchar(32)) tags(t1 int) sma(dev, code, ucode)")
+        tdSql.execute(f"create table {dbname}.ctb using {dbname}.stb tags(1)")
+        # a normal table of the same data, every column has SMA by default and none a bloom filter
+        tdSql.execute(f"create table {dbname}.ntb(ts timestamp, dev varchar(32), code bigint, ucode int unsigned, "
+                      f"other varchar(32))")
+        for start in range(0, self.rowNum, self.batch):
+            values = []
+            for i in range(start, start + self.batch):
+                # the values are not ordered by ts, so the min/max of the blocks don't prune them
+                dev = f"dev{(i * 7919) % self.rowNum}"
+                values.append(f"({self.ts + i}, '{dev}', {(i * 104729) % 1000003}, {i % 50}, '{dev}')")
+            tdSql.execute(f"insert into {dbname}.ctb values " + " ".join(values))
+            tdSql.execute(f"insert into {dbname}.ntb values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkPointLookup(self, dbname):
+        i = 12345
+        dev = f"dev{(i * 7919) % self.rowNum}"
+        code = (i * 104729) % 1000003
+
+        tdSql.query(f"select ts, code from {dbname}.stb where dev = '{dev}'")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 1, code)
+
+        tdSql.query(f"select count(*) from {dbname}.ctb where '{dev}' = dev")
+        tdSql.checkData(0, 0, 1)
+
+        tdSql.query(f"select dev from {dbname}.ctb where code = {code}")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, dev)
+
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = '{dev}' and code = {code}")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = '{dev}' and code = {code + 1}")
+        tdSql.checkData(0, 0, 0)
+
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev in ('dev1', 'dev2', 'nodev')")
+        tdSql.checkData(0, 0, 2)
+
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = 'nodev'")
+        tdSql.checkData(0, 0, 0)
+        tdSql.query(f"select count(*) from {dbname}.ctb where code = -1")
+        tdSql.checkData(0, 0, 0)
+
+        # constants out of the range of the column type never match
+        tdSql.query(f"select count(*) from {dbname}.ctb where ucode = -1")
+        tdSql.checkData(0, 0, 0)
+        tdSql.query(f"select count(*) from {dbname}.ctb where ucode = 7")
+        tdSql.checkData(0, 0, self.rowNum // 50)
+
+        # no bloom filter on the column not listed in the sma option
+        tdSql.query(f"select count(*) from {dbname}.ctb where other = '{dev}'")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query(f"select count(*) from {dbname}.ntb where dev = '{dev}'")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query(f"select count(*) from {dbname}.ntb where dev = 'nodev'")
+        tdSql.checkData(0, 0, 0)
+
+        # equalities under OR are not used to skip blocks
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = 'nodev' or code = {code}")
+        tdSql.checkData(0, 0, 1)
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True, stt_trigger=1)
+
+        self.insertData(dbname)
+        self.checkPointLookup(dbname)
+
+        # the updated row in memory overlaps with a file block, the block is merged instead of skipped
+        tdSql.execute(f"insert into {dbname}.ctb values({self.ts + 5}, 'updated', 7, 7, 'updated')")
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = 'dev{(5 * 7919) % self.rowNum}'")
+        tdSql.checkData(0, 0, 0)
+        tdSql.query(f"select ts from {dbname}.ctb where dev = 'updated'")
+        tdSql.checkRows(1)
+
+        tdSql.execute(f"flush database {dbname}")
+        tdSql.query(f"select count(*) from {dbname}.ctb where dev = 'dev{(5 * 7919) % self.rowNum}'")
+        tdSql.checkData(0, 0, 0)
+        tdSql.query(f"select ts from {dbname}.ctb where dev = 'updated'")
+        tdSql.checkRows(1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,84 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """file blocks skipped by the tsdb reader since the min/max of their columns can't match the filter"""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rowNum = 40000
+        self.batch = 1000
+        self.ts = 1537146000000
+
+    def insertData(self, dbname):
+        tdSql.execute(f"create table {dbname}.ntb(ts timestamp, voltage int, current double, c3 int, info binary(16))")
+        for start in range(0, self.rowNum, self.batch):
+            values = []
+            for i in range(start, start + self.batch):
+                # voltage grows with ts so the blocks cover disjoint ranges, c3 is always NULL
+                values.append(f"({self.ts + i}, {i // 100}, {i + 0.25}, NULL, 'info{i}')")
+            tdSql.execute(f"insert into {dbname}.ntb values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkPrune(self, dbname):
+        maxVoltage = (self.rowNum - 1) // 100
+
+        tdSql.query(f"select count(*), min(ts), max(info) from {dbname}.ntb where voltage > {maxVoltage - 2}")
+        tdSql.checkData(0, 0, 200)
+
+        tdSql.query(f"select ts, current, info from {dbname}.ntb where voltage > {maxVoltage - 1} order by ts desc")
+        tdSql.checkRows(100)
+        tdSql.checkData(0, 2, f"info{self.rowNum - 1}")
+        tdSql.checkData(99, 2, f"info{self.rowNum - 100}")
+
+        tdSql.query(f"select count(*) from {dbname}.ntb where voltage > {maxVoltage}")
+        tdSql.checkData(0, 0, 0)
+
+        tdSql.query(f"select count(*) from {dbname}.ntb where voltage between 10 and 11 and current < 1050")
+        tdSql.checkData(0, 0, 50)
+
+        # the NULL column has no min/max to prune on
+        tdSql.query(f"select count(*) from {dbname}.ntb where c3 > 0")
+        tdSql.checkData(0, 0, 0)
+        tdSql.query(f"select count(*) from {dbname}.ntb where c3 is null and voltage < 1")
+        tdSql.checkData(0, 0, 100)
+
+        # OR of the conditions on different columns
+        tdSql.query(f"select count(*) from {dbname}.ntb where voltage > {maxVoltage - 1} or current < 10")
+        tdSql.checkData(0, 0, 110)
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True, stt_trigger=1)
+
+        self.insertData(dbname)
+        self.checkPrune(dbname)
+
+        # updated rows in memory overlap with the file blocks, the blocks are merged instead of pruned
+        tdSql.execute(f"insert into {dbname}.ntb values({self.ts + 5}, 10000, 0.5, 1, 'updated')")
+        tdSql.query(f"select ts, info from {dbname}.ntb where voltage = 10000")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 1, "updated")
+        tdSql.query(f"select count(*) from {dbname}.ntb where voltage < 1")
+        tdSql.checkData(0, 0, 99)
+
+        # and the same after they are flushed
+        tdSql.execute(f"flush database {dbname}")
+        tdSql.query(f"select ts, info from {dbname}.ntb where voltage = 10000")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 1, "updated")
+        tdSql.query(f"select count(*) from {dbname}.ntb where voltage < 1")
+        tdSql.checkData(0, 0, 99)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
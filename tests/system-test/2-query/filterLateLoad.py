@@ -0,0 +1,101 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """filters evaluated by the tsdb reader on the filter columns before the other columns of a block are loaded"""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rowNum = 20000
+        self.batch = 500
+        self.ts = 1537146000000
+
+    def insertData(self, dbname):
+        tdSql.execute(f'''create stable {dbname}.stb(ts timestamp, c1 int, c2 bigint, c3 double, c4 binary(20), c5 nchar(20),
+                    c6 int, c7 bool) tags(t1 int)''')
+        for t in range(2):
+            tdSql.execute(f"create table {dbname}.ct{t} using {dbname}.stb tags({t})")
+            for start in range(0, self.rowNum, self.batch):
+                values = []
+                for i in range(start, start + self.batch):
+                    # c6 is NULL in every other row
+                    c6 = "NULL" if i % 2 else str(i)
+                    values.append(f"({self.ts + i}, {i}, {i * 10}, {i + 0.5}, 'bin{i}', 'nch{i}', {c6}, {i % 2})")
+                tdSql.execute(f"insert into {dbname}.ct{t} values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkRows(self, dbname):
+        # a single row qualifies, all the projected columns are loaded for its block
+        tdSql.query(f"select c2, c3, c4, c5, c6 from {dbname}.ct0 where c1 = 12345")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, 123450)
+        tdSql.checkData(0, 1, 12345.5)
+        tdSql.checkData(0, 2, "bin12345")
+        tdSql.checkData(0, 3, "nch12345")
+        tdSql.checkData(0, 4, None)
+
+        # no rows qualify in any block
+        tdSql.query(f"select c2, c3, c4, c5 from {dbname}.ct0 where c1 < 0")
+        tdSql.checkRows(0)
+
+        # the filter refers to more than one column
+        tdSql.query(f"select c4, c5 from {dbname}.ct0 where c1 >= 100 and c1 < 110 and c7 = true order by ts")
+        tdSql.checkRows(5)
+        tdSql.checkData(0, 0, "bin101")
+        tdSql.checkData(4, 1, "nch109")
+
+        # the filter column is NULL in half of the rows
+        tdSql.query(f"select count(*), sum(c2) from {dbname}.ct0 where c6 is not null and c6 < 1000")
+        tdSql.checkData(0, 0, 500)
+        tdSql.checkData(0, 1, sum(i * 10 for i in range(0, 1000, 2)))
+
+        # descending scan
+        tdSql.query(f"select c4 from {dbname}.ct0 where c1 > {self.rowNum - 4} order by ts desc")
+        tdSql.checkRows(3)
+        tdSql.checkData(0, 0, f"bin{self.rowNum - 1}")
+        tdSql.checkData(2, 0, f"bin{self.rowNum - 3}")
+
+        # the filter on tags and pseudo columns is not evaluated in the reader
+        tdSql.query(f"select c4, t1 from {dbname}.stb where c1 = 7 and t1 = 1")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, "bin7")
+        tdSql.checkData(0, 1, 1)
+
+        tdSql.query(f"select c4, tbname from {dbname}.stb where c1 = 8 and tbname = 'ct0'")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, "bin8")
+
+        tdSql.query(f"select count(*) from {dbname}.stb where c1 = 9 or t1 = 0")
+        tdSql.checkData(0, 0, self.rowNum + 1)
+
+        # the filter refers to all the loaded columns
+        tdSql.query(f"select c1 from {dbname}.ct1 where c1 = 3")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, 3)
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True)
+
+        self.insertData(dbname)
+        self.checkRows(dbname)
+
+        # the same queries with rows in memory after the blocks in files
+        tdSql.execute(f"insert into {dbname}.ct0 values({self.ts + self.rowNum}, -1, -10, -0.5, 'neg', 'neg', -1, true)")
+        tdSql.query(f"select c2, c4 from {dbname}.ct0 where c1 < 0")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, -10)
+        tdSql.checkData(0, 1, "neg")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
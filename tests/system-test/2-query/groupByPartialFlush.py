@@ -0,0 +1,83 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """partial group by of super tables returns its groups early when its result buffer is full, the merged results are
+    the same as those aggregated at once"""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.ts = 1537146000000
+        self.childNum = 4
+        self.rowNum = 20000
+        self.batch = 1000
+        self.groupNum = 1000
+        # 4 pages of the min buffer hold about a hundred groups
+        self.smallBufSize = 16
+        self.defaultBufSize = 10240
+
+    def insertData(self, dbname):
+        tdSql.execute(f"create stable {dbname}.stb(ts timestamp, g int, u bigint, v double, s varchar(16)) tags(t int)")
+        for t in range(self.childNum):
+            tdSql.execute(f"create table {dbname}.ctb{t} using {dbname}.stb tags({t})")
+            for start in range(0, self.rowNum, self.batch):
+                values = []
+                for i in range(start, start + self.batch):
+                    # g: groups repeated over and over, u: unique in the super table
+                    g = (i * 7 + t) % self.groupNum
+                    values.append(f"({self.ts + i}, {g}, {t * self.rowNum + i}, {i * 0.5}, 's{g % 10}')")
+                tdSql.execute(f"insert into {dbname}.ctb{t} values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def setBufSize(self, kb):
+        tdSql.execute(f"alter dnode 1 'queryOperatorBufSize' '{kb}'")
+
+    def queryRows(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult, key=str)
+
+    def checkSameRows(self, sql, rows):
+        self.setBufSize(self.defaultBufSize)
+        wholeRows = self.queryRows(sql)
+        self.setBufSize(self.smallBufSize)
+        flushedRows = self.queryRows(sql)
+        self.setBufSize(self.defaultBufSize)
+        if len(wholeRows) != rows or flushedRows != wholeRows:
+            tdLog.exit(f"{sql} got {len(flushedRows)} rows flushed, {len(wholeRows)} rows at once, {rows} expected")
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True, vgroups=2)
+        self.insertData(dbname)
+
+        aggs = "count(*), sum(u), min(v), max(v), avg(v), spread(u), first(ts), last(ts)"
+
+        # the groups are reduced by the input, the buffer is flushed and reused many times
+        self.checkSameRows(f"select g, {aggs} from {dbname}.stb group by g", self.groupNum)
+        self.checkSameRows(f"select g, s, {aggs} from {dbname}.stb group by g, s", self.groupNum)
+        self.checkSameRows(f"select g, t, {aggs} from {dbname}.stb group by g, t", self.groupNum * self.childNum)
+
+        # every row is a group of its own, the partial group by turns to pass through
+        total = self.childNum * self.rowNum
+        self.checkSameRows(f"select u, {aggs} from {dbname}.stb group by u", total)
+        self.checkSameRows(f"select count(*) from (select u, count(*) from {dbname}.stb group by u)", 1)
+
+        # filter and limit keep the partial results until the input is exhausted
+        self.checkSameRows(f"select g, count(*) from {dbname}.stb group by g having count(*) > 0", self.groupNum)
+        self.checkSameRows(f"select g, sum(u) from {dbname}.stb group by g order by g limit 10", 10)
+
+        tdSql.query(f"select count(*) from (select g from {dbname}.stb group by g)")
+        tdSql.checkData(0, 0, self.groupNum)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,81 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """inner hash joins whose build keys are pushed down to the probe table scan return what merge joins return"""
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.ts = 1537146000000
+        self.day = 86400000
+        self.rowNum = 20000
+
+    def insertData(self, dbname):
+        # big: a row every 37 seconds, many rows a day and most not at midnight
+        tdSql.execute(f"create table {dbname}.big(ts timestamp, v int)")
+        # small: a few of the ts of big, and midnights
+        tdSql.execute(f"create table {dbname}.small(ts timestamp, v int)")
+
+        for start in range(0, self.rowNum, 1000):
+            values = [f"({self.ts + i * 37000}, {i})" for i in range(start, start + 1000)]
+            tdSql.execute(f"insert into {dbname}.big values " + " ".join(values))
+
+        values = [f"({self.ts + i * 37000}, {i})" for i in range(0, self.rowNum, 997)]
+        day0 = self.ts - self.ts % self.day
+        values += [f"({day0 + d * self.day}, {-d})" for d in range(0, 10)]
+        tdSql.execute(f"insert into {dbname}.small values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def queryRows(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult)
+
+    def checkSameRows(self, hashSql, mergeSql, minRows):
+        hashRows = self.queryRows(hashSql)
+        mergeRows = self.queryRows(mergeSql)
+        if len(hashRows) < minRows or hashRows != mergeRows:
+            tdLog.exit(f"{hashSql} got {len(hashRows)} rows, {mergeSql} got {len(mergeRows)} rows")
+
+    def checkPlainKey(self, dbname):
+        for left, right in (("small", "big"), ("big", "small")):
+            cols = f"a.ts, a.v, b.v from {dbname}.{left} a join {dbname}.{right} b on a.ts = b.ts"
+            self.checkSameRows(f"select /*+ hash_join() */ {cols}", f"select {cols}", self.rowNum // 997)
+            self.checkSameRows(f"select /*+ hash_join() */ {cols} where b.v >= 0",
+                               f"select {cols} where b.v >= 0", self.rowNum // 997)
+
+        # the probe rows are not filtered under a subquery, the results are the same
+        self.checkSameRows(f"select /*+ hash_join() */ a.ts, b.v from {dbname}.small a join "
+                           f"(select ts, v from {dbname}.big) b on a.ts = b.ts",
+                           f"select a.ts, b.v from {dbname}.small a join {dbname}.big b on a.ts = b.ts",
+                           self.rowNum // 997)
+
+        tdSql.query(f"select /*+ hash_join() */ count(*) from {dbname}.small a join {dbname}.big b on a.ts = b.ts")
+        tdSql.checkData(0, 0, len(range(0, self.rowNum, 997)))
+
+    def checkTruncatedKey(self, dbname):
+        # the probe key is computed from the scanned ts, the raw ts must not be filtered by the build keys
+        for left, right, cond in (("small", "big", "a.ts = timetruncate(b.ts, 1d)"),
+                                  ("big", "small", "timetruncate(a.ts, 1d) = b.ts")):
+            cols = f"a.ts, b.ts, a.v, b.v from {dbname}.{left} a join {dbname}.{right} b on {cond}"
+            self.checkSameRows(f"select /*+ hash_join() */ {cols}", f"select {cols}", self.rowNum // 2)
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True)
+
+        self.insertData(dbname)
+        self.checkPlainKey(dbname)
+        self.checkTruncatedKey(dbname)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,98 @@
+import re
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    """hash joins whose build table exceeds hashJoinMemThreshold are spilled to disk and return what in memory joins return"""
+    updatecfgDict = {'hashJoinMemThreshold': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.ts = 1537146000000
+        self.rowNum = 3000
+        self.childNum = 4
+        self.batch = 200
+
+    def insertData(self, dbname):
+        # big: the build table, rows of all the children share the ts, so a key has a row of each child. 24 MB of
+        # build rows are more than 1 MB in each of the 16 partitions, the partitions are split again
+        tdSql.execute(f"create stable {dbname}.big(ts timestamp, v int, s varchar(2048)) tags(t int)")
+        for t in range(self.childNum):
+            tdSql.execute(f"create table {dbname}.big{t} using {dbname}.big tags({t})")
+            for start in range(0, self.rowNum, self.batch):
+                values = [f"({self.ts + i * 1000}, {i * 10 + t}, '{str(i * 10 + t).rjust(2000, 'x')}')"
+                          for i in range(start, start + self.batch)]
+                tdSql.execute(f"insert into {dbname}.big{t} values " + " ".join(values))
+
+        # probe: two thirds of the ts of big, and ts between them matching no build row
+        tdSql.execute(f"create table {dbname}.probe(ts timestamp, v int)")
+        for start in range(0, self.rowNum, self.batch):
+            values = [f"({self.ts + i * 1000}, {i})" for i in range(start, start + self.batch) if i % 3 != 0]
+            values += [f"({self.ts + i * 1000 + 500}, {-i})" for i in range(start, start + self.batch, 50)]
+            tdSql.execute(f"insert into {dbname}.probe values " + " ".join(values))
+
+        tdSql.execute(f"flush database {dbname}")
+
+    def queryRows(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult, key=str)
+
+    def setMemThreshold(self, mb):
+        tdSql.execute(f"alter dnode 1 'hashJoinMemThreshold' '{mb}'")
+
+    def checkSpilled(self, sql):
+        tdSql.query(f"explain analyze {sql}")
+        levels = 0
+        for row in tdSql.queryResult:
+            m = re.search(r"Spill: partitions:\d+ levels:(\d+)", str(row[0]))
+            if m:
+                levels = max(levels, int(m.group(1)))
+        # the partitions are split at least once more after the first partitioning
+        if levels < 2:
+            tdLog.exit(f"{sql} is not spilled again, levels:{levels}")
+
+    def checkSameRows(self, sql, minRows):
+        self.setMemThreshold(0)
+        memRows = self.queryRows(sql)
+        self.setMemThreshold(1)
+        spillRows = self.queryRows(sql)
+        if len(spillRows) < minRows or spillRows != memRows:
+            tdLog.exit(f"{sql} got {len(spillRows)} rows spilled, {len(memRows)} rows in memory")
+        self.checkSpilled(sql)
+
+    def run(self):
+        dbname = "db"
+        tdSql.prepare(dbname=dbname, drop=True)
+        self.insertData(dbname)
+
+        matched = (self.rowNum - self.rowNum // 3) * self.childNum
+        cols = "a.ts, a.v, b.ts, b.v, b.t, length(b.s)"
+
+        # the left table is the build table of inner and right joins, the right one is of left joins
+        self.checkSameRows(f"select /*+ hash_join() */ {cols} from {dbname}.big b join {dbname}.probe a "
+                           f"on a.ts = b.ts", matched)
+        self.checkSameRows(f"select /*+ hash_join() */ {cols} from {dbname}.big b join {dbname}.probe a "
+                           f"on a.ts = b.ts and a.v <= b.v", matched)
+        self.checkSameRows(f"select /*+ hash_join() */ {cols} from {dbname}.probe a left join {dbname}.big b "
+                           f"on a.ts = b.ts", matched)
+        self.checkSameRows(f"select /*+ hash_join() */ {cols} from {dbname}.big b right join {dbname}.probe a "
+                           f"on a.ts = b.ts", matched)
+        # the probe rows out of the time range are not matched but still returned by outer joins
+        self.checkSameRows(f"select /*+ hash_join() */ {cols} from {dbname}.probe a left join {dbname}.big b "
+                           f"on a.ts = b.ts and a.ts < {self.ts + self.rowNum * 500}", matched // 2)
+
+        tdSql.query(f"select /*+ hash_join() */ count(*) from {dbname}.big b join {dbname}.probe a on a.ts = b.ts")
+        tdSql.checkData(0, 0, matched)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())